@@ -0,0 +1,379 @@
+//
+//  AsyncTextureLoader.h
+//  Carregamento de texturas em segundo plano (decodificação em threads + upload por PBO)
+//
+//  O loadTexture dos demos chamava stbi_load na thread do OpenGL, uma imagem
+//  depois da outra, antes do primeiro frame. Aqui request() só lê o cabeçalho
+//  da imagem (stbi_info, para o demo já saber largura e altura), cria a textura
+//  com uma imagem provisória (xadrez cinza 2x2) e coloca a decodificação na
+//  fila de um pool de threads. O demo desenha normalmente com o id devolvido.
+//
+//  update(), chamado uma vez por frame na thread do OpenGL, pega as imagens já
+//  decodificadas e copia os pixels para um pixel buffer object, no máximo
+//  bytesPerFrame bytes por frame (uma imagem grande ocupa vários frames). Com a
+//  imagem inteira no PBO, o glTexImage2D lê do buffer e troca a provisória
+//  pela imagem de verdade, com os mesmos parâmetros do loadTexture antigo.
+//
+//  São medidos o tempo até o primeiro frame (primeiro update) e até todas as
+//  texturas pedidas estarem na GPU, a partir da criação do loader.
+//
+//  Os demos não usam o loader direto, e sim pelo cache do TextureManager.h.
+//
+//  O stb_image precisa ter a implementação no executável (STB_IMAGE_IMPLEMENTATION).
+//
+//  Exemplo:
+//    AsyncTextureLoader textureLoader;
+//    GLuint tex = textureLoader.request("../assets/sprites/coruja.png", width, height);
+//    while (...) { textureLoader.update(); ... desenho ... }
+//    textureLoader.printReport();
+//    textureLoader.release();   // antes do glfwTerminate
+//
+
+#ifndef AsyncTextureLoader_h
+#define AsyncTextureLoader_h
+
+#include <glad/glad.h>
+
+#ifndef STBI_INCLUDE_STB_IMAGE_H
+#include <stb_image.h>
+#endif
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_set>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+
+// Parâmetros de amostragem de uma textura 2D (o padrão é o que os demos sempre usaram)
+struct TextureParams {
+    GLint wrapS = GL_REPEAT;
+    GLint wrapT = GL_REPEAT;
+    GLint minFilter = GL_NEAREST;
+    GLint magFilter = GL_NEAREST;
+    bool mipmaps = true;
+};
+
+class AsyncTextureLoader {
+    struct Job {
+        GLuint texID;
+        std::string path;
+        TextureParams params;
+        unsigned char *pixels;   // preenchido pela thread de decodificação
+        int width, height, channels;
+        GLuint pbo;              // daqui para baixo só na thread do OpenGL
+        size_t size, staged;
+    };
+
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::unique_ptr<Job>> queue;      // esperando decodificação
+    std::vector<std::unique_ptr<Job>> decoded;   // prontas para o upload
+    bool stopping;
+
+    std::deque<std::unique_ptr<Job>> uploads;    // no meio do upload (thread do OpenGL)
+    std::unordered_set<GLuint> loading;          // texturas ainda com a imagem provisória
+    size_t bytesPerFrame;
+    int requested, loaded, failed, pending;
+    size_t bytesUploaded;
+
+    Clock::time_point start;
+    double firstFrameMs, allLoadedMs;
+
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void workerLoop() {
+        for (;;) {
+            std::unique_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (stopping) {
+                    return;
+                }
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            // stbi_load não usa estado global (não há flip vertical nos demos)
+            job->pixels = stbi_load(job->path.c_str(), &job->width, &job->height, &job->channels, 0);
+            if (job->pixels && job->channels != 3 && job->channels != 4) {
+                // cinza (com ou sem alfa): o upload é sempre RGB ou RGBA
+                stbi_image_free(job->pixels);
+                job->pixels = stbi_load(job->path.c_str(), &job->width, &job->height, &job->channels, 4);
+                job->channels = 4;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            decoded.push_back(std::move(job));
+        }
+    }
+
+    void startWorkers() {
+        unsigned int cores = std::thread::hardware_concurrency();
+        // um núcleo fica para a thread do OpenGL
+        int count = (int)std::min(4u, std::max(1u, cores > 1 ? cores - 1 : 1u));
+        for (int i = 0; i < count; i++) {
+            workers.emplace_back(&AsyncTextureLoader::workerLoop, this);
+        }
+    }
+
+    void stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+
+    static void applyParams(const TextureParams &params) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params.wrapS);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params.wrapT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.magFilter);
+    }
+
+    // Xadrez cinza 2x2 enquanto a imagem não chega
+    static void uploadPlaceholder(const TextureParams &params) {
+        const unsigned char pixels[] = {
+            96, 96, 96, 255,    160, 160, 160, 255,
+            160, 160, 160, 255, 96, 96, 96, 255
+        };
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        if (params.mipmaps) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+    }
+
+    // Copia até "budget" bytes da imagem para o PBO; retorna os bytes copiados
+    size_t stage(Job &job, size_t budget) {
+        if (job.pbo == 0) {
+            job.size = (size_t)job.width * job.height * job.channels;
+            job.staged = 0;
+            glGenBuffers(1, &job.pbo);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job.pbo);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, job.size, NULL, GL_STREAM_DRAW);
+        } else {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, job.pbo);
+        }
+        size_t chunk = std::min(budget, job.size - job.staged);
+        // o trecho nunca foi lido pela GPU: não precisa esperar por ela
+        void *dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, job.staged, chunk,
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (dst) {
+            memcpy(dst, job.pixels + job.staged, chunk);
+            if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+                job.staged += chunk;
+            } else {
+                job.staged = 0; // conteúdo do buffer perdido: começa de novo
+            }
+        }
+        return chunk;
+    }
+
+    // Imagem inteira no PBO: troca a provisória pela imagem de verdade
+    void finishUpload(Job &job) {
+        GLint previous = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+        glBindTexture(GL_TEXTURE_2D, job.texID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        GLenum format = job.channels == 3 ? GL_RGB : GL_RGBA; // jpg, bmp : png
+        glTexImage2D(GL_TEXTURE_2D, 0, format, job.width, job.height, 0, format, GL_UNSIGNED_BYTE, (void *)0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        if (job.params.mipmaps) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+        glBindTexture(GL_TEXTURE_2D, previous);
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &job.pbo);
+        job.pbo = 0;
+        stbi_image_free(job.pixels);
+        job.pixels = nullptr;
+        bytesUploaded += job.size;
+    }
+
+public:
+    // bytesPerFrame: quanto cada update() copia para os PBOs
+    explicit AsyncTextureLoader(size_t bytesPerFrame = 4 << 20) {
+        this->stopping = false;
+        this->bytesPerFrame = std::max<size_t>(bytesPerFrame, 1);
+        this->requested = 0;
+        this->loaded = 0;
+        this->failed = 0;
+        this->pending = 0;
+        this->bytesUploaded = 0;
+        this->start = Clock::now();
+        this->firstFrameMs = -1.0;
+        this->allLoadedMs = -1.0;
+    }
+
+    AsyncTextureLoader(const AsyncTextureLoader &) = delete;
+    AsyncTextureLoader &operator=(const AsyncTextureLoader &) = delete;
+
+    ~AsyncTextureLoader() {
+        stopWorkers();
+        for (auto &job : queue) {
+            stbi_image_free(job->pixels);
+        }
+        for (auto &job : decoded) {
+            stbi_image_free(job->pixels);
+        }
+        for (auto &job : uploads) {
+            stbi_image_free(job->pixels);
+        }
+    }
+
+    // Cria a textura (provisória até o upload) e pede a decodificação; width e
+    // height já saem com o tamanho da imagem. Se o arquivo não puder ser lido,
+    // a textura fica com a imagem provisória
+    GLuint request(const std::string &filePath, int &width, int &height, const TextureParams &params = TextureParams()) {
+        GLuint texID;
+        glGenTextures(1, &texID);
+        glBindTexture(GL_TEXTURE_2D, texID);
+        applyParams(params);
+        uploadPlaceholder(params);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        int channels;
+        if (!stbi_info(filePath.c_str(), &width, &height, &channels)) {
+            width = height = 0;
+            std::cout << "Failed to load texture" << std::endl;
+            failed++;
+            return texID;
+        }
+
+        std::unique_ptr<Job> job(new Job());
+        job->texID = texID;
+        job->path = filePath;
+        job->params = params;
+        job->pixels = nullptr;
+        job->width = job->height = job->channels = 0;
+        job->pbo = 0;
+        job->size = job->staged = 0;
+
+        if (workers.empty()) {
+            startWorkers();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(job));
+        }
+        wake.notify_one();
+        loading.insert(texID);
+        requested++;
+        pending++;
+        return texID;
+    }
+
+    GLuint request(const std::string &filePath, const TextureParams &params = TextureParams()) {
+        int width, height;
+        return request(filePath, width, height, params);
+    }
+
+    // Uma vez por frame, na thread do OpenGL (logo depois do runner.beginFrame)
+    void update() {
+        if (firstFrameMs < 0.0) {
+            firstFrameMs = elapsedMs();
+        }
+        if (pending == 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto &job : decoded) {
+                uploads.push_back(std::move(job));
+            }
+            decoded.clear();
+        }
+
+        size_t budget = bytesPerFrame;
+        while (!uploads.empty() && budget > 0) {
+            Job &job = *uploads.front();
+            if (!job.pixels) {
+                std::cout << "Failed to load texture" << std::endl;
+                failed++;
+            } else {
+                budget -= stage(job, budget);
+                if (job.staged < job.size) {
+                    break; // continua no próximo frame
+                }
+                finishUpload(job);
+                loaded++;
+            }
+            loading.erase(job.texID);
+            uploads.pop_front();
+            pending--;
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (pending == 0) {
+            allLoadedMs = elapsedMs();
+        }
+    }
+
+    // Bloqueia até todas as texturas pedidas estarem na GPU (benchmarks que
+    // não devem medir a imagem provisória)
+    void waitAll() {
+        while (pending > 0) {
+            update();
+            std::this_thread::yield();
+        }
+    }
+
+    // Texturas pedidas que ainda estão com a imagem provisória
+    int pendingCount() const {
+        return pending;
+    }
+
+    // true enquanto o upload de texID não terminou: a textura não pode ser
+    // apagada, porque o update ainda vai escrever nela
+    bool isLoading(GLuint texID) const {
+        return loading.count(texID) != 0;
+    }
+
+    // Milissegundos desde a criação do loader; -1 se ainda não aconteceu
+    double getFirstFrameMs() const {
+        return firstFrameMs;
+    }
+
+    double getAllLoadedMs() const {
+        return pending == 0 && allLoadedMs < 0.0 ? firstFrameMs : allLoadedMs;
+    }
+
+    void printReport() const {
+        std::cout << "texturas: " << loaded << " carregadas, " << failed << " falharam, "
+                  << bytesUploaded / 1024 << " KB enviados; primeiro frame em " << getFirstFrameMs() << " ms, ";
+        if (pending > 0) {
+            std::cout << pending << " ainda carregando" << std::endl;
+        } else {
+            std::cout << "todas em " << getAllLoadedMs() << " ms" << std::endl;
+        }
+    }
+
+    // Para as threads e apaga os PBOs que sobraram; chamar antes do glfwTerminate
+    void release() {
+        stopWorkers();
+        for (auto &job : uploads) {
+            if (job->pbo) {
+                glDeleteBuffers(1, &job->pbo);
+                job->pbo = 0;
+            }
+        }
+    }
+};
+
+#endif /* AsyncTextureLoader_h */
@@ -0,0 +1,396 @@
+//
+//  BakedTextures.h
+//  Leitura do pacote de texturas pré-decodificadas gerado pelo TextureBaker
+//  (src/Tools/TextureBaker.cpp)
+//
+//  O arquivo inteiro é mapeado na memória (mmap / MapViewOfFile) e os níveis de
+//  mipmap vão para o glTexImage2D direto das páginas mapeadas: não há
+//  decodificação de PNG nem cópia intermediária no heap. O sistema operacional
+//  só lê do disco as páginas que o driver realmente toca.
+//
+//  As texturas são identificadas pelo caminho relativo a assets/, como no
+//  TextureAtlas.h (ex.: "sprites/coruja.png").
+//
+//  Cada textura pode ter, além do RGBA8, variantes comprimidas em blocos (BC1,
+//  BC3, BC7, ETC2). O loadTexture escolhe a menor variante que o driver aceita
+//  (em caso de empate, a de maior PSNR) e envia com glCompressedTexImage2D;
+//  sem nenhuma extensão de compressão, ou com setCompression(false), usa o
+//  RGBA8. O ETC2 só entra sem S3TC/BPTC: nas placas de desktop o driver
+//  costuma descomprimir ETC2 na CPU e guardar RGBA8 na memória de vídeo.
+//
+//  Exemplo:
+//    BakedTexturePack pack;
+//    if (pack.open("baked/textures.pak")) {
+//        int width, height;
+//        GLuint tex = pack.loadTexture("sprites/coruja.png", width, height);
+//    }
+//    pack.close();
+//
+
+#ifndef BakedTextures_h
+#define BakedTextures_h
+
+#include <glad/glad.h>
+
+#include "AsyncTextureLoader.h"   // TextureParams
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+// Mesmos valores do TextureBaker
+enum BakedFormat {
+    BAKED_RGBA8 = 0,
+    BAKED_BC1 = 1,          // opaco
+    BAKED_BC1_ALPHA = 2,    // alfa de 1 bit
+    BAKED_BC3 = 3,
+    BAKED_BC7 = 4,
+    BAKED_ETC2_RGB = 5,
+    BAKED_ETC2_RGBA = 6,
+    BAKED_FORMAT_COUNT
+};
+
+struct BakedLevel {
+    int width, height;
+    const unsigned char *data;   // dentro do arquivo mapeado
+    size_t bytes;
+};
+
+struct BakedVariant {
+    int format;                  // BakedFormat
+    float psnr;                  // dB do nível 0 contra o PNG; infinito no RGBA8
+    std::vector<BakedLevel> levels;
+};
+
+struct BakedTexture {
+    int width, height;
+    bool premultiplied;
+    std::vector<BakedVariant> variants;   // [0] = RGBA8
+
+    const BakedVariant *variant(int format) const {
+        for (const BakedVariant &v : variants) {
+            if (v.format == format) {
+                return &v;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class BakedTexturePack {
+    MappedFile mapped;
+    const unsigned char *base;
+    size_t fileSize;
+    std::unordered_map<std::string, BakedTexture> textures;
+    bool compression;
+    int forcedFormat;            // -1: escolha automática
+
+    // Bytes por bloco 4x4 (0 no RGBA8)
+    static size_t blockBytes(int format) {
+        switch (format) {
+        case BAKED_BC1:
+        case BAKED_BC1_ALPHA:
+        case BAKED_ETC2_RGB:
+            return 8;
+        case BAKED_BC3:
+        case BAKED_BC7:
+        case BAKED_ETC2_RGBA:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    static GLenum internalFormat(int format) {
+        switch (format) {
+        case BAKED_BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case BAKED_BC1_ALPHA: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case BAKED_BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case BAKED_BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case BAKED_ETC2_RGB: return GL_COMPRESSED_RGB8_ETC2;
+        case BAKED_ETC2_RGBA: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+        default: return GL_RGBA8;
+        }
+    }
+
+    // Leitura do diretório direto da memória mapeada, sempre conferindo o tamanho
+    struct Reader {
+        const unsigned char *p, *end;
+
+        bool has(size_t n) const {
+            return (size_t)(end - p) >= n;
+        }
+
+        bool u8(int &value) {
+            if (!has(1)) return false;
+            value = p[0];
+            p += 1;
+            return true;
+        }
+
+        bool u16(int &value) {
+            if (!has(2)) return false;
+            value = p[0] | (p[1] << 8);
+            p += 2;
+            return true;
+        }
+
+        bool u32(uint32_t &value) {
+            if (!has(4)) return false;
+            value = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+            p += 4;
+            return true;
+        }
+
+        bool u64(uint64_t &value) {
+            uint32_t lo, hi;
+            if (!u32(lo) || !u32(hi)) return false;
+            value = lo | ((uint64_t)hi << 32);
+            return true;
+        }
+
+        bool name(std::string &value) {
+            int len;
+            if (!u8(len) || !has(len)) return false;
+            value.assign((const char *)p, len);
+            p += len;
+            return true;
+        }
+    };
+
+public:
+    BakedTexturePack() {
+        this->base = nullptr;
+        this->fileSize = 0;
+        this->compression = true;
+        this->forcedFormat = -1;
+    }
+
+    BakedTexturePack(const BakedTexturePack &) = delete;
+    BakedTexturePack &operator=(const BakedTexturePack &) = delete;
+
+    ~BakedTexturePack() {
+        close();
+    }
+
+    // Mapeia o pacote e lê o diretório. Retorna false se o arquivo não existe
+    // ou é inválido (o chamador volta para os PNGs)
+    bool open(const std::string &filePath) {
+        close();
+        if (!mapped.open(filePath)) {
+            return false;
+        }
+        base = mapped.data();
+        fileSize = mapped.size();
+
+        Reader in = { base, base + fileSize };
+        uint32_t version, count, dataStart;
+        if (!in.has(4) || memcmp(in.p, "TXPK", 4) != 0) {
+            std::cout << "Invalid texture pack " << filePath << std::endl;
+            close();
+            return false;
+        }
+        in.p += 4;
+        if (!in.u32(version) || version != 2 || !in.u32(count) || !in.u32(dataStart)) {
+            std::cout << "Invalid texture pack " << filePath << std::endl;
+            close();
+            return false;
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            std::string name;
+            BakedTexture tex;
+            int flags, variants;
+            if (!in.name(name) || !in.u16(tex.width) || !in.u16(tex.height) || !in.u8(flags) || !in.u8(variants)) {
+                std::cout << "Invalid texture pack " << filePath << std::endl;
+                close();
+                return false;
+            }
+            tex.premultiplied = (flags & 1) != 0;
+            for (int v = 0; v < variants; v++) {
+                BakedVariant variant;
+                int psnr, levels;
+                if (!in.u8(variant.format) || !in.u16(psnr) || !in.u8(levels)) {
+                    std::cout << "Invalid texture pack " << filePath << std::endl;
+                    close();
+                    return false;
+                }
+                variant.psnr = psnr == 0xFFFF ? INFINITY : psnr / 100.0f;
+                bool known = variant.format < BAKED_FORMAT_COUNT;
+                for (int l = 0; l < levels; l++) {
+                    uint64_t offset;
+                    uint32_t bytes;
+                    if (!in.u64(offset) || !in.u32(bytes) || offset > fileSize || bytes > fileSize - offset) {
+                        std::cout << "Invalid texture pack " << filePath << std::endl;
+                        close();
+                        return false;
+                    }
+                    BakedLevel level;
+                    level.width = std::max(1, tex.width >> l);
+                    level.height = std::max(1, tex.height >> l);
+                    level.data = base + offset;
+                    level.bytes = bytes;
+                    size_t expected = variant.format == BAKED_RGBA8
+                                          ? (size_t)level.width * level.height * 4
+                                          : (size_t)((level.width + 3) / 4) * ((level.height + 3) / 4) * blockBytes(variant.format);
+                    if (known && bytes != expected) {
+                        std::cout << "Invalid texture pack " << filePath << std::endl;
+                        close();
+                        return false;
+                    }
+                    variant.levels.push_back(level);
+                }
+                if (known && !variant.levels.empty()) {
+                    tex.variants.push_back(variant); // formatos de versões futuras são ignorados
+                }
+            }
+            textures[name] = tex;
+        }
+        return true;
+    }
+
+    void close() {
+        textures.clear();
+        mapped.close();
+        base = nullptr;
+        fileSize = 0;
+    }
+
+    bool isOpen() const {
+        return base != nullptr;
+    }
+
+    const BakedTexture *find(const std::string &name) const {
+        auto it = textures.find(name);
+        return it == textures.end() ? nullptr : &it->second;
+    }
+
+    // O driver aceita o formato? (precisa de um contexto ativo)
+    static bool isFormatSupported(int format) {
+        bool gl42 = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 2);
+        bool gl43 = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 3);
+        switch (format) {
+        case BAKED_RGBA8:
+            return true;
+        case BAKED_BC1:
+        case BAKED_BC1_ALPHA:
+        case BAKED_BC3:
+            return GLAD_GL_EXT_texture_compression_s3tc != 0;
+        case BAKED_BC7:
+            return gl42 || GLAD_GL_ARB_texture_compression_bptc;
+        case BAKED_ETC2_RGB:
+        case BAKED_ETC2_RGBA:
+            return gl43 || GLAD_GL_ARB_ES3_compatibility;
+        default:
+            return false;
+        }
+    }
+
+    // Com false todas as texturas vão em RGBA8
+    void setCompression(bool enabled) {
+        compression = enabled;
+    }
+
+    // Força um formato (para medir); sem essa variante cai no RGBA8. -1 volta
+    // para a escolha automática
+    void forceFormat(int format) {
+        forcedFormat = format;
+    }
+
+    // A variante que o loadTexture vai usar
+    const BakedVariant *chooseVariant(const BakedTexture &tex) const {
+        const BakedVariant *rgba = tex.variant(BAKED_RGBA8);
+        if (forcedFormat >= 0) {
+            const BakedVariant *forced = tex.variant(forcedFormat);
+            return forced && isFormatSupported(forcedFormat) ? forced : rgba;
+        }
+        if (!compression) {
+            return rgba;
+        }
+        const BakedVariant *best = nullptr;
+        for (int etc = 0; etc < 2 && !best; etc++) {
+            for (const BakedVariant &v : tex.variants) {
+                bool isEtc = v.format == BAKED_ETC2_RGB || v.format == BAKED_ETC2_RGBA;
+                if (v.format == BAKED_RGBA8 || isEtc != (etc == 1) || !isFormatSupported(v.format)) {
+                    continue;
+                }
+                if (!best || v.levels[0].bytes < best->levels[0].bytes ||
+                    (v.levels[0].bytes == best->levels[0].bytes && v.psnr > best->psnr)) {
+                    best = &v;
+                }
+            }
+        }
+        return best ? best : rgba;
+    }
+
+    // Cria a textura a partir do pacote (0 se o nome não está nele). Com
+    // params.mipmaps os níveis pré-calculados substituem o glGenerateMipmap
+    GLuint loadTexture(const std::string &name, int &width, int &height, const TextureParams &params = TextureParams()) {
+        const BakedTexture *tex = find(name);
+        const BakedVariant *variant = tex ? chooseVariant(*tex) : nullptr;
+        if (!variant) {
+            return 0;
+        }
+        GLuint texID;
+        glGenTextures(1, &texID);
+        glBindTexture(GL_TEXTURE_2D, texID);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params.wrapS);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params.wrapT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.magFilter);
+
+        int levels = params.mipmaps ? (int)variant->levels.size() : 1;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+        for (int l = 0; l < levels; l++) {
+            const BakedLevel &level = variant->levels[l];
+            if (variant->format == BAKED_RGBA8) {
+                glTexImage2D(GL_TEXTURE_2D, l, GL_RGBA8, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                             level.data);
+            } else {
+                glCompressedTexImage2D(GL_TEXTURE_2D, l, internalFormat(variant->format), level.width, level.height, 0,
+                                       (GLsizei)level.bytes, level.data);
+            }
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        width = tex->width;
+        height = tex->height;
+        return texID;
+    }
+
+    // Bytes que os níveis da variante escolhida ocupam na GPU (para o
+    // orçamento do TextureManager)
+    size_t residentBytes(const BakedTexture &tex, bool mipmaps) const {
+        const BakedVariant *variant = chooseVariant(tex);
+        size_t bytes = 0;
+        for (size_t l = 0; variant && l < (mipmaps ? variant->levels.size() : 1); l++) {
+            bytes += variant->levels[l].bytes;
+        }
+        return bytes;
+    }
+
+    static const char *formatName(int format) {
+        static const char *names[] = { "rgba8", "bc1", "bc1a", "bc3", "bc7", "etc2_rgb", "etc2_rgba" };
+        return format >= 0 && format < BAKED_FORMAT_COUNT ? names[format] : "?";
+    }
+
+    int getTextureCount() const {
+        return (int)textures.size();
+    }
+
+    std::vector<std::string> getNames() const {
+        std::vector<std::string> names;
+        for (const auto &item : textures) {
+            names.push_back(item.first);
+        }
+        return names;
+    }
+};
+
+#endif /* BakedTextures_h */
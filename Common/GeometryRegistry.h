@@ -0,0 +1,218 @@
+//
+//  GeometryRegistry.h
+//  Cache de geometria compartilhada (VAO + VBO) com contagem de referências
+//
+//  Os demos criavam um VAO/VBO novo para cada objeto, mesmo quando os vértices
+//  eram idênticos (o mesmo quad para todos os sprites, o mesmo triângulo em
+//  todos os cliques), e nunca apagavam nenhum. Aqui a geometria é identificada
+//  pelo layout de vértice + hash do conteúdo: pedir os mesmos vértices de novo
+//  devolve o mesmo VAO e só incrementa a contagem de referências.
+//
+//  release(VAO) devolve uma referência; com zero referências os objetos são
+//  apagados. releaseAll() apaga tudo o que sobrou, na ordem de criação, e deve
+//  ser chamado antes do glfwTerminate (enquanto o contexto existe).
+//
+//  Exemplo:
+//    GeometryRegistry geometry;
+//    GLuint VAO = geometry.acquire(VertexLayout().add(0, 3).add(1, 2), vertices, sizeof(vertices)).VAO;
+//
+
+#ifndef GeometryRegistry_h
+#define GeometryRegistry_h
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+
+// Um atributo de vértice (sempre GL_FLOAT, como em todos os demos)
+struct VertexAttrib {
+    GLuint location;
+    GLint size;        // quantidade de floats
+    GLsizei offset;    // em bytes, a partir do início do vértice
+};
+
+// Atributos intercalados num único VBO; add() acumula offset e stride
+class VertexLayout {
+    std::vector<VertexAttrib> attribs;
+    GLsizei stride;
+
+public:
+    VertexLayout() {
+        this->stride = 0;
+    }
+
+    VertexLayout &add(GLuint location, GLint floats) {
+        attribs.push_back({ location, floats, stride });
+        stride += floats * (GLsizei)sizeof(GLfloat);
+        return *this;
+    }
+
+    const std::vector<VertexAttrib> &getAttribs() const {
+        return attribs;
+    }
+
+    GLsizei getStride() const {
+        return stride;
+    }
+
+    // Descrição textual do layout (parte da chave do cache), ex.: "0:3@0;1:2@12;/20"
+    std::string signature() const {
+        std::string s;
+        for (const VertexAttrib &a : attribs) {
+            s += std::to_string(a.location) + ":" + std::to_string(a.size) + "@" + std::to_string(a.offset) + ";";
+        }
+        return s + "/" + std::to_string(stride);
+    }
+};
+
+// Handles devolvidos pelo registro (não apagar diretamente: usar release)
+struct Geometry {
+    GLuint VAO;
+    GLuint VBO;
+    GLsizei vertexCount;
+};
+
+class GeometryRegistry {
+    struct Entry {
+        Geometry geometry;
+        int refCount;
+        uint64_t hash;
+        std::string layout;
+        std::vector<unsigned char> data;   // cópia dos vértices para confirmar colisões de hash
+    };
+
+    std::vector<Entry> entries;                     // ordem de criação
+    std::unordered_multimap<uint64_t, size_t> byHash;
+    std::unordered_map<GLuint, size_t> byVAO;
+    int created, reused;
+
+    // FNV-1a 64 bits
+    static uint64_t hashBytes(const void *data, size_t bytes, uint64_t h = 14695981039346656037ull) {
+        const unsigned char *p = (const unsigned char *)data;
+        for (size_t i = 0; i < bytes; i++) {
+            h ^= p[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    void destroy(Entry &e) {
+        glDeleteVertexArrays(1, &e.geometry.VAO);
+        glDeleteBuffers(1, &e.geometry.VBO);
+        e.geometry.VAO = e.geometry.VBO = 0;
+        e.refCount = 0;
+        e.data.clear();
+        e.data.shrink_to_fit();
+    }
+
+public:
+    GeometryRegistry() {
+        this->created = 0;
+        this->reused = 0;
+    }
+
+    GeometryRegistry(const GeometryRegistry &) = delete;
+    GeometryRegistry &operator=(const GeometryRegistry &) = delete;
+
+    // Devolve a geometria com esse layout e esses vértices, criando VAO/VBO só
+    // na primeira vez
+    Geometry acquire(const VertexLayout &layout, const void *vertices, size_t bytes) {
+        std::string signature = layout.signature();
+        uint64_t hash = hashBytes(vertices, bytes, hashBytes(signature.data(), signature.size()));
+
+        auto range = byHash.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            Entry &e = entries[it->second];
+            if (e.layout == signature && e.data.size() == bytes && memcmp(e.data.data(), vertices, bytes) == 0) {
+                e.refCount++;
+                reused++;
+                return e.geometry;
+            }
+        }
+
+        Entry e;
+        e.refCount = 1;
+        e.hash = hash;
+        e.layout = signature;
+        e.data.assign((const unsigned char *)vertices, (const unsigned char *)vertices + bytes);
+        e.geometry.vertexCount = layout.getStride() > 0 ? (GLsizei)(bytes / layout.getStride()) : 0;
+
+        glGenBuffers(1, &e.geometry.VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, e.geometry.VBO);
+        glBufferData(GL_ARRAY_BUFFER, bytes, vertices, GL_STATIC_DRAW);
+
+        glGenVertexArrays(1, &e.geometry.VAO);
+        glBindVertexArray(e.geometry.VAO);
+        for (const VertexAttrib &a : layout.getAttribs()) {
+            glVertexAttribPointer(a.location, a.size, GL_FLOAT, GL_FALSE, layout.getStride(), (GLvoid *)(size_t)a.offset);
+            glEnableVertexAttribArray(a.location);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+
+        size_t index = entries.size();
+        entries.push_back(e);
+        byHash.insert({ hash, index });
+        byVAO[e.geometry.VAO] = index;
+        created++;
+        return e.geometry;
+    }
+
+    // Devolve uma referência; a última apaga o VAO e o VBO
+    void release(GLuint VAO) {
+        auto it = byVAO.find(VAO);
+        if (it == byVAO.end()) {
+            return;
+        }
+        size_t index = it->second;
+        Entry &e = entries[index];
+        if (--e.refCount > 0) {
+            return;
+        }
+        auto range = byHash.equal_range(e.hash);
+        for (auto h = range.first; h != range.second; ++h) {
+            if (h->second == index) {
+                byHash.erase(h);
+                break;
+            }
+        }
+        byVAO.erase(it);
+        destroy(e);
+    }
+
+    // Apaga toda a geometria que ainda existe, independente das referências.
+    // Retorna quantas geometrias ainda estavam em uso
+    int releaseAll() {
+        int live = 0;
+        for (Entry &e : entries) {
+            if (e.geometry.VAO != 0) {
+                destroy(e);
+                live++;
+            }
+        }
+        entries.clear();
+        byHash.clear();
+        byVAO.clear();
+        return live;
+    }
+
+    // Geometrias distintas existentes agora na GPU
+    int getLiveCount() const {
+        return (int)byVAO.size();
+    }
+
+    // Quantos VAOs foram criados e quantos pedidos reaproveitaram um existente
+    int getCreatedCount() const {
+        return created;
+    }
+
+    int getReusedCount() const {
+        return reused;
+    }
+};
+
+#endif /* GeometryRegistry_h */
@@ -0,0 +1,421 @@
+//
+//  HeadlessRunner.h
+//  Modo de benchmark sem janela visível (--headless --frames N [--out arquivo.json])
+//
+//  Sem --headless nada muda: createWindow é o glfwCreateWindow de sempre e os
+//  outros métodos não fazem nada. Com --headless:
+//    - a janela é criada escondida; se não há display (servidor de build sem
+//      GPU), a GLFW é reiniciada na plataforma "null" com contexto OSMesa
+//      (llvmpipe), que não precisa de X11/Wayland;
+//    - o demo roda exatamente N frames, sem vsync, e recebe a entrada
+//      programada com addKey/addClick/addDrag pelos próprios callbacks;
+//    - cada frame mede o tempo de CPU (beginFrame..endFrame), o tempo de GPU
+//      (query GL_TIME_ELAPSED) e as chamadas de desenho;
+//    - no fim, finish grava um JSON com os valores por frame e um resumo, mais
+//      as métricas avulsas do demo (setMetric), como o tempo de carregamento.
+//
+//  As chamadas de desenho são contadas trocando os ponteiros da GLAD
+//  (glad_glDrawArrays etc.) por funções que contam e repassam a chamada, então
+//  os demos não precisam ser alterados nos pontos de desenho.
+//
+//  Uso no demo:
+//    HeadlessRunner runner(argc, argv);
+//    GLFWwindow *window = runner.createWindow(WIDTH, HEIGHT, "Titulo");
+//    ... gladLoadGLLoader ...
+//    runner.attach(window);
+//    while (!glfwWindowShouldClose(window)) {
+//        glfwPollEvents();
+//        runner.beginFrame();
+//        ... desenho ...
+//        runner.endFrame();
+//        glfwSwapBuffers(window);
+//    }
+//    runner.finish();   // antes do glfwTerminate
+//
+
+#ifndef HeadlessRunner_h
+#define HeadlessRunner_h
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+class HeadlessRunner {
+    // Só move o cursor (callback de posição), sem apertar nada
+    static const int CURSOR_MOVE = -1;
+
+    struct ScriptedEvent {
+        int frame;
+        bool mouse;          // false: tecla, true: botão do mouse
+        int code;            // GLFW_KEY_* ou GLFW_MOUSE_BUTTON_*
+        int action;          // GLFW_PRESS, GLFW_REPEAT, GLFW_RELEASE ou CURSOR_MOVE
+        double x, y;         // posição do cursor (só mouse)
+    };
+
+    struct FrameStats {
+        double cpuMs;
+        double gpuMs;
+        int drawCalls;
+    };
+
+    bool enabled;
+    int frameCount;
+    int currentFrame;
+    std::string outPath;
+    std::string targetName;
+
+    GLFWwindow *window;
+    std::vector<ScriptedEvent> script;
+    std::vector<GLuint> queries;   // uma query GL_TIME_ELAPSED por frame
+    std::vector<FrameStats> stats;
+    std::vector<std::pair<std::string, double>> metrics;
+    double frameStart;
+    int status;
+
+    // Ponteiros originais da GLAD e contador compartilhado pelos wrappers
+    static inline int drawCalls = 0;
+    static inline PFNGLDRAWARRAYSPROC realDrawArrays = nullptr;
+    static inline PFNGLDRAWELEMENTSPROC realDrawElements = nullptr;
+    static inline PFNGLDRAWARRAYSINSTANCEDPROC realDrawArraysInstanced = nullptr;
+    static inline PFNGLDRAWELEMENTSINSTANCEDPROC realDrawElementsInstanced = nullptr;
+    static inline PFNGLMULTIDRAWARRAYSPROC realMultiDrawArrays = nullptr;
+    static inline PFNGLMULTIDRAWELEMENTSPROC realMultiDrawElements = nullptr;
+
+    static void APIENTRY countDrawArrays(GLenum mode, GLint first, GLsizei count) {
+        drawCalls++;
+        realDrawArrays(mode, first, count);
+    }
+
+    static void APIENTRY countDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) {
+        drawCalls++;
+        realDrawElements(mode, count, type, indices);
+    }
+
+    static void APIENTRY countDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) {
+        drawCalls++;
+        realDrawArraysInstanced(mode, first, count, instancecount);
+    }
+
+    static void APIENTRY countDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices,
+                                                    GLsizei instancecount) {
+        drawCalls++;
+        realDrawElementsInstanced(mode, count, type, indices, instancecount);
+    }
+
+    static void APIENTRY countMultiDrawArrays(GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawcount) {
+        drawCalls += drawcount;
+        realMultiDrawArrays(mode, first, count, drawcount);
+    }
+
+    static void APIENTRY countMultiDrawElements(GLenum mode, const GLsizei *count, GLenum type, const void *const *indices,
+                                                GLsizei drawcount) {
+        drawCalls += drawcount;
+        realMultiDrawElements(mode, count, type, indices, drawcount);
+    }
+
+    static void hookDrawCalls() {
+        if (realDrawArrays) {
+            return;
+        }
+        realDrawArrays = glad_glDrawArrays;
+        realDrawElements = glad_glDrawElements;
+        realDrawArraysInstanced = glad_glDrawArraysInstanced;
+        realDrawElementsInstanced = glad_glDrawElementsInstanced;
+        realMultiDrawArrays = glad_glMultiDrawArrays;
+        realMultiDrawElements = glad_glMultiDrawElements;
+        glad_glDrawArrays = countDrawArrays;
+        glad_glDrawElements = countDrawElements;
+        glad_glDrawArraysInstanced = countDrawArraysInstanced;
+        glad_glDrawElementsInstanced = countDrawElementsInstanced;
+        glad_glMultiDrawArrays = countMultiDrawArrays;
+        glad_glMultiDrawElements = countMultiDrawElements;
+    }
+
+    // Entrega os eventos programados deste frame pelos callbacks do demo
+    void dispatchScript() {
+        for (const ScriptedEvent &e : script) {
+            if (e.frame != currentFrame) {
+                continue;
+            }
+            if (e.mouse && e.action == CURSOR_MOVE) {
+                GLFWcursorposfun callback = glfwSetCursorPosCallback(window, NULL);
+                glfwSetCursorPosCallback(window, callback);
+                glfwSetCursorPos(window, e.x, e.y);
+                if (callback) {
+                    callback(window, e.x, e.y);
+                }
+            } else if (e.mouse) {
+                // glfwSetCallback devolve o callback atual; recoloca o mesmo
+                GLFWmousebuttonfun callback = glfwSetMouseButtonCallback(window, NULL);
+                glfwSetMouseButtonCallback(window, callback);
+                // o demo lê a posição com glfwGetCursorPos dentro do callback
+                glfwSetCursorPos(window, e.x, e.y);
+                if (callback) {
+                    callback(window, e.code, e.action, 0);
+                }
+            } else {
+                GLFWkeyfun callback = glfwSetKeyCallback(window, NULL);
+                glfwSetKeyCallback(window, callback);
+                if (callback) {
+                    callback(window, e.code, glfwGetKeyScancode(e.code), e.action, 0);
+                }
+            }
+        }
+    }
+
+    static double percentile(std::vector<double> values, double p) {
+        if (values.empty()) {
+            return 0.0;
+        }
+        std::sort(values.begin(), values.end());
+        size_t index = (size_t)(p * (values.size() - 1) + 0.5);
+        return values[index];
+    }
+
+    void writeSummary(std::ostream &out, const char *name, const std::vector<double> &values) {
+        double sum = 0.0;
+        for (double v : values) {
+            sum += v;
+        }
+        out << "    \"" << name << "\": { \"avg\": " << (values.empty() ? 0.0 : sum / values.size())
+            << ", \"p50\": " << percentile(values, 0.50)
+            << ", \"p95\": " << percentile(values, 0.95)
+            << ", \"max\": " << percentile(values, 1.0) << " }";
+    }
+
+public:
+    HeadlessRunner(int argc, char **argv) {
+        this->enabled = false;
+        this->frameCount = 300;
+        this->currentFrame = 0;
+        this->window = nullptr;
+        this->frameStart = 0.0;
+        this->status = 0;
+
+        targetName = argc > 0 ? argv[0] : "demo";
+        size_t slash = targetName.find_last_of("/\\");
+        if (slash != std::string::npos) {
+            targetName = targetName.substr(slash + 1);
+        }
+        size_t dot = targetName.rfind(".exe");
+        if (dot != std::string::npos) {
+            targetName = targetName.substr(0, dot);
+        }
+
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--headless") == 0) {
+                enabled = true;
+            } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+                frameCount = std::max(1, atoi(argv[++i]));
+            } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+                outPath = argv[++i];
+            }
+        }
+        if (outPath.empty()) {
+            outPath = "bench_" + targetName + ".json";
+        }
+    }
+
+    HeadlessRunner(const HeadlessRunner &) = delete;
+    HeadlessRunner &operator=(const HeadlessRunner &) = delete;
+
+    bool isEnabled() const {
+        return enabled;
+    }
+
+    // Substitui o glfwCreateWindow do demo (glfwInit e os hints já feitos)
+    GLFWwindow *createWindow(int width, int height, const char *title) {
+        if (!enabled) {
+            return glfwCreateWindow(width, height, title, nullptr, nullptr);
+        }
+
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        GLFWwindow *w = glfwCreateWindow(width, height, title, nullptr, nullptr);
+        if (w) {
+            return w;
+        }
+
+        // Sem display: plataforma "null" da GLFW 3.4 com contexto OSMesa. O
+        // glfwInit zera os hints, então o contexto 4.1 core é pedido de novo aqui
+        std::cerr << "headless: sem display, usando GLFW_PLATFORM_NULL + OSMesa" << std::endl;
+        glfwTerminate();
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        if (!glfwInit()) {
+            status = 1;
+            return nullptr;
+        }
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        w = glfwCreateWindow(width, height, title, nullptr, nullptr);
+        if (!w) {
+            status = 1;
+        }
+        return w;
+    }
+
+    // Entrada programada. addKey: PRESS no frame indicado, REPEAT nos
+    // holdFrames seguintes e RELEASE depois
+    void addKey(int frame, int key, int holdFrames = 0) {
+        script.push_back({ frame, false, key, GLFW_PRESS, 0.0, 0.0 });
+        for (int i = 1; i <= holdFrames; i++) {
+            script.push_back({ frame + i, false, key, GLFW_REPEAT, 0.0, 0.0 });
+        }
+        script.push_back({ frame + holdFrames + 1, false, key, GLFW_RELEASE, 0.0, 0.0 });
+    }
+
+    // Clique em (x, y), coordenadas da janela como as do glfwGetCursorPos
+    void addClick(int frame, double x, double y, int button = GLFW_MOUSE_BUTTON_LEFT) {
+        script.push_back({ frame, true, button, GLFW_PRESS, x, y });
+        script.push_back({ frame + 1, true, button, GLFW_RELEASE, x, y });
+    }
+
+    // Arrasta com o botão esquerdo de (x0, y0) até (x1, y1): PRESS no frame
+    // indicado, um movimento do cursor por frame durante "frames" frames e
+    // RELEASE no destino
+    void addDrag(int frame, double x0, double y0, double x1, double y1, int frames) {
+        script.push_back({ frame, true, GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS, x0, y0 });
+        for (int i = 1; i <= frames; i++) {
+            double t = (double)i / frames;
+            script.push_back({ frame + i, true, GLFW_MOUSE_BUTTON_LEFT, CURSOR_MOVE,
+                               x0 + (x1 - x0) * t, y0 + (y1 - y0) * t });
+        }
+        script.push_back({ frame + frames + 1, true, GLFW_MOUSE_BUTTON_LEFT, GLFW_RELEASE, x1, y1 });
+    }
+
+    // Valor avulso gravado em "metrics" no JSON; chamar antes do finish
+    void setMetric(const std::string &name, double value) {
+        for (auto &metric : metrics) {
+            if (metric.first == name) {
+                metric.second = value;
+                return;
+            }
+        }
+        metrics.push_back({ name, value });
+    }
+
+    // Chamar depois do gladLoadGLLoader, com o contexto atual
+    void attach(GLFWwindow *window) {
+        this->window = window;
+        if (!enabled) {
+            return;
+        }
+        glfwSwapInterval(0);
+        hookDrawCalls();
+        queries.resize(frameCount);
+        glGenQueries(frameCount, queries.data());
+        stats.reserve(frameCount);
+
+        const GLubyte *renderer = glGetString(GL_RENDERER);
+        std::cerr << "headless: " << targetName << ", " << frameCount << " frames em "
+                  << (renderer ? (const char *)renderer : "?") << std::endl;
+    }
+
+    // Logo depois do glfwPollEvents
+    void beginFrame() {
+        if (!enabled) {
+            return;
+        }
+        dispatchScript();
+        drawCalls = 0;
+        frameStart = glfwGetTime();
+        glBeginQuery(GL_TIME_ELAPSED, queries[currentFrame]);
+    }
+
+    // Logo antes do glfwSwapBuffers; fecha a janela depois do último frame
+    void endFrame() {
+        if (!enabled) {
+            return;
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+        FrameStats frame;
+        frame.cpuMs = (glfwGetTime() - frameStart) * 1000.0;
+        frame.gpuMs = 0.0;
+        frame.drawCalls = drawCalls;
+        stats.push_back(frame);
+
+        currentFrame++;
+        if (currentFrame >= frameCount) {
+            glfwSetWindowShouldClose(window, GL_TRUE);
+        }
+    }
+
+    // Lê as queries e grava o JSON; chamar antes do glfwTerminate
+    void finish() {
+        if (!enabled || queries.empty()) {
+            return;
+        }
+        // os resultados ficaram na GPU até aqui para não sincronizar a cada frame
+        for (size_t i = 0; i < stats.size(); i++) {
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &ns);
+            stats[i].gpuMs = ns / 1.0e6;
+        }
+        glDeleteQueries((GLsizei)queries.size(), queries.data());
+        queries.clear();
+
+        std::ofstream out(outPath);
+        if (!out) {
+            std::cerr << "headless: falha ao gravar " << outPath << std::endl;
+            status = 1;
+            return;
+        }
+
+        std::vector<double> cpu, gpu, draws;
+        for (const FrameStats &f : stats) {
+            cpu.push_back(f.cpuMs);
+            gpu.push_back(f.gpuMs);
+            draws.push_back(f.drawCalls);
+        }
+
+        const GLubyte *renderer = glGetString(GL_RENDERER);
+        std::string rendererName = renderer ? (const char *)renderer : "";
+        std::replace(rendererName.begin(), rendererName.end(), '"', '\'');
+
+        out << "{\n";
+        out << "  \"target\": \"" << targetName << "\",\n";
+        out << "  \"renderer\": \"" << rendererName << "\",\n";
+        out << "  \"frames\": " << stats.size() << ",\n";
+        out << "  \"summary\": {\n";
+        writeSummary(out, "cpu_ms", cpu);
+        out << ",\n";
+        writeSummary(out, "gpu_ms", gpu);
+        out << ",\n";
+        writeSummary(out, "draw_calls", draws);
+        out << "\n  },\n";
+        out << "  \"metrics\": {";
+        for (size_t i = 0; i < metrics.size(); i++) {
+            out << (i ? ",\n" : "\n") << "    \"" << metrics[i].first << "\": " << metrics[i].second;
+        }
+        out << (metrics.empty() ? "},\n" : "\n  },\n");
+        out << "  \"per_frame\": [\n";
+        for (size_t i = 0; i < stats.size(); i++) {
+            out << "    { \"cpu_ms\": " << stats[i].cpuMs << ", \"gpu_ms\": " << stats[i].gpuMs
+                << ", \"draw_calls\": " << stats[i].drawCalls << " }" << (i + 1 < stats.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+
+        std::cerr << "headless: " << stats.size() << " frames, relatorio em " << outPath << std::endl;
+        if ((int)stats.size() < frameCount) {
+            status = 1; // a janela fechou antes (ESC programado, erro no demo)
+        }
+    }
+
+    // Código de saída do demo: 0, ou 1 se o modo headless falhou
+    int exitStatus() const {
+        return status;
+    }
+};
+
+#endif /* HeadlessRunner_h */
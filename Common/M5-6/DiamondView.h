@@ -0,0 +1,79 @@
+//
+//  DiamondView.h
+//  Visão isométrica em losango (diamond)
+//
+//  Mesma disposição usada na atividade 14/06: cada tile é um losango 2:1 cujo
+//  retângulo envolvente começa em (targetx, targety). Aumentar a coluna anda
+//  meio tile para a direita e para cima; aumentar a linha anda meio tile para a
+//  esquerda e para cima (projeção com y crescendo para cima).
+//
+
+#ifndef DiamondView_h
+#define DiamondView_h
+
+#include "TilemapView.h"
+#include <cmath>
+
+class DiamondView : public TilemapView {
+public:
+    void computeDrawPosition(const int col, const int row, const float tw, const float th, float &targetx, float &targety) const {
+        targetx = (col - row) * tw / 2;
+        targety = (col + row) * th / 2;
+    }
+
+    // Inverso de computeDrawPosition: (mx, my) relativo à mesma origem
+    void computeMouseMap(int &col, int &row, const float tw, const float th, const float mx, const float my) const {
+        float tw2 = tw / 2.0f;
+        float th2 = th / 2.0f;
+
+        // coordenadas relativas ao centro do tile (0,0), em unidades de meio tile
+        float u = (mx - tw2) / tw2; // col - row
+        float v = (my - th2) / th2; // col + row
+
+        // dentro de um losango |a|,|b| <= 0.5, então arredondar é exato
+        col = (int)floorf((u + v) / 2.0f + 0.5f);
+        row = (int)floorf((v - u) / 2.0f + 0.5f);
+    }
+
+    // x = (col - row) * tw/2 e y = (col + row) * th/2, resolvido para col e row
+    void computeTilePosition(const float x, const float y, const float tw, const float th, float &col, float &row) const {
+        col = x / tw + y / th;
+        row = y / th - x / tw;
+    }
+
+    void computeTileWalking(int &col, int &row, const int direction) const {
+        switch(direction){
+            case DIRECTION_NORTH:
+                col++;
+                row++;
+                break;
+            case DIRECTION_EAST:
+                col++;
+                row--;
+                break;
+            case DIRECTION_SOUTH:
+                col--;
+                row--;
+                break;
+            case DIRECTION_WEST:
+                col--;
+                row++;
+                break;
+            case DIRECTION_NORTHEAST:
+                col++;
+                break;
+            case DIRECTION_SOUTHEAST:
+                row--;
+                break;
+            case DIRECTION_SOUTHWEST:
+                col--;
+                break;
+            case DIRECTION_NORTHWEST:
+                row++;
+                break;
+        }
+    }
+
+};
+
+#endif /* DiamondView_h */
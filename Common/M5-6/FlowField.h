@@ -0,0 +1,548 @@
+//
+//  FlowField.h
+//  Campos de fluxo (flow fields) para multidões andando no TileMap
+//
+//  Para muitos personagens indo para os mesmos poucos destinos, em vez de um
+//  A* por personagem calcula-se uma vez por destino:
+//    - o campo de integração: custo do caminho mais barato de cada célula até
+//      o destino (Dijkstra a partir do destino, com os mesmos passos e custos
+//      do Pathfinder.h: 10 reto, 14 diagonal, vezes o custo do tile de
+//      destino na TileCostTable, sem cortar cantos);
+//    - o campo de direções: para cada célula, a DIRECTION_* do TilemapView
+//      que leva ao vizinho que continua o caminho mais barato.
+//  Depois, cada personagem só lê a direção da sua célula (O(1)) e anda com
+//  computeTileWalking.
+//
+//  Construção em paralelo: o mapa é dividido em blocos de blockSize x
+//  blockSize células. Cada bloco pendente roda um Dijkstra limitado a ele,
+//  semeado pelas células em volta (a vizinhança que alcança o bloco em um
+//  passo), e, se alguma célula perto da beirada melhorou, marca os blocos
+//  vizinhos como pendentes. Os blocos são pintados com 4 cores ((bx % 2,
+//  by % 2)) e em cada fase as threads processam só os pendentes de uma cor:
+//  blocos da mesma cor não se encostam, então nenhuma thread lê o que outra
+//  está escrevendo. As rodadas de 4 fases se repetem até nenhum bloco ficar
+//  pendente; o resultado é o mesmo do Dijkstra no mapa inteiro.
+//
+//  O custo por célula é copiado do mapa e mantido pelo setTile (listener);
+//  cada mudança de custo aumenta a versão do gerador, e um FlowField com
+//  versão antiga tem que ser reconstruído (isStale).
+//
+//  Exemplo:
+//    FlowFieldGenerator generator(&tilemap, costs, &diamondView);
+//    FlowField field;
+//    generator.build(goalCol, goalRow, field);
+//    ...
+//    // a cada passo de cada personagem:
+//    if (field.step(col, row)) ...            // ou field.getDirection(col, row)
+//
+//  Depois de TileMap::resize ou TileMapFile::load, chamar rebuild.
+//
+
+#ifndef FlowField_h
+#define FlowField_h
+
+#include "TileMap.h"
+#include "TilemapView.h"
+#include "TileCostTable.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <cstdlib>
+
+struct FlowFieldStats {
+    long builds;
+    long rounds;               // rodadas de 4 fases (uma por cor)
+    long blockPasses;          // Dijkstras de bloco
+};
+
+// Resultado de uma construção: custo até o destino e direção de cada célula
+class FlowField {
+    template <typename Layout> friend class BasicFlowFieldGenerator;
+
+    int width, height, pad, stride;
+    std::vector<uint32_t> dist;           // com a borda do gerador
+    std::vector<unsigned char> direction; // 0: destino, bloqueado ou sem caminho
+    int dirCol[9], dirRow[9];
+    unsigned long version;
+
+    int cellOf(int col, int row) const {
+        return (row + pad) * stride + col + pad;
+    }
+
+public:
+    static constexpr uint32_t UNREACHABLE = 0xFFFFFFFFu;
+
+    FlowField() {
+        width = height = pad = stride = 0;
+        version = 0;
+        for (int d = 0; d < 9; d++) {
+            dirCol[d] = dirRow[d] = 0;
+        }
+    }
+
+    int getWidth() const {
+        return width;
+    }
+
+    int getHeight() const {
+        return height;
+    }
+
+    // DIRECTION_* do próximo passo em (col, row); 0 no destino ou sem caminho
+    int getDirection(int col, int row) const {
+        if (col < 0 || row < 0 || col >= width || row >= height) {
+            return 0;
+        }
+        return direction[cellOf(col, row)];
+    }
+
+    // Custo do caminho até o destino; UNREACHABLE se não há caminho
+    uint32_t getDistance(int col, int row) const {
+        if (col < 0 || row < 0 || col >= width || row >= height) {
+            return UNREACHABLE;
+        }
+        return dist[cellOf(col, row)];
+    }
+
+    // Anda um passo seguindo o campo; false se já está no destino ou sem caminho
+    bool step(int &col, int &row) const {
+        int d = getDirection(col, row);
+        if (d == 0) {
+            return false;
+        }
+        col += dirCol[d];
+        row += dirRow[d];
+        return true;
+    }
+
+    unsigned long getVersion() const {
+        return version;
+    }
+};
+
+template <typename Layout>
+class BasicFlowFieldGenerator : public TileMapListener {
+    static constexpr unsigned STRAIGHT = 10;
+    static constexpr unsigned DIAGONAL = 14;
+    static constexpr uint32_t UNREACHABLE = FlowField::UNREACHABLE;
+    static constexpr unsigned WINDOW_BLOCKS = 2;
+
+    // Espera todas as threads; a última a chegar roda onLast antes de liberar
+    class Barrier {
+        std::mutex mutex;
+        std::condition_variable released;
+        unsigned count, waiting;
+        unsigned long phase;
+
+    public:
+        Barrier(unsigned count) : count(count), waiting(0), phase(0) {}
+
+        void wait(const std::function<void()> &onLast) {
+            std::unique_lock<std::mutex> lock(mutex);
+            unsigned long current = phase;
+            if (++waiting == count) {
+                onLast();
+                waiting = 0;
+                phase++;
+                released.notify_all();
+            } else {
+                released.wait(lock, [this, current]() { return phase != current; });
+            }
+        }
+    };
+
+    BasicTileMap<Layout> *tilemap;
+    TileCostTable table;
+    int width, height;
+    int pad, stride;                  // borda bloqueada e largura com a borda
+    std::vector<unsigned char> cost;  // custo por célula (0: bloqueado)
+    unsigned long version;
+
+    int dirCol[9], dirRow[9], dirStep[9];
+    unsigned dirCost[9];
+    bool dirCorner[9];
+
+    int blockSize, blocksX, blocksY;
+    std::vector<int> colorBlocks[4];  // blocos de cada cor
+    // menor custo que chegou na beirada do bloco e ainda não foi propagado
+    // dentro dele (UNREACHABLE: nada pendente)
+    std::unique_ptr<std::atomic<uint32_t>[]> pending;
+    uint32_t window;                  // faixa de custos processada por rodada
+    unsigned minCost;
+    std::vector<unsigned char> hasGoal;
+    std::vector<int> goalCells;
+    std::vector<std::vector<uint64_t>> heaps;   // um por thread: dist << 32 | célula
+    unsigned threadCount;
+
+    FlowFieldStats stats;
+
+    int cellOf(int col, int row) const {
+        return (row + pad) * stride + col + pad;
+    }
+
+    // Dijkstra dentro do bloco b, semeado pelo anel de pad células em volta
+    void processBlock(std::vector<uint64_t> &heap, std::vector<uint32_t> &dist, int b) {
+        int bx = b % blocksX, by = b / blocksX;
+        int col0 = bx * blockSize, row0 = by * blockSize;
+        int col1 = std::min(width, col0 + blockSize), row1 = std::min(height, row0 + blockSize);
+        heap.clear();
+        for (int row = row0 - pad; row < row1 + pad; row++) {
+            bool inside = row >= row0 && row < row1;
+            for (int col = col0 - pad; col < col1 + pad; col++) {
+                if (inside && col == col0) {
+                    col = col1 - 1;        // o miolo já está consistente
+                    continue;
+                }
+                uint32_t d = dist[cellOf(col, row)];
+                if (d != UNREACHABLE) {
+                    heap.push_back(((uint64_t)d << 32) | (uint32_t)cellOf(col, row));
+                }
+            }
+        }
+        if (hasGoal[b]) {
+            for (int cell : goalCells) {
+                int col = cell % stride - pad, row = cell / stride - pad;
+                if (col >= col0 && col < col1 && row >= row0 && row < row1) {
+                    heap.push_back((uint32_t)cell);
+                }
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), std::greater<uint64_t>());
+
+        int w = col1 - col0, h = row1 - row0;
+        uint32_t touched[9];           // menor custo novo na beirada de cada vizinho
+        std::fill(touched, touched + 9, UNREACHABLE);
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<uint64_t>());
+            uint64_t key = heap.back();
+            heap.pop_back();
+            int cell = (int)(uint32_t)key;
+            uint32_t d = (uint32_t)(key >> 32);
+            if (d != dist[cell]) {
+                continue;              // entrada velha
+            }
+            int col = cell % stride - pad, row = cell / stride - pad;
+            unsigned enter = cost[cell];
+            // quem chega em cell com um passo: from = cell - passo
+            for (int k = 1; k <= 8; k++) {
+                int fromCol = col - dirCol[k], fromRow = row - dirRow[k];
+                if (fromCol < col0 || fromRow < row0 || fromCol >= col1 || fromRow >= row1) {
+                    continue;
+                }
+                int from = cell - dirStep[k];
+                if (cost[from] == 0 ||
+                    (dirCorner[k] && (cost[from + dirCol[k]] == 0 || cost[from + dirRow[k] * stride] == 0))) {
+                    continue;
+                }
+                uint32_t nd = d + dirCost[k] * enter;
+                if (nd >= dist[from]) {
+                    continue;
+                }
+                dist[from] = nd;
+                heap.push_back(((uint64_t)nd << 32) | (uint32_t)from);
+                std::push_heap(heap.begin(), heap.end(), std::greater<uint64_t>());
+                int lc = fromCol - col0, lr = fromRow - row0;
+                if (lc < pad || lr < pad || lc >= w - pad || lr >= h - pad) {
+                    int xs = 2 | (lc < pad ? 1 : 0) | (lc >= w - pad ? 4 : 0);
+                    int ys = 2 | (lr < pad ? 1 : 0) | (lr >= h - pad ? 4 : 0);
+                    for (int dy = 0; dy < 3; dy++) {
+                        for (int dx = 0; dx < 3; dx++) {
+                            if ((xs >> dx & 1) && (ys >> dy & 1)) {
+                                touched[dy * 3 + dx] = std::min(touched[dy * 3 + dx], nd);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = bx + dx, ny = by + dy;
+                uint32_t d = touched[(dy + 1) * 3 + dx + 1];
+                if ((dx != 0 || dy != 0) && d != UNREACHABLE && nx >= 0 && ny >= 0 && nx < blocksX && ny < blocksY) {
+                    // dois blocos da mesma cor podem marcar o mesmo vizinho
+                    std::atomic<uint32_t> &seed = pending[ny * blocksX + nx];
+                    uint32_t current = seed.load(std::memory_order_relaxed);
+                    while (d < current && !seed.compare_exchange_weak(current, d, std::memory_order_relaxed)) {
+                    }
+                }
+            }
+        }
+    }
+
+    // Cada rodada só abre blocos até window acima do menor custo pendente:
+    // a frente de onda avança em ordem e poucos blocos são refeitos
+    void updateWindow() {
+        window = (uint32_t)(WINDOW_BLOCKS * blockSize * STRAIGHT * minCost);
+    }
+
+    // Direção de cada célula das linhas [row0, row1): o vizinho de menor custo
+    void deriveDirections(FlowField &field, int row0, int row1) const {
+        for (int row = row0; row < row1; row++) {
+            for (int col = 0; col < width; col++) {
+                int cell = cellOf(col, row);
+                uint32_t d = field.dist[cell];
+                unsigned char best = 0;
+                if (d != UNREACHABLE && d != 0) {
+                    uint32_t bestDist = UNREACHABLE;
+                    for (int k = 1; k <= 8; k++) {
+                        int next = cell + dirStep[k];
+                        if (cost[next] == 0 || field.dist[next] == UNREACHABLE ||
+                            (dirCorner[k] && (cost[cell + dirCol[k]] == 0 || cost[cell + dirRow[k] * stride] == 0))) {
+                            continue;
+                        }
+                        uint32_t through = field.dist[next] + dirCost[k] * cost[next];
+                        if (through < bestDist) {
+                            bestDist = through;
+                            best = (unsigned char)k;
+                        }
+                    }
+                }
+                field.direction[cell] = best;
+            }
+        }
+    }
+
+public:
+    BasicFlowFieldGenerator(BasicTileMap<Layout> *tilemap, const TileCostTable &table, const TilemapView *view,
+                            int blockSize = 64) {
+        this->tilemap = tilemap;
+        this->table = table;
+        this->version = 0;
+        this->threadCount = 0;
+        this->stats = FlowFieldStats();
+
+        // deslocamentos de cada direção, tirados do próprio view
+        int maxOffset = 1;
+        for (int d = 1; d <= 8; d++) {
+            int col = 0, row = 0;
+            view->computeTileWalking(col, row, d);
+            dirCol[d] = col;
+            dirRow[d] = row;
+            maxOffset = std::max(maxOffset, std::max(abs(col), abs(row)));
+            dirCost[d] = abs(col) + abs(row) == 1 ? STRAIGHT : DIAGONAL;
+            dirCorner[d] = abs(col) == 1 && abs(row) == 1;
+        }
+        pad = maxOffset;
+        // um passo não pode pular um bloco inteiro
+        this->blockSize = std::max(std::max(8, 2 * pad), blockSize);
+
+        rebuild();
+        tilemap->addListener(this);
+    }
+
+    ~BasicFlowFieldGenerator() {
+        tilemap->removeListener(this);
+    }
+
+    BasicFlowFieldGenerator(const BasicFlowFieldGenerator &) = delete;
+    BasicFlowFieldGenerator &operator=(const BasicFlowFieldGenerator &) = delete;
+
+    // Relê o mapa inteiro (depois de resize/load ou de trocar a tabela)
+    void rebuild() {
+        width = tilemap->getWidth();
+        height = tilemap->getHeight();
+        stride = width + 2 * pad;
+        cost.assign((size_t)stride * (height + 2 * pad), TileCostTable::BLOCKED);
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                cost[cellOf(col, row)] = table.getCost(tilemap->getTile(col, row));
+            }
+        }
+        for (int d = 1; d <= 8; d++) {
+            dirStep[d] = dirCol[d] + dirRow[d] * stride;
+        }
+
+        blocksX = (width + blockSize - 1) / blockSize;
+        blocksY = (height + blockSize - 1) / blockSize;
+        for (int color = 0; color < 4; color++) {
+            colorBlocks[color].clear();
+        }
+        for (int by = 0; by < blocksY; by++) {
+            for (int bx = 0; bx < blocksX; bx++) {
+                colorBlocks[(by % 2) * 2 + bx % 2].push_back(by * blocksX + bx);
+            }
+        }
+        pending.reset(new std::atomic<uint32_t>[(size_t)blocksX * blocksY]);
+        hasGoal.assign((size_t)blocksX * blocksY, 0);
+        minCost = 255;
+        for (unsigned char c : cost) {
+            if (c != TileCostTable::BLOCKED) {
+                minCost = std::min(minCost, (unsigned)c);
+            }
+        }
+        updateWindow();
+        version++;
+    }
+
+    void setCostTable(const TileCostTable &table) {
+        this->table = table;
+        rebuild();
+    }
+
+    const TileCostTable &getCostTable() const {
+        return table;
+    }
+
+    void onTileChanged(int col, int row, unsigned char oldTile, unsigned char newTile) {
+        int cell = cellOf(col, row);
+        unsigned char after = table.getCost(newTile);
+        if (cost[cell] != after) {
+            cost[cell] = after;
+            if (after != TileCostTable::BLOCKED && after < minCost) {
+                minCost = after;
+                updateWindow();
+            }
+            version++;
+        }
+    }
+
+    // Threads da construção (0: uma por núcleo)
+    void setThreads(unsigned count) {
+        threadCount = count;
+    }
+
+    unsigned getThreads() const {
+        return threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    int getBlockSize() const {
+        return blockSize;
+    }
+
+    bool isWalkable(int col, int row) const {
+        return col >= 0 && row >= 0 && col < width && row < height && cost[cellOf(col, row)] != TileCostTable::BLOCKED;
+    }
+
+    // A versão muda a cada tile que muda de custo
+    unsigned long getVersion() const {
+        return version;
+    }
+
+    bool isStale(const FlowField &field) const {
+        return field.version != version || field.width != width || field.height != height;
+    }
+
+    bool build(int goalCol, int goalRow, FlowField &field) {
+        return build(std::vector<std::pair<int, int>>(1, std::make_pair(goalCol, goalRow)), field);
+    }
+
+    // Campo até o destino mais próximo entre goals (col, row); false se nenhum
+    // destino é livre. field é reaproveitado entre chamadas
+    bool build(const std::vector<std::pair<int, int>> &goals, FlowField &field) {
+        stats.builds++;
+        field.width = width;
+        field.height = height;
+        field.pad = pad;
+        field.stride = stride;
+        field.version = version;
+        for (int d = 0; d < 9; d++) {
+            field.dirCol[d] = d == 0 ? 0 : dirCol[d];
+            field.dirRow[d] = d == 0 ? 0 : dirRow[d];
+        }
+        size_t cells = cost.size();
+        field.dist.assign(cells, UNREACHABLE);
+        field.direction.assign(cells, 0);
+
+        int blocks = blocksX * blocksY;
+        for (int b = 0; b < blocks; b++) {
+            pending[b].store(UNREACHABLE, std::memory_order_relaxed);
+        }
+        std::fill(hasGoal.begin(), hasGoal.end(), 0);
+        goalCells.clear();
+        for (const std::pair<int, int> &goal : goals) {
+            if (!isWalkable(goal.first, goal.second)) {
+                continue;
+            }
+            int cell = cellOf(goal.first, goal.second);
+            int b = (goal.second / blockSize) * blocksX + goal.first / blockSize;
+            field.dist[cell] = 0;
+            goalCells.push_back(cell);
+            hasGoal[b] = 1;
+            pending[b].store(0, std::memory_order_relaxed);
+        }
+        if (goalCells.empty()) {
+            return false;
+        }
+
+        unsigned threads = getThreads();
+        if (heaps.size() < threads) {
+            heaps.resize(threads);
+        }
+        Barrier barrier(threads);
+        std::atomic<int> next(0);
+        std::atomic<long> passes(0);
+        uint32_t limit = window;
+        int color = 0;
+        bool done = false;
+        int rowChunk = 16;
+
+        // fases de uma cor por vez; a última thread a chegar troca de fase e,
+        // no fim da rodada, move a janela para o menor custo pendente
+        auto endPhase = [&]() {
+            if (color == 3) {
+                stats.rounds++;
+                uint32_t lowest = UNREACHABLE;
+                for (int b = 0; b < blocks; b++) {
+                    lowest = std::min(lowest, pending[b].load(std::memory_order_relaxed));
+                }
+                done = lowest == UNREACHABLE;
+                limit = lowest > UNREACHABLE - window ? UNREACHABLE - 1 : lowest + window;
+            }
+            color = (color + 1) % 4;
+            next.store(0);
+        };
+        auto work = [&](unsigned t) {
+            std::vector<uint64_t> &heap = heaps[t];
+            while (!done) {
+                const std::vector<int> &list = colorBlocks[color];
+                for (int i = next.fetch_add(1); i < (int)list.size(); i = next.fetch_add(1)) {
+                    int b = list[i];
+                    // só esta fase mexe no pendente de um bloco desta cor
+                    if (pending[b].load(std::memory_order_relaxed) <= limit) {
+                        pending[b].store(UNREACHABLE, std::memory_order_relaxed);
+                        processBlock(heap, field.dist, b);
+                        passes.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                barrier.wait(endPhase);
+            }
+            // direções, linhas em pedaços
+            for (int row0 = next.fetch_add(rowChunk); row0 < height; row0 = next.fetch_add(rowChunk)) {
+                deriveDirections(field, row0, std::min(height, row0 + rowChunk));
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < threads; t++) {
+            workers.emplace_back(work, t);
+        }
+        work(0);
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        stats.blockPasses += passes.load();
+        return true;
+    }
+
+    const FlowFieldStats &getStats() const {
+        return stats;
+    }
+
+    void resetStats() {
+        stats = FlowFieldStats();
+    }
+};
+
+typedef BasicFlowFieldGenerator<RowMajorLayout> FlowFieldGenerator;
+
+#endif /* FlowField_h */
@@ -0,0 +1,449 @@
+//
+//  FogOfWar.h
+//  Neblina de guerra e campo de visão sobre um TileMap
+//
+//  Cada unidade (time, célula, raio) enxerga as células do seu campo de visão,
+//  calculado por recursive shadowcasting: os 8 octantes em volta da unidade
+//  são varridos linha a linha, e cada tile opaco abre uma "sombra" (intervalo
+//  de inclinações) que as linhas seguintes pulam. Tiles opacos são vistos,
+//  mas escondem o que está atrás; o raio é circular.
+//
+//  Por time: quantas unidades veem cada célula, um bitset de células visíveis
+//  e outro de exploradas (vistas alguma vez), linha a linha (wordsPerRow
+//  palavras de 64 bits por linha). Cada unidade guarda as células que viu, e
+//  update() só recalcula as unidades marcadas (moveUnit, setRadius ou um tile
+//  que mudou de opacidade dentro do raio delas): tira as células antigas,
+//  soma as novas, e só as células que mudaram de estado mexem no bitset. O
+//  custo é proporcional às unidades que se mexeram, não à área do mapa.
+//
+//  Para a GPU, cada time tem também um nível por célula (um byte: HIDDEN,
+//  EXPLORED ou VISIBLE), no formato de uma textura R8 do tamanho do mapa, e
+//  a lista dos blocos de BLOCK x BLOCK células que mudaram desde o último
+//  clearDirtyBlocks (ver FogTexture.h).
+//
+//  Exemplo:
+//    FogOfWar fog(&tilemap, 2);         // dois times
+//    fog.setOpaque(2, true);            // pedra esconde o que está atrás
+//    int hero = fog.addUnit(0, col, row, 6);
+//    ...
+//    fog.moveUnit(hero, col, row);
+//    fog.update();
+//    if (fog.isVisible(0, c, r)) ...
+//
+//  Depois de TileMap::resize ou TileMapFile::load, chamar rebuild.
+//
+
+#ifndef FogOfWar_h
+#define FogOfWar_h
+
+#include "TileMap.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+struct FogOfWarStats {
+    long updates;
+    long unitsUpdated;         // campos de visão recalculados
+    long cellsLit;             // células somadas nos campos recalculados
+    long cellsChanged;         // células que mudaram de estado num time
+};
+
+template <typename Layout>
+class BasicFogOfWar : public TileMapListener {
+public:
+    static constexpr unsigned char HIDDEN = 0;
+    static constexpr unsigned char EXPLORED = 96;
+    static constexpr unsigned char VISIBLE = 255;
+    static const int BLOCK = 32;
+
+private:
+    struct Unit {
+        int team;
+        int col, row, radius;
+        bool alive, dirty;
+        std::vector<int> cells;        // células vistas no último cálculo
+    };
+
+    struct Team {
+        std::vector<uint16_t> viewers;     // unidades do time vendo a célula
+        std::vector<uint64_t> visible, explored;
+        std::vector<unsigned char> levels; // HIDDEN / EXPLORED / VISIBLE
+        std::vector<unsigned char> blockDirty;
+        std::vector<int> dirtyBlocks;
+    };
+
+    BasicTileMap<Layout> *tilemap;
+    int width, height, wordsPerRow;
+    int blocksX, blocksY;
+    bool opaqueTile[256];
+    std::vector<unsigned char> opaque;     // por célula
+
+    std::vector<Unit> units;
+    std::vector<int> freeUnits;
+    std::vector<int> dirtyUnits;
+    std::vector<int> previous;             // células antigas da unidade em update
+    std::vector<Team> teams;
+
+    // células já marcadas no cálculo atual (os octantes se encostam)
+    std::vector<uint32_t> stamp;
+    uint32_t generation;
+
+    FogOfWarStats stats;
+
+    void markDirty(int unit) {
+        if (!units[unit].dirty) {
+            units[unit].dirty = true;
+            dirtyUnits.push_back(unit);
+        }
+    }
+
+    void light(Unit &unit, int col, int row) {
+        int cell = row * width + col;
+        if (stamp[cell] != generation) {
+            stamp[cell] = generation;
+            unit.cells.push_back(cell);
+        }
+    }
+
+    // Um octante: linhas de distance em diante, entre as inclinações start e
+    // end (1 = diagonal, 0 = eixo). (xx, xy, yx, yy) leva o octante para o grid
+    void castLight(Unit &unit, int distance, double start, double end, int xx, int xy, int yx, int yy) {
+        if (start < end) {
+            return;
+        }
+        int radius2 = unit.radius * unit.radius;
+        double newStart = 0.0;
+        for (int j = distance; j <= unit.radius; j++) {
+            int dy = -j;
+            bool blocked = false;
+            for (int dx = -j; dx <= 0; dx++) {
+                int col = unit.col + dx * xx + dy * xy;
+                int row = unit.row + dx * yx + dy * yy;
+                double leftSlope = (dx - 0.5) / (dy + 0.5);
+                double rightSlope = (dx + 0.5) / (dy - 0.5);
+                if (start < rightSlope) {
+                    continue;
+                }
+                if (end > leftSlope) {
+                    break;
+                }
+                bool inside = col >= 0 && row >= 0 && col < width && row < height;
+                if (inside && dx * dx + dy * dy <= radius2) {
+                    light(unit, col, row);
+                }
+                bool wall = !inside || opaque[row * width + col];
+                if (blocked) {
+                    if (wall) {
+                        newStart = rightSlope;
+                        continue;
+                    }
+                    blocked = false;
+                    start = newStart;
+                } else if (wall && j < unit.radius) {
+                    // a sombra começa aqui: o resto do octante continua acima dela
+                    blocked = true;
+                    castLight(unit, j + 1, start, leftSlope, xx, xy, yx, yy);
+                    newStart = rightSlope;
+                }
+            }
+            if (blocked) {
+                break;
+            }
+        }
+    }
+
+    void computeView(Unit &unit) {
+        static const int mult[4][8] = {
+            { 1, 0, 0, -1, -1, 0, 0, 1 },
+            { 0, 1, -1, 0, 0, -1, 1, 0 },
+            { 0, 1, 1, 0, 0, -1, -1, 0 },
+            { 1, 0, 0, 1, -1, 0, 0, -1 }
+        };
+        unit.cells.clear();
+        if (++generation == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+        if (unit.col < 0 || unit.row < 0 || unit.col >= width || unit.row >= height) {
+            return;
+        }
+        light(unit, unit.col, unit.row);
+        for (int octant = 0; octant < 8; octant++) {
+            castLight(unit, 1, 1.0, 0.0, mult[0][octant], mult[1][octant], mult[2][octant], mult[3][octant]);
+        }
+    }
+
+    void setLevel(Team &team, int cell, unsigned char level) {
+        team.levels[cell] = level;
+        int b = (cell / width / BLOCK) * blocksX + (cell % width) / BLOCK;
+        if (!team.blockDirty[b]) {
+            team.blockDirty[b] = 1;
+            team.dirtyBlocks.push_back(b);
+        }
+        stats.cellsChanged++;
+    }
+
+    void addViewer(Team &team, int cell) {
+        if (team.viewers[cell]++ == 0) {
+            int row = cell / width, col = cell % width;
+            uint64_t bit = (uint64_t)1 << (col & 63);
+            team.visible[(size_t)row * wordsPerRow + (col >> 6)] |= bit;
+            team.explored[(size_t)row * wordsPerRow + (col >> 6)] |= bit;
+            setLevel(team, cell, VISIBLE);
+        }
+    }
+
+    void removeViewer(Team &team, int cell) {
+        if (--team.viewers[cell] == 0) {
+            int row = cell / width, col = cell % width;
+            team.visible[(size_t)row * wordsPerRow + (col >> 6)] &= ~((uint64_t)1 << (col & 63));
+            setLevel(team, cell, EXPLORED);
+        }
+    }
+
+public:
+    BasicFogOfWar(BasicTileMap<Layout> *tilemap, int teamCount = 1) {
+        this->tilemap = tilemap;
+        this->generation = 0;
+        this->stats = FogOfWarStats();
+        std::fill(opaqueTile, opaqueTile + 256, false);
+        teams.resize(std::max(1, teamCount));
+        rebuild();
+        tilemap->addListener(this);
+    }
+
+    ~BasicFogOfWar() {
+        tilemap->removeListener(this);
+    }
+
+    BasicFogOfWar(const BasicFogOfWar &) = delete;
+    BasicFogOfWar &operator=(const BasicFogOfWar &) = delete;
+
+    // Relê o mapa inteiro e esquece o explorado; as unidades são recalculadas
+    // no próximo update
+    void rebuild() {
+        width = tilemap->getWidth();
+        height = tilemap->getHeight();
+        wordsPerRow = (width + 63) / 64;
+        blocksX = (width + BLOCK - 1) / BLOCK;
+        blocksY = (height + BLOCK - 1) / BLOCK;
+        size_t cells = (size_t)width * height;
+        opaque.assign(cells, 0);
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                opaque[(size_t)row * width + col] = opaqueTile[tilemap->getTile(col, row)];
+            }
+        }
+        stamp.assign(cells, 0);
+        generation = 0;
+        for (Team &team : teams) {
+            team.viewers.assign(cells, 0);
+            team.visible.assign((size_t)wordsPerRow * height, 0);
+            team.explored.assign((size_t)wordsPerRow * height, 0);
+            team.levels.assign(cells, HIDDEN);
+            team.blockDirty.assign((size_t)blocksX * blocksY, 1);
+            team.dirtyBlocks.clear();
+            for (int b = 0; b < blocksX * blocksY; b++) {
+                team.dirtyBlocks.push_back(b);
+            }
+        }
+        for (int i = 0; i < (int)units.size(); i++) {
+            units[i].cells.clear();       // as contagens já foram zeradas
+            if (units[i].alive) {
+                markDirty(i);
+            }
+        }
+    }
+
+    // Tiles que escondem o que está atrás (paredes, pedras, árvores)
+    void setOpaque(int tile, bool value) {
+        if (opaqueTile[tile & 0xff] == value) {
+            return;
+        }
+        opaqueTile[tile & 0xff] = value;
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                opaque[(size_t)row * width + col] = opaqueTile[tilemap->getTile(col, row)];
+            }
+        }
+        for (int i = 0; i < (int)units.size(); i++) {
+            if (units[i].alive) {
+                markDirty(i);
+            }
+        }
+    }
+
+    bool isOpaque(int tile) const {
+        return opaqueTile[tile & 0xff];
+    }
+
+    void onTileChanged(int col, int row, unsigned char oldTile, unsigned char newTile) {
+        unsigned char after = opaqueTile[newTile];
+        unsigned char &cell = opaque[(size_t)row * width + col];
+        if (cell == after) {
+            return;
+        }
+        cell = after;
+        // só quem tem a célula dentro do raio pode ver diferente
+        for (int i = 0; i < (int)units.size(); i++) {
+            const Unit &unit = units[i];
+            int dc = col - unit.col, dr = row - unit.row;
+            if (unit.alive && dc * dc + dr * dr <= unit.radius * unit.radius) {
+                markDirty(i);
+            }
+        }
+    }
+
+    int getTeamCount() const {
+        return (int)teams.size();
+    }
+
+    // Nova unidade do time team em (col, row); devolve o id
+    int addUnit(int team, int col, int row, int radius) {
+        int id;
+        if (!freeUnits.empty()) {
+            id = freeUnits.back();
+            freeUnits.pop_back();
+        } else {
+            id = (int)units.size();
+            units.push_back(Unit());
+        }
+        Unit &unit = units[id];
+        unit.team = std::min(std::max(team, 0), (int)teams.size() - 1);
+        unit.col = col;
+        unit.row = row;
+        unit.radius = std::max(0, radius);
+        unit.alive = true;
+        unit.cells.clear();
+        markDirty(id);
+        return id;
+    }
+
+    void moveUnit(int id, int col, int row) {
+        Unit &unit = units[id];
+        if (unit.col != col || unit.row != row) {
+            unit.col = col;
+            unit.row = row;
+            markDirty(id);
+        }
+    }
+
+    void setRadius(int id, int radius) {
+        Unit &unit = units[id];
+        if (unit.radius != std::max(0, radius)) {
+            unit.radius = std::max(0, radius);
+            markDirty(id);
+        }
+    }
+
+    void removeUnit(int id) {
+        Unit &unit = units[id];
+        Team &team = teams[unit.team];
+        for (int cell : unit.cells) {
+            removeViewer(team, cell);
+        }
+        unit.cells.clear();
+        unit.alive = false;
+        freeUnits.push_back(id);
+    }
+
+    // Recalcula as unidades marcadas; devolve quantas
+    int update() {
+        stats.updates++;
+        int count = 0;
+        for (size_t i = 0; i < dirtyUnits.size(); i++) {
+            Unit &unit = units[dirtyUnits[i]];
+            unit.dirty = false;
+            if (!unit.alive) {
+                continue;
+            }
+            Team &team = teams[unit.team];
+            // soma as novas antes de tirar as antigas: o que continua visível
+            // não passa por "explorado"
+            previous.swap(unit.cells);
+            computeView(unit);
+            for (int cell : unit.cells) {
+                addViewer(team, cell);
+            }
+            for (int cell : previous) {
+                removeViewer(team, cell);
+            }
+            stats.cellsLit += (long)unit.cells.size();
+            count++;
+        }
+        dirtyUnits.clear();
+        stats.unitsUpdated += count;
+        return count;
+    }
+
+    bool isVisible(int team, int col, int row) const {
+        if (col < 0 || row < 0 || col >= width || row >= height) {
+            return false;
+        }
+        return (teams[team].visible[(size_t)row * wordsPerRow + (col >> 6)] >> (col & 63)) & 1;
+    }
+
+    bool isExplored(int team, int col, int row) const {
+        if (col < 0 || row < 0 || col >= width || row >= height) {
+            return false;
+        }
+        return (teams[team].explored[(size_t)row * wordsPerRow + (col >> 6)] >> (col & 63)) & 1;
+    }
+
+    // Bitset de visíveis do time: wordsPerRow palavras por linha, bit col & 63
+    const std::vector<uint64_t> &getVisibleBits(int team) const {
+        return teams[team].visible;
+    }
+
+    const std::vector<uint64_t> &getExploredBits(int team) const {
+        return teams[team].explored;
+    }
+
+    int getWordsPerRow() const {
+        return wordsPerRow;
+    }
+
+    int getWidth() const {
+        return width;
+    }
+
+    int getHeight() const {
+        return height;
+    }
+
+    // Nível de cada célula, linha a linha (width x height bytes)
+    const unsigned char *getLevels(int team) const {
+        return teams[team].levels.data();
+    }
+
+    // Blocos (by * blocksX + bx) com níveis alterados desde o último clear
+    const std::vector<int> &getDirtyBlocks(int team) const {
+        return teams[team].dirtyBlocks;
+    }
+
+    void clearDirtyBlocks(int team) {
+        Team &t = teams[team];
+        for (int b : t.dirtyBlocks) {
+            t.blockDirty[b] = 0;
+        }
+        t.dirtyBlocks.clear();
+    }
+
+    int getBlocksX() const {
+        return blocksX;
+    }
+
+    const FogOfWarStats &getStats() const {
+        return stats;
+    }
+
+    void resetStats() {
+        stats = FogOfWarStats();
+    }
+};
+
+typedef BasicFogOfWar<RowMajorLayout> FogOfWar;
+
+#endif /* FogOfWar_h */
@@ -0,0 +1,120 @@
+//
+//  FogTexture.h
+//  Neblina de guerra de um time na GPU: textura R8 com uma célula por texel
+//
+//  O nível de cada célula (FogOfWar::HIDDEN / EXPLORED / VISIBLE) vai para
+//  uma textura GL_R8 do tamanho do mapa. upload() só reenvia os blocos que o
+//  FogOfWar marcou como alterados, direto do buffer de níveis dele (com
+//  GL_UNPACK_ROW_LENGTH, sem cópia), então o custo acompanha as unidades que
+//  se mexeram e não a área do mapa.
+//
+//  O shader dos tiles lê o texel da célula (atributo location 2 do
+//  TileMapMesh) com texelFetch e multiplica a cor:
+//    flat in vec2 tile_cell;
+//    uniform sampler2D fog_buff;
+//    color.rgb *= texelFetch(fog_buff, ivec2(tile_cell), 0).r;
+//
+//  Exemplo:
+//    FogTexture fogTexture;
+//    fogTexture.build(fog, 0);          // time 0
+//    ...
+//    fog.update();
+//    fogTexture.upload(fog, 0);
+//    glActiveTexture(GL_TEXTURE1);
+//    glBindTexture(GL_TEXTURE_2D, fogTexture.getTexture());
+//
+
+#ifndef FogTexture_h
+#define FogTexture_h
+
+#include <glad/glad.h>
+
+#include "FogOfWar.h"
+
+#include <algorithm>
+
+class FogTexture {
+    GLuint texID;
+    int width, height;
+    long uploadedTexels;
+
+public:
+    FogTexture() {
+        texID = 0;
+        width = height = 0;
+        uploadedTexels = 0;
+    }
+
+    FogTexture(const FogTexture &) = delete;
+    FogTexture &operator=(const FogTexture &) = delete;
+
+    // Cria a textura com os níveis atuais do time
+    template <typename Layout>
+    void build(BasicFogOfWar<Layout> &fog, int team) {
+        width = fog.getWidth();
+        height = fog.getHeight();
+        if (texID == 0) {
+            glGenTextures(1, &texID);
+        }
+        glBindTexture(GL_TEXTURE_2D, texID);
+        // um texel por célula: sem filtro nem repetição
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, fog.getLevels(team));
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        uploadedTexels += (long)width * height;
+        fog.clearDirtyBlocks(team);
+    }
+
+    // Reenvia os blocos alterados desde o último upload; devolve quantos
+    template <typename Layout>
+    int upload(BasicFogOfWar<Layout> &fog, int team) {
+        if (texID == 0 || fog.getWidth() != width || fog.getHeight() != height) {
+            build(fog, team);
+            return 1;
+        }
+        const std::vector<int> &blocks = fog.getDirtyBlocks(team);
+        if (blocks.empty()) {
+            return 0;
+        }
+        const int block = BasicFogOfWar<Layout>::BLOCK;
+        const unsigned char *levels = fog.getLevels(team);
+        glBindTexture(GL_TEXTURE_2D, texID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+        for (int b : blocks) {
+            int col0 = (b % fog.getBlocksX()) * block, row0 = (b / fog.getBlocksX()) * block;
+            int w = std::min(block, width - col0), h = std::min(block, height - row0);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, col0, row0, w, h, GL_RED, GL_UNSIGNED_BYTE,
+                            levels + (size_t)row0 * width + col0);
+            uploadedTexels += (long)w * h;
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        int count = (int)blocks.size();
+        fog.clearDirtyBlocks(team);
+        return count;
+    }
+
+    GLuint getTexture() const {
+        return texID;
+    }
+
+    // Texels enviados desde a criação (métrica)
+    long getUploadedTexels() const {
+        return uploadedTexels;
+    }
+
+    // Libera a textura; chamar antes do glfwTerminate
+    void release() {
+        glDeleteTextures(1, &texID);
+        texID = 0;
+    }
+};
+
+#endif /* FogTexture_h */
@@ -0,0 +1,691 @@
+//
+//  HierarchicalPathfinder.h
+//  Caminhos longos em mapas grandes com HPA* (A* hierárquico)
+//
+//  O mapa é dividido em clusters de clusterSize x clusterSize células. Em cada
+//  borda entre dois clusters vizinhos, cada trecho contínuo de células livres
+//  dos dois lados vira uma ou duas "entradas" (no meio, se o trecho tem menos
+//  de 6 células, ou nas duas pontas): um nó abstrato de cada lado, ligados pelo
+//  passo que atravessa a borda. Dentro de cada cluster, um Dijkstra limitado ao
+//  cluster a partir de cada nó dá o custo até os outros nós do mesmo cluster
+//  (clusterSize vai de 4 a 256).
+//
+//  Uma consulta liga o início e o fim aos nós dos seus clusters (Dijkstra
+//  local), roda A* no grafo abstrato (algumas dezenas de nós por cluster, em
+//  vez de clusterSize² células) e refina cada aresta com A* dentro de um
+//  cluster. O caminho é válido e quase ótimo (tipicamente poucos % acima do
+//  A* completo); início e fim no mesmo cluster tentam primeiro a busca local.
+//
+//  Passos, custos e cantos como no Pathfinder.h (10 reto, 14 diagonal, vezes o
+//  custo do tile de destino na TileCostTable); as direções vêm do
+//  computeTileWalking e têm que formar a vizinhança 8 do grid (DiamondView).
+//
+//  Atualização incremental: TileMap::setTile marca o cluster da célula (e a
+//  borda e o cluster vizinho, se a célula está na beirada) e o próximo update
+//  (ou findPath) só refaz as bordas e os clusters marcados. A construção
+//  inicial calcula os clusters em paralelo.
+//
+//  Exemplo:
+//    HierarchicalPathfinder hpa(&tilemap, costs, &diamondView, 32);
+//    hpa.findPath(col, row, destCol, destRow, path);
+//    tilemap.setTile(c, r, 2);      // parede nova
+//    hpa.update();                   // só os clusters afetados
+//
+
+#ifndef HierarchicalPathfinder_h
+#define HierarchicalPathfinder_h
+
+#include "TileMap.h"
+#include "TilemapView.h"
+#include "TileCostTable.h"
+#include "Pathfinder.h"       // PathStep
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <cstdlib>
+
+struct HierarchicalPathfinderStats {
+    long queries;
+    long abstractExpanded;     // nós do grafo abstrato expandidos
+    long localSearches;        // buscas dentro de um cluster (ligação e refino)
+    long clusterRebuilds;
+    long borderRebuilds;
+};
+
+template <typename Layout>
+class BasicHierarchicalPathfinder : public TileMapListener {
+    static constexpr unsigned STRAIGHT = 10;
+    static constexpr unsigned DIAGONAL = 14;
+    static const int MIN_SPLIT_ENTRANCE = 6;
+
+    struct AbstractEdge {
+        int to;
+        uint32_t cost;
+    };
+
+    struct AbstractNode {
+        int cell;
+        int cluster;
+        bool alive;
+        int partner;                      // nó do outro lado da borda
+        uint32_t partnerCost;             // custo do passo até ele
+        std::vector<AbstractEdge> edges;  // nós do mesmo cluster
+    };
+
+    // Espaço de uma busca limitada a um cluster (índices locais)
+    struct LocalSearch {
+        std::vector<uint32_t> g;
+        std::vector<int> parent;
+        std::vector<uint32_t> stamp;
+        uint32_t generation;
+        std::vector<uint64_t> heap;   // f << 16 | índice local
+        int col0, row0, col1, row1;
+    };
+
+    BasicTileMap<Layout> *tilemap;
+    TileCostTable table;
+    int clusterSize;
+    int width, height, stride;
+    int clustersX, clustersY;
+    std::vector<unsigned char> cost;      // com borda bloqueada de uma célula
+    unsigned minCost;
+
+    int dirCol[9], dirRow[9], dirStep[9];
+    unsigned dirCost[9];
+    bool dirCorner[9];
+    int dirOf[3][3];
+
+    std::vector<AbstractNode> nodes;
+    std::vector<int> freeNodes;
+    std::vector<std::vector<int>> borderNodes;    // bordas verticais e depois horizontais
+    std::vector<std::vector<int>> clusterNodes;
+    std::vector<char> borderDirty, clusterDirty;
+    std::vector<int> dirtyBorders, dirtyClusters;
+
+    LocalSearch local;
+
+    // busca abstrata: índices de nós + início e fim temporários
+    std::vector<uint32_t> abstractG, abstractStamp;
+    std::vector<int> abstractParent;
+    uint32_t abstractGeneration;
+    std::vector<std::pair<uint64_t, int>> abstractHeap;
+    std::vector<AbstractEdge> startEdges;
+    std::vector<uint32_t> goalDist;
+    std::vector<int> route;
+    std::vector<int> abstractPath;
+
+    HierarchicalPathfinderStats stats;
+    unsigned lastCost;
+
+    int cellOf(int col, int row) const {
+        return (row + 1) * stride + col + 1;
+    }
+
+    int colOf(int cell) const {
+        return cell % stride - 1;
+    }
+
+    int rowOf(int cell) const {
+        return cell / stride - 1;
+    }
+
+    int clusterOf(int col, int row) const {
+        return (row / clusterSize) * clustersX + col / clusterSize;
+    }
+
+    int verticalBorders() const {
+        return (clustersX - 1) * clustersY;
+    }
+
+    unsigned octile(int dc, int dr) const {
+        dc = abs(dc);
+        dr = abs(dr);
+        int lo = std::min(dc, dr), hi = std::max(dc, dr);
+        return (STRAIGHT * (hi - lo) + DIAGONAL * lo) * minCost;
+    }
+
+    int allocNode(int cell, int cluster) {
+        int id;
+        if (!freeNodes.empty()) {
+            id = freeNodes.back();
+            freeNodes.pop_back();
+        } else {
+            id = (int)nodes.size();
+            nodes.emplace_back();
+        }
+        AbstractNode &node = nodes[id];
+        node.cell = cell;
+        node.cluster = cluster;
+        node.alive = true;
+        node.partner = -1;
+        node.edges.clear();
+        clusterNodes[cluster].push_back(id);
+        return id;
+    }
+
+    void removeBorder(int border) {
+        for (int id : borderNodes[border]) {
+            AbstractNode &node = nodes[id];
+            std::vector<int> &list = clusterNodes[node.cluster];
+            list.erase(std::find(list.begin(), list.end(), id));
+            node.alive = false;
+            node.edges.clear();
+            freeNodes.push_back(id);
+        }
+        borderNodes[border].clear();
+    }
+
+    // Entradas de uma borda: trechos livres dos dois lados
+    void scanBorder(int border) {
+        bool vertical = border < verticalBorders();
+        int cx, cy, length;
+        int dc, dr;                // passo que atravessa a borda
+        int col, row;              // primeira célula do lado de cá
+        int along;                 // passo ao longo da borda (em células)
+        if (vertical) {
+            cx = border % (clustersX - 1);
+            cy = border / (clustersX - 1);
+            col = (cx + 1) * clusterSize - 1;
+            row = cy * clusterSize;
+            length = std::min(clusterSize, height - row);
+            dc = 1;
+            dr = 0;
+            along = stride;
+        } else {
+            int b = border - verticalBorders();
+            cx = b % clustersX;
+            cy = b / clustersX;
+            col = cx * clusterSize;
+            row = (cy + 1) * clusterSize - 1;
+            length = std::min(clusterSize, width - col);
+            dc = 0;
+            dr = 1;
+            along = 1;
+        }
+        int here = cy * clustersX + cx;
+        int there = (cy + dr) * clustersX + cx + dc;
+        int first = cellOf(col, row), across = dc + dr * stride;
+
+        auto addEntrance = [&](int i) {
+            int a = first + i * along, b = a + across;
+            int na = allocNode(a, here), nb = allocNode(b, there);
+            nodes[na].partner = nb;
+            nodes[na].partnerCost = STRAIGHT * cost[b];
+            nodes[nb].partner = na;
+            nodes[nb].partnerCost = STRAIGHT * cost[a];
+            borderNodes[border].push_back(na);
+            borderNodes[border].push_back(nb);
+        };
+
+        int start = -1;
+        for (int i = 0; i <= length; i++) {
+            int a = first + i * along;
+            bool open = i < length && cost[a] != 0 && cost[a + across] != 0;
+            if (open && start < 0) {
+                start = i;
+            } else if (!open && start >= 0) {
+                int end = i - 1;
+                if (end - start + 1 < MIN_SPLIT_ENTRANCE) {
+                    addEntrance((start + end) / 2);
+                } else {
+                    addEntrance(start);
+                    addEntrance(end);
+                }
+                start = -1;
+            }
+        }
+    }
+
+    // Dijkstra (target < 0) ou A* até target, limitado ao cluster. reverse:
+    // custos do caminho de cada célula ATÉ source (entrar numa célula custa o
+    // tile dela)
+    bool searchCluster(LocalSearch &ws, int cluster, int source, int target, bool reverse) const {
+        int cx = cluster % clustersX, cy = cluster / clustersX;
+        ws.col0 = cx * clusterSize;
+        ws.row0 = cy * clusterSize;
+        ws.col1 = std::min(width, ws.col0 + clusterSize);
+        ws.row1 = std::min(height, ws.row0 + clusterSize);
+        if (++ws.generation == 0) {
+            std::fill(ws.stamp.begin(), ws.stamp.end(), 0);
+            ws.generation = 1;
+        }
+        ws.heap.clear();
+        int targetCol = target >= 0 ? colOf(target) : 0, targetRow = target >= 0 ? rowOf(target) : 0;
+
+        int sourceLocal = (rowOf(source) - ws.row0) * clusterSize + colOf(source) - ws.col0;
+        ws.stamp[sourceLocal] = ws.generation;
+        ws.g[sourceLocal] = 0;
+        ws.parent[sourceLocal] = -1;
+        uint32_t h = target >= 0 ? octile(colOf(source) - targetCol, rowOf(source) - targetRow) : 0;
+        ws.heap.push_back(((uint64_t)h << 16) | (uint64_t)sourceLocal);
+        while (!ws.heap.empty()) {
+            std::pop_heap(ws.heap.begin(), ws.heap.end(), std::greater<uint64_t>());
+            uint64_t key = ws.heap.back();
+            ws.heap.pop_back();
+            int index = (int)(key & 0xFFFF);
+            int col = ws.col0 + index % clusterSize, row = ws.row0 + index / clusterSize;
+            uint32_t g = ws.g[index];
+            if ((key >> 16) != g + (target >= 0 ? octile(col - targetCol, row - targetRow) : 0)) {
+                continue;          // entrada velha (o nó já melhorou)
+            }
+            int cell = cellOf(col, row);
+            if (cell == target) {
+                return true;
+            }
+            for (int d = 1; d <= 8; d++) {
+                int nc = col + dirCol[d], nr = row + dirRow[d];
+                if (nc < ws.col0 || nr < ws.row0 || nc >= ws.col1 || nr >= ws.row1) {
+                    continue;
+                }
+                int next = cell + dirStep[d];
+                if (cost[next] == 0 ||
+                    (dirCorner[d] && (cost[cell + dirCol[d]] == 0 || cost[cell + dirRow[d] * stride] == 0))) {
+                    continue;
+                }
+                uint32_t ng = g + dirCost[d] * (reverse ? cost[cell] : cost[next]);
+                int nIndex = (nr - ws.row0) * clusterSize + nc - ws.col0;
+                if (ws.stamp[nIndex] == ws.generation && ng >= ws.g[nIndex]) {
+                    continue;
+                }
+                ws.stamp[nIndex] = ws.generation;
+                ws.g[nIndex] = ng;
+                ws.parent[nIndex] = index;
+                uint32_t f = ng + (target >= 0 ? octile(nc - targetCol, nr - targetRow) : 0);
+                ws.heap.push_back(((uint64_t)f << 16) | (uint64_t)nIndex);
+                std::push_heap(ws.heap.begin(), ws.heap.end(), std::greater<uint64_t>());
+            }
+        }
+        return false;
+    }
+
+    // Custo guardado na última busca do cluster até cell; false se não chegou
+    bool reached(const LocalSearch &ws, int cell, uint32_t &g) const {
+        int col = colOf(cell), row = rowOf(cell);
+        if (col < ws.col0 || row < ws.row0 || col >= ws.col1 || row >= ws.row1) {
+            return false;
+        }
+        int index = (row - ws.row0) * clusterSize + col - ws.col0;
+        if (ws.stamp[index] != ws.generation) {
+            return false;
+        }
+        g = ws.g[index];
+        return true;
+    }
+
+    void rebuildCluster(LocalSearch &ws, int cluster) {
+        const std::vector<int> &list = clusterNodes[cluster];
+        for (int id : list) {
+            nodes[id].edges.clear();
+        }
+        for (int id : list) {
+            searchCluster(ws, cluster, nodes[id].cell, -1, false);
+            for (int other : list) {
+                uint32_t g;
+                if (other != id && reached(ws, nodes[other].cell, g)) {
+                    nodes[id].edges.push_back({ other, g });
+                }
+            }
+        }
+    }
+
+    void initLocal(LocalSearch &ws) const {
+        size_t cells = (size_t)clusterSize * clusterSize;
+        ws.g.assign(cells, 0);
+        ws.parent.assign(cells, -1);
+        ws.stamp.assign(cells, 0);
+        ws.generation = 0;
+    }
+
+    void markBorder(int border, int other) {
+        if (!borderDirty[border]) {
+            borderDirty[border] = 1;
+            dirtyBorders.push_back(border);
+        }
+        markCluster(other);
+    }
+
+    void markCluster(int cluster) {
+        if (!clusterDirty[cluster]) {
+            clusterDirty[cluster] = 1;
+            dirtyClusters.push_back(cluster);
+        }
+    }
+
+    // Passos da última busca local até target, somando o custo
+    void appendLocal(int target, std::vector<PathStep> &path) {
+        route.clear();
+        int index = (rowOf(target) - local.row0) * clusterSize + colOf(target) - local.col0;
+        for (; local.parent[index] >= 0; index = local.parent[index]) {
+            route.push_back(index);
+        }
+        int col = local.col0 + index % clusterSize, row = local.row0 + index / clusterSize;
+        for (size_t i = route.size(); i-- > 0;) {
+            int nc = local.col0 + route[i] % clusterSize, nr = local.row0 + route[i] / clusterSize;
+            int direction = dirOf[nc - col + 1][nr - row + 1];
+            lastCost += dirCost[direction] * cost[cellOf(nc, nr)];
+            path.push_back({ nc, nr, direction });
+            col = nc;
+            row = nr;
+        }
+    }
+
+public:
+    BasicHierarchicalPathfinder(BasicTileMap<Layout> *tilemap, const TileCostTable &table, const TilemapView *view,
+                                int clusterSize = 32) {
+        this->tilemap = tilemap;
+        this->table = table;
+        this->clusterSize = std::max(4, std::min(256, clusterSize));   // índice local em 16 bits
+        this->abstractGeneration = 0;
+        this->lastCost = 0;
+        this->stats = HierarchicalPathfinderStats();
+
+        minCost = 255;
+        for (int tile = 0; tile < 256; tile++) {
+            if (table.isWalkable(tile)) {
+                minCost = std::min(minCost, (unsigned)table.getCost(tile));
+            }
+        }
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                dirOf[i][j] = 0;
+            }
+        }
+        for (int d = 1; d <= 8; d++) {
+            int col = 0, row = 0;
+            view->computeTileWalking(col, row, d);
+            dirCol[d] = std::max(-1, std::min(1, col));
+            dirRow[d] = std::max(-1, std::min(1, row));
+            dirCost[d] = abs(dirCol[d]) + abs(dirRow[d]) == 1 ? STRAIGHT : DIAGONAL;
+            dirCorner[d] = dirCol[d] != 0 && dirRow[d] != 0;
+            dirOf[dirCol[d] + 1][dirRow[d] + 1] = d;
+        }
+
+        rebuild();
+        tilemap->addListener(this);
+    }
+
+    ~BasicHierarchicalPathfinder() {
+        tilemap->removeListener(this);
+    }
+
+    BasicHierarchicalPathfinder(const BasicHierarchicalPathfinder &) = delete;
+    BasicHierarchicalPathfinder &operator=(const BasicHierarchicalPathfinder &) = delete;
+
+    // Monta tudo de novo (depois de resize/load); os clusters em paralelo
+    void rebuild() {
+        width = tilemap->getWidth();
+        height = tilemap->getHeight();
+        stride = width + 2;
+        cost.assign((size_t)stride * (height + 2), TileCostTable::BLOCKED);
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                cost[cellOf(col, row)] = table.getCost(tilemap->getTile(col, row));
+            }
+        }
+        for (int d = 1; d <= 8; d++) {
+            dirStep[d] = dirCol[d] + dirRow[d] * stride;
+        }
+
+        clustersX = (width + clusterSize - 1) / clusterSize;
+        clustersY = (height + clusterSize - 1) / clusterSize;
+        int clusters = clustersX * clustersY;
+        int borders = verticalBorders() + (clustersY - 1) * clustersX;
+        nodes.clear();
+        freeNodes.clear();
+        clusterNodes.assign(clusters, std::vector<int>());
+        borderNodes.assign(borders, std::vector<int>());
+        borderDirty.assign(borders, 0);
+        clusterDirty.assign(clusters, 0);
+        dirtyBorders.clear();
+        dirtyClusters.clear();
+        for (int border = 0; border < borders; border++) {
+            scanBorder(border);
+        }
+
+        // cada thread calcula clusters inteiros (só mexe nos nós deles)
+        unsigned threads = std::max(1u, std::min(std::thread::hardware_concurrency(), 16u));
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back([this, t, threads, clusters]() {
+                LocalSearch ws;
+                initLocal(ws);
+                for (int cluster = (int)t; cluster < clusters; cluster += (int)threads) {
+                    rebuildCluster(ws, cluster);
+                }
+            });
+        }
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        stats.clusterRebuilds += clusters;
+        stats.borderRebuilds += borders;
+
+        initLocal(local);
+    }
+
+    void onTileChanged(int col, int row, unsigned char oldTile, unsigned char newTile) {
+        int cell = cellOf(col, row);
+        unsigned char after = table.getCost(newTile);
+        if (cost[cell] == after) {
+            return;
+        }
+        cost[cell] = after;
+        int cx = col / clusterSize, cy = row / clusterSize;
+        markCluster(cy * clustersX + cx);
+        // na beirada: a borda com o vizinho (e os nós dele) mudam também
+        if (col % clusterSize == 0 && cx > 0) {
+            markBorder(cy * (clustersX - 1) + cx - 1, cy * clustersX + cx - 1);
+        }
+        if (col % clusterSize == clusterSize - 1 && cx < clustersX - 1) {
+            markBorder(cy * (clustersX - 1) + cx, cy * clustersX + cx + 1);
+        }
+        if (row % clusterSize == 0 && cy > 0) {
+            markBorder(verticalBorders() + (cy - 1) * clustersX + cx, (cy - 1) * clustersX + cx);
+        }
+        if (row % clusterSize == clusterSize - 1 && cy < clustersY - 1) {
+            markBorder(verticalBorders() + cy * clustersX + cx, (cy + 1) * clustersX + cx);
+        }
+    }
+
+    // Refaz as bordas e os clusters marcados; devolve quantos clusters
+    int update() {
+        for (int border : dirtyBorders) {
+            removeBorder(border);
+            scanBorder(border);
+            borderDirty[border] = 0;
+        }
+        for (int cluster : dirtyClusters) {
+            rebuildCluster(local, cluster);
+            clusterDirty[cluster] = 0;
+        }
+        int rebuilt = (int)dirtyClusters.size();
+        stats.borderRebuilds += (long)dirtyBorders.size();
+        stats.clusterRebuilds += rebuilt;
+        dirtyBorders.clear();
+        dirtyClusters.clear();
+        return rebuilt;
+    }
+
+    bool isWalkable(int col, int row) const {
+        return col >= 0 && row >= 0 && col < width && row < height && cost[cellOf(col, row)] != TileCostTable::BLOCKED;
+    }
+
+    // Mesmo contrato do Pathfinder::findPath
+    bool findPath(int col0, int row0, int col1, int row1, std::vector<PathStep> &path) {
+        path.clear();
+        lastCost = 0;
+        stats.queries++;
+        if (col0 < 0 || row0 < 0 || col0 >= width || row0 >= height || !isWalkable(col1, row1)) {
+            return false;
+        }
+        update();
+        int start = cellOf(col0, row0), goal = cellOf(col1, row1);
+        if (start == goal) {
+            return true;
+        }
+        int startCluster = clusterOf(col0, row0), goalCluster = clusterOf(col1, row1);
+        if (startCluster == goalCluster) {
+            stats.localSearches++;
+            if (searchCluster(local, startCluster, start, goal, false)) {
+                appendLocal(goal, path);
+                return true;
+            }
+        }
+
+        // ligações do início e do fim com os nós dos seus clusters
+        int startId = (int)nodes.size(), goalId = startId + 1;
+        startEdges.clear();
+        stats.localSearches += 2;
+        searchCluster(local, startCluster, start, -1, false);
+        for (int id : clusterNodes[startCluster]) {
+            uint32_t g;
+            if (reached(local, nodes[id].cell, g)) {
+                startEdges.push_back({ id, g });
+            }
+        }
+        goalDist.resize(nodes.size(), UINT32_MAX);     // só os do cluster do fim são usados
+        searchCluster(local, goalCluster, goal, -1, true);
+        for (int id : clusterNodes[goalCluster]) {
+            uint32_t g;
+            if (reached(local, nodes[id].cell, g)) {
+                goalDist[id] = g;
+            }
+        }
+
+        // A* no grafo abstrato
+        size_t count = nodes.size() + 2;
+        if (abstractStamp.size() < count) {
+            abstractStamp.resize(count, 0);
+            abstractG.resize(count);
+            abstractParent.resize(count);
+        }
+        if (++abstractGeneration == 0) {
+            std::fill(abstractStamp.begin(), abstractStamp.end(), 0);
+            abstractGeneration = 1;
+        }
+        abstractHeap.clear();
+        int goalCol = col1, goalRow = row1;
+        auto relax = [&](int id, int from, uint32_t g) {
+            if (abstractStamp[id] == abstractGeneration && g >= abstractG[id]) {
+                return;
+            }
+            abstractStamp[id] = abstractGeneration;
+            abstractG[id] = g;
+            abstractParent[id] = from;
+            // início e fim são ids temporários, fora de nodes
+            int cell = id == startId ? start : (id == goalId ? goal : nodes[id].cell);
+            uint32_t h = octile(colOf(cell) - goalCol, rowOf(cell) - goalRow);
+            abstractHeap.push_back({ ((uint64_t)(g + h) << 32) | (0xFFFFFFFFu - g), id });
+            std::push_heap(abstractHeap.begin(), abstractHeap.end(), std::greater<std::pair<uint64_t, int>>());
+        };
+        relax(startId, -1, 0);
+        bool found = false;
+        while (!abstractHeap.empty()) {
+            std::pop_heap(abstractHeap.begin(), abstractHeap.end(), std::greater<std::pair<uint64_t, int>>());
+            std::pair<uint64_t, int> top = abstractHeap.back();
+            abstractHeap.pop_back();
+            int id = top.second;
+            uint32_t g = abstractG[id];
+            if ((uint32_t)top.first != 0xFFFFFFFFu - g) {
+                continue;
+            }
+            stats.abstractExpanded++;
+            if (id == goalId) {
+                found = true;
+                break;
+            }
+            if (id == startId) {
+                for (const AbstractEdge &edge : startEdges) {
+                    relax(edge.to, id, g + edge.cost);
+                }
+                continue;
+            }
+            const AbstractNode &node = nodes[id];
+            for (const AbstractEdge &edge : node.edges) {
+                relax(edge.to, id, g + edge.cost);
+            }
+            if (node.partner >= 0) {
+                relax(node.partner, id, g + node.partnerCost);
+            }
+            if (goalDist[id] != UINT32_MAX) {
+                relax(goalId, id, g + goalDist[id]);
+            }
+        }
+        for (int id : clusterNodes[goalCluster]) {
+            goalDist[id] = UINT32_MAX;
+        }
+        if (!found) {
+            return false;
+        }
+
+        // refino: busca local em cada trecho dentro de um cluster
+        abstractPath.clear();
+        for (int id = goalId; id != startId; id = abstractParent[id]) {
+            abstractPath.push_back(id);
+        }
+        int cell = start, cluster = startCluster;
+        for (size_t i = abstractPath.size(); i-- > 0;) {
+            int id = abstractPath[i];
+            int target = id == goalId ? goal : nodes[id].cell;
+            int targetCluster = id == goalId ? goalCluster : nodes[id].cluster;
+            if (target == cell) {
+                continue;
+            }
+            if (targetCluster != cluster) {
+                // atravessa a borda: um passo
+                int nc = colOf(target), nr = rowOf(target);
+                int direction = dirOf[nc - colOf(cell) + 1][nr - rowOf(cell) + 1];
+                lastCost += dirCost[direction] * cost[target];
+                path.push_back({ nc, nr, direction });
+            } else {
+                stats.localSearches++;
+                searchCluster(local, cluster, cell, target, false);
+                appendLocal(target, path);
+            }
+            cell = target;
+            cluster = targetCluster;
+        }
+        return true;
+    }
+
+    unsigned getLastCost() const {
+        return lastCost;
+    }
+
+    int getClusterSize() const {
+        return clusterSize;
+    }
+
+    int getNodeCount() const {
+        return (int)(nodes.size() - freeNodes.size());
+    }
+
+    long getEdgeCount() const {
+        long edges = 0;
+        for (const AbstractNode &node : nodes) {
+            if (node.alive) {
+                edges += (long)node.edges.size() + (node.partner >= 0 ? 1 : 0);
+            }
+        }
+        return edges;
+    }
+
+    const TileCostTable &getCostTable() const {
+        return table;
+    }
+
+    const HierarchicalPathfinderStats &getStats() const {
+        return stats;
+    }
+
+    void resetStats() {
+        stats = HierarchicalPathfinderStats();
+    }
+};
+
+typedef BasicHierarchicalPathfinder<RowMajorLayout> HierarchicalPathfinder;
+
+#endif /* HierarchicalPathfinder_h */
@@ -0,0 +1,665 @@
+//
+//  Pathfinder.h
+//  Caminhos sobre um TileMap: A*, jump point search e cache de caminhos
+//
+//  Os passos são as oito direções do TilemapView (DIRECTION_NORTH ...
+//  DIRECTION_SOUTHWEST): o deslocamento (col, row) de cada uma vem do próprio
+//  computeTileWalking, e o caminho devolvido diz a direção de cada passo, pronto
+//  para andar com computeTileWalking.
+//
+//  Custo de um passo: 10 para os passos retos no grid (só col ou só row muda em
+//  1) e 14 para os outros, vezes o custo do tile de destino (TileCostTable.h).
+//  Passos na diagonal do grid não cortam cantos: as duas células retas ao lado
+//  têm que estar livres.
+//
+//  Com as direções formando a vizinhança 8 do grid (DiamondView) e todos os
+//  tiles usados no mapa com o mesmo custo, a busca usa jump point search (só
+//  os pontos de salto entram na lista aberta); senão, A* com heurística octile
+//  (ou o mínimo de passos, para o SlideView). Os dois dão caminhos de mesmo
+//  custo (ótimos).
+//
+//  O custo por célula é copiado do mapa e mantido pelo setTile (listener), com
+//  uma borda bloqueada em volta para a busca não testar limites. A lista aberta
+//  é um heap binário com decrease-key sobre vetores do tamanho do mapa
+//  reaproveitados entre buscas (uma "geração" por busca dispensa limpá-los),
+//  então uma busca não aloca memória.
+//
+//  Cache: os últimos caminhos encontrados ficam guardados, e qualquer consulta
+//  cujo início e fim estão, nessa ordem, num caminho guardado é respondida com
+//  o trecho (trecho de caminho ótimo é ótimo), como um personagem que pede de
+//  novo o caminho para o mesmo destino no meio do trajeto. Um tile que fica
+//  mais caro descarta só os caminhos que passam por ele; um que fica mais
+//  barato descarta todos.
+//
+//  Exemplo:
+//    TileCostTable costs;
+//    costs.setBlocked(3);
+//    Pathfinder pathfinder(&tilemap, costs, &diamondView);
+//    std::vector<PathStep> path;
+//    if (pathfinder.findPath(col, row, destCol, destRow, path)) {
+//        for (const PathStep &step : path)
+//            diamondView.computeTileWalking(col, row, step.direction);
+//    }
+//
+//  Depois de TileMap::resize ou TileMapFile::load, chamar rebuild.
+//
+
+#ifndef Pathfinder_h
+#define Pathfinder_h
+
+#include "TileMap.h"
+#include "TilemapView.h"
+#include "TileCostTable.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+struct PathStep {
+    int col, row;
+    int direction;            // DIRECTION_* do passo que chega nesta célula
+};
+
+struct PathfinderStats {
+    long queries;
+    long cacheHits;           // respondidas com trecho de um caminho guardado
+    long jumpSearches;        // buscas com jump point search
+    long expanded;            // nós tirados da lista aberta
+};
+
+template <typename Layout>
+class BasicPathfinder : public TileMapListener {
+    static constexpr unsigned STRAIGHT = 10;
+    static constexpr unsigned DIAGONAL = 14;
+
+    BasicTileMap<Layout> *tilemap;
+    TileCostTable table;
+    int width, height;
+    int pad, stride;                  // borda bloqueada e largura com a borda
+    std::vector<unsigned char> cost;  // custo por célula (0: bloqueado)
+
+    // quantas células de cada tile: define se o mapa tem custo uniforme
+    long tileCount[256];
+    bool countsDirty;
+    bool uniform;
+    unsigned minCost;
+
+    // deslocamento de cada DIRECTION_* (índices 1..8)
+    int dirCol[9], dirRow[9], dirStep[9];
+    unsigned dirCost[9];
+    bool dirCorner[9];                // diagonal do grid: não corta cantos
+    int dirOf[3][3];                  // direção de (dc + 1, dr + 1), se grid8
+    bool grid8;                       // direções = vizinhança 8 do grid
+    int maxDc, maxDr;
+    unsigned minStepCost;
+
+    // estado da busca, do tamanho do mapa com a borda
+    struct HeapEntry {
+        uint64_t key;                 // f no alto, g invertido embaixo (desempate)
+        int cell;
+    };
+    // tudo o que a busca toca numa célula fica junto (uma linha de cache)
+    struct Node {
+        uint32_t stamp;               // geração da busca que usou o nó
+        uint32_t g;
+        int parent;
+        int heapPos;                  // posição no heap, -1 fora dele
+    };
+    std::vector<Node> nodes;
+    std::vector<HeapEntry> heap;
+    std::vector<int> jumpPoints;
+    uint32_t generation;
+    bool jumping;
+    int goalCol, goalRow;
+
+    struct CachedPath {
+        int start, goal;              // -1: entrada livre
+        uint64_t lastUse;
+        std::vector<PathStep> steps;
+        std::vector<uint32_t> costs;  // custo acumulado até cada célula (0: início)
+        std::vector<std::pair<int, int>> lookup;   // (célula, posição), ordenado
+    };
+    std::vector<CachedPath> cache;
+    size_t cacheCapacity;
+    uint64_t useClock;
+
+    bool useJumpPoints;
+    unsigned lastCost;
+    PathfinderStats stats;
+
+    int cellOf(int col, int row) const {
+        return (row + pad) * stride + col + pad;
+    }
+
+    int colOf(int cell) const {
+        return cell % stride - pad;
+    }
+
+    int rowOf(int cell) const {
+        return cell / stride - pad;
+    }
+
+    static int sign(int v) {
+        return (v > 0) - (v < 0);
+    }
+
+    void refreshCounts() {
+        if (!countsDirty) {
+            return;
+        }
+        minCost = 0;
+        uniform = true;
+        for (int tile = 0; tile < 256; tile++) {
+            unsigned c = table.getCost(tile);
+            if (tileCount[tile] == 0 || c == TileCostTable::BLOCKED) {
+                continue;
+            }
+            if (minCost != 0 && c != minCost) {
+                uniform = false;
+            }
+            minCost = minCost == 0 ? c : std::min(minCost, c);
+        }
+        if (minCost == 0) {
+            minCost = 1;
+        }
+        countsDirty = false;
+    }
+
+    unsigned heuristic(int col, int row) const {
+        int dc = abs(col - goalCol), dr = abs(row - goalRow);
+        if (grid8) {
+            int lo = std::min(dc, dr), hi = std::max(dc, dr);
+            return (STRAIGHT * (hi - lo) + DIAGONAL * lo) * minCost;
+        }
+        // mínimo de passos, cada um com o menor custo possível
+        int moves = std::max((dc + maxDc - 1) / maxDc, (dr + maxDr - 1) / maxDr);
+        return moves * minStepCost * minCost;
+    }
+
+    bool before(const HeapEntry &a, const HeapEntry &b) const {
+        return a.key < b.key;
+    }
+
+    void siftUp(int i) {
+        HeapEntry entry = heap[i];
+        while (i > 0) {
+            int up = (i - 1) / 2;
+            if (!before(entry, heap[up])) {
+                break;
+            }
+            heap[i] = heap[up];
+            nodes[heap[i].cell].heapPos = i;
+            i = up;
+        }
+        heap[i] = entry;
+        nodes[entry.cell].heapPos = i;
+    }
+
+    void siftDown(int i) {
+        HeapEntry entry = heap[i];
+        int n = (int)heap.size();
+        for (;;) {
+            int child = 2 * i + 1;
+            if (child >= n) {
+                break;
+            }
+            if (child + 1 < n && before(heap[child + 1], heap[child])) {
+                child++;
+            }
+            if (!before(heap[child], entry)) {
+                break;
+            }
+            heap[i] = heap[child];
+            nodes[heap[i].cell].heapPos = i;
+            i = child;
+        }
+        heap[i] = entry;
+        nodes[entry.cell].heapPos = i;
+    }
+
+    int pop() {
+        int cell = heap[0].cell;
+        nodes[cell].heapPos = -1;
+        HeapEntry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            siftDown(0);
+        }
+        return cell;
+    }
+
+    // Abre (ou melhora) a célula (col, row) com custo g vindo de from
+    void relax(int cell, int col, int row, int from, uint32_t g) {
+        Node &node = nodes[cell];
+        if (node.stamp == generation) {
+            if (g >= node.g) {
+                return;
+            }
+        } else {
+            node.stamp = generation;
+            node.heapPos = -1;
+        }
+        node.g = g;
+        node.parent = from;
+        HeapEntry entry = { ((uint64_t)(g + heuristic(col, row)) << 32) | (0xFFFFFFFFu - g), cell };
+        if (node.heapPos >= 0) {
+            heap[node.heapPos] = entry;
+            siftUp(node.heapPos);
+        } else {
+            heap.push_back(entry);
+            siftUp((int)heap.size() - 1);
+        }
+    }
+
+    void expandAll(int cell) {
+        uint32_t g = nodes[cell].g;
+        int col = colOf(cell), row = rowOf(cell);
+        for (int d = 1; d <= 8; d++) {
+            int next = cell + dirStep[d];
+            unsigned c = cost[next];
+            if (c == 0 || (dirCorner[d] && (cost[cell + dirCol[d]] == 0 || cost[cell + dirRow[d] * stride] == 0))) {
+                continue;
+            }
+            relax(next, col + dirCol[d], row + dirRow[d], cell, g + dirCost[d] * c);
+        }
+    }
+
+    // Salto reto a partir de cell; devolve o ponto de salto ou -1
+    int jumpStraight(int cell, int dc, int dr, int goal) const {
+        if (dc != 0) {
+            for (;;) {
+                cell += dc;
+                if (cost[cell] == 0) {
+                    return -1;
+                }
+                // vizinho forçado: livre acima/abaixo com o de trás bloqueado
+                if (cell == goal || (cost[cell + stride] && !cost[cell - dc + stride]) ||
+                    (cost[cell - stride] && !cost[cell - dc - stride])) {
+                    return cell;
+                }
+            }
+        }
+        int step = dr * stride;
+        for (;;) {
+            cell += step;
+            if (cost[cell] == 0) {
+                return -1;
+            }
+            if (cell == goal || (cost[cell + 1] && !cost[cell + 1 - step]) || (cost[cell - 1] && !cost[cell - 1 - step])) {
+                return cell;
+            }
+        }
+    }
+
+    // Salto na diagonal: para onde um dos saltos retos encontra algo
+    int jump(int cell, int dc, int dr, int goal) const {
+        if (dc == 0 || dr == 0) {
+            return jumpStraight(cell, dc, dr, goal);
+        }
+        int step = dc + dr * stride;
+        for (;;) {
+            if (cost[cell + dc] == 0 || cost[cell + dr * stride] == 0) {
+                return -1;
+            }
+            cell += step;
+            if (cost[cell] == 0) {
+                return -1;
+            }
+            if (cell == goal || jumpStraight(cell, dc, 0, goal) >= 0 || jumpStraight(cell, 0, dr, goal) >= 0) {
+                return cell;
+            }
+        }
+    }
+
+    void expandJumps(int cell, int goal) {
+        int candidates[8][2];
+        int count = 0;
+        int from = nodes[cell].parent;
+        if (from < 0) {
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    if (dc != 0 || dr != 0) {
+                        candidates[count][0] = dc;
+                        candidates[count++][1] = dr;
+                    }
+                }
+            }
+        } else {
+            int dc = sign(colOf(cell) - colOf(from)), dr = sign(rowOf(cell) - rowOf(from));
+            if (dc != 0 && dr != 0) {
+                int list[3][2] = { { dc, 0 }, { 0, dr }, { dc, dr } };
+                for (auto &c : list) {
+                    candidates[count][0] = c[0];
+                    candidates[count++][1] = c[1];
+                }
+            } else if (dc != 0) {
+                int list[5][2] = { { dc, 0 }, { 0, 1 }, { 0, -1 }, { dc, 1 }, { dc, -1 } };
+                for (auto &c : list) {
+                    candidates[count][0] = c[0];
+                    candidates[count++][1] = c[1];
+                }
+            } else {
+                int list[5][2] = { { 0, dr }, { 1, 0 }, { -1, 0 }, { 1, dr }, { -1, dr } };
+                for (auto &c : list) {
+                    candidates[count][0] = c[0];
+                    candidates[count++][1] = c[1];
+                }
+            }
+        }
+
+        uint32_t g = nodes[cell].g;
+        int col = colOf(cell), row = rowOf(cell);
+        for (int i = 0; i < count; i++) {
+            int point = jump(cell, candidates[i][0], candidates[i][1], goal);
+            if (point >= 0) {
+                int pointCol = colOf(point), pointRow = rowOf(point);
+                int dc = abs(pointCol - col), dr = abs(pointRow - row);
+                int lo = std::min(dc, dr), hi = std::max(dc, dr);
+                relax(point, pointCol, pointRow, cell, g + (STRAIGHT * (hi - lo) + DIAGONAL * lo) * minCost);
+            }
+        }
+    }
+
+    bool search(int start, int goal) {
+        if (++generation == 0) {
+            for (Node &node : nodes) {
+                node.stamp = 0;
+            }
+            generation = 1;
+        }
+        heap.clear();
+        goalCol = colOf(goal);
+        goalRow = rowOf(goal);
+        relax(start, colOf(start), rowOf(start), -1, 0);
+        while (!heap.empty()) {
+            int cell = pop();
+            stats.expanded++;
+            if (cell == goal) {
+                return true;
+            }
+            if (jumping) {
+                expandJumps(cell, goal);
+            } else {
+                expandAll(cell);
+            }
+        }
+        return false;
+    }
+
+    // Passos de start até goal pelos pais (pontos de salto viram linhas retas)
+    void reconstruct(int start, int goal, std::vector<PathStep> &path) {
+        jumpPoints.clear();
+        for (int cell = goal; cell != start; cell = nodes[cell].parent) {
+            jumpPoints.push_back(cell);
+        }
+        path.clear();
+        int cell = start;
+        for (size_t i = jumpPoints.size(); i-- > 0;) {
+            int next = jumpPoints[i];
+            if (jumping) {
+                int dc = sign(colOf(next) - colOf(cell)), dr = sign(rowOf(next) - rowOf(cell));
+                int direction = dirOf[dc + 1][dr + 1];
+                while (cell != next) {
+                    cell += dirStep[direction];
+                    path.push_back({ colOf(cell), rowOf(cell), direction });
+                }
+            } else {
+                int direction = 1;
+                while (direction < 8 && cell + dirStep[direction] != next) {
+                    direction++;
+                }
+                cell = next;
+                path.push_back({ colOf(cell), rowOf(cell), direction });
+            }
+        }
+    }
+
+    static int indexIn(const CachedPath &entry, int cell) {
+        auto it = std::lower_bound(entry.lookup.begin(), entry.lookup.end(), std::make_pair(cell, -1));
+        return it != entry.lookup.end() && it->first == cell ? it->second : -1;
+    }
+
+    bool lookupCache(int start, int goal, std::vector<PathStep> &path) {
+        for (CachedPath &entry : cache) {
+            if (entry.start < 0) {
+                continue;
+            }
+            int i = indexIn(entry, start);
+            int j = i < 0 ? -1 : indexIn(entry, goal);
+            if (j > i) {
+                path.assign(entry.steps.begin() + i, entry.steps.begin() + j);
+                lastCost = entry.costs[j] - entry.costs[i];
+                entry.lastUse = ++useClock;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void storeCache(int start, int goal, const std::vector<PathStep> &path) {
+        if (cacheCapacity == 0) {
+            return;
+        }
+        CachedPath *entry = nullptr;
+        if (cache.size() < cacheCapacity) {
+            cache.emplace_back();
+            entry = &cache.back();
+        } else {
+            entry = &cache[0];
+            for (CachedPath &e : cache) {
+                if (e.start < 0) {
+                    entry = &e;
+                    break;
+                }
+                if (e.lastUse < entry->lastUse) {
+                    entry = &e;
+                }
+            }
+        }
+        entry->start = start;
+        entry->goal = goal;
+        entry->lastUse = ++useClock;
+        entry->steps.assign(path.begin(), path.end());
+        entry->costs.resize(path.size() + 1);
+        entry->lookup.resize(path.size() + 1);
+        entry->costs[0] = 0;
+        entry->lookup[0] = std::make_pair(start, 0);
+        for (size_t i = 0; i < path.size(); i++) {
+            int cell = cellOf(path[i].col, path[i].row);
+            entry->costs[i + 1] = entry->costs[i] + dirCost[path[i].direction] * cost[cell];
+            entry->lookup[i + 1] = std::make_pair(cell, (int)i + 1);
+        }
+        std::sort(entry->lookup.begin(), entry->lookup.end());
+    }
+
+public:
+    BasicPathfinder(BasicTileMap<Layout> *tilemap, const TileCostTable &table, const TilemapView *view) {
+        this->tilemap = tilemap;
+        this->table = table;
+        this->generation = 0;
+        this->jumping = false;
+        this->cacheCapacity = 64;
+        this->useClock = 0;
+        this->useJumpPoints = true;
+        this->lastCost = 0;
+        this->stats = PathfinderStats();
+
+        // deslocamentos de cada direção, tirados do próprio view
+        grid8 = true;
+        maxDc = maxDr = 1;
+        minStepCost = DIAGONAL;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                dirOf[i][j] = 0;
+            }
+        }
+        for (int d = 1; d <= 8; d++) {
+            int col = 0, row = 0;
+            view->computeTileWalking(col, row, d);
+            dirCol[d] = col;
+            dirRow[d] = row;
+            maxDc = std::max(maxDc, abs(col));
+            maxDr = std::max(maxDr, abs(row));
+            dirCost[d] = abs(col) + abs(row) == 1 ? STRAIGHT : DIAGONAL;
+            dirCorner[d] = abs(col) == 1 && abs(row) == 1;
+            minStepCost = std::min(minStepCost, dirCost[d]);
+            if (abs(col) <= 1 && abs(row) <= 1 && (col != 0 || row != 0) && dirOf[col + 1][row + 1] == 0) {
+                dirOf[col + 1][row + 1] = d;
+            } else {
+                grid8 = false;
+            }
+        }
+        pad = std::max(maxDc, maxDr);
+
+        rebuild();
+        tilemap->addListener(this);
+    }
+
+    ~BasicPathfinder() {
+        tilemap->removeListener(this);
+    }
+
+    BasicPathfinder(const BasicPathfinder &) = delete;
+    BasicPathfinder &operator=(const BasicPathfinder &) = delete;
+
+    // Relê o mapa inteiro (depois de resize/load ou de trocar a tabela)
+    void rebuild() {
+        width = tilemap->getWidth();
+        height = tilemap->getHeight();
+        stride = width + 2 * pad;
+        size_t cells = (size_t)stride * (height + 2 * pad);
+        cost.assign(cells, TileCostTable::BLOCKED);
+        std::fill(tileCount, tileCount + 256, 0);
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                int tile = tilemap->getTile(col, row);
+                cost[cellOf(col, row)] = table.getCost(tile);
+                tileCount[tile]++;
+            }
+        }
+        countsDirty = true;
+        for (int d = 1; d <= 8; d++) {
+            dirStep[d] = dirCol[d] + dirRow[d] * stride;
+        }
+
+        nodes.assign(cells, Node());
+        heap.reserve(std::min(cells, (size_t)1 << 16));
+        generation = 0;
+        clearCache();
+    }
+
+    void setCostTable(const TileCostTable &table) {
+        this->table = table;
+        rebuild();
+    }
+
+    const TileCostTable &getCostTable() const {
+        return table;
+    }
+
+    void onTileChanged(int col, int row, unsigned char oldTile, unsigned char newTile) {
+        tileCount[oldTile]--;
+        tileCount[newTile]++;
+        countsDirty = true;
+        int cell = cellOf(col, row);
+        unsigned before = cost[cell], after = table.getCost(newTile);
+        if (before == after) {
+            return;
+        }
+        cost[cell] = (unsigned char)after;
+        if (after == TileCostTable::BLOCKED || (before != TileCostTable::BLOCKED && after > before)) {
+            // mais caro: só os caminhos que passam pela célula deixam de valer.
+            // Bloqueada, ela vira canto dos passos diagonais entre os seus
+            // vizinhos de lado, então os caminhos que passam por eles também
+            const int around[4] = { 1, -1, stride, -stride };
+            bool blocked = after == TileCostTable::BLOCKED;
+            for (CachedPath &entry : cache) {
+                if (entry.start < 0) {
+                    continue;
+                }
+                bool stale = indexIn(entry, cell) >= 0;
+                for (int k = 0; blocked && !stale && k < 4; k++) {
+                    stale = indexIn(entry, cell + around[k]) >= 0;
+                }
+                if (stale) {
+                    entry.start = -1;
+                }
+            }
+        } else {
+            clearCache();
+        }
+    }
+
+    bool isWalkable(int col, int row) const {
+        return col >= 0 && row >= 0 && col < width && row < height && cost[cellOf(col, row)] != TileCostTable::BLOCKED;
+    }
+
+    // Caminho de (col0, row0) até (col1, row1), sem a célula inicial; false se
+    // não há caminho. path é reaproveitado entre chamadas
+    bool findPath(int col0, int row0, int col1, int row1, std::vector<PathStep> &path) {
+        path.clear();
+        lastCost = 0;
+        stats.queries++;
+        if (col0 < 0 || row0 < 0 || col0 >= width || row0 >= height || !isWalkable(col1, row1)) {
+            return false;
+        }
+        int start = cellOf(col0, row0), goal = cellOf(col1, row1);
+        if (start == goal) {
+            return true;
+        }
+        if (lookupCache(start, goal, path)) {
+            stats.cacheHits++;
+            return true;
+        }
+
+        refreshCounts();
+        jumping = useJumpPoints && grid8 && uniform;
+        if (jumping) {
+            stats.jumpSearches++;
+        }
+        if (!search(start, goal)) {
+            return false;
+        }
+        reconstruct(start, goal, path);
+        lastCost = nodes[goal].g;
+        storeCache(start, goal, path);
+        return true;
+    }
+
+    // Custo do último caminho encontrado
+    unsigned getLastCost() const {
+        return lastCost;
+    }
+
+    // false: sempre A* (para comparar)
+    void setJumpPoints(bool enabled) {
+        useJumpPoints = enabled;
+    }
+
+    // Quantos caminhos o cache guarda (0 desliga)
+    void setCacheSize(size_t capacity) {
+        cacheCapacity = capacity;
+        cache.resize(std::min(cache.size(), capacity));
+    }
+
+    void clearCache() {
+        for (CachedPath &entry : cache) {
+            entry.start = -1;
+        }
+    }
+
+    const PathfinderStats &getStats() const {
+        return stats;
+    }
+
+    void resetStats() {
+        stats = PathfinderStats();
+    }
+};
+
+typedef BasicPathfinder<RowMajorLayout> Pathfinder;
+
+#endif /* Pathfinder_h */
@@ -30,6 +30,12 @@ public:
 
     }
     
+    // x = col * tw + row * tw/2 e y = row * th/2, resolvido para col e row
+    void computeTilePosition(const float x, const float y, const float tw, const float th, float &col, float &row) const {
+        row = 2.0f * y / th;
+        col = x / tw - y / th;
+    }
+    
     void computeTileWalking(int &col, int &row, const int direction) const {
         switch(direction){
             case DIRECTION_NORTH: 
@@ -0,0 +1,325 @@
+//
+//  StreamingTileMap.h
+//  TileMap lido sob demanda de um arquivo .tmap (TileMapFile.h)
+//
+//  O arquivo é mapeado na memória (MappedFile.h) e só o cabeçalho e o índice
+//  são lidos no open, então um mundo de 16k x 16k abre na hora. Os chunks são
+//  descomprimidos quando alguma célula deles é acessada e ficam num cache LRU
+//  de tamanho fixo (maxChunks); o menos usado sai quando falta lugar. Assim a
+//  memória fica limitada pelo cache, não pelo tamanho do mapa.
+//
+//  Chunks alterados por setTile que saem do cache são comprimidos de novo e
+//  guardados à parte (só os alterados, já comprimidos); save grava o mapa com
+//  as alterações.
+//
+//  Mesma interface de acesso do TileMap (getTile, setTile, listeners). O
+//  prefetch carrega de uma vez os chunks de uma região, tipicamente a área da
+//  câmera mais uma margem.
+//
+//  Exemplo:
+//    StreamingTileMap world(256);            // até 256 chunks descomprimidos
+//    if (world.open("mundo.tmap")) {
+//        world.prefetch(col0, row0, col1, row1);
+//        int tile = world.getTile(col, row);
+//    }
+//
+
+#ifndef StreamingTileMap_h
+#define StreamingTileMap_h
+
+#include "TileMap.h"        // TileMapListener
+#include "TileMapFile.h"
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <filesystem>
+#include <cstdio>
+
+struct StreamingTileMapStats {
+    long loads;                  // chunks descomprimidos
+    long evictions;              // chunks que saíram do cache
+    long writeBacks;             // ... dos quais alterados (comprimidos de novo)
+    size_t peakResidentBytes;
+};
+
+class StreamingTileMap {
+    struct Slot {
+        int chunk;               // -1: livre
+        int width;               // largura do chunk (menor na borda)
+        bool dirty;
+        int prev, next;          // lista LRU (head = mais recente)
+        std::vector<unsigned char> cells;
+    };
+
+    struct Edited {
+        int encoding, value;
+        std::vector<unsigned char> data;
+    };
+
+    MappedFile file;
+    TileMapHeader header;
+    std::vector<TileMapChunkEntry> entries;
+    std::vector<Slot> slots;
+    std::vector<int> slotOf;     // chunk -> slot ou -1
+    std::unordered_map<int, Edited> edited;
+    size_t editedBytes;
+    size_t cellBytes;            // soma das células dos slots ocupados
+    int maxChunks, used;
+    int head, tail;
+    int lastChunk, lastSlot;     // atalho para acessos seguidos no mesmo chunk
+    std::vector<TileMapListener*> listeners;
+    StreamingTileMapStats stats;
+
+    void unlink(int s) {
+        Slot &slot = slots[s];
+        if (slot.prev >= 0) slots[slot.prev].next = slot.next; else head = slot.next;
+        if (slot.next >= 0) slots[slot.next].prev = slot.prev; else tail = slot.prev;
+        slot.prev = slot.next = -1;
+    }
+
+    void pushFront(int s) {
+        slots[s].prev = -1;
+        slots[s].next = head;
+        if (head >= 0) slots[head].prev = s;
+        head = s;
+        if (tail < 0) tail = s;
+    }
+
+    void evict(int s) {
+        Slot &slot = slots[s];
+        if (slot.dirty) {
+            Edited &e = edited[slot.chunk];
+            editedBytes -= e.data.size();
+            e.encoding = TileMapFile::encodeChunk(slot.cells.data(), (int)slot.cells.size(), e.data, e.value);
+            editedBytes += e.data.size();
+            stats.writeBacks++;
+        }
+        slotOf[slot.chunk] = -1;
+        slot.chunk = -1;
+        slot.dirty = false;
+        stats.evictions++;
+        lastChunk = -1;
+    }
+
+    // Slot com o chunk descomprimido (carrega e despeja o LRU se preciso)
+    int acquire(int chunk) {
+        if (chunk == lastChunk) {
+            return lastSlot;
+        }
+        int s = slotOf[chunk];
+        if (s >= 0) {
+            unlink(s);
+            pushFront(s);
+        } else {
+            if (used < maxChunks) {
+                s = used++;
+            } else {
+                s = tail;
+                evict(s);
+                unlink(s);
+            }
+            int cx = chunk % header.chunksX(), cy = chunk / header.chunksX();
+            Slot &slot = slots[s];
+            slot.chunk = chunk;
+            slot.width = header.chunkWidth(cx);
+            cellBytes -= slot.cells.size();
+            slot.cells.resize((size_t)slot.width * header.chunkHeight(cy));
+            auto found = edited.find(chunk);
+            bool ok;
+            if (found != edited.end()) {
+                TileMapChunkEntry e = { 0, (uint32_t)found->second.data.size(), found->second.encoding, found->second.value };
+                ok = TileMapFile::decodeChunk(e, found->second.data.data(), slot.cells.data(), (int)slot.cells.size());
+            } else {
+                const TileMapChunkEntry &e = entries[chunk];
+                ok = TileMapFile::decodeChunk(e, file.data() + e.offset, slot.cells.data(), (int)slot.cells.size());
+            }
+            if (!ok) {
+                // chunk corrompido: vira tile 0 em vez de derrubar o jogo
+                fprintf(stderr, "StreamingTileMap: chunk %d invalido\n", chunk);
+                std::fill(slot.cells.begin(), slot.cells.end(), 0);
+            }
+            cellBytes += slot.cells.size();
+            slotOf[chunk] = s;
+            pushFront(s);
+            stats.loads++;
+            stats.peakResidentBytes = std::max(stats.peakResidentBytes, getResidentBytes());
+        }
+        lastChunk = chunk;
+        lastSlot = s;
+        return s;
+    }
+
+    int chunkOf(int col, int row) const {
+        return (row / header.chunkSize) * header.chunksX() + col / header.chunkSize;
+    }
+
+    unsigned char &cell(int s, int col, int row) {
+        Slot &slot = slots[s];
+        return slot.cells[(row % header.chunkSize) * slot.width + col % header.chunkSize];
+    }
+
+public:
+    explicit StreamingTileMap(int maxChunks = 256) {
+        this->maxChunks = std::max(1, maxChunks);
+        this->header = TileMapHeader();
+        this->editedBytes = 0;
+        this->cellBytes = 0;
+        this->used = 0;
+        this->head = this->tail = -1;
+        this->lastChunk = this->lastSlot = -1;
+        this->stats = StreamingTileMapStats();
+    }
+
+    StreamingTileMap(const StreamingTileMap &) = delete;
+    StreamingTileMap &operator=(const StreamingTileMap &) = delete;
+
+    // Mapeia o arquivo e lê só o índice; false se não existe ou é inválido
+    bool open(const std::string &path) {
+        close();
+        if (!file.open(path)) {
+            return false;
+        }
+        if (!TileMapFile::parse(file.data(), file.size(), header, entries)) {
+            fprintf(stderr, "Invalid tilemap %s\n", path.c_str());
+            close();
+            return false;
+        }
+        slots.assign(maxChunks, Slot());
+        for (Slot &slot : slots) {
+            slot.chunk = -1;
+            slot.width = 0;
+            slot.dirty = false;
+            slot.prev = slot.next = -1;
+        }
+        slotOf.assign(entries.size(), -1);
+        return true;
+    }
+
+    void close() {
+        file.close();
+        entries.clear();
+        slots.clear();
+        slotOf.clear();
+        edited.clear();
+        editedBytes = 0;
+        cellBytes = 0;
+        used = 0;
+        head = tail = -1;
+        lastChunk = lastSlot = -1;
+        header = TileMapHeader();
+    }
+
+    bool isOpen() const {
+        return file.isOpen();
+    }
+
+    int getTile(int col, int row) {
+        return cell(acquire(chunkOf(col, row)), col, row);
+    }
+
+    void setTile(int col, int row, unsigned char tile) {
+        int s = acquire(chunkOf(col, row));
+        unsigned char &value = cell(s, col, row);
+        unsigned char old = value;
+        if (old == tile) {
+            return;
+        }
+        value = tile;
+        slots[s].dirty = true;
+        for (TileMapListener *listener : listeners) {
+            listener->onTileChanged(col, row, old, tile);
+        }
+    }
+
+    // Carrega os chunks que cobrem as células [col0, col1] x [row0, row1]
+    // (recortadas ao mapa); devolve quantos não estavam no cache
+    int prefetch(int col0, int row0, int col1, int row1) {
+        col0 = std::max(col0, 0);
+        row0 = std::max(row0, 0);
+        col1 = std::min(col1, header.width - 1);
+        row1 = std::min(row1, header.height - 1);
+        long before = stats.loads;
+        for (int cy = row0 / header.chunkSize; cy <= row1 / header.chunkSize && row0 <= row1; cy++) {
+            for (int cx = col0 / header.chunkSize; cx <= col1 / header.chunkSize && col0 <= col1; cx++) {
+                acquire(cy * header.chunksX() + cx);
+            }
+        }
+        return (int)(stats.loads - before);
+    }
+
+    // Grava o mapa com as alterações. Chunks intocados são copiados do arquivo
+    // aberto sem descomprimir. Grava num .tmp e renomeia, então path pode ser o
+    // próprio arquivo aberto (exceto no Windows, que não renomeia sobre um
+    // arquivo mapeado)
+    bool save(const std::string &path) {
+        TileMapFile::Writer writer;
+        std::string temp = path + ".tmp";
+        if (!writer.open(temp, header)) {
+            return false;
+        }
+        for (int chunk = 0; chunk < (int)entries.size(); chunk++) {
+            int s = slotOf[chunk];
+            auto found = edited.find(chunk);
+            if (s >= 0 && slots[s].dirty) {
+                writer.writeCells(slots[s].cells.data(), (int)slots[s].cells.size());
+            } else if (found != edited.end()) {
+                writer.writeChunk(found->second.encoding, found->second.value, found->second.data.data(), found->second.data.size());
+            } else {
+                const TileMapChunkEntry &e = entries[chunk];
+                writer.writeChunk(e.encoding, e.value, file.data() + e.offset, e.bytes);
+            }
+        }
+        if (!writer.close()) {
+            return false;
+        }
+        std::error_code error;
+        std::filesystem::rename(temp, path, error);
+        return !error;
+    }
+
+    void addListener(TileMapListener *listener) {
+        listeners.push_back(listener);
+    }
+
+    void removeListener(TileMapListener *listener) {
+        listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+    }
+
+    int getWidth() const {
+        return header.width;
+    }
+
+    int getHeight() const {
+        return header.height;
+    }
+
+    int getChunkSize() const {
+        return header.chunkSize;
+    }
+
+    int getTileSet() const {
+        return header.tileset;
+    }
+
+    float getZ() const {
+        return header.z;
+    }
+
+    int getResidentChunks() const {
+        return used;
+    }
+
+    // Chunks descomprimidos + alterações guardadas + índice
+    size_t getResidentBytes() const {
+        return cellBytes + editedBytes + entries.size() * sizeof(TileMapChunkEntry) + slotOf.size() * sizeof(int);
+    }
+
+    const StreamingTileMapStats &getStats() const {
+        return stats;
+    }
+};
+
+#endif /* StreamingTileMap_h */
@@ -0,0 +1,321 @@
+//
+//  TileBitPlanes.h
+//  Bit-planes das propriedades do TileProperties.h sobre um TileMap inteiro
+//
+//  Para cada TileFlag (andável, opaco, animado), um bit por célula, linha a
+//  linha (wordsPerRow palavras de 64 bits por linha, bit col & 63). Os planes
+//  são montados a partir do mapa e mantidos pelo setTile (listener), então
+//  uma pergunta sobre uma região lê 1 bit por célula em vez de um byte do
+//  mapa mais uma consulta à tabela.
+//
+//  Consultas num retângulo [col0, col1) x [row0, row1) (recortado ao mapa):
+//  any, all e count de uma flag. Em cada linha, as palavras das pontas levam
+//  máscara e as do meio são lidas de 2 ou 4 em 4 com SIMD (o mesmo backend do
+//  maths_simd.h: AVX2, SSE2, NEON ou escalar com MATHS_NO_SIMD); count soma
+//  popcounts (bits por byte e _mm_sad_epu8 no x86, vcnt no NEON).
+//
+//  Exemplo:
+//    TileBitPlanes planes(&tilemap, props);
+//    if (planes.anyBlocked(col, row, col + 3, row + 3)) ...   // não cabe
+//    long free = planes.countWalkable(0, 0, 64, 64);
+//
+//  Depois de TileMap::resize ou TileMapFile::load, chamar rebuild.
+//
+
+#ifndef TileBitPlanes_h
+#define TileBitPlanes_h
+
+#include "TileMap.h"
+#include "TileProperties.h"
+#include "maths_simd.h"
+
+#include <vector>
+#include <bitset>
+#include <algorithm>
+#include <cstdint>
+
+template <typename Layout>
+class BasicTileBitPlanes : public TileMapListener {
+    BasicTileMap<Layout> *tilemap;
+    TileProperties props;
+    int width, height, wordsPerRow;
+    std::vector<uint64_t> planes[TILE_FLAG_COUNT];
+
+    static long popcount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(word);
+#else
+        return (long)std::bitset<64>(word).count();
+#endif
+    }
+
+    // Palavras inteiras [p, p + n) -------------------------------------------
+
+    static bool anyWords(const uint64_t *p, int n) {
+        int i = 0;
+        uint64_t acc = 0;
+#if defined(MATHS_SIMD_AVX2)
+        __m256i v = _mm256_setzero_si256();
+        for (; i + 4 <= n; i += 4) {
+            v = _mm256_or_si256(v, _mm256_loadu_si256((const __m256i *)(p + i)));
+        }
+        if (!_mm256_testz_si256(v, v)) {
+            return true;
+        }
+#elif defined(MATHS_SIMD_SSE)
+        __m128i v = _mm_setzero_si128();
+        for (; i + 2 <= n; i += 2) {
+            v = _mm_or_si128(v, _mm_loadu_si128((const __m128i *)(p + i)));
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xFFFF) {
+            return true;
+        }
+#elif defined(MATHS_SIMD_NEON)
+        uint64x2_t v = vdupq_n_u64(0);
+        for (; i + 2 <= n; i += 2) {
+            v = vorrq_u64(v, vld1q_u64(p + i));
+        }
+        acc = vgetq_lane_u64(v, 0) | vgetq_lane_u64(v, 1);
+#endif
+        for (; i < n; i++) {
+            acc |= p[i];
+        }
+        return acc != 0;
+    }
+
+    static bool allWords(const uint64_t *p, int n) {
+        int i = 0;
+        uint64_t acc = ~(uint64_t)0;
+#if defined(MATHS_SIMD_AVX2)
+        __m256i ones = _mm256_set1_epi64x(-1), v = ones;
+        for (; i + 4 <= n; i += 4) {
+            v = _mm256_and_si256(v, _mm256_loadu_si256((const __m256i *)(p + i)));
+        }
+        if (!_mm256_testc_si256(v, ones)) {
+            return false;
+        }
+#elif defined(MATHS_SIMD_SSE)
+        __m128i ones = _mm_set1_epi32(-1), v = ones;
+        for (; i + 2 <= n; i += 2) {
+            v = _mm_and_si128(v, _mm_loadu_si128((const __m128i *)(p + i)));
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, ones)) != 0xFFFF) {
+            return false;
+        }
+#elif defined(MATHS_SIMD_NEON)
+        uint64x2_t v = vdupq_n_u64(~(uint64_t)0);
+        for (; i + 2 <= n; i += 2) {
+            v = vandq_u64(v, vld1q_u64(p + i));
+        }
+        acc = vgetq_lane_u64(v, 0) & vgetq_lane_u64(v, 1);
+#endif
+        for (; i < n; i++) {
+            acc &= p[i];
+        }
+        return acc == ~(uint64_t)0;
+    }
+
+    static long countWords(const uint64_t *p, int n) {
+        int i = 0;
+        long total = 0;
+#if defined(MATHS_SIMD_AVX2)
+        // popcount de cada byte por tabela de 4 bits (vpshufb), somado com sad
+        const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                               0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low = _mm256_set1_epi8(0x0f);
+        __m256i sum = _mm256_setzero_si256();
+        for (; i + 4 <= n; i += 4) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+            __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(v, low)),
+                                            _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+            sum = _mm256_add_epi64(sum, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+        }
+        uint64_t lanes[4];
+        _mm256_storeu_si256((__m256i *)lanes, sum);
+        total = (long)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#elif defined(MATHS_SIMD_SSE)
+        // popcount de cada byte só com SSE2 (somas de 1, 2 e 4 bits), somado com sad
+        const __m128i m1 = _mm_set1_epi8(0x55), m2 = _mm_set1_epi8(0x33), m4 = _mm_set1_epi8(0x0f);
+        __m128i sum = _mm_setzero_si128();
+        for (; i + 2 <= n; i += 2) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+            v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi64(v, 1), m1));
+            v = _mm_add_epi8(_mm_and_si128(v, m2), _mm_and_si128(_mm_srli_epi64(v, 2), m2));
+            v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi64(v, 4)), m4);
+            sum = _mm_add_epi64(sum, _mm_sad_epu8(v, _mm_setzero_si128()));
+        }
+        total = _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(sum, sum));
+#elif defined(MATHS_SIMD_NEON)
+        uint64x2_t sum = vdupq_n_u64(0);
+        for (; i + 2 <= n; i += 2) {
+            uint8x16_t bytes = vcntq_u8(vreinterpretq_u8_u64(vld1q_u64(p + i)));
+            sum = vaddq_u64(sum, vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(bytes))));
+        }
+        total = (long)(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+#endif
+        for (; i < n; i++) {
+            total += popcount(p[i]);
+        }
+        return total;
+    }
+
+    // Recorta o retângulo ao mapa; false se ficou vazio
+    bool clip(int &col0, int &row0, int &col1, int &row1) const {
+        col0 = std::max(col0, 0);
+        row0 = std::max(row0, 0);
+        col1 = std::min(col1, width);
+        row1 = std::min(row1, height);
+        return col0 < col1 && row0 < row1;
+    }
+
+    void writeCell(int col, int row, int tile) {
+        size_t word = (size_t)row * wordsPerRow + (col >> 6);
+        uint64_t bit = (uint64_t)1 << (col & 63);
+        for (int flag = 0; flag < TILE_FLAG_COUNT; flag++) {
+            if (props.has((TileFlag)flag, tile)) {
+                planes[flag][word] |= bit;
+            } else {
+                planes[flag][word] &= ~bit;
+            }
+        }
+    }
+
+public:
+    BasicTileBitPlanes(BasicTileMap<Layout> *tilemap, const TileProperties &props) {
+        this->tilemap = tilemap;
+        this->props = props;
+        rebuild();
+        tilemap->addListener(this);
+    }
+
+    ~BasicTileBitPlanes() {
+        tilemap->removeListener(this);
+    }
+
+    BasicTileBitPlanes(const BasicTileBitPlanes &) = delete;
+    BasicTileBitPlanes &operator=(const BasicTileBitPlanes &) = delete;
+
+    // Relê o mapa inteiro (depois de resize/load ou de trocar a tabela)
+    void rebuild() {
+        width = tilemap->getWidth();
+        height = tilemap->getHeight();
+        wordsPerRow = (width + 63) / 64;
+        for (int flag = 0; flag < TILE_FLAG_COUNT; flag++) {
+            planes[flag].assign((size_t)wordsPerRow * height, 0);
+        }
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                writeCell(col, row, tilemap->getTile(col, row));
+            }
+        }
+    }
+
+    void setProperties(const TileProperties &props) {
+        this->props = props;
+        rebuild();
+    }
+
+    const TileProperties &getProperties() const {
+        return props;
+    }
+
+    void onTileChanged(int col, int row, unsigned char oldTile, unsigned char newTile) {
+        writeCell(col, row, newTile);
+    }
+
+    bool test(TileFlag flag, int col, int row) const {
+        if (col < 0 || row < 0 || col >= width || row >= height) {
+            return false;
+        }
+        return (planes[flag][(size_t)row * wordsPerRow + (col >> 6)] >> (col & 63)) & 1;
+    }
+
+    // Alguma célula do retângulo tem a flag
+    bool any(TileFlag flag, int col0, int row0, int col1, int row1) const {
+        if (!clip(col0, row0, col1, row1)) {
+            return false;
+        }
+        int w0 = col0 >> 6, w1 = (col1 - 1) >> 6;
+        uint64_t first = ~(uint64_t)0 << (col0 & 63), last = ~(uint64_t)0 >> (63 - ((col1 - 1) & 63));
+        for (int row = row0; row < row1; row++) {
+            const uint64_t *line = &planes[flag][(size_t)row * wordsPerRow];
+            if (w0 == w1) {
+                if (line[w0] & first & last) {
+                    return true;
+                }
+            } else if ((line[w0] & first) || (line[w1] & last) || anyWords(line + w0 + 1, w1 - w0 - 1)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Todas as células do retângulo têm a flag (vazio: true)
+    bool all(TileFlag flag, int col0, int row0, int col1, int row1) const {
+        if (!clip(col0, row0, col1, row1)) {
+            return true;
+        }
+        int w0 = col0 >> 6, w1 = (col1 - 1) >> 6;
+        uint64_t first = ~(uint64_t)0 << (col0 & 63), last = ~(uint64_t)0 >> (63 - ((col1 - 1) & 63));
+        for (int row = row0; row < row1; row++) {
+            const uint64_t *line = &planes[flag][(size_t)row * wordsPerRow];
+            if (w0 == w1) {
+                if (~line[w0] & first & last) {
+                    return false;
+                }
+            } else if ((~line[w0] & first) || (~line[w1] & last) || !allWords(line + w0 + 1, w1 - w0 - 1)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Quantas células do retângulo têm a flag
+    long count(TileFlag flag, int col0, int row0, int col1, int row1) const {
+        if (!clip(col0, row0, col1, row1)) {
+            return 0;
+        }
+        int w0 = col0 >> 6, w1 = (col1 - 1) >> 6;
+        uint64_t first = ~(uint64_t)0 << (col0 & 63), last = ~(uint64_t)0 >> (63 - ((col1 - 1) & 63));
+        long total = 0;
+        for (int row = row0; row < row1; row++) {
+            const uint64_t *line = &planes[flag][(size_t)row * wordsPerRow];
+            if (w0 == w1) {
+                total += popcount(line[w0] & first & last);
+            } else {
+                total += popcount(line[w0] & first) + popcount(line[w1] & last) +
+                         countWords(line + w0 + 1, w1 - w0 - 1);
+            }
+        }
+        return total;
+    }
+
+    bool isWalkable(int col, int row) const {
+        return test(TILE_WALKABLE, col, row);
+    }
+
+    // Alguma célula bloqueada no retângulo; sair do mapa também conta
+    bool anyBlocked(int col0, int row0, int col1, int row1) const {
+        if (col0 < 0 || row0 < 0 || col1 > width || row1 > height) {
+            return true;
+        }
+        return !all(TILE_WALKABLE, col0, row0, col1, row1);
+    }
+
+    long countWalkable(int col0, int row0, int col1, int row1) const {
+        return count(TILE_WALKABLE, col0, row0, col1, row1);
+    }
+
+    // Plane de uma flag: wordsPerRow palavras por linha
+    const std::vector<uint64_t> &getPlane(TileFlag flag) const {
+        return planes[flag];
+    }
+
+    int getWordsPerRow() const {
+        return wordsPerRow;
+    }
+};
+
+typedef BasicTileBitPlanes<RowMajorLayout> TileBitPlanes;
+
+#endif /* TileBitPlanes_h */
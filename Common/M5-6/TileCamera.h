@@ -0,0 +1,192 @@
+//
+//  TileCamera.h
+//  Câmera com rolagem sobre um tilemap e recorte das células visíveis
+//
+//  A câmera é um retângulo de width x height pixels no espaço de desenho do
+//  TilemapView (a mesma origem do computeDrawPosition), com o canto inferior
+//  esquerdo em (x, y). Uma célula é visível quando o retângulo tw x th que o
+//  computeDrawPosition dá para ela cruza a tela.
+//
+//  computeVisibleSpans devolve, para cada linha do mapa que aparece na tela,
+//  o intervalo exato de colunas visíveis: no losango (DiamondView) a área
+//  visível é um paralelogramo no espaço (col, row), e o retângulo envolvente
+//  teria o dobro de células. As linhas vêm dos cantos da tela levados para
+//  (col, row) com computeTilePosition (inverso de computeDrawPosition); as
+//  colunas de cada linha, das duas desigualdades de x e y. O custo depende só
+//  do tamanho da tela, não do mapa.
+//
+//  Funciona com qualquer TilemapView em que a posição de desenho seja afim em
+//  (col, row), como o DiamondView e o SlideView.
+//
+//  Exemplo:
+//    TileCamera camera(&diamondView, TILE_WIDTH, TILE_HEIGHT, mapWidth, mapHeight);
+//    camera.setViewport(800, 600);
+//    camera.setPosition(-tile_inicial_x, -tile_inicial_y);
+//    camera.computeVisibleSpans(spans);      // só as células na tela
+//    mapMesh.draw(spans);
+//
+
+#ifndef TileCamera_h
+#define TileCamera_h
+
+#include "TilemapView.h"
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// Colunas [col0, col1) visíveis na linha row
+struct TileSpan {
+    int row;
+    int col0, col1;
+};
+
+class TileCamera {
+    const TilemapView *view;
+    float tw, th;
+    int mapWidth, mapHeight;
+    double x, y;                 // canto inferior esquerdo da tela no espaço de desenho
+    double width, height;
+
+    // posição de desenho = origem + col * colStep + row * rowStep
+    double originX, originY;
+    double colStepX, colStepY, rowStepX, rowStepY;
+
+    // Inteiros c com lo < a * c + k < hi (a pode ser 0); false se nenhum
+    static bool solve(double a, double k, double lo, double hi, double &cMin, double &cMax) {
+        if (a == 0.0) {
+            cMin = -1e18;
+            cMax = 1e18;
+            return k > lo && k < hi;
+        }
+        double c0 = (lo - k) / a, c1 = (hi - k) / a;
+        if (a < 0.0) {
+            std::swap(c0, c1);
+        }
+        // estritamente entre c0 e c1
+        cMin = std::floor(c0) + 1.0;
+        cMax = std::ceil(c1) - 1.0;
+        return cMin <= cMax;
+    }
+
+public:
+    TileCamera(const TilemapView *view, float tw, float th, int mapWidth, int mapHeight) {
+        this->view = view;
+        this->tw = tw;
+        this->th = th;
+        this->mapWidth = mapWidth;
+        this->mapHeight = mapHeight;
+        this->x = this->y = 0.0;
+        this->width = this->height = 0.0;
+
+        // passos de uma coluna e de uma linha, tirados do próprio view
+        float x0, y0, x1, y1, x2, y2;
+        view->computeDrawPosition(0, 0, tw, th, x0, y0);
+        view->computeDrawPosition(1, 0, tw, th, x1, y1);
+        view->computeDrawPosition(0, 1, tw, th, x2, y2);
+        this->originX = x0;
+        this->originY = y0;
+        this->colStepX = x1 - x0;
+        this->colStepY = y1 - y0;
+        this->rowStepX = x2 - x0;
+        this->rowStepY = y2 - y0;
+    }
+
+    void setViewport(float width, float height) {
+        this->width = width;
+        this->height = height;
+    }
+
+    void setMapSize(int mapWidth, int mapHeight) {
+        this->mapWidth = mapWidth;
+        this->mapHeight = mapHeight;
+    }
+
+    void setPosition(double x, double y) {
+        this->x = x;
+        this->y = y;
+    }
+
+    void move(double dx, double dy) {
+        this->x += dx;
+        this->y += dy;
+    }
+
+    // Centraliza a tela no centro da célula
+    void centerOn(int col, int row) {
+        x = originX + col * colStepX + row * rowStepX + tw / 2.0 - width / 2.0;
+        y = originY + col * colStepY + row * rowStepY + th / 2.0 - height / 2.0;
+    }
+
+    double getX() const {
+        return x;
+    }
+
+    double getY() const {
+        return y;
+    }
+
+    // Ponto da tela (pixels a partir do canto inferior esquerdo) em (col, row)
+    // fracionários
+    void screenToTile(float sx, float sy, float &col, float &row) const {
+        view->computeTilePosition((float)(x + sx), (float)(y + sy), tw, th, col, row);
+    }
+
+    // Retângulo envolvente das células visíveis, [col0, col1) x [row0, row1)
+    // recortado ao mapa; false se a tela não mostra nenhuma célula
+    bool computeVisibleRange(int &col0, int &row0, int &col1, int &row1) const {
+        // cantos da tela aumentada em um tile para baixo e para a esquerda: uma
+        // célula é visível se o seu canto cai nessa área
+        float cx[4], cy[4];
+        float left = (float)(x - tw), bottom = (float)(y - th);
+        float right = (float)(x + width), top = (float)(y + height);
+        view->computeTilePosition(left, bottom, tw, th, cx[0], cy[0]);
+        view->computeTilePosition(right, bottom, tw, th, cx[1], cy[1]);
+        view->computeTilePosition(left, top, tw, th, cx[2], cy[2]);
+        view->computeTilePosition(right, top, tw, th, cx[3], cy[3]);
+        float minC = *std::min_element(cx, cx + 4), maxC = *std::max_element(cx, cx + 4);
+        float minR = *std::min_element(cy, cy + 4), maxR = *std::max_element(cy, cy + 4);
+        // margem de uma célula para o arredondamento em coordenadas grandes
+        col0 = std::max(0, (int)std::floor(minC) - 1);
+        row0 = std::max(0, (int)std::floor(minR) - 1);
+        col1 = std::min(mapWidth, (int)std::ceil(maxC) + 2);
+        row1 = std::min(mapHeight, (int)std::ceil(maxR) + 2);
+        return col0 < col1 && row0 < row1;
+    }
+
+    // Intervalos exatos de colunas visíveis em cada linha; devolve o total de
+    // células. spans é reaproveitado entre frames (sem alocar depois do primeiro)
+    long computeVisibleSpans(std::vector<TileSpan> &spans) const {
+        spans.clear();
+        int col0, row0, col1, row1;
+        if (!computeVisibleRange(col0, row0, col1, row1)) {
+            return 0;
+        }
+        long cells = 0;
+        for (int row = row0; row < row1; row++) {
+            // x - tw < desenhoX < x + width e y - th < desenhoY < y + height
+            double kx = originX + row * rowStepX, ky = originY + row * rowStepY;
+            double minX, maxX, minY, maxY;
+            if (!solve(colStepX, kx, x - tw, x + width, minX, maxX) ||
+                !solve(colStepY, ky, y - th, y + height, minY, maxY)) {
+                continue;
+            }
+            int c0 = (int)std::max((double)col0, std::max(minX, minY));
+            int c1 = (int)std::min((double)col1 - 1, std::min(maxX, maxY)) + 1;
+            if (c0 < c1) {
+                spans.push_back({ row, c0, c1 });
+                cells += c1 - c0;
+            }
+        }
+        return cells;
+    }
+
+    bool isVisible(int col, int row) const {
+        double dx = originX + col * colStepX + row * rowStepX;
+        double dy = originY + col * colStepY + row * rowStepY;
+        return col >= 0 && row >= 0 && col < mapWidth && row < mapHeight &&
+               dx > x - tw && dx < x + width && dy > y - th && dy < y + height;
+    }
+};
+
+#endif /* TileCamera_h */
@@ -0,0 +1,48 @@
+//
+//  TileCostTable.h
+//  Custo de atravessar cada tile do tileset (usado pelo Pathfinder.h)
+//
+//  Uma entrada por id de tile (0..255): 0 é bloqueado, 1 é o custo normal e
+//  valores maiores deixam o tile mais caro (lama, água rasa, ...). O custo é o
+//  de entrar na célula.
+//
+//  Exemplo (tilesetIso.png):
+//    TileCostTable costs;           // tudo com custo 1
+//    costs.setBlocked(3);           // lava
+//    costs.setBlocked(5);           // água funda
+//    costs.setCost(4, 3);           // água rasa
+//
+
+#ifndef TileCostTable_h
+#define TileCostTable_h
+
+class TileCostTable {
+    unsigned char costs[256];
+
+public:
+    static constexpr unsigned char BLOCKED = 0;
+
+    TileCostTable(unsigned char defaultCost = 1) {
+        for (int i = 0; i < 256; i++) {
+            costs[i] = defaultCost;
+        }
+    }
+
+    void setCost(int tile, unsigned char cost) {
+        costs[tile & 0xff] = cost;
+    }
+
+    void setBlocked(int tile) {
+        costs[tile & 0xff] = BLOCKED;
+    }
+
+    unsigned char getCost(int tile) const {
+        return costs[tile & 0xff];
+    }
+
+    bool isWalkable(int tile) const {
+        return costs[tile & 0xff] != BLOCKED;
+    }
+};
+
+#endif /* TileCostTable_h */
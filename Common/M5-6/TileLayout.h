@@ -0,0 +1,164 @@
+//
+//  TileLayout.h
+//  Ordem das células de um TileMap na memória (parâmetro de template do
+//  BasicTileMap, ver TileMap.h)
+//
+//  RowMajorLayout  linha a linha (o layout original): ótimo para varrer linhas
+//                  inteiras, ruim para vizinhos de cima/baixo em mapas largos
+//  TiledLayout     blocos de 16x16 (256 bytes, 4 linhas de cache) em ordem
+//                  linha a linha de blocos, cada bloco linha a linha
+//  MortonLayout    curva Z (bits de col e row intercalados) dentro de blocos
+//                  quadrados de até 256x256: todo quadrado alinhado de lado
+//                  2^k fica contíguo, então vizinhos em qualquer direção
+//                  costumam estar na mesma linha de cache
+//
+//  Cada layout diz o tamanho da alocação (com as bordas arredondadas para
+//  blocos inteiros), o índice de (col, row), o índice da célula à direita
+//  (dentro de um bloco da iteração, sem recalcular tudo) e o tamanho do bloco
+//  que a iteração por região percorre de uma vez (BasicTileMap::region).
+//
+
+#ifndef TileLayout_h
+#define TileLayout_h
+
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+
+class RowMajorLayout {
+    int width;
+
+public:
+    static const char *name() {
+        return "row-major";
+    }
+
+    // Aloca e devolve quantas células
+    size_t init(int w, int h) {
+        width = w;
+        return (size_t)w * h;
+    }
+
+    size_t index(int col, int row) const {
+        return col + (size_t)row * width;
+    }
+
+    size_t nextCol(size_t index) const {
+        return index + 1;
+    }
+
+    // Bloco da iteração por região: a linha inteira
+    int walkWidth() const {
+        return INT_MAX;
+    }
+
+    int walkHeight() const {
+        return 1;
+    }
+};
+
+class TiledLayout {
+    int tilesX;
+
+public:
+    static const int SHIFT = 4;
+    static const int SIDE = 1 << SHIFT;      // 16
+    static const int MASK = SIDE - 1;
+
+    static const char *name() {
+        return "tiled-16";
+    }
+
+    size_t init(int w, int h) {
+        tilesX = (w + MASK) >> SHIFT;
+        int tilesY = (h + MASK) >> SHIFT;
+        return (size_t)tilesX * tilesY * SIDE * SIDE;
+    }
+
+    size_t index(int col, int row) const {
+        size_t tile = (size_t)(row >> SHIFT) * tilesX + (col >> SHIFT);
+        return (tile << (2 * SHIFT)) + ((row & MASK) << SHIFT) + (col & MASK);
+    }
+
+    size_t nextCol(size_t index) const {
+        return index + 1;
+    }
+
+    int walkWidth() const {
+        return SIDE;
+    }
+
+    int walkHeight() const {
+        return SIDE;
+    }
+};
+
+class MortonLayout {
+    int shift;                 // lado do bloco = 1 << shift (até 256)
+    int mask;
+    int blocksX;
+
+    // 0b abcd -> 0b 0a0b0c0d (col e row dentro do bloco têm até 8 bits)
+    struct SpreadTable {
+        uint16_t value[256];
+
+        constexpr SpreadTable() : value() {
+            for (uint32_t x = 0; x < 256; x++) {
+                uint32_t v = (x | (x << 4)) & 0x0F0Fu;
+                v = (v | (v << 2)) & 0x3333u;
+                v = (v | (v << 1)) & 0x5555u;
+                value[x] = (uint16_t)v;
+            }
+        }
+    };
+
+    static uint32_t spread(uint32_t x) {
+        static constexpr SpreadTable table;
+        return table.value[x];
+    }
+
+    static const size_t X_BITS = 0x5555u;    // bits de col no índice dentro do bloco
+
+public:
+    static const int MAX_SHIFT = 8;
+
+    static const char *name() {
+        return "morton";
+    }
+
+    size_t init(int w, int h) {
+        // bloco do tamanho do mapa (potência de 2) para mapas pequenos, sem
+        // desperdiçar memória; 256x256 para os grandes
+        int side = w > h ? w : h;
+        shift = 0;
+        while ((1 << shift) < side && shift < MAX_SHIFT) {
+            shift++;
+        }
+        mask = (1 << shift) - 1;
+        blocksX = (w + mask) >> shift;
+        int blocksY = (h + mask) >> shift;
+        return ((size_t)blocksX * blocksY) << (2 * shift);
+    }
+
+    size_t index(int col, int row) const {
+        size_t block = (size_t)(row >> shift) * blocksX + (col >> shift);
+        return (block << (2 * shift)) + (spread(col & mask) | (spread(row & mask) << 1));
+    }
+
+    // Soma 1 só nos bits de col (não sai do bloco de 16x16 da iteração)
+    size_t nextCol(size_t index) const {
+        size_t low = index & 0xFFu;
+        return (index & ~(size_t)0xFFu) | ((((low | ~X_BITS) + 1) & X_BITS & 0xFFu) | (low & ~X_BITS & 0xFFu));
+    }
+
+    // quadrados de 16x16 alinhados são contíguos na curva Z
+    int walkWidth() const {
+        return shift < 4 ? 1 << shift : 16;
+    }
+
+    int walkHeight() const {
+        return walkWidth();
+    }
+};
+
+#endif /* TileLayout_h */
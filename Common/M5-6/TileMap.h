@@ -1,34 +1,83 @@
-class TileMap {
+#ifndef TileMap_h
+#define TileMap_h
+
+#include "TileLayout.h"
+
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+// Quem precisa saber quando um tile muda (malha da GPU, caches, ...) se registra
+// no TileMap e é avisado a cada setTile que realmente troca o valor da célula
+class TileMapListener {
+public:
+    virtual ~TileMapListener() {}
+    virtual void onTileChanged(int col, int row, unsigned char oldTile, unsigned char newTile) = 0;
+};
+
+// Célula devolvida pelos iteradores do BasicTileMap (só leitura: alterações
+// passam pelo setTile, que avisa os listeners)
+struct TileCell {
+    int col, row;
+    unsigned char tile;
+};
+
+// Layout: ordem das células na memória (RowMajorLayout, TiledLayout ou
+// MortonLayout, ver TileLayout.h). TileMap é o layout linha a linha original
+template <typename Layout>
+class BasicTileMap {
     float z;               // caso de eventual de vários tilemaps sobrepostos
     unsigned int tid;      // indicação do tileset utilizado
     int width, height;     // dimensões da matriz
     unsigned char *map; // mapa com ids dos tiles que formam o cenário
+    size_t cells;          // células alocadas (com as bordas dos blocos do layout)
+    Layout layout;
+    std::vector<TileMapListener*> listeners;
 
     
 public:
-    TileMap(int w, int h, unsigned char initWith) {
-        this->map = new unsigned char [w*h];
+    BasicTileMap(int w, int h, unsigned char initWith) {
+        this->cells = this->layout.init(w, h);
+        this->map = new unsigned char [this->cells];
         this->width = w;
         this->height = h;
         this->z = 0.0f;
         this->tid = 0;
+        memset(this->map, initWith, this->cells);
+    }
+
+    ~BasicTileMap() {
+        delete [] this->map;
     }
+
+    BasicTileMap(const BasicTileMap &tm) = delete;
+    BasicTileMap &operator=(const BasicTileMap &tm) = delete;
     
-//    TileMap(const TileMap &tm) {
-//        map = new unsigned char[tm.width * tm.height];
-//        this->width = tm.width;
-//        this->height = tm.height;
-//        this->z = tm.z;
-//        this->tid = tm.tid;
-////        for (int i=0; this->width * this->height; i++) {
-////            this->map[i] = tm.map[i];
-////        }
-//        memcpy(this->map, tm.map, tm.width*tm.height);
-//    }
+    // Novas dimensões, todas as células com initWith (usado ao ler de arquivo,
+    // ver TileMapFile.h); os listeners não são avisados
+    void resize(int w, int h, unsigned char initWith) {
+        delete [] this->map;
+        this->cells = this->layout.init(w, h);
+        this->map = new unsigned char [this->cells];
+        this->width = w;
+        this->height = h;
+        memset(this->map, initWith, this->cells);
+    }
     
+    // Células na ordem do Layout (linha a linha só no TileMap)
     unsigned char* getMap() {
         return this->map;
     }
+
+    // Acesso direto, sem avisar os listeners (para carregar ou gerar o mapa)
+    unsigned char &at(int col, int row) {
+        return this->map[this->layout.index(col, row)];
+    }
+
+    const Layout &getLayout() const {
+        return this->layout;
+    }
     
     int getWidth() {
         return this->width;
@@ -38,12 +87,28 @@ public:
         return this->height;
     }
     
-    int getTile(int col, int row) {
-        return this->map[col + row * this->width];
+    int getTile(int col, int row) const {
+        return this->map[this->layout.index(col, row)];
     }
     
     void setTile(int col, int row, unsigned char tile) {
-        this->map[col + row * this->width] = tile;
+        unsigned char &cell = this->map[this->layout.index(col, row)];
+        unsigned char old = cell;
+        if (old == tile) {
+            return;
+        }
+        cell = tile;
+        for (TileMapListener *listener : this->listeners) {
+            listener->onTileChanged(col, row, old, tile);
+        }
+    }
+
+    void addListener(TileMapListener *listener) {
+        this->listeners.push_back(listener);
+    }
+
+    void removeListener(TileMapListener *listener) {
+        this->listeners.erase(std::remove(this->listeners.begin(), this->listeners.end(), listener), this->listeners.end());
     }
     
     int getTileSet() {
@@ -61,6 +126,121 @@ public:
     void setTid(int tid) {
         this->tid = tid;
     }
+
+    // Percorre as células de [col0, col1) x [row0, row1) bloco a bloco, na
+    // ordem em que estão na memória: linhas inteiras no row-major, quadrados
+    // de 16x16 no tiled e no morton. Dentro de cada bloco, linha a linha
+    class RegionIterator {
+        const BasicTileMap *tilemap;
+        int col0, col1, row1;      // região
+        int bx, by, bx1, by1;      // bloco atual, recortado à região
+        int col, row;
+        size_t index;              // de (col, row) no layout
+
+        // Fim do bloco que começa em x (blocos alinhados à grade do layout)
+        static int blockEnd(int x, int side, int limit) {
+            long long end = ((long long)x / side + 1) * side;
+            return end < limit ? (int)end : limit;
+        }
+
+    public:
+        RegionIterator(const BasicTileMap *tilemap, int col0, int row0, int col1, int row1) {
+            this->tilemap = tilemap;
+            this->col0 = col0;
+            this->col1 = col1;
+            this->row1 = row1;
+            this->bx = this->col = col0;
+            this->by = this->row = row0;
+            if (col0 >= col1 || row0 >= row1) {
+                this->col = -1;      // região vazia: já no fim
+                this->row = row1;
+                return;
+            }
+            this->bx1 = blockEnd(col0, tilemap->layout.walkWidth(), col1);
+            this->by1 = blockEnd(row0, tilemap->layout.walkHeight(), row1);
+            this->index = tilemap->layout.index(col0, row0);
+        }
+
+        TileCell operator*() const {
+            TileCell cell = { col, row, tilemap->map[index] };
+            return cell;
+        }
+
+        RegionIterator &operator++() {
+            if (++col < bx1) {
+                index = tilemap->layout.nextCol(index);
+                return *this;
+            }
+            col = bx;
+            if (++row < by1) {
+                index = tilemap->layout.index(col, row);
+                return *this;
+            }
+            // próximo bloco na mesma faixa, ou primeiro bloco da faixa seguinte
+            bx = bx1;
+            if (bx >= col1) {
+                bx = col0;
+                by = by1;
+                if (by >= row1) {
+                    col = -1;
+                    row = row1;
+                    return *this;
+                }
+                by1 = blockEnd(by, tilemap->layout.walkHeight(), row1);
+            }
+            bx1 = blockEnd(bx, tilemap->layout.walkWidth(), col1);
+            col = bx;
+            row = by;
+            index = tilemap->layout.index(col, row);
+            return *this;
+        }
+
+        bool operator==(const RegionIterator &other) const {
+            return col == other.col && row == other.row;
+        }
+
+        bool operator!=(const RegionIterator &other) const {
+            return !(*this == other);
+        }
+    };
+
+    class Region {
+        const BasicTileMap *tilemap;
+        int col0, row0, col1, row1;
+
+    public:
+        Region(const BasicTileMap *tilemap, int col0, int row0, int col1, int row1) {
+            this->tilemap = tilemap;
+            this->col0 = col0;
+            this->row0 = row0;
+            this->col1 = col1;
+            this->row1 = row1;
+        }
+
+        RegionIterator begin() const {
+            return RegionIterator(tilemap, col0, row0, col1, row1);
+        }
+
+        RegionIterator end() const {
+            return RegionIterator(tilemap, col0, row1, col0, row1);
+        }
+    };
+
+    // for (TileCell cell : tilemap.region(col0, row0, col1, row1)) { ... }
+    // (recortada ao mapa; col1 e row1 exclusivos)
+    Region region(int col0, int row0, int col1, int row1) const {
+        return Region(this, std::max(col0, 0), std::max(row0, 0), std::min(col1, width), std::min(row1, height));
+    }
+
+    // Todas as células, na ordem da memória
+    Region all() const {
+        return region(0, 0, width, height);
+    }
     
 };
 
+typedef BasicTileMap<RowMajorLayout> TileMap;
+typedef BasicTileMap<TiledLayout> TiledTileMap;
+typedef BasicTileMap<MortonLayout> MortonTileMap;
+
+#endif /* TileMap_h */
@@ -0,0 +1,322 @@
+//
+//  TileMapFile.h
+//  Formato binário de tilemap em chunks (.tmap)
+//
+//  O mapa é dividido em chunks quadrados de chunkSize x chunkSize células
+//  (os da borda direita/inferior podem ser menores), gravados em ordem
+//  linha a linha de chunks, cada um comprimido à parte. Uma tabela de índice
+//  logo depois do cabeçalho diz onde cada chunk começa, então quem lê o arquivo
+//  (StreamingTileMap.h) só precisa tocar nos chunks que usa.
+//
+//  Layout (little-endian):
+//    "TMAP", u32 versão (1), u32 largura, u32 altura, u32 chunkSize,
+//    u32 tileset, f32 z, u32 número de chunks
+//    índice: por chunk u64 offset, u32 bytes, u8 codificação, u8 valor, u16 0
+//    dados dos chunks
+//  Codificações:
+//    TMAP_UNIFORM  chunk todo com "valor", sem bytes (água, grama, ...)
+//    TMAP_RLE      pares (repetições - 1, tile), linha a linha dentro do chunk
+//    TMAP_RAW      células cruas, quando o RLE não ajuda
+//
+//  Exemplo:
+//    TileMapFile::save(tilemap, "mapa.tmap");
+//    TileMapFile::load("mapa.tmap", tilemap);    // redimensiona o tilemap
+//
+
+#ifndef TileMapFile_h
+#define TileMapFile_h
+
+#include "TileMap.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+enum TileMapEncoding {
+    TMAP_UNIFORM = 0,
+    TMAP_RLE = 1,
+    TMAP_RAW = 2
+};
+
+struct TileMapHeader {
+    int width, height;
+    int chunkSize;
+    int tileset;
+    float z;
+
+    int chunksX() const {
+        return (width + chunkSize - 1) / chunkSize;
+    }
+
+    int chunksY() const {
+        return (height + chunkSize - 1) / chunkSize;
+    }
+
+    int chunkCount() const {
+        return chunksX() * chunksY();
+    }
+
+    // Dimensões do chunk (cx, cy), menores na borda
+    int chunkWidth(int cx) const {
+        return std::min(chunkSize, width - cx * chunkSize);
+    }
+
+    int chunkHeight(int cy) const {
+        return std::min(chunkSize, height - cy * chunkSize);
+    }
+};
+
+struct TileMapChunkEntry {
+    uint64_t offset;
+    uint32_t bytes;
+    int encoding;        // TileMapEncoding
+    int value;           // tile do TMAP_UNIFORM
+};
+
+class TileMapFile {
+public:
+    static const int HEADER_BYTES = 32;
+    static const int ENTRY_BYTES = 16;
+
+    // Comprime as células de um chunk; devolve a codificação escolhida
+    static int encodeChunk(const unsigned char *cells, int count, std::vector<unsigned char> &out, int &value) {
+        out.clear();
+        value = count > 0 ? cells[0] : 0;
+        bool uniform = true;
+        for (int i = 1; i < count && uniform; i++) {
+            uniform = cells[i] == cells[0];
+        }
+        if (uniform) {
+            return TMAP_UNIFORM;
+        }
+        for (int i = 0; i < count;) {
+            int run = 1;
+            while (i + run < count && run < 256 && cells[i + run] == cells[i]) {
+                run++;
+            }
+            out.push_back((unsigned char)(run - 1));
+            out.push_back(cells[i]);
+            i += run;
+            if ((int)out.size() >= count) {
+                out.assign(cells, cells + count);
+                return TMAP_RAW;
+            }
+        }
+        return TMAP_RLE;
+    }
+
+    // Descomprime para count células; false se os dados não fecham
+    static bool decodeChunk(const TileMapChunkEntry &entry, const unsigned char *data, unsigned char *cells, int count) {
+        switch (entry.encoding) {
+        case TMAP_UNIFORM:
+            memset(cells, entry.value, count);
+            return true;
+        case TMAP_RAW:
+            if ((int)entry.bytes != count) {
+                return false;
+            }
+            memcpy(cells, data, count);
+            return true;
+        case TMAP_RLE: {
+            int filled = 0;
+            for (uint32_t i = 0; i + 1 < entry.bytes; i += 2) {
+                int run = data[i] + 1;
+                if (filled + run > count) {
+                    return false;
+                }
+                memset(cells + filled, data[i + 1], run);
+                filled += run;
+            }
+            return filled == count;
+        }
+        default:
+            return false;
+        }
+    }
+
+    static void put32(unsigned char *p, uint32_t value) {
+        p[0] = value & 0xff;
+        p[1] = (value >> 8) & 0xff;
+        p[2] = (value >> 16) & 0xff;
+        p[3] = value >> 24;
+    }
+
+    static uint32_t get32(const unsigned char *p) {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    // Cabeçalho e índice a partir do início do arquivo; false se inválido
+    static bool parse(const unsigned char *data, size_t size, TileMapHeader &header,
+                      std::vector<TileMapChunkEntry> &entries) {
+        if (size < HEADER_BYTES || memcmp(data, "TMAP", 4) != 0 || get32(data + 4) != 1) {
+            return false;
+        }
+        header.width = (int)get32(data + 8);
+        header.height = (int)get32(data + 12);
+        header.chunkSize = (int)get32(data + 16);
+        header.tileset = (int)get32(data + 20);
+        uint32_t zBits = get32(data + 24);
+        memcpy(&header.z, &zBits, sizeof(float));
+        uint32_t count = get32(data + 28);
+        if (header.width <= 0 || header.height <= 0 || header.chunkSize <= 0 || header.chunkSize > 4096 ||
+            (int)count != header.chunkCount() || size < HEADER_BYTES + (size_t)count * ENTRY_BYTES) {
+            return false;
+        }
+
+        entries.resize(count);
+        const unsigned char *p = data + HEADER_BYTES;
+        for (uint32_t i = 0; i < count; i++, p += ENTRY_BYTES) {
+            TileMapChunkEntry &e = entries[i];
+            e.offset = get32(p) | ((uint64_t)get32(p + 4) << 32);
+            e.bytes = get32(p + 8);
+            e.encoding = p[12];
+            e.value = p[13];
+            if (e.offset > size || e.bytes > size - e.offset) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Grava chunk por chunk, já comprimidos, em ordem; o índice vai no final
+    // para o começo do arquivo. Só um chunk fica na memória por vez
+    class Writer {
+        std::ofstream out;
+        TileMapHeader header;
+        std::vector<TileMapChunkEntry> entries;
+        uint64_t offset;
+
+    public:
+        bool open(const std::string &path, const TileMapHeader &header) {
+            this->header = header;
+            this->entries.clear();
+            this->offset = HEADER_BYTES + (uint64_t)header.chunkCount() * ENTRY_BYTES;
+            out.open(path, std::ios::binary | std::ios::trunc);
+            std::vector<char> zeros((size_t)offset, 0);
+            out.write(zeros.data(), zeros.size());
+            return (bool)out;
+        }
+
+        void writeChunk(int encoding, int value, const unsigned char *data, size_t bytes) {
+            entries.push_back({ offset, (uint32_t)bytes, encoding, value });
+            out.write((const char *)data, bytes);
+            offset += bytes;
+        }
+
+        // Comprime e grava as células do próximo chunk
+        void writeCells(const unsigned char *cells, int count) {
+            std::vector<unsigned char> encoded;
+            int value;
+            int encoding = encodeChunk(cells, count, encoded, value);
+            writeChunk(encoding, value, encoded.data(), encoded.size());
+        }
+
+        bool close() {
+            if ((int)entries.size() != header.chunkCount()) {
+                out.close();
+                return false;
+            }
+            unsigned char head[HEADER_BYTES];
+            memcpy(head, "TMAP", 4);
+            put32(head + 4, 1);
+            put32(head + 8, header.width);
+            put32(head + 12, header.height);
+            put32(head + 16, header.chunkSize);
+            put32(head + 20, header.tileset);
+            uint32_t zBits;
+            memcpy(&zBits, &header.z, sizeof(float));
+            put32(head + 24, zBits);
+            put32(head + 28, (uint32_t)entries.size());
+
+            std::vector<unsigned char> index(entries.size() * ENTRY_BYTES, 0);
+            for (size_t i = 0; i < entries.size(); i++) {
+                unsigned char *p = &index[i * ENTRY_BYTES];
+                put32(p, (uint32_t)entries[i].offset);
+                put32(p + 4, (uint32_t)(entries[i].offset >> 32));
+                put32(p + 8, entries[i].bytes);
+                p[12] = (unsigned char)entries[i].encoding;
+                p[13] = (unsigned char)entries[i].value;
+            }
+            out.seekp(0);
+            out.write((const char *)head, HEADER_BYTES);
+            out.write((const char *)index.data(), index.size());
+            out.close();
+            return !out.fail();
+        }
+    };
+
+    // Grava um mapa gerado célula a célula (sem precisar dele inteiro na memória)
+    static bool save(const std::string &path, const TileMapHeader &header,
+                     const std::function<unsigned char(int col, int row)> &tileAt) {
+        Writer writer;
+        if (!writer.open(path, header)) {
+            return false;
+        }
+        std::vector<unsigned char> cells;
+        for (int cy = 0; cy < header.chunksY(); cy++) {
+            for (int cx = 0; cx < header.chunksX(); cx++) {
+                int cw = header.chunkWidth(cx), ch = header.chunkHeight(cy);
+                cells.resize((size_t)cw * ch);
+                for (int r = 0; r < ch; r++) {
+                    for (int c = 0; c < cw; c++) {
+                        cells[r * cw + c] = tileAt(cx * header.chunkSize + c, cy * header.chunkSize + r);
+                    }
+                }
+                writer.writeCells(cells.data(), (int)cells.size());
+            }
+        }
+        return writer.close();
+    }
+
+    template <typename Layout>
+    static bool save(BasicTileMap<Layout> &tilemap, const std::string &path, int chunkSize = 64) {
+        TileMapHeader header = { tilemap.getWidth(), tilemap.getHeight(), chunkSize, tilemap.getTileSet(), tilemap.getZ() };
+        return save(path, header, [&tilemap](int col, int row) {
+            return (unsigned char)tilemap.getTile(col, row);
+        });
+    }
+
+    // Lê o arquivo inteiro para o tilemap (redimensionado para o tamanho do arquivo)
+    template <typename Layout>
+    static bool load(const std::string &path, BasicTileMap<Layout> &tilemap) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            return false;
+        }
+        std::vector<unsigned char> data((size_t)in.tellg());
+        in.seekg(0);
+        in.read((char *)data.data(), data.size());
+        TileMapHeader header;
+        std::vector<TileMapChunkEntry> entries;
+        if (!in || !parse(data.data(), data.size(), header, entries)) {
+            return false;
+        }
+
+        tilemap.resize(header.width, header.height, 0);
+        tilemap.setTid(header.tileset);
+        tilemap.setZ(header.z);
+        std::vector<unsigned char> cells;
+        for (int cy = 0; cy < header.chunksY(); cy++) {
+            for (int cx = 0; cx < header.chunksX(); cx++) {
+                const TileMapChunkEntry &e = entries[cy * header.chunksX() + cx];
+                int cw = header.chunkWidth(cx), ch = header.chunkHeight(cy);
+                cells.resize((size_t)cw * ch);
+                if (!decodeChunk(e, data.data() + e.offset, cells.data(), (int)cells.size())) {
+                    return false;
+                }
+                for (int r = 0; r < ch; r++) {
+                    for (int c = 0; c < cw; c++) {
+                        tilemap.at(cx * header.chunkSize + c, cy * header.chunkSize + r) = cells[r * cw + c];
+                    }
+                }
+            }
+        }
+        return true;
+    }
+};
+
+#endif /* TileMapFile_h */
@@ -0,0 +1,227 @@
+//
+//  TileMapMesh.h
+//  Malha estática de um TileMap
+//
+//  Todos os losangos do mapa são "assados" num único VBO (posição já em
+//  coordenadas do mapa + UV do tile no tileset) com um EBO de índices fixos,
+//  então o mapa inteiro sai numa única chamada glDrawElements. Quando um tile
+//  muda via TileMap::setTile, só os 4 vértices daquela célula são reenviados.
+//
+//  Com uma TileCamera, draw(spans) desenha só as linhas de células visíveis:
+//  cada TileSpan é um trecho contíguo do EBO, e todos saem num único
+//  glMultiDrawElements.
+//
+//  Layout de vértice igual ao dos demos: location 0 -> vec3 position,
+//  location 1 -> vec2 texc; e location 2 -> vec2 cell, a (col, row) da célula
+//  nos 4 vértices, para o shader ler texturas com um texel por célula (a
+//  neblina do FogTexture.h).
+//
+
+#ifndef TileMapMesh_h
+#define TileMapMesh_h
+
+#include <glad/glad.h>
+
+#include "TileMap.h"
+#include "TilemapView.h"
+#include "TileCamera.h"
+
+#include <vector>
+#include <algorithm>
+
+class TileMapMesh : public TileMapListener {
+    TileMap *tilemap;
+    const TilemapView *view;
+    float tw, th;              // tamanho do tile na tela
+    int tilesetCols, tilesetRows;
+
+    GLuint VAO, VBO, EBO;
+    std::vector<GLfloat> vertices;
+    std::vector<int> dirtyCells;   // células alteradas desde o último upload
+    std::vector<bool> dirtyFlag;
+    int indexCount;
+    std::vector<GLsizei> spanCounts;        // reaproveitados entre frames
+    std::vector<const GLvoid *> spanOffsets;
+
+    static const int FLOATS_PER_VERTEX = 7;
+    static const int FLOATS_PER_CELL = 4 * FLOATS_PER_VERTEX;
+
+    // Escreve os 4 vértices (A, B, D, C) do losango da célula
+    void bakeCell(int col, int row) {
+        float x, y;
+        view->computeDrawPosition(col, row, tw, th, x, y);
+
+        int tile = tilemap->getTile(col, row);
+        float ds = 1.0f / tilesetCols;
+        float dt = 1.0f / tilesetRows;
+        float s0 = (tile % tilesetCols) * ds;
+        float t0 = (tile / tilesetCols) * dt;
+
+        float c = (float)col, r = (float)row;
+        GLfloat cell[FLOATS_PER_CELL] = {
+            // x             y             z    s                t               col row
+            x,            y + th / 2.0f, 0.0f, s0,              t0 + dt / 2.0f, c, r, // A
+            x + tw / 2.0f, y + th,       0.0f, s0 + ds / 2.0f,  t0 + dt,        c, r, // B
+            x + tw / 2.0f, y,            0.0f, s0 + ds / 2.0f,  t0,             c, r, // D
+            x + tw,        y + th / 2.0f, 0.0f, s0 + ds,        t0 + dt / 2.0f, c, r  // C
+        };
+
+        int index = col + row * tilemap->getWidth();
+        std::copy(cell, cell + FLOATS_PER_CELL, vertices.begin() + index * FLOATS_PER_CELL);
+    }
+
+public:
+    // tilesetCols/tilesetRows: quantos tiles o tileset tem em cada eixo
+    TileMapMesh(TileMap *tilemap, const TilemapView *view, float tw, float th, int tilesetCols, int tilesetRows = 1) {
+        this->tilemap = tilemap;
+        this->view = view;
+        this->tw = tw;
+        this->th = th;
+        this->tilesetCols = tilesetCols;
+        this->tilesetRows = tilesetRows;
+        this->VAO = this->VBO = this->EBO = 0;
+        this->indexCount = 0;
+        tilemap->addListener(this);
+    }
+
+    ~TileMapMesh() {
+        tilemap->removeListener(this);
+    }
+
+    TileMapMesh(const TileMapMesh &) = delete;
+    TileMapMesh &operator=(const TileMapMesh &) = delete;
+
+    // Monta a malha do mapa inteiro e envia para a GPU
+    void build() {
+        int w = tilemap->getWidth();
+        int h = tilemap->getHeight();
+        int cells = w * h;
+
+        vertices.assign((size_t)cells * FLOATS_PER_CELL, 0.0f);
+        for (int row = 0; row < h; row++) {
+            for (int col = 0; col < w; col++) {
+                bakeCell(col, row);
+            }
+        }
+
+        // dois triângulos por losango: A B D e B C D
+        std::vector<GLuint> indices((size_t)cells * 6);
+        for (int i = 0; i < cells; i++) {
+            GLuint base = i * 4;
+            GLuint *idx = &indices[(size_t)i * 6];
+            idx[0] = base + 0; idx[1] = base + 1; idx[2] = base + 2;
+            idx[3] = base + 1; idx[4] = base + 3; idx[5] = base + 2;
+        }
+        indexCount = (int)indices.size();
+
+        if (VAO == 0) {
+            glGenVertexArrays(1, &VAO);
+            glGenBuffers(1, &VBO);
+            glGenBuffers(1, &EBO);
+        }
+        glBindVertexArray(VAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_DYNAMIC_DRAW);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+        // Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(GLfloat), (GLvoid *)0);
+        glEnableVertexAttribArray(0);
+
+        // Ponteiro pro atributo 1 - Coordenada de textura s, t
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(1);
+
+        // Ponteiro pro atributo 2 - Célula col, row
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(GLfloat), (GLvoid *)(5 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(2);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        dirtyCells.clear();
+        dirtyFlag.assign(cells, false);
+    }
+
+    void onTileChanged(int col, int row, unsigned char oldTile, unsigned char newTile) {
+        int index = col + row * tilemap->getWidth();
+        if (dirtyFlag.empty() || dirtyFlag[index]) {
+            return;
+        }
+        dirtyFlag[index] = true;
+        dirtyCells.push_back(index);
+    }
+
+    // Reenvia só as células alteradas, juntando células vizinhas num único
+    // glBufferSubData
+    void update() {
+        if (dirtyCells.empty()) {
+            return;
+        }
+        int w = tilemap->getWidth();
+        std::sort(dirtyCells.begin(), dirtyCells.end());
+        for (int index : dirtyCells) {
+            bakeCell(index % w, index / w);
+            dirtyFlag[index] = false;
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        size_t first = 0;
+        while (first < dirtyCells.size()) {
+            size_t last = first + 1;
+            while (last < dirtyCells.size() && dirtyCells[last] == dirtyCells[last - 1] + 1) {
+                last++;
+            }
+            int cellStart = dirtyCells[first];
+            int cellCount = dirtyCells[last - 1] - cellStart + 1;
+            glBufferSubData(GL_ARRAY_BUFFER,
+                            (size_t)cellStart * FLOATS_PER_CELL * sizeof(GLfloat),
+                            (size_t)cellCount * FLOATS_PER_CELL * sizeof(GLfloat),
+                            &vertices[(size_t)cellStart * FLOATS_PER_CELL]);
+            first = last;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        dirtyCells.clear();
+    }
+
+    // Desenha o mapa inteiro: shader, textura do tileset e matriz de modelo
+    // já devem estar configurados
+    void draw() {
+        update();
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+        glBindVertexArray(0);
+    }
+
+    // Desenha só as células dos spans (TileCamera::computeVisibleSpans)
+    void draw(const std::vector<TileSpan> &spans) {
+        update();
+        if (spans.empty()) {
+            return;
+        }
+        int w = tilemap->getWidth();
+        spanCounts.clear();
+        spanOffsets.clear();
+        for (const TileSpan &span : spans) {
+            size_t first = ((size_t)span.row * w + span.col0) * 6;
+            spanCounts.push_back((GLsizei)((span.col1 - span.col0) * 6));
+            spanOffsets.push_back((const GLvoid *)(first * sizeof(GLuint)));
+        }
+        glBindVertexArray(VAO);
+        glMultiDrawElements(GL_TRIANGLES, spanCounts.data(), GL_UNSIGNED_INT, spanOffsets.data(), (GLsizei)spans.size());
+        glBindVertexArray(0);
+    }
+
+    // Libera os buffers da GPU; chamar antes do glfwTerminate
+    void release() {
+        glDeleteBuffers(1, &EBO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteVertexArrays(1, &VAO);
+        VAO = VBO = EBO = 0;
+    }
+};
+
+#endif /* TileMapMesh_h */
@@ -0,0 +1,102 @@
+//
+//  TileProperties.h
+//  Propriedades de cada tile do tileset: andável, custo, opaco, animado
+//
+//  Uma tabela por tileset, com uma entrada por id de tile (0..255) e um vetor
+//  por propriedade (SoA): quem só quer saber se um tile é andável lê 256
+//  bytes seguidos, sem trazer junto o resto. As propriedades de sim/não viram
+//  bit-planes do mapa inteiro no TileBitPlanes.h; o custo vai para o
+//  Pathfinder pela TileCostTable (toCostTable).
+//
+//  Exemplo (tilesetIso.png):
+//    TileProperties props;          // tudo andável, custo 1, transparente
+//    props.setWalkable(3, false);   // lava
+//    props.setWalkable(5, false);   // água funda
+//    props.setCost(4, 3);           // água rasa
+//    props.setOpaque(2, true);      // pedra
+//    props.setAnimated(3, true);    // lava
+//
+
+#ifndef TileProperties_h
+#define TileProperties_h
+
+#include "TileCostTable.h"
+
+// Propriedades de sim/não, uma por bit-plane
+enum TileFlag {
+    TILE_WALKABLE = 0,
+    TILE_OPAQUE,
+    TILE_ANIMATED,
+    TILE_FLAG_COUNT
+};
+
+class TileProperties {
+    unsigned char flags[TILE_FLAG_COUNT][256];
+    unsigned char costs[256];
+
+public:
+    TileProperties() {
+        for (int i = 0; i < 256; i++) {
+            flags[TILE_WALKABLE][i] = 1;
+            flags[TILE_OPAQUE][i] = 0;
+            flags[TILE_ANIMATED][i] = 0;
+            costs[i] = 1;
+        }
+    }
+
+    void set(TileFlag flag, int tile, bool value) {
+        flags[flag][tile & 0xff] = value ? 1 : 0;
+    }
+
+    bool has(TileFlag flag, int tile) const {
+        return flags[flag][tile & 0xff] != 0;
+    }
+
+    void setWalkable(int tile, bool value) {
+        set(TILE_WALKABLE, tile, value);
+    }
+
+    void setOpaque(int tile, bool value) {
+        set(TILE_OPAQUE, tile, value);
+    }
+
+    void setAnimated(int tile, bool value) {
+        set(TILE_ANIMATED, tile, value);
+    }
+
+    // Custo de entrar no tile, se andável (1 é o normal)
+    void setCost(int tile, unsigned char cost) {
+        costs[tile & 0xff] = cost == 0 ? 1 : cost;
+    }
+
+    bool isWalkable(int tile) const {
+        return has(TILE_WALKABLE, tile);
+    }
+
+    bool isOpaque(int tile) const {
+        return has(TILE_OPAQUE, tile);
+    }
+
+    bool isAnimated(int tile) const {
+        return has(TILE_ANIMATED, tile);
+    }
+
+    unsigned char getCost(int tile) const {
+        return costs[tile & 0xff];
+    }
+
+    // Tabela de custos do Pathfinder: os não andáveis ficam bloqueados
+    TileCostTable toCostTable() const {
+        TileCostTable table;
+        for (int tile = 0; tile < 256; tile++) {
+            if (isWalkable(tile)) {
+                table.setCost(tile, costs[tile]);
+            } else {
+                table.setBlocked(tile);
+            }
+        }
+        return table;
+    }
+};
+
+#endif /* TileProperties_h */
@@ -23,6 +23,9 @@ public:
     virtual void computeDrawPosition(const int col, const int row, const float tw, const float th, float &targetx, float &targety) const = 0;
     virtual void computeMouseMap(int &col, int &row, const float tw, const float th, const float mx, const float my) const = 0;
     virtual void computeTileWalking(int &col, int &row, const int direction) const = 0;
+    // Inverso contínuo de computeDrawPosition: (col, row) fracionários do ponto
+    // (x, y) do espaço de desenho (usado pela TileCamera nos cantos da tela)
+    virtual void computeTilePosition(const float x, const float y, const float tw, const float th, float &col, float &row) const = 0;
 };
 
 
@@ -0,0 +1,177 @@
+//
+//  ltMathBatch.h
+//  Teste ponto-em-triângulo em lote (muitos pontos contra muitos triângulos)
+//
+//  Versão em lote do triangleCollidePoint2D do ltMath.h. Cada triângulo vira
+//  três funções de aresta E(x, y) = a*x + b*y + c, já com o sinal ajustado para
+//  que o interior seja positivo nas duas ordens de vértices; o ponto está dentro
+//  quando as três são >= 0 (as arestas contam como dentro, como no teste por
+//  áreas). As funções são relativas ao primeiro vértice do triângulo (x e y
+//  entram como x - ox, y - oy), para não perder precisão em coordenadas
+//  grandes. Os coeficientes ficam em SoA (um vetor por coeficiente), e cada passo
+//  testa um ponto contra 4 triângulos com SIMD (ver maths_simd.h).
+//
+//  Triângulos degenerados (área zero) nunca colidem.
+//
+//  Exemplo:
+//    TriangleBatch tris;
+//    float t[] = { 0, 0,  10, 0,  0, 10 };   // mesmo formato do ltMath.h
+//    tris.add(t);
+//    int hit = pickTriangle2D(tris, 2.0f, 3.0f);   // 0
+//
+
+#ifndef ltMathBatch_h
+#define ltMathBatch_h
+
+#include "maths_simd.h"
+
+#include <vector>
+#include <cstdint>
+
+class TriangleBatch {
+    // origem (primeiro vértice) e coeficientes das arestas 0-1, 1-2 e 2-0; o
+    // tamanho é sempre múltiplo de 4, completado com triângulos que nunca
+    // colidem (a = b = 0, c = -1)
+    std::vector<float> ox, oy, a0, b0, c0, a1, b1, c1, a2, b2, c2;
+    int count;
+
+    void pad() {
+        size_t padded = ((size_t)count + 3) & ~(size_t)3;
+        for (std::vector<float> *v : { &ox, &oy, &a0, &b0, &a1, &b1, &a2, &b2 }) {
+            v->resize(padded, 0.0f);
+        }
+        for (std::vector<float> *v : { &c0, &c1, &c2 }) {
+            v->resize(padded, -1.0f);
+        }
+    }
+
+public:
+    TriangleBatch() {
+        this->count = 0;
+    }
+
+    // t = { p1x, p1y, p2x, p2y, p3x, p3y }; retorna o índice do triângulo
+    int add(const float *t) {
+        int index = count++;
+        pad();
+        set(index, t);
+        return index;
+    }
+
+    void set(int index, const float *t) {
+        // vértices relativos ao primeiro: p0 = (0, 0)
+        float x1 = t[2] - t[0], y1 = t[3] - t[1];
+        float x2 = t[4] - t[0], y2 = t[5] - t[1];
+        float area2 = x1 * y2 - x2 * y1;
+        if (area2 == 0.0f) {
+            ox[index] = oy[index] = 0.0f;
+            a0[index] = b0[index] = a1[index] = b1[index] = a2[index] = b2[index] = 0.0f;
+            c0[index] = c1[index] = c2[index] = -1.0f;
+            return;
+        }
+        float s = area2 > 0.0f ? 1.0f : -1.0f;
+        ox[index] = t[0];
+        oy[index] = t[1];
+        // aresta p->q: (py - qy) * x + (qx - px) * y + (px * qy - qx * py)
+        a0[index] = s * -y1;       b0[index] = s * x1;        c0[index] = 0.0f;
+        a1[index] = s * (y1 - y2); b1[index] = s * (x2 - x1); c1[index] = s * (x1 * y2 - x2 * y1);
+        a2[index] = s * y2;        b2[index] = s * -x2;       c2[index] = 0.0f;
+    }
+
+    // Remove o triângulo trocando-o com o último (a ordem muda: o último passa a
+    // ocupar index)
+    void removeSwap(int index) {
+        int last = count - 1;
+        for (std::vector<float> *v : { &ox, &oy, &a0, &b0, &c0, &a1, &b1, &c1, &a2, &b2, &c2 }) {
+            (*v)[index] = (*v)[last];
+        }
+        count--;
+        for (std::vector<float> *v : { &ox, &oy, &a0, &b0, &a1, &b1, &a2, &b2 }) {
+            (*v)[last] = 0.0f;
+        }
+        for (std::vector<float> *v : { &c0, &c1, &c2 }) {
+            (*v)[last] = -1.0f;
+        }
+    }
+
+    void clear() {
+        count = 0;
+        for (std::vector<float> *v : { &ox, &oy, &a0, &b0, &c0, &a1, &b1, &c1, &a2, &b2, &c2 }) {
+            v->clear();
+        }
+    }
+
+    int size() const {
+        return count;
+    }
+
+    // Bits (0..3) dos triângulos first..first+3 que contêm o ponto; px e py têm
+    // a coordenada repetida nas 4 faixas e first é múltiplo de 4
+    int hitGroup(int first, f4 px, f4 py) const {
+        f4 zero = f4_set1(0.0f);
+        f4 x = f4_sub(px, f4_load(&ox[first]));
+        f4 y = f4_sub(py, f4_load(&oy[first]));
+        f4 e0 = f4_madd(f4_load(&a0[first]), x, f4_madd(f4_load(&b0[first]), y, f4_load(&c0[first])));
+        f4 e1 = f4_madd(f4_load(&a1[first]), x, f4_madd(f4_load(&b1[first]), y, f4_load(&c1[first])));
+        f4 e2 = f4_madd(f4_load(&a2[first]), x, f4_madd(f4_load(&b2[first]), y, f4_load(&c2[first])));
+        return f4_bits(f4_and(f4_and(f4_ge(e0, zero), f4_ge(e1, zero)), f4_ge(e2, zero)));
+    }
+
+    // Teste de um único triângulo (sem SIMD), para quem já tem os candidatos
+    bool contains(int index, float x, float y) const {
+        x -= ox[index];
+        y -= oy[index];
+        return a0[index] * x + b0[index] * y + c0[index] >= 0.0f &&
+               a1[index] * x + b1[index] * y + c1[index] >= 0.0f &&
+               a2[index] * x + b2[index] * y + c2[index] >= 0.0f;
+    }
+
+    int groupCount() const {
+        return (count + 3) / 4;
+    }
+};
+
+// Índice do triângulo de maior índice (o desenhado por último, ou seja, o que
+// está por cima) que contém o ponto, ou -1
+inline int pickTriangle2D(const TriangleBatch &tris, float x, float y) {
+    f4 px = f4_set1(x), py = f4_set1(y);
+    for (int g = tris.groupCount() - 1; g >= 0; g--) {
+        int bits = tris.hitGroup(g * 4, px, py);
+        if (bits) {
+            int lane = bits & 8 ? 3 : bits & 4 ? 2 : bits & 2 ? 1 : 0;
+            return g * 4 + lane;
+        }
+    }
+    return -1;
+}
+
+// pickTriangle2D para n pontos (xs[i], ys[i]); hits[i] recebe o índice ou -1
+inline void pickTriangles2D(const TriangleBatch &tris, const float *xs, const float *ys, int n, int *hits) {
+    for (int i = 0; i < n; i++) {
+        hits[i] = pickTriangle2D(tris, xs[i], ys[i]);
+    }
+}
+
+// Todas as colisões de n pontos contra todos os triângulos: para o ponto i,
+// o bit t da linha i de "mask" diz se o triângulo t contém o ponto. Cada linha
+// tem wordsPerPoint(tris) palavras de 32 bits
+inline int wordsPerPoint(const TriangleBatch &tris) {
+    return (tris.size() + 31) / 32;
+}
+
+inline void collidePoints2D(const TriangleBatch &tris, const float *xs, const float *ys, int n,
+                            std::vector<uint32_t> &mask) {
+    int words = wordsPerPoint(tris);
+    int groups = tris.groupCount();
+    mask.assign((size_t)n * words, 0u);
+    for (int i = 0; i < n; i++) {
+        f4 px = f4_set1(xs[i]), py = f4_set1(ys[i]);
+        uint32_t *row = &mask[(size_t)i * words];
+        for (int g = 0; g < groups; g++) {
+            // 8 grupos de 4 triângulos por palavra
+            row[g >> 3] |= (uint32_t)tris.hitGroup(g * 4, px, py) << ((g & 7) * 4);
+        }
+    }
+}
+
+#endif /* ltMathBatch_h */
@@ -13,6 +13,7 @@
 | A versor is the proper name for a unit quaternion.                           |
 \******************************************************************************/
 #include "maths_funcs.h"
+#include "maths_simd.h"
 #include <stdio.h>
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -310,43 +311,47 @@ mat4 identity_mat4 () {
 */
 
 vec4 mat4::operator* (const vec4& rhs) {
-	// 0x + 4y + 8z + 12w
-	float x =
-		m[0] * rhs.v[0] +
-		m[4] * rhs.v[1] +
-		m[8] * rhs.v[2] +
-		m[12] * rhs.v[3];
-	// 1x + 5y + 9z + 13w
-	float y = m[1] * rhs.v[0] +
-		m[5] * rhs.v[1] +
-		m[9] * rhs.v[2] +
-		m[13] * rhs.v[3];
-	// 2x + 6y + 10z + 14w
-	float z = m[2] * rhs.v[0] +
-		m[6] * rhs.v[1] +
-		m[10] * rhs.v[2] +
-		m[14] * rhs.v[3];
-	// 3x + 7y + 11z + 15w
-	float w = m[3] * rhs.v[0] +
-		m[7] * rhs.v[1] +
-		m[11] * rhs.v[2] +
-		m[15] * rhs.v[3];
-	return vec4 (x, y, z, w);
+	// column0 * x + column1 * y + column2 * z + column3 * w
+	f4 r = f4_mul (f4_load (m), f4_set1 (rhs.v[0]));
+	r = f4_madd (f4_load (m + 4), f4_set1 (rhs.v[1]), r);
+	r = f4_madd (f4_load (m + 8), f4_set1 (rhs.v[2]), r);
+	r = f4_madd (f4_load (m + 12), f4_set1 (rhs.v[3]), r);
+	vec4 out;
+	f4_store (out.v, r);
+	return out;
 }
 
 mat4 mat4::operator* (const mat4& rhs) {
-	mat4 r = zero_mat4 ();
-	int r_index = 0;
+	mat4 r;
+#ifdef MATHS_SIMD_AVX2
+	// two result columns per iteration: each 128-bit half holds one column of
+	// rhs, and lane i of that half is broadcast against column i of this
+	__m256 c0 = _mm256_broadcast_ps ((const __m128*)m);
+	__m256 c1 = _mm256_broadcast_ps ((const __m128*)(m + 4));
+	__m256 c2 = _mm256_broadcast_ps ((const __m128*)(m + 8));
+	__m256 c3 = _mm256_broadcast_ps ((const __m128*)(m + 12));
+	for (int col = 0; col < 4; col += 2) {
+		__m256 b = _mm256_loadu_ps (rhs.m + col * 4);
+		__m256 s = _mm256_mul_ps (c0, _mm256_shuffle_ps (b, b, 0x00));
+		s = _mm256_fmadd_ps (c1, _mm256_shuffle_ps (b, b, 0x55), s);
+		s = _mm256_fmadd_ps (c2, _mm256_shuffle_ps (b, b, 0xAA), s);
+		s = _mm256_fmadd_ps (c3, _mm256_shuffle_ps (b, b, 0xFF), s);
+		_mm256_storeu_ps (r.m + col * 4, s);
+	}
+#else
+	f4 c0 = f4_load (m);
+	f4 c1 = f4_load (m + 4);
+	f4 c2 = f4_load (m + 8);
+	f4 c3 = f4_load (m + 12);
 	for (int col = 0; col < 4; col++) {
-		for (int row = 0; row < 4; row++) {
-			float sum = 0.0f;
-			for (int i = 0; i < 4; i++) {
-				sum += rhs.m[i + col * 4] * m[row + i * 4];
-			}
-			r.m[r_index] = sum;
-			r_index++;
-		}
+		const float* b = rhs.m + col * 4;
+		f4 s = f4_mul (c0, f4_set1 (b[0]));
+		s = f4_madd (c1, f4_set1 (b[1]), s);
+		s = f4_madd (c2, f4_set1 (b[2]), s);
+		s = f4_madd (c3, f4_set1 (b[3]), s);
+		f4_store (r.m + col * 4, s);
 	}
+#endif
 	return r;
 }
 
@@ -357,195 +362,200 @@ mat4& mat4::operator= (const mat4& rhs) {
 	return *this;
 }
 
+/* determinant and inverse use 2x2 blocks. with the columns split in halves
+ | A  C |   each block is a 2x2 matrix stored as (a00, a10, a01, a11), and
+ | B  D |   the scalar cofactor expansion turns into a handful of 2x2 products.
+ see "Fast 4x4 matrix inverse with SSE SIMD, explained" (Eric Zhang). the
+ derivation is for row-major storage, but inverse(transpose(M)) is
+ transpose(inverse(M)), so it works unchanged on columns. */
+
+// 2x2 product a * b
+static inline f4 mat2_mul (f4 a, f4 b) {
+	return f4_add (
+		f4_mul (a, F4_SWIZZLE (b, 0, 3, 0, 3)),
+		f4_mul (F4_SWIZZLE (a, 1, 0, 3, 2), F4_SWIZZLE (b, 2, 1, 2, 1))
+	);
+}
+
+// 2x2 product adjugate(a) * b
+static inline f4 mat2_adj_mul (f4 a, f4 b) {
+	return f4_sub (
+		f4_mul (F4_SWIZZLE (a, 3, 3, 0, 0), b),
+		f4_mul (F4_SWIZZLE (a, 1, 1, 2, 2), F4_SWIZZLE (b, 2, 3, 0, 1))
+	);
+}
+
+// 2x2 product a * adjugate(b)
+static inline f4 mat2_mul_adj (f4 a, f4 b) {
+	return f4_sub (
+		f4_mul (a, F4_SWIZZLE (b, 3, 0, 3, 0)),
+		f4_mul (F4_SWIZZLE (a, 1, 0, 3, 2), F4_SWIZZLE (b, 2, 1, 2, 1))
+	);
+}
+
+// sum of the four lanes, in every lane
+static inline f4 f4_hsum (f4 a) {
+	a = f4_add (a, F4_SWIZZLE (a, 1, 0, 3, 2));
+	return f4_add (a, F4_SWIZZLE (a, 2, 3, 0, 1));
+}
+
+struct mat4_blocks {
+	f4 A, B, C, D;
+	f4 detA, detB, detC, detD;
+	f4 A_B, D_C;   // adjugate(A) * B and adjugate(D) * C
+	f4 det;        // determinant of the whole matrix, in every lane
+};
+
+static inline void split_blocks (const mat4& mm, mat4_blocks& k) {
+	f4 c0 = f4_load (mm.m);
+	f4 c1 = f4_load (mm.m + 4);
+	f4 c2 = f4_load (mm.m + 8);
+	f4 c3 = f4_load (mm.m + 12);
+	k.A = F4_SHUFFLE (c0, c1, 0, 1, 0, 1);
+	k.B = F4_SHUFFLE (c0, c1, 2, 3, 2, 3);
+	k.C = F4_SHUFFLE (c2, c3, 0, 1, 0, 1);
+	k.D = F4_SHUFFLE (c2, c3, 2, 3, 2, 3);
+
+	// (|A|, |B|, |C|, |D|)
+	f4 dets = f4_sub (
+		f4_mul (F4_SHUFFLE (c0, c2, 0, 2, 0, 2), F4_SHUFFLE (c1, c3, 1, 3, 1, 3)),
+		f4_mul (F4_SHUFFLE (c0, c2, 1, 3, 1, 3), F4_SHUFFLE (c1, c3, 0, 2, 0, 2))
+	);
+	k.detA = F4_SPLAT (dets, 0);
+	k.detB = F4_SPLAT (dets, 1);
+	k.detC = F4_SPLAT (dets, 2);
+	k.detD = F4_SPLAT (dets, 3);
+
+	k.D_C = mat2_adj_mul (k.D, k.C);
+	k.A_B = mat2_adj_mul (k.A, k.B);
+
+	// |M| = |A||D| + |B||C| - trace((A#B)(D#C))
+	f4 tr = f4_hsum (f4_mul (k.A_B, F4_SWIZZLE (k.D_C, 0, 2, 1, 3)));
+	k.det = f4_sub (f4_add (f4_mul (k.detA, k.detD), f4_mul (k.detB, k.detC)), tr);
+}
+
 // returns a scalar value with the determinant for a 4x4 matrix
-// see http://www.euclideanspace.com/maths/algebra/matrix/functions/determinant/fourD/index.htm
 float determinant (const mat4& mm) {
-	return
-		mm.m[12] * mm.m[9] * mm.m[6] * mm.m[3] -
-		mm.m[8] * mm.m[13] * mm.m[6] * mm.m[3] -
-		mm.m[12] * mm.m[5] * mm.m[10] * mm.m[3] +
-		mm.m[4] * mm.m[13] * mm.m[10] * mm.m[3] +
-		mm.m[8] * mm.m[5] * mm.m[14] * mm.m[3] -
-		mm.m[4] * mm.m[9] * mm.m[14] * mm.m[3] -
-		mm.m[12] * mm.m[9] * mm.m[2] * mm.m[7] +
-		mm.m[8] * mm.m[13] * mm.m[2] * mm.m[7] +
-		mm.m[12] * mm.m[1] * mm.m[10] * mm.m[7] -
-		mm.m[0] * mm.m[13] * mm.m[10] * mm.m[7] -
-		mm.m[8] * mm.m[1] * mm.m[14] * mm.m[7] +
-		mm.m[0] * mm.m[9] * mm.m[14] * mm.m[7] +
-		mm.m[12] * mm.m[5] * mm.m[2] * mm.m[11] -
-		mm.m[4] * mm.m[13] * mm.m[2] * mm.m[11] -
-		mm.m[12] * mm.m[1] * mm.m[6] * mm.m[11] +
-		mm.m[0] * mm.m[13] * mm.m[6] * mm.m[11] +
-		mm.m[4] * mm.m[1] * mm.m[14] * mm.m[11] -
-		mm.m[0] * mm.m[5] * mm.m[14] * mm.m[11] -
-		mm.m[8] * mm.m[5] * mm.m[2] * mm.m[15] +
-		mm.m[4] * mm.m[9] * mm.m[2] * mm.m[15] +
-		mm.m[8] * mm.m[1] * mm.m[6] * mm.m[15] -
-		mm.m[0] * mm.m[9] * mm.m[6] * mm.m[15] -
-		mm.m[4] * mm.m[1] * mm.m[10] * mm.m[15] +
-		mm.m[0] * mm.m[5] * mm.m[10] * mm.m[15];
+	mat4_blocks k;
+	split_blocks (mm, k);
+	float det[4];
+	f4_store (det, k.det);
+	return det[0];
 }
 
 /* returns a 16-element array that is the inverse of a 16-element array (4x4
-matrix). see http://www.euclideanspace.com/maths/algebra/matrix/functions/inverse/fourD/index.htm */
+matrix). */
 mat4 inverse (const mat4& mm) {
-	float det = determinant (mm);
+	mat4_blocks k;
+	split_blocks (mm, k);
+	float det[4];
+	f4_store (det, k.det);
 	/* there is no inverse if determinant is zero (not likely unless scale is
 	broken) */
-	if (0.0f == det) {
+	if (0.0f == det[0]) {
 		fprintf (stderr, "WARNING. matrix has no determinant. can not invert\n");
 		return mm;
 	}
-	float inv_det = 1.0f / det;
-	
-	return mat4 (
-		inv_det * (
-			mm.m[9] * mm.m[14] * mm.m[7] - mm.m[13] * mm.m[10] * mm.m[7] +
-			mm.m[13] * mm.m[6] * mm.m[11] - mm.m[5] * mm.m[14] * mm.m[11] -
-			mm.m[9] * mm.m[6] * mm.m[15] + mm.m[5] * mm.m[10] * mm.m[15]
-		),
-		inv_det * (
-			mm.m[13] * mm.m[10] * mm.m[3] - mm.m[9] * mm.m[14] * mm.m[3] -
-			mm.m[13] * mm.m[2] * mm.m[11] + mm.m[1] * mm.m[14] * mm.m[11] +
-			mm.m[9] * mm.m[2] * mm.m[15] - mm.m[1] * mm.m[10] * mm.m[15]
-		),
-		inv_det * (
-			mm.m[5] * mm.m[14] * mm.m[3] - mm.m[13] * mm.m[6] * mm.m[3] +
-			mm.m[13] * mm.m[2] * mm.m[7] - mm.m[1] * mm.m[14] * mm.m[7] -
-			mm.m[5] * mm.m[2] * mm.m[15] + mm.m[1] * mm.m[6] * mm.m[15]
-		),
-		inv_det * (
-			mm.m[9] * mm.m[6] * mm.m[3] - mm.m[5] * mm.m[10] * mm.m[3] -
-			mm.m[9] * mm.m[2] * mm.m[7] + mm.m[1] * mm.m[10] * mm.m[7] +
-			mm.m[5] * mm.m[2] * mm.m[11] - mm.m[1] * mm.m[6] * mm.m[11]
-		),
-		inv_det * (
-			mm.m[12] * mm.m[10] * mm.m[7] - mm.m[8] * mm.m[14] * mm.m[7] -
-			mm.m[12] * mm.m[6] * mm.m[11] + mm.m[4] * mm.m[14] * mm.m[11] +
-			mm.m[8] * mm.m[6] * mm.m[15] - mm.m[4] * mm.m[10] * mm.m[15]
-		),
-		inv_det * (
-			mm.m[8] * mm.m[14] * mm.m[3] - mm.m[12] * mm.m[10] * mm.m[3] +
-			mm.m[12] * mm.m[2] * mm.m[11] - mm.m[0] * mm.m[14] * mm.m[11] -
-			mm.m[8] * mm.m[2] * mm.m[15] + mm.m[0] * mm.m[10] * mm.m[15]
-		),
-		inv_det * (
-			mm.m[12] * mm.m[6] * mm.m[3] - mm.m[4] * mm.m[14] * mm.m[3] -
-			mm.m[12] * mm.m[2] * mm.m[7] + mm.m[0] * mm.m[14] * mm.m[7] +
-			mm.m[4] * mm.m[2] * mm.m[15] - mm.m[0] * mm.m[6] * mm.m[15]
-		),
-		inv_det * (
-			mm.m[4] * mm.m[10] * mm.m[3] - mm.m[8] * mm.m[6] * mm.m[3] +
-			mm.m[8] * mm.m[2] * mm.m[7] - mm.m[0] * mm.m[10] * mm.m[7] -
-			mm.m[4] * mm.m[2] * mm.m[11] + mm.m[0] * mm.m[6] * mm.m[11]
-		),
-		inv_det * (
-			mm.m[8] * mm.m[13] * mm.m[7] - mm.m[12] * mm.m[9] * mm.m[7] +
-			mm.m[12] * mm.m[5] * mm.m[11] - mm.m[4] * mm.m[13] * mm.m[11] -
-			mm.m[8] * mm.m[5] * mm.m[15] + mm.m[4] * mm.m[9] * mm.m[15]
-		),
-		inv_det * (
-			mm.m[12] * mm.m[9] * mm.m[3] - mm.m[8] * mm.m[13] * mm.m[3] -
-			mm.m[12] * mm.m[1] * mm.m[11] + mm.m[0] * mm.m[13] * mm.m[11] +
-			mm.m[8] * mm.m[1] * mm.m[15] - mm.m[0] * mm.m[9] * mm.m[15]
-		),
-		inv_det * (
-			mm.m[4] * mm.m[13] * mm.m[3] - mm.m[12] * mm.m[5] * mm.m[3] +
-			mm.m[12] * mm.m[1] * mm.m[7] - mm.m[0] * mm.m[13] * mm.m[7] -
-			mm.m[4] * mm.m[1] * mm.m[15] + mm.m[0] * mm.m[5] * mm.m[15]
-		),
-		inv_det * (
-			mm.m[8] * mm.m[5] * mm.m[3] - mm.m[4] * mm.m[9] * mm.m[3] -
-			mm.m[8] * mm.m[1] * mm.m[7] + mm.m[0] * mm.m[9] * mm.m[7] +
-			mm.m[4] * mm.m[1] * mm.m[11] - mm.m[0] * mm.m[5] * mm.m[11]
-		),
-		inv_det * (
-			mm.m[12] * mm.m[9] * mm.m[6] - mm.m[8] * mm.m[13] * mm.m[6] -
-			mm.m[12] * mm.m[5] * mm.m[10] + mm.m[4] * mm.m[13] * mm.m[10] +
-			mm.m[8] * mm.m[5] * mm.m[14] - mm.m[4] * mm.m[9] * mm.m[14]
-		),
-		inv_det * (
-			mm.m[8] * mm.m[13] * mm.m[2] - mm.m[12] * mm.m[9] * mm.m[2] +
-			mm.m[12] * mm.m[1] * mm.m[10] - mm.m[0] * mm.m[13] * mm.m[10] -
-			mm.m[8] * mm.m[1] * mm.m[14] + mm.m[0] * mm.m[9] * mm.m[14]
-		),
-		inv_det * (
-			mm.m[12] * mm.m[5] * mm.m[2] - mm.m[4] * mm.m[13] * mm.m[2] -
-			mm.m[12] * mm.m[1] * mm.m[6] + mm.m[0] * mm.m[13] * mm.m[6] +
-			mm.m[4] * mm.m[1] * mm.m[14] - mm.m[0] * mm.m[5] * mm.m[14]
-		),
-		inv_det * (
-			mm.m[4] * mm.m[9] * mm.m[2] - mm.m[8] * mm.m[5] * mm.m[2] +
-			mm.m[8] * mm.m[1] * mm.m[6] - mm.m[0] * mm.m[9] * mm.m[6] -
-			mm.m[4] * mm.m[1] * mm.m[10] + mm.m[0] * mm.m[5] * mm.m[10]
-		)
-	);
+
+	// adjugate blocks of the inverse, before the 1/|M| scale
+	f4 X_ = f4_sub (f4_mul (k.detD, k.A), mat2_mul (k.B, k.D_C));
+	f4 W_ = f4_sub (f4_mul (k.detA, k.D), mat2_mul (k.C, k.A_B));
+	f4 Y_ = f4_sub (f4_mul (k.detB, k.C), mat2_mul_adj (k.D, k.A_B));
+	f4 Z_ = f4_sub (f4_mul (k.detC, k.B), mat2_mul_adj (k.A, k.D_C));
+
+	f4 inv_det = f4_div (f4_set (1.0f, -1.0f, -1.0f, 1.0f), k.det);
+	X_ = f4_mul (X_, inv_det);
+	Y_ = f4_mul (Y_, inv_det);
+	Z_ = f4_mul (Z_, inv_det);
+	W_ = f4_mul (W_, inv_det);
+
+	// the final adjugate swizzle and the block-to-column shuffle in one step
+	mat4 r;
+	f4_store (r.m, F4_SHUFFLE (X_, Y_, 3, 1, 3, 1));
+	f4_store (r.m + 4, F4_SHUFFLE (X_, Y_, 2, 0, 2, 0));
+	f4_store (r.m + 8, F4_SHUFFLE (Z_, W_, 3, 1, 3, 1));
+	f4_store (r.m + 12, F4_SHUFFLE (Z_, W_, 2, 0, 2, 0));
+	return r;
 }
 
 // returns a 16-element array flipped on the main diagonal
 mat4 transpose (const mat4& mm) {
-	return mat4 (
-		mm.m[0], mm.m[4], mm.m[8], mm.m[12],
-		mm.m[1], mm.m[5], mm.m[9], mm.m[13],
-		mm.m[2], mm.m[6], mm.m[10], mm.m[14],
-		mm.m[3], mm.m[7], mm.m[11], mm.m[15]
-	);
+	f4 c0 = f4_load (mm.m);
+	f4 c1 = f4_load (mm.m + 4);
+	f4 c2 = f4_load (mm.m + 8);
+	f4 c3 = f4_load (mm.m + 12);
+	// (m0 m1 m4 m5), (m2 m3 m6 m7), (m8 m9 m12 m13), (m10 m11 m14 m15)
+	f4 t0 = F4_SHUFFLE (c0, c1, 0, 1, 0, 1);
+	f4 t1 = F4_SHUFFLE (c0, c1, 2, 3, 2, 3);
+	f4 t2 = F4_SHUFFLE (c2, c3, 0, 1, 0, 1);
+	f4 t3 = F4_SHUFFLE (c2, c3, 2, 3, 2, 3);
+	mat4 r;
+	f4_store (r.m, F4_SHUFFLE (t0, t2, 0, 2, 0, 2));
+	f4_store (r.m + 4, F4_SHUFFLE (t0, t2, 1, 3, 1, 3));
+	f4_store (r.m + 8, F4_SHUFFLE (t1, t3, 0, 2, 0, 2));
+	f4_store (r.m + 12, F4_SHUFFLE (t1, t3, 1, 3, 1, 3));
+	return r;
 }
 
 /*--------------------------AFFINE MATRIX FUNCTIONS---------------------------*/
+/* each of these used to build a full matrix and multiply it on the left of m.
+the left factor only touches some rows of m, so only those are computed: the
+results are the same as T * m, R * m and S * m. */
+
 // translate a 4d matrix with xyz array
 mat4 translate (const mat4& m, const vec3& v) {
-	mat4 m_t = identity_mat4 ();
-	m_t.m[12] = v.v[0];
-	m_t.m[13] = v.v[1];
-	m_t.m[14] = v.v[2];
-	return m_t * m;
+	// every column gets (x, y, z, 0) times its own w
+	f4 t = f4_set (v.v[0], v.v[1], v.v[2], 0.0f);
+	mat4 r;
+	for (int col = 0; col < 16; col += 4) {
+		f4 c = f4_load (m.m + col);
+		f4_store (r.m + col, f4_madd (t, f4_set1 (m.m[col + 3]), c));
+	}
+	return r;
+}
+
+// rows i and j of m rotated by (c, s): row_i' = c row_i - s row_j,
+// row_j' = s row_i + c row_j
+static mat4 rotate_rows (const mat4& m, int i, int j, float c, float s) {
+	mat4 r = m;
+	for (int col = 0; col < 16; col += 4) {
+		float a = m.m[col + i];
+		float b = m.m[col + j];
+		r.m[col + i] = c * a - s * b;
+		r.m[col + j] = s * a + c * b;
+	}
+	return r;
 }
 
 // rotate around x axis by an angle in degrees
 mat4 rotate_x_deg (const mat4& m, float deg) {
 	// convert to radians
 	float rad = deg * ONE_DEG_IN_RAD;
-	mat4 m_r = identity_mat4 ();
-	m_r.m[5] = cos (rad);
-	m_r.m[9] = -sin (rad);
-	m_r.m[6] = sin (rad);
-	m_r.m[10] = cos (rad);
-	return m_r * m;
+	return rotate_rows (m, 1, 2, cos (rad), sin (rad));
 }
 
 // rotate around y axis by an angle in degrees
 mat4 rotate_y_deg (const mat4& m, float deg) {
 	// convert to radians
 	float rad = deg * ONE_DEG_IN_RAD;
-	mat4 m_r = identity_mat4 ();
-	m_r.m[0] = cos (rad);
-	m_r.m[8] = sin (rad);
-	m_r.m[2] = -sin (rad);
-	m_r.m[10] = cos (rad);
-	return m_r * m;
+	return rotate_rows (m, 2, 0, cos (rad), sin (rad));
 }
 
 // rotate around z axis by an angle in degrees
 mat4 rotate_z_deg (const mat4& m, float deg) {
 	// convert to radians
 	float rad = deg * ONE_DEG_IN_RAD;
-	mat4 m_r = identity_mat4 ();
-	m_r.m[0] = cos (rad);
-	m_r.m[4] = -sin (rad);
-	m_r.m[1] = sin (rad);
-	m_r.m[5] = cos (rad);
-	return m_r * m;
+	return rotate_rows (m, 0, 1, cos (rad), sin (rad));
 }
 
 // scale a matrix by [x, y, z]
 mat4 scale (const mat4& m, const vec3& v) {
-	mat4 a = identity_mat4 ();
-	a.m[0] = v.v[0];
-	a.m[5] = v.v[1];
-	a.m[10] = v.v[2];
-	return a * m;
+	f4 s = f4_set (v.v[0], v.v[1], v.v[2], 1.0f);
+	mat4 r;
+	for (int col = 0; col < 16; col += 4) {
+		f4_store (r.m + col, f4_mul (f4_load (m.m + col), s));
+	}
+	return r;
 }
 
 /*-----------------------VIRTUAL CAMERA MATRIX FUNCTIONS----------------------*/
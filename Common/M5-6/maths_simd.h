@@ -0,0 +1,186 @@
+/******************************************************************************\
+| 4-wide float vector used by maths_funcs.cpp and ltMathBatch.h               |
+| One column of a mat4 (or one vec4) fits in a register. The backend is chosen |
+| at compile time:                                                             |
+|   AVX2 + FMA  -> SSE registers with fused multiply-add (and 256-bit mat4    |
+|                  products in maths_funcs.cpp)                                |
+|   SSE2        -> any x86-64 compiler                                         |
+|   NEON        -> ARMv7 with NEON / AArch64                                   |
+|   scalar      -> everything else, or when MATHS_NO_SIMD is defined           |
+| Loads and stores are unaligned, so mat4/vec4 keep their plain float arrays.  |
+| MATHS_SIMD_NAME says which backend was compiled in (printed by MathsBench).  |
+\******************************************************************************/
+#ifndef _MATHS_SIMD_H_
+#define _MATHS_SIMD_H_
+
+#if !defined(MATHS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#	include <immintrin.h>
+#	if defined(__AVX2__) && defined(__FMA__)
+#		define MATHS_SIMD_AVX2 1
+#		define MATHS_SIMD_NAME "AVX2+FMA"
+#	else
+#		define MATHS_SIMD_NAME "SSE2"
+#	endif
+#	define MATHS_SIMD_SSE 1
+#elif !defined(MATHS_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#	include <arm_neon.h>
+#	define MATHS_SIMD_NEON 1
+#	define MATHS_SIMD_NAME "NEON"
+#else
+#	define MATHS_SIMD_SCALAR 1
+#	define MATHS_SIMD_NAME "scalar"
+#endif
+
+#if defined(MATHS_SIMD_SSE)
+
+typedef __m128 f4;
+
+static inline f4 f4_load (const float* p) { return _mm_loadu_ps (p); }
+static inline void f4_store (float* p, f4 a) { _mm_storeu_ps (p, a); }
+static inline f4 f4_set1 (float x) { return _mm_set1_ps (x); }
+static inline f4 f4_set (float x, float y, float z, float w) {
+	return _mm_setr_ps (x, y, z, w);
+}
+static inline f4 f4_add (f4 a, f4 b) { return _mm_add_ps (a, b); }
+static inline f4 f4_sub (f4 a, f4 b) { return _mm_sub_ps (a, b); }
+static inline f4 f4_mul (f4 a, f4 b) { return _mm_mul_ps (a, b); }
+static inline f4 f4_div (f4 a, f4 b) { return _mm_div_ps (a, b); }
+// a * b + c
+#	if defined(MATHS_SIMD_AVX2)
+static inline f4 f4_madd (f4 a, f4 b, f4 c) { return _mm_fmadd_ps (a, b, c); }
+#	else
+static inline f4 f4_madd (f4 a, f4 b, f4 c) { return _mm_add_ps (_mm_mul_ps (a, b), c); }
+#	endif
+// comparisons give all-ones / all-zeros lanes; f4_bits packs the lanes into
+// bits 0..3 of an int
+static inline f4 f4_ge (f4 a, f4 b) { return _mm_cmpge_ps (a, b); }
+static inline f4 f4_and (f4 a, f4 b) { return _mm_and_ps (a, b); }
+static inline int f4_bits (f4 mask) { return _mm_movemask_ps (mask); }
+// (a[x], a[y], b[z], b[w]) -- same meaning as _mm_shuffle_ps
+#	define F4_SHUFFLE(a, b, x, y, z, w) \
+	_mm_shuffle_ps ((a), (b), _MM_SHUFFLE ((w), (z), (y), (x)))
+
+#elif defined(MATHS_SIMD_NEON)
+
+typedef float32x4_t f4;
+
+static inline f4 f4_load (const float* p) { return vld1q_f32 (p); }
+static inline void f4_store (float* p, f4 a) { vst1q_f32 (p, a); }
+static inline f4 f4_set1 (float x) { return vdupq_n_f32 (x); }
+static inline f4 f4_set (float x, float y, float z, float w) {
+	float t[4] = { x, y, z, w };
+	return vld1q_f32 (t);
+}
+static inline f4 f4_add (f4 a, f4 b) { return vaddq_f32 (a, b); }
+static inline f4 f4_sub (f4 a, f4 b) { return vsubq_f32 (a, b); }
+static inline f4 f4_mul (f4 a, f4 b) { return vmulq_f32 (a, b); }
+#	if defined(__aarch64__)
+static inline f4 f4_div (f4 a, f4 b) { return vdivq_f32 (a, b); }
+static inline f4 f4_madd (f4 a, f4 b, f4 c) { return vfmaq_f32 (c, a, b); }
+#	else
+// ARMv7 has no vector divide: reciprocal estimate plus two Newton steps
+static inline f4 f4_div (f4 a, f4 b) {
+	f4 r = vrecpeq_f32 (b);
+	r = vmulq_f32 (vrecpsq_f32 (b, r), r);
+	r = vmulq_f32 (vrecpsq_f32 (b, r), r);
+	return vmulq_f32 (a, r);
+}
+static inline f4 f4_madd (f4 a, f4 b, f4 c) { return vmlaq_f32 (c, a, b); }
+#	endif
+static inline f4 f4_ge (f4 a, f4 b) { return vreinterpretq_f32_u32 (vcgeq_f32 (a, b)); }
+static inline f4 f4_and (f4 a, f4 b) {
+	return vreinterpretq_f32_u32 (vandq_u32 (vreinterpretq_u32_f32 (a), vreinterpretq_u32_f32 (b)));
+}
+static inline int f4_bits (f4 mask) {
+	uint32x4_t m = vshrq_n_u32 (vreinterpretq_u32_f32 (mask), 31);
+	return (int)(vgetq_lane_u32 (m, 0) | (vgetq_lane_u32 (m, 1) << 1) |
+		(vgetq_lane_u32 (m, 2) << 2) | (vgetq_lane_u32 (m, 3) << 3));
+}
+// (a[x], a[y], b[z], b[w]); lane indices are constants, so the compiler folds
+// the lane moves into the fewest permutes it knows for the target
+#	define F4_SHUFFLE(a, b, x, y, z, w) \
+	vsetq_lane_f32 (vgetq_lane_f32 ((b), (w)), \
+	vsetq_lane_f32 (vgetq_lane_f32 ((b), (z)), \
+	vsetq_lane_f32 (vgetq_lane_f32 ((a), (y)), \
+	vdupq_n_f32 (vgetq_lane_f32 ((a), (x))), 1), 2), 3)
+
+#else
+
+#	include <string.h>
+
+struct f4 {
+	float v[4];
+};
+
+static inline f4 f4_load (const float* p) {
+	f4 r = { { p[0], p[1], p[2], p[3] } };
+	return r;
+}
+static inline void f4_store (float* p, f4 a) {
+	p[0] = a.v[0];
+	p[1] = a.v[1];
+	p[2] = a.v[2];
+	p[3] = a.v[3];
+}
+static inline f4 f4_set1 (float x) {
+	f4 r = { { x, x, x, x } };
+	return r;
+}
+static inline f4 f4_set (float x, float y, float z, float w) {
+	f4 r = { { x, y, z, w } };
+	return r;
+}
+#	define F4_SCALAR_OP(name, op) \
+	static inline f4 name (f4 a, f4 b) { \
+		f4 r = { { a.v[0] op b.v[0], a.v[1] op b.v[1], a.v[2] op b.v[2], a.v[3] op b.v[3] } }; \
+		return r; \
+	}
+F4_SCALAR_OP (f4_add, +)
+F4_SCALAR_OP (f4_sub, -)
+F4_SCALAR_OP (f4_mul, *)
+F4_SCALAR_OP (f4_div, /)
+#	undef F4_SCALAR_OP
+static inline f4 f4_madd (f4 a, f4 b, f4 c) { return f4_add (f4_mul (a, b), c); }
+// masks keep the SIMD meaning (all bits set per true lane), built with memcpy
+static inline f4 f4_ge (f4 a, f4 b) {
+	f4 r;
+	for (int i = 0; i < 4; i++) {
+		unsigned int bits = a.v[i] >= b.v[i] ? 0xFFFFFFFFu : 0u;
+		memcpy (&r.v[i], &bits, sizeof (bits));
+	}
+	return r;
+}
+static inline f4 f4_and (f4 a, f4 b) {
+	f4 r;
+	for (int i = 0; i < 4; i++) {
+		unsigned int x, y;
+		memcpy (&x, &a.v[i], sizeof (x));
+		memcpy (&y, &b.v[i], sizeof (y));
+		x &= y;
+		memcpy (&r.v[i], &x, sizeof (x));
+	}
+	return r;
+}
+static inline int f4_bits (f4 mask) {
+	int bits = 0;
+	for (int i = 0; i < 4; i++) {
+		unsigned int x;
+		memcpy (&x, &mask.v[i], sizeof (x));
+		bits |= (int)(x >> 31) << i;
+	}
+	return bits;
+}
+static inline f4 f4_shuffle (f4 a, f4 b, int x, int y, int z, int w) {
+	f4 r = { { a.v[x], a.v[y], b.v[z], b.v[w] } };
+	return r;
+}
+#	define F4_SHUFFLE(a, b, x, y, z, w) f4_shuffle ((a), (b), (x), (y), (z), (w))
+
+#endif
+
+// (a[x], a[y], a[z], a[w])
+#define F4_SWIZZLE(a, x, y, z, w) F4_SHUFFLE (a, a, x, y, z, w)
+// a[i] in every lane
+#define F4_SPLAT(a, i) F4_SHUFFLE (a, a, i, i, i, i)
+
+#endif
@@ -0,0 +1,127 @@
+//
+//  MappedFile.h
+//  Arquivo somente leitura mapeado na memória (mmap / MapViewOfFile)
+//
+//  O sistema operacional só lê do disco as páginas que são tocadas, então abrir
+//  um arquivo grande custa o mesmo que abrir um pequeno. Usado pelo pacote de
+//  texturas (BakedTextures.h) e pelos mapas em chunks (StreamingTileMap.h).
+//
+
+#ifndef MappedFile_h
+#define MappedFile_h
+
+#include <string>
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+class MappedFile {
+    const unsigned char *base;
+    size_t fileSize;
+#ifdef _WIN32
+    HANDLE file, mapping;
+#endif
+
+public:
+    MappedFile() {
+        this->base = nullptr;
+        this->fileSize = 0;
+#ifdef _WIN32
+        this->file = INVALID_HANDLE_VALUE;
+        this->mapping = NULL;
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    // false se o arquivo não existe ou está vazio
+    bool open(const std::string &filePath) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+            return false;
+        }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        base = mapping ? (const unsigned char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        fileSize = (size_t)size.QuadPart;
+#else
+        int fd = ::open(filePath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        fileSize = (size_t)info.st_size;
+        void *addr = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // o mapeamento continua válido sem o descritor
+        base = addr == MAP_FAILED ? nullptr : (const unsigned char *)addr;
+#endif
+        if (!base) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (base) {
+            UnmapViewOfFile(base);
+        }
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base) {
+            munmap((void *)base, fileSize);
+        }
+#endif
+        base = nullptr;
+        fileSize = 0;
+    }
+
+    bool isOpen() const {
+        return base != nullptr;
+    }
+
+    const unsigned char *data() const {
+        return base;
+    }
+
+    size_t size() const {
+        return fileSize;
+    }
+};
+
+#endif /* MappedFile_h */
@@ -0,0 +1,324 @@
+//
+//  ProgramCache.h
+//  Cache em disco dos binários de programas de shader (glGetProgramBinary)
+//
+//  Compilar e linkar GLSL é o passo mais lento do início de cada demo. Depois
+//  do primeiro link, o binário que o driver gerou é gravado em
+//  shader_cache/<hash dos fontes>.bin; nas execuções seguintes o programa é
+//  recriado com glProgramBinary, sem passar pelo compilador.
+//
+//  Invalidação:
+//    - fonte diferente: outro hash, outro arquivo;
+//    - driver diferente: o arquivo guarda fabricante, renderer e versão do
+//      OpenGL; se não bate com o contexto atual, o programa é compilado de novo
+//      e o arquivo é sobrescrito;
+//    - binário recusado (GL_LINK_STATUS falso depois do glProgramBinary, por
+//      exemplo num driver atualizado sem mudar a versão): idem.
+//  Sem formatos de binário no driver (GL_NUM_PROGRAM_BINARY_FORMATS == 0) o
+//  cache só compila, como antes.
+//
+//  Exemplo:
+//    ProgramCache programCache;                  // pasta padrão: shader_cache
+//    GLuint program = programCache.build(vertexShaderSource, fragmentShaderSource);
+//    ...
+//    programCache.printReport();                 // do cache x compilados, em ms
+//
+
+#ifndef ProgramCache_h
+#define ProgramCache_h
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+struct ShaderStage {
+    GLenum type;                 // GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, ...
+    const char *source;
+    // Fonte em trechos (ShaderSource.h), usado no lugar de source quando count > 0
+    GLsizei count = 0;
+    const GLchar *const *strings = nullptr;
+    const GLint *lengths = nullptr;
+};
+
+struct ProgramCacheStats {
+    int hits;                    // programas vindos do disco
+    int misses;                  // compilados (sem arquivo ou invalidados)
+    int invalidated;             // ... dos quais com arquivo de outro driver ou recusado
+    double hitMs, missMs;        // tempo total de cada caso
+};
+
+class ProgramCache {
+    std::string directory;
+    bool enabled;
+    int supported;               // -1: ainda não consultado
+    std::string driver;
+    ProgramCacheStats stats;
+
+    static uint64_t hash(uint64_t h, const void *data, size_t bytes) {
+        const unsigned char *p = (const unsigned char *)data;
+        for (size_t i = 0; i < bytes; i++) {
+            h = (h ^ p[i]) * 1099511628211ull; // FNV-1a
+        }
+        return h;
+    }
+
+    static uint64_t sourceHash(const ShaderStage *stages, int count) {
+        uint64_t h = 14695981039346656037ull;
+        for (int i = 0; i < count; i++) {
+            // o mesmo texto dá a mesma chave, inteiro ou em trechos
+            uint32_t type = stages[i].type;
+            uint64_t length = 0;
+            if (stages[i].count > 0) {
+                for (GLsizei s = 0; s < stages[i].count; s++) {
+                    length += stages[i].lengths[s];
+                }
+            } else {
+                length = strlen(stages[i].source);
+            }
+            h = hash(h, &type, sizeof(type));
+            h = hash(h, &length, sizeof(length));
+            if (stages[i].count > 0) {
+                for (GLsizei s = 0; s < stages[i].count; s++) {
+                    h = hash(h, stages[i].strings[s], stages[i].lengths[s]);
+                }
+            } else {
+                h = hash(h, stages[i].source, length);
+            }
+        }
+        return h;
+    }
+
+    static const char *stageName(GLenum type) {
+        switch (type) {
+        case GL_VERTEX_SHADER: return "VERTEX";
+        case GL_FRAGMENT_SHADER: return "FRAGMENT";
+        case GL_GEOMETRY_SHADER: return "GEOMETRY";
+        default: return "SHADER";
+        }
+    }
+
+    bool isSupported() {
+        if (supported < 0) {
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            supported = formats > 0 && glProgramBinary && glGetProgramBinary ? 1 : 0;
+            driver = driverString();
+        }
+        return supported == 1;
+    }
+
+    std::string pathFor(uint64_t key) const {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+        return (std::filesystem::path(directory) / name).string();
+    }
+
+    // Programa a partir do arquivo, ou 0 (sem arquivo, de outro driver ou recusado)
+    GLuint load(const std::string &path, uint64_t key, bool &stale) {
+        stale = false;
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return 0;
+        }
+        char magic[4];
+        uint32_t version = 0, driverLength = 0, format = 0, length = 0;
+        uint64_t storedKey = 0;
+        in.read(magic, 4);
+        in.read((char *)&version, sizeof(version));
+        in.read((char *)&storedKey, sizeof(storedKey));
+        in.read((char *)&driverLength, sizeof(driverLength));
+        std::string storedDriver(driverLength < 4096 ? driverLength : 0, '\0');
+        in.read(&storedDriver[0], storedDriver.size());
+        in.read((char *)&format, sizeof(format));
+        in.read((char *)&length, sizeof(length));
+        if (!in || memcmp(magic, "PGBC", 4) != 0 || version != 1 || storedKey != key || storedDriver != driver) {
+            stale = true;
+            return 0;
+        }
+        std::vector<char> binary(length);
+        in.read(binary.data(), length);
+        if (!in) {
+            stale = true;
+            return 0;
+        }
+
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, (GLenum)format, binary.data(), (GLsizei)length);
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glDeleteProgram(program);
+            stale = true;
+            return 0;
+        }
+        return program;
+    }
+
+    // Grava num arquivo temporário e renomeia: outra execução nunca lê pela metade
+    void save(const std::string &path, uint64_t key, GLuint program) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) {
+            return;
+        }
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        GLsizei written = 0;
+        glGetProgramBinary(program, length, &written, &format, binary.data());
+        if (written <= 0) {
+            return;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary);
+            uint32_t version = 1, driverLength = (uint32_t)driver.size(), format32 = format, length32 = written;
+            out.write("PGBC", 4);
+            out.write((const char *)&version, sizeof(version));
+            out.write((const char *)&key, sizeof(key));
+            out.write((const char *)&driverLength, sizeof(driverLength));
+            out.write(driver.data(), driver.size());
+            out.write((const char *)&format32, sizeof(format32));
+            out.write((const char *)&length32, sizeof(length32));
+            out.write(binary.data(), written);
+            if (!out) {
+                return;
+            }
+        }
+        std::filesystem::rename(temp, path, error);
+    }
+
+    // Compilação normal, com as mensagens de erro que os demos já imprimiam
+    GLuint compile(const ShaderStage *stages, int count, bool retrievable) {
+        GLint success;
+        GLchar infoLog[512];
+        std::vector<GLuint> shaders;
+        for (int i = 0; i < count; i++) {
+            GLuint shader = glCreateShader(stages[i].type);
+            if (stages[i].count > 0) {
+                glShaderSource(shader, stages[i].count, stages[i].strings, stages[i].lengths);
+            } else {
+                glShaderSource(shader, 1, &stages[i].source, NULL);
+            }
+            glCompileShader(shader);
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+            if (!success) {
+                glGetShaderInfoLog(shader, 512, NULL, infoLog);
+                std::cout << "ERROR::SHADER::" << stageName(stages[i].type) << "::COMPILATION_FAILED\n"
+                          << infoLog << std::endl;
+            }
+            shaders.push_back(shader);
+        }
+
+        GLuint program = glCreateProgram();
+        if (retrievable) {
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        for (GLuint shader : shaders) {
+            glAttachShader(program, shader);
+        }
+        glLinkProgram(program);
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glGetProgramInfoLog(program, 512, NULL, infoLog);
+            std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
+                      << infoLog << std::endl;
+        }
+        for (GLuint shader : shaders) {
+            glDetachShader(program, shader);
+            glDeleteShader(shader);
+        }
+        return program;
+    }
+
+public:
+    explicit ProgramCache(const std::string &directory = "shader_cache") {
+        this->directory = directory;
+        this->enabled = true;
+        this->supported = -1;
+        this->stats = ProgramCacheStats();
+    }
+
+    // Fabricante, renderer e versão do OpenGL do contexto atual
+    static std::string driverString() {
+        const GLubyte *vendor = glGetString(GL_VENDOR);
+        const GLubyte *renderer = glGetString(GL_RENDERER);
+        const GLubyte *version = glGetString(GL_VERSION);
+        return std::string(vendor ? (const char *)vendor : "") + '|' + (renderer ? (const char *)renderer : "") + '|' +
+               (version ? (const char *)version : "");
+    }
+
+    // Programa linkado a partir dos estágios (precisa de um contexto ativo)
+    GLuint build(const ShaderStage *stages, int count) {
+        auto start = std::chrono::steady_clock::now();
+        bool useCache = enabled && isSupported();
+        uint64_t key = sourceHash(stages, count);
+        std::string path = pathFor(key);
+
+        bool stale = false;
+        GLuint program = useCache ? load(path, key, stale) : 0;
+        bool hit = program != 0;
+        if (!hit) {
+            program = compile(stages, count, useCache);
+            GLint success = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &success);
+            if (useCache && success) {
+                save(path, key, program);
+            }
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (hit) {
+            stats.hits++;
+            stats.hitMs += ms;
+        } else {
+            stats.misses++;
+            stats.missMs += ms;
+            stats.invalidated += stale ? 1 : 0;
+        }
+        return program;
+    }
+
+    GLuint build(const char *vertexSource, const char *fragmentSource) {
+        ShaderStage stages[2] = { { GL_VERTEX_SHADER, vertexSource }, { GL_FRAGMENT_SHADER, fragmentSource } };
+        return build(stages, 2);
+    }
+
+    // Com false sempre compila (e não grava nada)
+    void setEnabled(bool value) {
+        enabled = value;
+    }
+
+    // Apaga os binários gravados (a próxima execução começa fria)
+    void clear() {
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+    }
+
+    const ProgramCacheStats &getStats() const {
+        return stats;
+    }
+
+    double getTotalMs() const {
+        return stats.hitMs + stats.missMs;
+    }
+
+    void printReport() const {
+        char line[160];
+        snprintf(line, sizeof(line), "cache de programas: %d do cache (%.2f ms), %d compilados (%.2f ms, %d invalidados)",
+                 stats.hits, stats.hitMs, stats.misses, stats.missMs, stats.invalidated);
+        std::cout << line << (supported == 0 ? "; driver sem binarios de programa" : "") << std::endl;
+    }
+};
+
+#endif /* ProgramCache_h */
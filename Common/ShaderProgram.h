@@ -0,0 +1,171 @@
+//
+//  ShaderProgram.h
+//  Cache de uniforms de um programa de shader
+//
+//  Logo depois do setupShader, o programa é inspecionado uma única vez
+//  (glGetActiveUniform) e cada uniform ativo ganha um "handle" com a location já
+//  resolvida, para que o laço de desenho não chame glGetUniformLocation. Cada
+//  handle guarda o último valor enviado: se o valor não mudou, o glUniform* não
+//  é chamado. Os envios e os envios ignorados são contados por frame.
+//
+//  Como nos demos, os setters usam glUniform*, então o programa precisa estar
+//  em uso (glUseProgram) quando forem chamados.
+//
+
+#ifndef ShaderProgram_h
+#define ShaderProgram_h
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+
+class ShaderProgram {
+    struct Uniform {
+        GLint location;
+        GLenum type;
+        GLint size;               // > 1 para arrays
+        std::vector<unsigned char> value;  // último valor enviado (vazio = nunca enviado)
+    };
+
+    GLuint id;
+    std::vector<Uniform> uniforms;
+    std::unordered_map<std::string, int> handles;
+
+    int uploads, skipped;                  // frame atual
+    int lastUploads, lastSkipped;          // último frame completo
+
+    // Devolve true se o valor é diferente do último enviado (e guarda o novo)
+    bool changed(int handle, const void *data, size_t bytes) {
+        if (handle < 0) {
+            return false;
+        }
+        Uniform &u = uniforms[handle];
+        if (u.value.size() == bytes && memcmp(u.value.data(), data, bytes) == 0) {
+            skipped++;
+            return false;
+        }
+        u.value.assign((const unsigned char *)data, (const unsigned char *)data + bytes);
+        uploads++;
+        return true;
+    }
+
+public:
+    // Recebe o programa já linkado (por exemplo, o retorno de setupShader)
+    explicit ShaderProgram(GLuint programID) {
+        this->id = programID;
+        this->uploads = this->skipped = 0;
+        this->lastUploads = this->lastSkipped = 0;
+
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+        std::vector<GLchar> name(maxLength > 0 ? maxLength : 1);
+        for (GLint i = 0; i < count; i++) {
+            Uniform u;
+            GLsizei length = 0;
+            glGetActiveUniform(programID, i, (GLsizei)name.size(), &length, &u.size, &u.type, name.data());
+            u.location = glGetUniformLocation(programID, name.data());
+            if (u.location < 0) {
+                continue; // uniforms de blocos não têm location
+            }
+
+            std::string key(name.data(), length);
+            handles[key] = (int)uniforms.size();
+            // arrays aparecem como "nome[0]"; aceita também só "nome"
+            size_t bracket = key.find('[');
+            if (bracket != std::string::npos) {
+                handles[key.substr(0, bracket)] = (int)uniforms.size();
+            }
+            uniforms.push_back(u);
+        }
+    }
+
+    GLuint getID() const {
+        return id;
+    }
+
+    void use() const {
+        glUseProgram(id);
+    }
+
+    // Handle de um uniform ativo, ou -1 se o nome não existe (ou foi otimizado
+    // pelo compilador); setters com -1 são ignorados, como glUniform com location -1
+    int uniform(const char *name) const {
+        auto it = handles.find(name);
+        return it == handles.end() ? -1 : it->second;
+    }
+
+    GLint location(int handle) const {
+        return handle < 0 ? -1 : uniforms[handle].location;
+    }
+
+    void setInt(int handle, int value) {
+        if (changed(handle, &value, sizeof(value)))
+            glUniform1i(uniforms[handle].location, value);
+    }
+
+    void setFloat(int handle, float value) {
+        if (changed(handle, &value, sizeof(value)))
+            glUniform1f(uniforms[handle].location, value);
+    }
+
+    void setVec2(int handle, float x, float y) {
+        float v[2] = { x, y };
+        if (changed(handle, v, sizeof(v)))
+            glUniform2fv(uniforms[handle].location, 1, v);
+    }
+
+    void setVec2(int handle, const glm::vec2 &v) {
+        setVec2(handle, v.x, v.y);
+    }
+
+    void setVec4(int handle, float x, float y, float z, float w) {
+        float v[4] = { x, y, z, w };
+        if (changed(handle, v, sizeof(v)))
+            glUniform4fv(uniforms[handle].location, 1, v);
+    }
+
+    void setVec4(int handle, const glm::vec4 &v) {
+        setVec4(handle, v.x, v.y, v.z, v.w);
+    }
+
+    // Arrays de float (uniform float nome[N]); count <= N
+    void setFloatArray(int handle, const float *values, int count) {
+        if (changed(handle, values, count * sizeof(float)))
+            glUniform1fv(uniforms[handle].location, count, values);
+    }
+
+    void setMat4(int handle, const float *m) {
+        if (changed(handle, m, 16 * sizeof(float)))
+            glUniformMatrix4fv(uniforms[handle].location, 1, GL_FALSE, m);
+    }
+
+    void setMat4(int handle, const glm::mat4 &m) {
+        setMat4(handle, glm::value_ptr(m));
+    }
+
+    // Fecha a contagem do frame anterior; chamar uma vez no início de cada frame
+    void beginFrame() {
+        lastUploads = uploads;
+        lastSkipped = skipped;
+        uploads = skipped = 0;
+    }
+
+    // Envios feitos e envios ignorados (valor repetido) no último frame completo
+    int getUploads() const {
+        return lastUploads;
+    }
+
+    int getSkippedUploads() const {
+        return lastSkipped;
+    }
+};
+
+#endif /* ShaderProgram_h */
@@ -0,0 +1,322 @@
+//
+//  ShaderSource.h
+//  Leitura de shaders GLSL de arquivos, com #include e #defines de permutação
+//
+//  Cada arquivo é lido com uma única leitura (tamanho conhecido, sem fgets
+//  linha a linha) e fica no cache junto com a lista dos seus #include, até a
+//  data de modificação mudar. Montar um shader não concatena nada: o resultado
+//  é uma lista de trechos (ponteiro + tamanho) que apontam para o texto já
+//  carregado, entregue direto ao glShaderSource(shader, count, strings,
+//  lengths). O tempo é linear no tamanho dos arquivos. O ShaderSource segura
+//  os arquivos que usa: se o loader reler um deles (mudou no disco, ou
+//  clearCache), os trechos continuam apontando para o texto antigo.
+//
+//  Diretivas:
+//    #include "arquivo.glsl"   procurado na pasta de quem inclui e depois nas
+//                              pastas de addIncludePath; cada arquivo entra uma
+//                              vez só por shader (como #pragma once) e ciclos
+//                              viram erro; o #version de um arquivo incluído
+//                              é descartado
+//    defines                   "NOME" ou "NOME VALOR", inseridos logo depois do
+//                              #version (que precisa ser a primeira diretiva)
+//  Depois de cada trecho vem um "#line N índice", então os erros do compilador
+//  apontam a linha certa; getFiles() traduz o índice para o caminho.
+//
+//  Exemplo:
+//    ShaderSourceLoader loader;
+//    ShaderSource source;
+//    if (loader.load("shaders/sprite.frag", { "USE_FOG", "MAX_LIGHTS 4" }, source)) {
+//        glShaderSource(shader, source.count(), source.strings(), source.lengths());
+//    }
+//
+
+#ifndef ShaderSource_h
+#define ShaderSource_h
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+// Shader montado: os trechos apontam para os arquivos do cache do loader,
+// mantidos vivos por held enquanto o ShaderSource existir
+class ShaderSource {
+    friend class ShaderSourceLoader;
+
+    std::vector<std::shared_ptr<const void>> held;   // arquivos dos trechos
+    std::vector<const GLchar *> pieces;
+    std::vector<GLint> pieceLengths;
+    std::deque<std::string> generated;     // #define e #line (endereços estáveis)
+    std::vector<std::string> files;        // índice do #line -> caminho
+    std::string error;
+
+    void add(const char *text, size_t length) {
+        if (length > 0) {
+            pieces.push_back(text);
+            pieceLengths.push_back((GLint)length);
+        }
+    }
+
+    void addGenerated(const std::string &text) {
+        generated.push_back(text);
+        add(generated.back().data(), generated.back().size());
+    }
+
+public:
+    void clear() {
+        held.clear();
+        pieces.clear();
+        pieceLengths.clear();
+        generated.clear();
+        files.clear();
+        error.clear();
+    }
+
+    GLsizei count() const {
+        return (GLsizei)pieces.size();
+    }
+
+    const GLchar *const *strings() const {
+        return pieces.data();
+    }
+
+    const GLint *lengths() const {
+        return pieceLengths.data();
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (GLint length : pieceLengths) {
+            total += length;
+        }
+        return total;
+    }
+
+    // Texto completo (cópia; só para depurar ou para APIs que pedem uma string)
+    std::string text() const {
+        std::string all;
+        all.reserve(size());
+        for (size_t i = 0; i < pieces.size(); i++) {
+            all.append(pieces[i], pieceLengths[i]);
+        }
+        return all;
+    }
+
+    const std::vector<std::string> &getFiles() const {
+        return files;
+    }
+
+    const std::string &getError() const {
+        return error;
+    }
+};
+
+class ShaderSourceLoader {
+    struct Include {
+        size_t begin, end;         // a linha do #include no texto
+        int line;                  // número da linha seguinte
+        std::string name;
+    };
+
+    struct File {
+        std::string text;
+        std::filesystem::file_time_type modified;
+        std::vector<Include> includes;
+        size_t versionEnd;         // fim da linha do #version (0 se não tem)
+    };
+
+    std::unordered_map<std::string, std::shared_ptr<const File>> files;
+    std::vector<std::string> includePaths;
+    long reads, cacheHits;
+
+    // Diretivas do arquivo numa passada só
+    static void scan(File &file) {
+        const std::string &text = file.text;
+        file.includes.clear();
+        file.versionEnd = 0;
+        size_t pos = 0;
+        int line = 1;
+        bool seenDirective = false;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            end = end == std::string::npos ? text.size() : end + 1;
+            size_t p = pos;
+            while (p < end && (text[p] == ' ' || text[p] == '\t')) {
+                p++;
+            }
+            if (p < end && text[p] == '#') {
+                p++;
+                while (p < end && (text[p] == ' ' || text[p] == '\t')) {
+                    p++;
+                }
+                if (!seenDirective && text.compare(p, 7, "version") == 0) {
+                    file.versionEnd = end;
+                } else if (text.compare(p, 7, "include") == 0) {
+                    size_t open = text.find_first_of("\"<", p + 7);
+                    size_t close = open < end ? text.find_first_of("\">", open + 1) : std::string::npos;
+                    if (close < end) {
+                        file.includes.push_back({ pos, end, line + 1, text.substr(open + 1, close - open - 1) });
+                    }
+                }
+                seenDirective = true;
+            }
+            pos = end;
+            line++;
+        }
+    }
+
+    // Arquivo do cache, relido se mudou no disco (a versão antiga fica com
+    // quem ainda a segura); nullptr se não existe
+    std::shared_ptr<const File> get(const std::string &path) {
+        std::error_code error;
+        auto modified = std::filesystem::last_write_time(path, error);
+        if (error) {
+            return nullptr;
+        }
+        auto found = files.find(path);
+        if (found != files.end() && found->second->modified == modified) {
+            cacheHits++;
+            return found->second;
+        }
+
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            return nullptr;
+        }
+        auto loaded = std::make_shared<File>();
+        File &file = *loaded;
+        file.modified = modified;
+        file.text.resize((size_t)in.tellg());
+        in.seekg(0);
+        in.read(&file.text[0], file.text.size());
+        if (!in) {
+            return nullptr;
+        }
+        if (!file.text.empty() && file.text.back() != '\n') {
+            file.text += '\n'; // o próximo trecho começa numa linha nova
+        }
+        scan(file);
+        reads++;
+        files[path] = loaded;
+        return loaded;
+    }
+
+    std::string resolve(const std::string &from, const std::string &name) const {
+        std::filesystem::path local = std::filesystem::path(from).parent_path() / name;
+        if (std::filesystem::exists(local)) {
+            return local.lexically_normal().generic_string();
+        }
+        for (const std::string &dir : includePaths) {
+            std::filesystem::path candidate = std::filesystem::path(dir) / name;
+            if (std::filesystem::exists(candidate)) {
+                return candidate.lexically_normal().generic_string();
+            }
+        }
+        return std::string();
+    }
+
+    bool expand(const std::string &path, const std::vector<std::string> &defines, bool root,
+                std::vector<std::string> &stack, ShaderSource &out) {
+        std::shared_ptr<const File> file = get(path);
+        if (!file) {
+            out.error = "arquivo de shader nao encontrado: " + path;
+            return false;
+        }
+        out.held.push_back(file);
+        int index = (int)out.files.size();
+        out.files.push_back(path);
+        stack.push_back(path);
+
+        size_t pos = 0;
+        if (root && !defines.empty()) {
+            // #version, depois os defines, depois o resto a partir da linha 2
+            out.add(file->text.data(), file->versionEnd);
+            std::string block;
+            for (const std::string &define : defines) {
+                block += "#define " + define + "\n";
+            }
+            out.addGenerated(block);
+            pos = file->versionEnd;
+            if (pos > 0) {
+                out.addGenerated("#line 2 " + std::to_string(index) + "\n");
+            }
+        } else if (!root && file->versionEnd > 0) {
+            // #version de um arquivo incluído (para ele compilar sozinho) fica de fora
+            pos = file->versionEnd;
+            out.addGenerated("#line 2 " + std::to_string(index) + "\n");
+        }
+
+        for (const Include &inc : file->includes) {
+            out.add(file->text.data() + pos, inc.begin - pos);
+            pos = inc.end;
+            std::string target = resolve(path, inc.name);
+            if (target.empty()) {
+                out.error = path + ":" + std::to_string(inc.line - 1) + ": #include nao encontrado: " + inc.name;
+                return false;
+            }
+            for (const std::string &open : stack) {
+                if (open == target) {
+                    out.error = path + ":" + std::to_string(inc.line - 1) + ": #include circular: " + inc.name;
+                    return false;
+                }
+            }
+            bool already = false;
+            for (const std::string &done : out.files) {
+                already = already || done == target;
+            }
+            if (!already) {
+                out.addGenerated("#line 1 " + std::to_string(out.files.size()) + "\n");
+                if (!expand(target, defines, false, stack, out)) {
+                    return false;
+                }
+            }
+            out.addGenerated("#line " + std::to_string(inc.line) + " " + std::to_string(index) + "\n");
+        }
+        out.add(file->text.data() + pos, file->text.size() - pos);
+        stack.pop_back();
+        return true;
+    }
+
+public:
+    ShaderSourceLoader() {
+        this->reads = 0;
+        this->cacheHits = 0;
+    }
+
+    // Pasta extra para os #include (depois da pasta de quem inclui)
+    void addIncludePath(const std::string &dir) {
+        includePaths.push_back(dir);
+    }
+
+    // Monta o shader do arquivo; false com a mensagem em out.getError()
+    bool load(const std::string &path, const std::vector<std::string> &defines, ShaderSource &out) {
+        out.clear();
+        std::vector<std::string> stack;
+        return expand(std::filesystem::path(path).lexically_normal().generic_string(), defines, true, stack, out);
+    }
+
+    bool load(const std::string &path, ShaderSource &out) {
+        return load(path, std::vector<std::string>(), out);
+    }
+
+    // Arquivos lidos do disco x reaproveitados do cache
+    long getReads() const {
+        return reads;
+    }
+
+    long getCacheHits() const {
+        return cacheHits;
+    }
+
+    void clearCache() {
+        files.clear();
+    }
+};
+
+#endif /* ShaderSource_h */
@@ -0,0 +1,242 @@
+//
+//  SpriteBatch.h
+//  Renderizador de sprites instanciado
+//
+//  Todos os sprites compartilham um único VAO com o quad unitário; os dados de
+//  cada sprite (matriz de modelo, retângulo de UV e camada da textura) vão para
+//  um buffer de instâncias que é reescrito a cada frame. Sprites consecutivos
+//  com a mesma textura viram uma única chamada glDrawArraysInstanced.
+//
+//  Layout esperado no vertex shader:
+//    location 0     -> vec3 position   (quad unitário)
+//    location 1     -> vec2 texc       (coordenada de textura do quad, 0..1)
+//    location 2..5  -> mat4 model      (por instância)
+//    location 6     -> vec4 uvRect     (por instância: offset.xy, escala.zw)
+//    location 7     -> float layer     (por instância: camada em GL_TEXTURE_2D_ARRAY)
+//
+
+#ifndef SpriteBatch_h
+#define SpriteBatch_h
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// Dados enviados para a GPU por sprite (um elemento do buffer de instâncias)
+struct SpriteInstance {
+    float model[16];
+    float uvRect[4];
+    float layer;
+};
+
+enum SpriteSortMode {
+    SPRITE_SORT_NONE,    // mantém a ordem de submissão (só junta sprites consecutivos da mesma textura)
+    SPRITE_SORT_TEXTURE  // ordena (estável) por textura: mínimo de draw calls, ordem de pintura por textura
+};
+
+class SpriteBatch {
+    GLuint VAO;
+    GLuint quadVBO;
+    GLuint instanceVBO;
+    int capacity;          // quantas instâncias cabem no buffer da GPU
+    SpriteSortMode sortMode;
+
+    std::vector<SpriteInstance> instances;
+    std::vector<GLuint> textures;     // textura de cada instância submetida
+    std::vector<GLenum> targets;      // GL_TEXTURE_2D ou GL_TEXTURE_2D_ARRAY
+    std::vector<int> order;           // índices das instâncias na ordem de desenho
+    std::vector<SpriteInstance> staging;
+
+    int drawCalls;
+    int spriteCount;
+
+    void setupQuad() {
+        GLfloat vertices[] = {
+            // x   y    z    s     t
+            -0.5,  0.5, 0.0, 0.0, 1.0, //V0
+            -0.5, -0.5, 0.0, 0.0, 0.0, //V1
+             0.5,  0.5, 0.0, 1.0, 1.0, //V2
+             0.5, -0.5, 0.0, 1.0, 0.0  //V3
+        };
+
+        glGenVertexArrays(1, &VAO);
+        glBindVertexArray(VAO);
+
+        glGenBuffers(1, &quadVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(1);
+
+        glGenBuffers(1, &instanceVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(SpriteInstance), NULL, GL_STREAM_DRAW);
+
+        for (int i = 0; i < 6; i++) {
+            glEnableVertexAttribArray(2 + i);
+            glVertexAttribDivisor(2 + i, 1);
+        }
+        pointInstanceAttributes(0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    // Aponta os atributos por instância para a instância "first" do buffer.
+    // Sem glDrawArraysInstancedBaseInstance (GL 4.2) é assim que cada grupo de
+    // textura começa no lugar certo do buffer. Espera o VAO e o instanceVBO vinculados.
+    void pointInstanceAttributes(int first) {
+        const GLsizei stride = sizeof(SpriteInstance);
+        const size_t base = first * sizeof(SpriteInstance);
+        for (int c = 0; c < 4; c++) {
+            glVertexAttribPointer(2 + c, 4, GL_FLOAT, GL_FALSE, stride,
+                                  (GLvoid *)(base + offsetof(SpriteInstance, model) + c * 4 * sizeof(float)));
+        }
+        glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid *)(base + offsetof(SpriteInstance, uvRect)));
+        glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid *)(base + offsetof(SpriteInstance, layer)));
+    }
+
+public:
+    SpriteBatch(int initialCapacity = 1024, SpriteSortMode mode = SPRITE_SORT_NONE) {
+        this->capacity = initialCapacity > 0 ? initialCapacity : 1;
+        this->sortMode = mode;
+        this->drawCalls = 0;
+        this->spriteCount = 0;
+        setupQuad();
+    }
+
+    // Libera os buffers da GPU; deve ser chamado antes do glfwTerminate,
+    // enquanto o contexto ainda existe
+    void release() {
+        glDeleteBuffers(1, &instanceVBO);
+        glDeleteBuffers(1, &quadVBO);
+        glDeleteVertexArrays(1, &VAO);
+        instanceVBO = quadVBO = VAO = 0;
+    }
+
+    SpriteBatch(const SpriteBatch &) = delete;
+    SpriteBatch &operator=(const SpriteBatch &) = delete;
+
+    void setSortMode(SpriteSortMode mode) {
+        this->sortMode = mode;
+    }
+
+    // Começa um novo frame, descartando os sprites do frame anterior
+    void begin() {
+        instances.clear();
+        textures.clear();
+        targets.clear();
+        drawCalls = 0;
+        spriteCount = 0;
+    }
+
+    // Sprite com a matriz de modelo já pronta
+    void draw(GLuint texID, const float *model, const glm::vec4 &uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+              float layer = 0.0f, GLenum target = GL_TEXTURE_2D) {
+        SpriteInstance inst;
+        std::copy(model, model + 16, inst.model);
+        inst.uvRect[0] = uvRect.x;
+        inst.uvRect[1] = uvRect.y;
+        inst.uvRect[2] = uvRect.z;
+        inst.uvRect[3] = uvRect.w;
+        inst.layer = layer;
+        instances.push_back(inst);
+        textures.push_back(texID);
+        targets.push_back(target);
+    }
+
+    // Equivalente a translate(position) * rotate(rotation, z) * scale(dimensions),
+    // montado direto nas colunas da matriz (sem multiplicações 4x4)
+    void draw(GLuint texID, const glm::vec3 &position, const glm::vec3 &dimensions,
+              const glm::vec4 &uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), float rotation = 0.0f,
+              float layer = 0.0f, GLenum target = GL_TEXTURE_2D) {
+        float c = 1.0f, s = 0.0f;
+        if (rotation != 0.0f) {
+            c = cosf(rotation);
+            s = sinf(rotation);
+        }
+        float model[16] = {
+             c * dimensions.x, s * dimensions.x, 0.0f, 0.0f,
+            -s * dimensions.y, c * dimensions.y, 0.0f, 0.0f,
+             0.0f, 0.0f, dimensions.z, 0.0f,
+             position.x, position.y, position.z, 1.0f
+        };
+        draw(texID, model, uvRect, layer, target);
+    }
+
+    // Envia as instâncias para a GPU e desenha um grupo por textura.
+    // O shader já deve estar em uso e a unidade de textura ativa escolhida.
+    void end() {
+        spriteCount = (int)instances.size();
+        if (spriteCount == 0) {
+            return;
+        }
+
+        order.resize(spriteCount);
+        for (int i = 0; i < spriteCount; i++) {
+            order[i] = i;
+        }
+        if (sortMode == SPRITE_SORT_TEXTURE) {
+            std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+                return textures[a] < textures[b];
+            });
+        }
+
+        const SpriteInstance *upload = instances.data();
+        if (sortMode == SPRITE_SORT_TEXTURE) {
+            staging.resize(spriteCount);
+            for (int i = 0; i < spriteCount; i++) {
+                staging[i] = instances[order[i]];
+            }
+            upload = staging.data();
+        }
+
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        while (capacity < spriteCount) {
+            capacity *= 2;
+        }
+        // "orphaning": o driver entrega um buffer novo em vez de esperar a GPU
+        // terminar de ler o conteúdo do frame anterior
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(SpriteInstance), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, spriteCount * sizeof(SpriteInstance), upload);
+
+        int first = 0;
+        while (first < spriteCount) {
+            GLuint tex = textures[order[first]];
+            GLenum target = targets[order[first]];
+            int last = first + 1;
+            while (last < spriteCount && textures[order[last]] == tex) {
+                last++;
+            }
+
+            pointInstanceAttributes(first);
+            glBindTexture(target, tex);
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, last - first);
+            drawCalls++;
+
+            first = last;
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    int getDrawCalls() const {
+        return drawCalls;
+    }
+
+    int getSpriteCount() const {
+        return spriteCount;
+    }
+};
+
+#endif /* SpriteBatch_h */
@@ -0,0 +1,170 @@
+//
+//  TextureAtlas.h
+//  Leitura do atlas gerado pelo AtlasPacker (src/Tools/AtlasPacker.cpp)
+//
+//  Carrega o manifesto atlas.bin e as páginas atlas_<n>.png, e resolve o nome de
+//  um asset (caminho relativo a assets/, ex.: "sprites/coruja.png") para a
+//  textura da página e o retângulo de UV da imagem dentro dela. Sprites que
+//  caem na mesma página compartilham a textura e podem sair numa única chamada
+//  de desenho (ver SpriteBatch.h).
+//
+//  O stb_image precisa ter a implementação no executável (STB_IMAGE_IMPLEMENTATION).
+//
+
+#ifndef TextureAtlas_h
+#define TextureAtlas_h
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#ifndef STBI_INCLUDE_STB_IMAGE_H
+#include <stb_image.h>
+#endif
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+
+struct AtlasRegion {
+    GLuint texID;         // textura da página
+    int page;
+    glm::vec4 uvRect;     // offset.xy e escala.zw dentro da página (formato do SpriteBatch)
+    int width, height;    // tamanho original da imagem, em pixels
+};
+
+class TextureAtlas {
+    std::vector<GLuint> pages;
+    std::unordered_map<std::string, AtlasRegion> regions;
+
+    static bool readU16(std::ifstream &in, int &value) {
+        unsigned char b[2];
+        if (!in.read((char *)b, 2)) return false;
+        value = b[0] | (b[1] << 8);
+        return true;
+    }
+
+    static bool readU32(std::ifstream &in, uint32_t &value) {
+        unsigned char b[4];
+        if (!in.read((char *)b, 4)) return false;
+        value = b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+        return true;
+    }
+
+    static bool readName(std::ifstream &in, std::string &name) {
+        unsigned char len;
+        if (!in.read((char *)&len, 1)) return false;
+        name.resize(len);
+        return len == 0 || (bool)in.read(&name[0], len);
+    }
+
+    static GLuint uploadPage(const std::string &filePath) {
+        GLuint texID;
+        glGenTextures(1, &texID);
+        glBindTexture(GL_TEXTURE_2D, texID);
+
+        // Nada de GL_REPEAT: as bordas das imagens são as bordas de outras imagens
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        int width, height, nrChannels;
+        unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 4);
+        if (data) {
+            // sem mipmaps: os níveis menores misturariam imagens vizinhas
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        } else {
+            std::cout << "Failed to load atlas page " << filePath << std::endl;
+        }
+        stbi_image_free(data);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return texID;
+    }
+
+public:
+    // Lê o manifesto e carrega as páginas que estão na mesma pasta dele.
+    // Retorna false se o arquivo não existe ou é inválido (o chamador pode
+    // voltar para as texturas avulsas).
+    bool load(const std::string &manifestPath) {
+        std::ifstream in(manifestPath, std::ios::binary);
+        if (!in) {
+            return false;
+        }
+
+        char magic[4];
+        uint32_t version, pageCount, imageCount;
+        if (!in.read(magic, 4) || memcmp(magic, "ATLS", 4) != 0 ||
+            !readU32(in, version) || version != 1 ||
+            !readU32(in, pageCount) || !readU32(in, imageCount)) {
+            std::cout << "Invalid atlas manifest " << manifestPath << std::endl;
+            return false;
+        }
+
+        std::string dir;
+        size_t slash = manifestPath.find_last_of("/\\");
+        if (slash != std::string::npos) {
+            dir = manifestPath.substr(0, slash + 1);
+        }
+
+        std::vector<glm::vec2> pageSizes;
+        for (uint32_t p = 0; p < pageCount; p++) {
+            int w, h;
+            std::string name;
+            if (!readU16(in, w) || !readU16(in, h) || !readName(in, name)) {
+                return false;
+            }
+            pageSizes.push_back(glm::vec2((float)w, (float)h));
+            pages.push_back(uploadPage(dir + name));
+        }
+
+        for (uint32_t i = 0; i < imageCount; i++) {
+            std::string name;
+            int page, x, y, w, h;
+            if (!readName(in, name) || !readU16(in, page) || !readU16(in, x) || !readU16(in, y) ||
+                !readU16(in, w) || !readU16(in, h) || page >= (int)pages.size()) {
+                return false;
+            }
+            AtlasRegion region;
+            region.texID = pages[page];
+            region.page = page;
+            region.width = w;
+            region.height = h;
+            glm::vec2 size = pageSizes[page];
+            region.uvRect = glm::vec4(x / size.x, y / size.y, w / size.x, h / size.y);
+            regions[name] = region;
+        }
+        return true;
+    }
+
+    // name: caminho relativo a assets/, ex.: "sprites/coruja.png"
+    bool find(const std::string &name, AtlasRegion &region) const {
+        auto it = regions.find(name);
+        if (it == regions.end()) {
+            return false;
+        }
+        region = it->second;
+        return true;
+    }
+
+    int getPageCount() const {
+        return (int)pages.size();
+    }
+
+    // Libera as texturas das páginas; chamar antes do glfwTerminate
+    void release() {
+        if (!pages.empty()) {
+            glDeleteTextures((GLsizei)pages.size(), pages.data());
+        }
+        pages.clear();
+        regions.clear();
+    }
+};
+
+#endif /* TextureAtlas_h */
@@ -0,0 +1,241 @@
+//
+//  TextureManager.h
+//  Cache de texturas por caminho + parâmetros, com contagem de referências e
+//  limite de memória de vídeo
+//
+//  Substitui as cópias do loadTexture que cada demo tinha. Pedir o mesmo
+//  arquivo com os mesmos parâmetros devolve a mesma textura (hit) e só
+//  incrementa a contagem de referências; um miss carrega a imagem pelo
+//  AsyncTextureLoader (decodificação em threads, upload por PBO).
+//
+//  release(tex) devolve uma referência. Uma textura sem referências continua
+//  na GPU, para o caso de ser pedida de novo, até o total passar do orçamento
+//  de VRAM: aí as texturas sem referências são apagadas, da que está sem uso há
+//  mais tempo para a mais recente. Texturas em uso nunca são apagadas, então o
+//  orçamento pode ser ultrapassado se todas estiverem em uso.
+//
+//  Com useBakedPack, os arquivos que estão no pacote do TextureBaker são
+//  carregados de lá (já decodificados, com mipmaps, direto da memória
+//  mapeada), num formato comprimido quando o driver aceita, e os demais
+//  continuam pelo loader assíncrono.
+//
+//  Os bytes dos PNGs são uma estimativa: largura x altura x 4 (os drivers
+//  guardam RGB como RGBA), mais 1/3 com mipmaps.
+//
+//  Exemplo:
+//    TextureManager textureManager;              // orçamento padrão: 256 MB
+//    GLuint tex = textureManager.acquire("../assets/sprites/coruja.png", width, height);
+//    while (...) { textureManager.update(); ... desenho ... }
+//    textureManager.releaseAll();                // antes do glfwTerminate
+//
+
+#ifndef TextureManager_h
+#define TextureManager_h
+
+#include "AsyncTextureLoader.h"
+#include "BakedTextures.h"
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <iostream>
+
+struct TextureStats {
+    long hits, misses, evictions;
+    long baked;              // misses atendidos pelo pacote pré-decodificado
+    long compressed;         // ... dos quais em formato comprimido (BC/ETC2)
+    size_t residentBytes, peakBytes;
+    int textures;
+};
+
+class TextureManager {
+    struct Entry {
+        GLuint texID;
+        int width, height;
+        size_t bytes;
+        int refs;
+        std::list<std::string>::iterator unusedIt;   // válido só com refs == 0
+    };
+
+    AsyncTextureLoader loader;
+    BakedTexturePack baked;
+    std::string bakedRoot;   // prefixo dos caminhos que o pacote cobre
+    std::unordered_map<std::string, Entry> entries;
+    std::unordered_map<GLuint, std::string> keyOf;
+    std::list<std::string> unused;   // sem referências, do mais antigo ao mais recente
+    size_t budgetBytes;
+    TextureStats stats;
+
+    static std::string makeKey(const std::string &filePath, const TextureParams &params) {
+        return filePath + '|' + std::to_string(params.wrapS) + ',' + std::to_string(params.wrapT) + ',' +
+               std::to_string(params.minFilter) + ',' + std::to_string(params.magFilter) + ',' +
+               (params.mipmaps ? '1' : '0');
+    }
+
+    // Nome no pacote ("sprites/coruja.png") de um caminho do demo, ou nullptr
+    const BakedTexture *findBaked(const std::string &filePath, std::string &name) const {
+        if (!baked.isOpen() || filePath.compare(0, bakedRoot.size(), bakedRoot) != 0) {
+            return nullptr;
+        }
+        name = filePath.substr(bakedRoot.size());
+        const BakedTexture *tex = baked.find(name);
+        // os demos desenham com alfa comum
+        return tex && !tex->premultiplied ? tex : nullptr;
+    }
+
+    static size_t estimateBytes(int width, int height, bool mipmaps) {
+        size_t bytes = (size_t)width * height * 4;
+        return mipmaps ? bytes + bytes / 3 : bytes;
+    }
+
+    // Apaga texturas sem referências até caber no orçamento
+    void evict() {
+        auto it = unused.begin();
+        while (stats.residentBytes > budgetBytes && it != unused.end()) {
+            Entry &entry = entries[*it];
+            if (loader.isLoading(entry.texID)) {
+                ++it; // o upload ainda vai escrever nela
+                continue;
+            }
+            glDeleteTextures(1, &entry.texID);
+            stats.residentBytes -= entry.bytes;
+            stats.textures--;
+            stats.evictions++;
+            keyOf.erase(entry.texID);
+            std::string key = *it;
+            it = unused.erase(it);
+            entries.erase(key);
+        }
+    }
+
+public:
+    explicit TextureManager(size_t budgetBytes = (size_t)256 << 20) {
+        this->budgetBytes = budgetBytes;
+        this->stats = TextureStats();
+    }
+
+    TextureManager(const TextureManager &) = delete;
+    TextureManager &operator=(const TextureManager &) = delete;
+
+    // Textura do arquivo (já carregada ou com a imagem provisória até o upload
+    // terminar); width e height saem com o tamanho da imagem
+    GLuint acquire(const std::string &filePath, int &width, int &height, const TextureParams &params = TextureParams()) {
+        std::string key = makeKey(filePath, params);
+        auto found = entries.find(key);
+        if (found != entries.end()) {
+            Entry &entry = found->second;
+            if (entry.refs++ == 0) {
+                unused.erase(entry.unusedIt);
+            }
+            stats.hits++;
+            width = entry.width;
+            height = entry.height;
+            return entry.texID;
+        }
+
+        stats.misses++;
+        Entry entry;
+        std::string bakedName;
+        const BakedTexture *bakedTex = findBaked(filePath, bakedName);
+        entry.texID = bakedTex ? baked.loadTexture(bakedName, width, height, params) : 0;
+        if (entry.texID) {
+            entry.bytes = baked.residentBytes(*bakedTex, params.mipmaps);
+            stats.baked++;
+            if (baked.chooseVariant(*bakedTex)->format != BAKED_RGBA8) {
+                stats.compressed++;
+            }
+        } else {
+            entry.texID = loader.request(filePath, width, height, params);
+            entry.bytes = estimateBytes(width, height, params.mipmaps);
+        }
+        entry.width = width;
+        entry.height = height;
+        entry.refs = 1;
+        entries[key] = entry;
+        keyOf[entry.texID] = key;
+        stats.residentBytes += entry.bytes;
+        stats.peakBytes = std::max(stats.peakBytes, stats.residentBytes);
+        stats.textures++;
+        evict();
+        return entry.texID;
+    }
+
+    GLuint acquire(const std::string &filePath, const TextureParams &params = TextureParams()) {
+        int width, height;
+        return acquire(filePath, width, height, params);
+    }
+
+    // Devolve uma referência; sem referências a textura pode ser apagada
+    void release(GLuint texID) {
+        auto found = keyOf.find(texID);
+        if (found == keyOf.end()) {
+            return;
+        }
+        Entry &entry = entries[found->second];
+        if (entry.refs > 0 && --entry.refs == 0) {
+            entry.unusedIt = unused.insert(unused.end(), found->second);
+            evict();
+        }
+    }
+
+    // Abre o pacote do TextureBaker; os caminhos que começam com assetsRoot
+    // passam a ser procurados nele. Sem o pacote tudo continua pelos PNGs
+    bool useBakedPack(const std::string &packPath, const std::string &assetsRoot = "../assets/") {
+        bakedRoot = assetsRoot;
+        return baked.open(packPath);
+    }
+
+    // Com false o pacote envia tudo em RGBA8, mesmo com compressão no driver
+    void setCompression(bool enabled) {
+        baked.setCompression(enabled);
+    }
+
+    void setBudget(size_t bytes) {
+        budgetBytes = bytes;
+        evict();
+    }
+
+    size_t getBudget() const {
+        return budgetBytes;
+    }
+
+    // Uma vez por frame, na thread do OpenGL (uploads pendentes)
+    void update() {
+        loader.update();
+        if (stats.residentBytes > budgetBytes) {
+            evict(); // texturas que esperavam o upload terminar
+        }
+    }
+
+    const TextureStats &getStats() const {
+        return stats;
+    }
+
+    AsyncTextureLoader &getLoader() {
+        return loader;
+    }
+
+    void printReport() const {
+        loader.printReport();
+        std::cout << "cache de texturas: " << stats.hits << " hits, " << stats.misses << " misses, "
+                  << stats.evictions << " removidas, " << stats.baked << " do pacote (" << stats.compressed << " comprimidas); " << stats.textures << " residentes, "
+                  << stats.residentBytes / 1024 << " KB (pico " << stats.peakBytes / 1024 << " KB, orcamento "
+                  << budgetBytes / 1024 << " KB)" << std::endl;
+    }
+
+    // Apaga todas as texturas e para o loader; chamar antes do glfwTerminate
+    void releaseAll() {
+        loader.release();
+        for (auto &item : entries) {
+            glDeleteTextures(1, &item.second.texID);
+        }
+        baked.close();
+        entries.clear();
+        keyOf.clear();
+        unused.clear();
+        stats.residentBytes = 0;
+        stats.textures = 0;
+    }
+};
+
+#endif /* TextureManager_h */
@@ -0,0 +1,241 @@
+//
+//  TriangleIndex.h
+//  Índice espacial dinâmico para escolher com o mouse o triângulo de cima
+//
+//  Grade uniforme com hash (sem limites de mundo): cada triângulo é registrado
+//  em todas as células que o seu retângulo envolvente (já transformado) toca.
+//  O id de um triângulo é a sua posição na ordem de desenho, então um id maior
+//  está por cima. Dentro de cada célula os ids ficam em ordem crescente e a
+//  busca percorre a célula de trás para frente: o primeiro triângulo que
+//  contém o ponto é o de cima, e a busca para aí. O teste exato usa as funções
+//  de aresta do TriangleBatch (ltMathBatch.h).
+//
+//  Mover (update) e apagar (remove) não limpam as células antigas na hora: a
+//  entrada velha só é descartada quando o teste exato falha nela. Quando essas
+//  entradas velhas passam da metade do total, a grade é refeita.
+//
+//  Apagar deixa um buraco no id; compact(items) fecha os buracos, mantendo a
+//  ordem, no índice e no vetor de objetos do demo ao mesmo tempo.
+//
+//  Exemplo:
+//    TriangleIndex index(64.0f);
+//    int id = index.insert(vertices);      // { x0, y0, x1, y1, x2, y2 }
+//    int top = index.pick(mouseX, mouseY); // -1 se não há triângulo
+//
+
+#ifndef TriangleIndex_h
+#define TriangleIndex_h
+
+#include "ltMathBatch.h"
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+class TriangleIndex {
+    struct Bounds {
+        int x0, y0, x1, y1;   // células ocupadas (inclusive)
+    };
+
+    float cellSize;
+    TriangleBatch edges;                 // funções de aresta por id
+    std::vector<float> vertices;         // 6 floats por id
+    std::vector<Bounds> bounds;
+    std::vector<bool> alive;
+    std::unordered_map<uint64_t, std::vector<int>> cells;
+    size_t entries, stale;
+    int liveCount;
+
+    static uint64_t key(int cx, int cy) {
+        return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+    }
+
+    int cellOf(float v) const {
+        return (int)std::floor(v / cellSize);
+    }
+
+    Bounds boundsOf(const float *t) const {
+        float minX = std::min(t[0], std::min(t[2], t[4]));
+        float maxX = std::max(t[0], std::max(t[2], t[4]));
+        float minY = std::min(t[1], std::min(t[3], t[5]));
+        float maxY = std::max(t[1], std::max(t[3], t[5]));
+        return { cellOf(minX), cellOf(minY), cellOf(maxX), cellOf(maxY) };
+    }
+
+    static bool inside(const Bounds &b, int cx, int cy) {
+        return cx >= b.x0 && cx <= b.x1 && cy >= b.y0 && cy <= b.y1;
+    }
+
+    // Coloca id na célula mantendo a ordem; ids novos (os maiores) só fazem push_back
+    void addToCell(int cx, int cy, int id) {
+        std::vector<int> &cell = cells[key(cx, cy)];
+        if (cell.empty() || cell.back() < id) {
+            cell.push_back(id);
+            entries++;
+            return;
+        }
+        auto it = std::lower_bound(cell.begin(), cell.end(), id);
+        if (it != cell.end() && *it == id) {
+            stale--; // entrada velha que volta a valer
+            return;
+        }
+        cell.insert(it, id);
+        entries++;
+    }
+
+    void addToCells(int id, const Bounds &b) {
+        for (int cy = b.y0; cy <= b.y1; cy++) {
+            for (int cx = b.x0; cx <= b.x1; cx++) {
+                addToCell(cx, cy, id);
+            }
+        }
+    }
+
+    static int cellArea(const Bounds &b) {
+        return (b.x1 - b.x0 + 1) * (b.y1 - b.y0 + 1);
+    }
+
+    void rebuildIfStale() {
+        if (stale > 1024 && stale * 2 > entries) {
+            rebuild();
+        }
+    }
+
+public:
+    // cellSize: lado da célula, na mesma unidade dos vértices (algo perto do
+    // tamanho típico de um triângulo)
+    explicit TriangleIndex(float cellSize = 64.0f) {
+        this->cellSize = cellSize;
+        this->entries = 0;
+        this->stale = 0;
+        this->liveCount = 0;
+    }
+
+    // Acrescenta um triângulo por cima de todos; retorna o id (= ordem de desenho)
+    int insert(const float *t) {
+        int id = (int)alive.size();
+        edges.add(t);
+        vertices.insert(vertices.end(), t, t + 6);
+        Bounds b = boundsOf(t);
+        bounds.push_back(b);
+        alive.push_back(true);
+        liveCount++;
+        addToCells(id, b);
+        return id;
+    }
+
+    // Novos vértices para um triângulo existente (arrastar); a ordem não muda
+    void update(int id, const float *t) {
+        if (id < 0 || id >= (int)alive.size() || !alive[id]) {
+            return;
+        }
+        edges.set(id, t);
+        std::copy(t, t + 6, vertices.begin() + (size_t)id * 6);
+        Bounds old = bounds[id];
+        Bounds b = boundsOf(t);
+        bounds[id] = b;
+        // só as células que entram e as que saem mudam
+        for (int cy = b.y0; cy <= b.y1; cy++) {
+            for (int cx = b.x0; cx <= b.x1; cx++) {
+                if (!inside(old, cx, cy)) {
+                    addToCell(cx, cy, id);
+                }
+            }
+        }
+        for (int cy = old.y0; cy <= old.y1; cy++) {
+            for (int cx = old.x0; cx <= old.x1; cx++) {
+                if (!inside(b, cx, cy)) {
+                    stale++;
+                }
+            }
+        }
+        rebuildIfStale();
+    }
+
+    void remove(int id) {
+        if (id < 0 || id >= (int)alive.size() || !alive[id]) {
+            return;
+        }
+        alive[id] = false;
+        liveCount--;
+        float none[6] = { 0, 0, 0, 0, 0, 0 };
+        edges.set(id, none); // degenerado: nunca mais colide
+        stale += cellArea(bounds[id]);
+        rebuildIfStale();
+    }
+
+    // Id do triângulo de cima que contém (x, y), ou -1
+    int pick(float x, float y) const {
+        auto it = cells.find(key(cellOf(x), cellOf(y)));
+        if (it == cells.end()) {
+            return -1;
+        }
+        const std::vector<int> &cell = it->second;
+        for (size_t i = cell.size(); i-- > 0;) {
+            if (edges.contains(cell[i], x, y)) {
+                return cell[i];
+            }
+        }
+        return -1;
+    }
+
+    // Refaz as células só com as entradas válidas
+    void rebuild() {
+        cells.clear();
+        entries = 0;
+        stale = 0;
+        for (int id = 0; id < (int)alive.size(); id++) {
+            if (alive[id]) {
+                addToCells(id, bounds[id]);
+            }
+        }
+    }
+
+    // Fecha os buracos deixados por remove: items[id] acompanha o id, e os dois
+    // são compactados juntos, preservando a ordem de desenho
+    template <typename T>
+    void compact(std::vector<T> &items) {
+        TriangleIndex packed(cellSize);
+        packed.cells.reserve(cells.size());
+        std::vector<T> kept;
+        kept.reserve(liveCount);
+        for (int id = 0; id < (int)alive.size(); id++) {
+            if (alive[id]) {
+                packed.insert(&vertices[(size_t)id * 6]);
+                kept.push_back(items[id]);
+            }
+        }
+        *this = std::move(packed);
+        items.swap(kept);
+    }
+
+    bool isAlive(int id) const {
+        return id >= 0 && id < (int)alive.size() && alive[id];
+    }
+
+    const float *getVertices(int id) const {
+        return &vertices[(size_t)id * 6];
+    }
+
+    // Ids usados (vivos e apagados) e ids vivos
+    int size() const {
+        return (int)alive.size();
+    }
+
+    int getLiveCount() const {
+        return liveCount;
+    }
+
+    // Entradas nas células (inclusive as velhas) e quantas delas são velhas
+    size_t getEntryCount() const {
+        return entries;
+    }
+
+    size_t getStaleCount() const {
+        return stale;
+    }
+};
+
+#endif /* TriangleIndex_h */
@@ -13,13 +13,14 @@
 | it is really making life easier.                                             |
 \******************************************************************************/
 #include "gl_utils.h"
+#include "ProgramCache.h"
+#include "ShaderSource.h"
 
 #include <stdio.h>
 #include <time.h>
 #include <string.h>
 #include <assert.h>
 #define GL_LOG_FILE "gl.log"
-#define MAX_SHADER_LENGTH 262144
 
 /*--------------------------------LOG FUNCTIONS-------------------------------*/
 bool restart_gl_log () {
@@ -160,32 +161,19 @@ void _update_fps_counter (GLFWwindow* window) {
 }
 
 /*-----------------------------------SHADERS----------------------------------*/
-bool parse_file_into_str (
-	const char* file_name, char* shader_str, int max_len
+/* shader files are read whole, once, and kept with their #include list until
+they change on disk; the assembled source is a list of pieces pointing into
+those files, handed straight to glShaderSource (see ShaderSource.h). each
+ShaderSource holds the files it points into, so the vertex pieces stay valid
+even if an include is reloaded while the fragment stage is loading */
+static ShaderSourceLoader g_shader_loader;
+
+bool load_shader_source (
+	const char* file_name, const vector<string>& defines, ShaderSource* source
 ) {
-	shader_str[0] = '\0'; // reset string
-	FILE* file = fopen (file_name , "r");
-	if (!file) {
-		gl_log_err ("ERROR: opening file for reading: %s\n", file_name);
-		return false;
-	}
-	int current_len = 0;
-	char line[2048];
-	strcpy (line, ""); // remember to clean up before using for first time!
-	while (!feof (file)) {
-		if (NULL != fgets (line, 2048, file)) {
-			current_len += strlen (line); // +1 for \n at end
-			if (current_len >= max_len) {
-				gl_log_err (
-					"ERROR: shader length is longer than string buffer length %i\n",
-					max_len
-				);
-			}
-			strcat (shader_str, line);
-		}
-	}
-	if (EOF == fclose (file)) { // probably unnecesssary validation
-		gl_log_err ("ERROR: closing file from reading %s\n", file_name);
+	if (!g_shader_loader.load (file_name, defines, *source)) {
+		gl_log_err ("ERROR: loading shader %s: %s\n", file_name,
+			source->getError ().c_str ());
 		return false;
 	}
 	return true;
@@ -200,13 +188,16 @@ void print_shader_info_log (GLuint shader_index) {
 	gl_log ("shader info log for GL index %i:\n%s\n", shader_index, log);
 }
 
-bool create_shader (const char* file_name, GLuint* shader, GLenum type) {
+bool create_shader (
+	const char* file_name, GLuint* shader, GLenum type, const vector<string>& defines
+) {
 	gl_log ("creating shader from %s...\n", file_name);
-	char shader_string[MAX_SHADER_LENGTH];
-	assert (parse_file_into_str (file_name, shader_string, MAX_SHADER_LENGTH));
+	ShaderSource source;
+	if (!load_shader_source (file_name, defines, &source)) {
+		return false;
+	}
 	*shader = glCreateShader (type);
-	const GLchar* p = (const GLchar*)shader_string;
-	glShaderSource (*shader, 1, &p, NULL);
+	glShaderSource (*shader, source.count (), source.strings (), source.lengths ());
 	glCompileShader (*shader);
 	// check for compile errors
 	int params = -1;
@@ -271,12 +262,24 @@ bool create_programme (GLuint vert, GLuint frag, GLuint* programme) {
 	return true;
 }
 
+/* the linked programme binaries are kept on disk by ProgramCache.h, so the
+shaders are only compiled again when a source file or the driver changes */
 GLuint create_programme_from_files (
-	const char* vert_file_name, const char* frag_file_name
+	const char* vert_file_name, const char* frag_file_name, const vector<string>& defines
 ) {
-	GLuint vert, frag, programme;
-	assert (create_shader (vert_file_name, &vert, GL_VERTEX_SHADER));
-	assert (create_shader (frag_file_name, &frag, GL_FRAGMENT_SHADER));
-	assert (create_programme (vert, frag, &programme));
+	static ProgramCache cache;
+	gl_log ("creating programme from %s and %s...\n", vert_file_name, frag_file_name);
+	ShaderSource vert_source, frag_source;
+	bool loaded = load_shader_source (vert_file_name, defines, &vert_source) &&
+		load_shader_source (frag_file_name, defines, &frag_source);
+	assert (loaded);
+	ShaderStage stages[2] = {
+		{ GL_VERTEX_SHADER, NULL, vert_source.count (), vert_source.strings (), vert_source.lengths () },
+		{ GL_FRAGMENT_SHADER, NULL, frag_source.count (), frag_source.strings (), frag_source.lengths () }
+	};
+	GLuint programme = cache.build (stages, 2);
+	assert (is_programme_valid (programme));
+	gl_log ("programme %u: %i from the binary cache, %i compiled\n", programme,
+		cache.getStats ().hits, cache.getStats ().misses);
 	return programme;
 }
@@ -22,6 +22,8 @@
 
 #include <GLFW/glfw3.h> // GLFW helper library
 #include <iostream>
+#include <string>
+#include <vector>
 
 using namespace std;
 
@@ -40,13 +42,22 @@ void glfw_error_callback (int error, const char* description);
 void glfw_window_size_callback (GLFWwindow* window, int width, int height);
 void _update_fps_counter (GLFWwindow* window);
 /*-----------------------------------SHADERS----------------------------------*/
-bool parse_file_into_str (const char* file_name, char* shader_str, int max_len);
+class ShaderSource;
+/* reads the file and its #includes (cached), defines go after #version, e.g.
+"USE_FOG" or "MAX_LIGHTS 4"; the pieces point into the cache, no copies */
+bool load_shader_source (
+	const char* file_name, const vector<string>& defines, ShaderSource* source
+);
 void print_shader_info_log (GLuint shader_index);
-bool create_shader (const char* file_name, GLuint* shader, GLenum type);
+bool create_shader (
+	const char* file_name, GLuint* shader, GLenum type,
+	const vector<string>& defines = vector<string> ()
+);
 bool is_programme_valid (GLuint sp);
 bool create_programme (GLuint vert, GLuint frag, GLuint* programme);
 /* just use this func to create most shaders; give it vertex and frag files */
 GLuint create_programme_from_files (
-	const char* vert_file_name, const char* frag_file_name
+	const char* vert_file_name, const char* frag_file_name,
+	const vector<string>& defines = vector<string> ()
 );
 #endif
@@ -2,6 +2,7 @@
 #include <string>
 #include <assert.h>
 #include <cmath>
+#include <vector>
 
 using namespace std;
 
@@ -22,6 +23,21 @@ using namespace std;
 
 using namespace glm;
 
+#include "TileMap.h"
+#include "TileMapFile.h"
+#include "DiamondView.h"
+#include "TileMapMesh.h"
+#include "TileCamera.h"
+#include "Pathfinder.h"
+#include "FogOfWar.h"
+#include "FogTexture.h"
+#include "TileBitPlanes.h"
+#include "ShaderProgram.h"
+#include "HeadlessRunner.h"
+#include "ProgramCache.h"
+#include "GeometryRegistry.h"
+#include "TextureManager.h"
+
 
 struct Sprite
 {
@@ -37,38 +53,39 @@ struct Sprite
     int tileMapColumn = 1;
 };
 
-struct Tile
-{
-    GLuint VAO;
-    GLuint texID;
-    int iTile;
-    vec3 position;
-    vec3 dimensions; // tamanho do losango 2:1
-    float ds, dt;
-};
-
 Sprite vampirao;
 
+// VAOs/VBOs compartilhados: sprites com o mesmo recorte usam o mesmo quad
+GeometryRegistry geometry;
+
+// Texturas compartilhadas por caminho (carregadas em segundo plano, ver TextureManager.h)
+TextureManager textureManager;
+
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
+void mouse_button_callback(GLFWwindow *window, int button, int action, int mods);
 int setupShader();
 int setupSprite(int nAnimations, int nFrames, float &ds, float &dt);
-int setupTile(int nTiles, float &ds, float &dt);
-int loadTexture(string filePath, int &width, int &height);
-void desenharMapa(GLuint shaderID);
+void desenharMapa(ShaderProgram &shader, TileMapMesh &mapMesh, GLuint tilesetTexID, GLuint fogTexID, const vector<TileSpan> &spans);
 
 const GLuint WIDTH = 800, HEIGHT = 600;
 
+// Programas de shader compilados uma vez e reaproveitados do disco
+ProgramCache programCache;
+
 // Código fonte do Vertex Shader (em GLSL): ainda hardcoded
 const GLchar *vertexShaderSource = R"(
  #version 400
  layout (location = 0) in vec3 position;
  layout (location = 1) in vec2 texc;
+ layout (location = 2) in vec2 cell;
  out vec2 tex_coord;
+ flat out vec2 tile_cell;
  uniform mat4 model;
  uniform mat4 projection;
  void main()
  {
 	tex_coord = vec2(texc.s, 1.0 - texc.t);
+	tile_cell = cell;
 	gl_Position = projection * model * vec4(position, 1.0);
  }
  )";
@@ -77,16 +94,23 @@ const GLchar *vertexShaderSource = R"(
 const GLchar *fragmentShaderSource = R"(
  #version 400
  in vec2 tex_coord;
+ flat in vec2 tile_cell;
  out vec4 color;
  uniform sampler2D tex_buff;
+ uniform sampler2D fog_buff;
  uniform vec2 offsetTex;
+ uniform float fogAmount; // 1 nos tiles, 0 nos sprites
 
  void main()
  {
 	 color = texture(tex_buff,tex_coord + offsetTex);
+	 float fog = texelFetch(fog_buff, ivec2(tile_cell), 0).r;
+	 color.rgb *= mix(1.0, fog, fogAmount);
  }
  )";
 
+// Mapa de reserva, usado se baked/1406.tmap (gerado no build a partir de
+// assets/maps/1406.txt) não existir
 #define TILEMAP_WIDTH 5
 #define TILEMAP_HEIGHT 5
 int map[5][5] = {
@@ -97,13 +121,41 @@ int map[5][5] = {
     0, 0, 0, 0, 0
 };
 
+#define TILE_WIDTH 114.0f  // tamanho do losango 2:1
+#define TILE_HEIGHT 57.0f
+#define TILESET_TILES 7    // tiles lado a lado no tilesetIso.png
+
 float tile_inicial_x = 400 - 57; // centro do eixo x - o valor da metade da largura para centralizar o tilemap na janela
 float tile_inicial_y = 600 / TILEMAP_HEIGHT + 28.5; // divisão da altura da janela pela quantidade de linhas + metade do valor da altura para centralizar o tilemap também no eixo y
 
-vector<Tile> tileset;
-
-int main()
+TileMap tilemap(TILEMAP_WIDTH, TILEMAP_HEIGHT, 0);
+DiamondView diamondView;
+
+// Clique num tile: o vampirao anda até lá pelo caminho do Pathfinder, um passo
+// a cada PASSO_S segundos (lava e água funda bloqueiam, água rasa é mais cara)
+#define PASSO_S 0.25
+Pathfinder *pathfinder = nullptr;
+// Andável/opaco de cada célula (bit-planes do TileProperties); o teclado não
+// entra em tile bloqueado nem sai do mapa
+TileBitPlanes *tilePlanes = nullptr;
+long movimentosBloqueados = 0;
+vector<PathStep> caminho;
+size_t passoCaminho = 0;
+
+// Neblina: o vampirao enxerga RAIO_VISAO tiles em volta; fora disso o mapa
+// fica escuro (nunca visto) ou apagado (já visto)
+#define RAIO_VISAO 2
+
+// Handles dos uniforms usados a cada frame (resolvidos uma vez no main)
+int modelLoc = -1;
+int offsetTexLoc = -1;
+int fogAmountLoc = -1;
+
+int main(int argc, char **argv)
 {
+	// --headless --frames N: benchmark sem janela visível (ver HeadlessRunner.h)
+	HeadlessRunner runner(argc, argv);
+
 	// Inicialização da GLFW
 	glfwInit();
 
@@ -111,7 +163,7 @@ int main()
 	glfwWindowHint(GLFW_SAMPLES, 8);
 
 	// Criação da janela GLFW
-	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana", nullptr, nullptr);
+	GLFWwindow *window = runner.createWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana");
 	if (!window)
 	{
 		std::cerr << "Falha ao criar a janela GLFW" << std::endl;
@@ -122,6 +174,7 @@ int main()
 
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
+	glfwSetMouseButtonCallback(window, mouse_button_callback);
 
 	// GLAD: carrega todos os ponteiros d funções da OpenGL
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
@@ -130,6 +183,14 @@ int main()
 		return -1;
 	}
 
+	runner.attach(window);
+	// Entrada programada do modo headless
+	const int walk[] = { GLFW_KEY_RIGHT, GLFW_KEY_UP, GLFW_KEY_W, GLFW_KEY_LEFT, GLFW_KEY_DOWN, GLFW_KEY_S, GLFW_KEY_D, GLFW_KEY_A };
+	for (int i = 0; i < 40; i++)
+		runner.addKey(10 + i * 6, walk[i % 8]);
+	// clique no tile (0, 4), canto de areia do mapa
+	runner.addClick(260, 343 + (0 - 4) * 57 + 57, HEIGHT - (148.5 + (0 + 4) * 28.5 + 28.5));
+
 	// Obtendo as informações de versão
 	const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
 	const GLubyte *version = glGetString(GL_VERSION);	/* version as a string */
@@ -144,11 +205,15 @@ int main()
 	// Compilando e buildando o programa de shader
 	GLuint shaderID = setupShader();
 
+	// Texturas já decodificadas no build (alvo "textures" do CMake); sem o pacote
+	// os PNGs são decodificados na hora
+	textureManager.useBakedPack("baked/textures.pak");
+
 	//Carregando uma textura 
 	int imgWidth, imgHeight;
-	GLuint vampiraoID = loadTexture("../assets/sprites/Vampires1_Walk_full.png",imgWidth,imgHeight);
+	GLuint vampiraoID = textureManager.acquire("../assets/sprites/Vampires1_Walk_full.png", imgWidth, imgHeight);
 
-    GLuint texID = loadTexture("../assets/tilesets/tilesetIso.png", imgWidth, imgHeight);
+    GLuint texID = textureManager.acquire("../assets/tilesets/tilesetIso.png", imgWidth, imgHeight);
 	// Gerando um buffer simples, com a geometria de um triângulo
  
 	vampirao.nAnimations = 4;
@@ -160,20 +225,60 @@ int main()
 	vampirao.iAnimation = 1;
 	vampirao.iFrame = 0;
     
-     for (int i = 0; i < 7; i++)
+    // O mapa inteiro vira uma única malha; setTile só reenvia a célula alterada
+    if (!TileMapFile::load("baked/1406.tmap", tilemap))
     {
-        Tile tile;
-
-        tile.dimensions = vec3(114, 57, 1.0);
-        tile.iTile = i;
-        tile.texID = texID;
-        tile.VAO = setupTile(7, tile.ds, tile.dt);
-        tileset.push_back(tile);
+        for (int i = 0; i < TILEMAP_HEIGHT; i++)
+        {
+            for (int j = 0; j < TILEMAP_WIDTH; j++)
+            {
+                tilemap.setTile(j, i, map[i][j]);
+            }
+        }
     }
+    TileMapMesh mapMesh(&tilemap, &diamondView, TILE_WIDTH, TILE_HEIGHT, TILESET_TILES);
+    mapMesh.build();
+
+    TileProperties tileProps;
+    tileProps.setWalkable(3, false);   // lava
+    tileProps.setWalkable(5, false);   // água funda
+    tileProps.setCost(4, 3);           // água rasa
+    tileProps.setOpaque(2, true);      // pedra esconde o que está atrás
+    tileProps.setAnimated(3, true);    // lava
+    TileBitPlanes mapPlanes(&tilemap, tileProps);
+    tilePlanes = &mapPlanes;
+    Pathfinder mapPathfinder(&tilemap, tileProps.toCostTable(), &diamondView);
+    pathfinder = &mapPathfinder;
+    double lastStepTime = 0.0;
+
+    // Visibilidade do time do vampirao numa textura R8 (uma célula por texel),
+    // reenviada só nos blocos que mudam quando ele troca de tile
+    FogOfWar fog(&tilemap);
+    for (int tile = 0; tile < TILESET_TILES; tile++) {
+        fog.setOpaque(tile, tileProps.isOpaque(tile));
+    }
+    int visaoVampirao = fog.addUnit(0, vampirao.tileMapColumn - 1, vampirao.tileMapLine - 1, RAIO_VISAO);
+    fog.update();
+    FogTexture fogTexture;
+    fogTexture.build(fog, 0);
+
+    // A tela mostra o espaço de desenho deslocado por (tile_inicial_x,
+    // tile_inicial_y); só as linhas de células dentro dela são desenhadas
+    TileCamera camera(&diamondView, TILE_WIDTH, TILE_HEIGHT, tilemap.getWidth(), tilemap.getHeight());
+    camera.setViewport(WIDTH, HEIGHT);
+    camera.setPosition(-tile_inicial_x, -tile_inicial_y);
+    vector<TileSpan> visibleSpans;
+    double visibleTiles = 0.0;
+    long visibleFrames = 0;
 
 
 	glUseProgram(shaderID);
 
+	ShaderProgram shader(shaderID);
+	modelLoc = shader.uniform("model");
+	offsetTexLoc = shader.uniform("offsetTex");
+	fogAmountLoc = shader.uniform("fogAmount");
+
 	double prev_s = glfwGetTime();
 	double title_countdown_s = 0.1;
 
@@ -183,11 +288,13 @@ int main()
 	glActiveTexture(GL_TEXTURE0);
 
 	// Criando a variável uniform pra mandar a textura pro shader
-	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+	shader.setInt(shader.uniform("tex_buff"), 0);
+	// e a da neblina no buffer 1
+	shader.setInt(shader.uniform("fog_buff"), 1);
 
 	// Matriz de projeção paralela ortográfica
 	mat4 projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	shader.setMat4(shader.uniform("projection"), projection);
 
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_ALWAYS);
@@ -219,7 +326,8 @@ int main()
 
 				// Cria uma string e define o FPS como título da janela.
 				char tmp[256];
-				sprintf(tmp, "Vampirinho por ai no tilemap\tFPS %.2lf", fps);
+				sprintf(tmp, "Vampirinho por ai no tilemap\tFPS %.2lf | uniforms: %d enviados, %d ignorados", fps,
+						shader.getUploads(), shader.getSkippedUploads());
 				glfwSetWindowTitle(window, tmp);
 
 				title_countdown_s = 0.1;
@@ -227,6 +335,9 @@ int main()
 		}
 
 		glfwPollEvents();
+		runner.beginFrame();
+		textureManager.update();
+		shader.beginFrame();
 
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
@@ -236,30 +347,52 @@ int main()
 		glPointSize(20);
 
 
-        desenharMapa(shaderID);
+        visibleTiles += camera.computeVisibleSpans(visibleSpans);
+        visibleFrames++;
+        desenharMapa(shader, mapMesh, texID, fogTexture.getTexture(), visibleSpans);
 
         mat4 model = mat4(1);
 		currTime = glfwGetTime();
 		deltaT = currTime - lastTime;
-		
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         float x = 0;
         float y = 0;
 
-        if(vampirao.tileMapLine > TILEMAP_HEIGHT){
-            vampirao.tileMapLine = TILEMAP_HEIGHT;
+        // Próximo passo do caminho do clique (tileMapColumn/Line começam em 1)
+        if (passoCaminho < caminho.size() && currTime - lastStepTime >= PASSO_S)
+        {
+            const PathStep &passo = caminho[passoCaminho++];
+            switch (passo.direction)
+            {
+                case DIRECTION_NORTH: case DIRECTION_NORTHWEST: vampirao.iAnimation = 2; break;
+                case DIRECTION_SOUTH: case DIRECTION_SOUTHEAST: vampirao.iAnimation = 1; break;
+                case DIRECTION_WEST: case DIRECTION_SOUTHWEST: vampirao.iAnimation = 3; break;
+                default: vampirao.iAnimation = 4; break;
+            }
+            vampirao.tileMapColumn = passo.col + 1;
+            vampirao.tileMapLine = passo.row + 1;
+            vampirao.isWalking = passoCaminho < caminho.size();
+            lastStepTime = currTime;
+        }
+
+        if(vampirao.tileMapLine > tilemap.getHeight()){
+            vampirao.tileMapLine = tilemap.getHeight();
         } 
         if(vampirao.tileMapLine < 1){
             vampirao.tileMapLine = 1;
         } 
-        if(vampirao.tileMapColumn > TILEMAP_WIDTH){
-            vampirao.tileMapColumn = TILEMAP_WIDTH;
+        if(vampirao.tileMapColumn > tilemap.getWidth()){
+            vampirao.tileMapColumn = tilemap.getWidth();
         }
         if(vampirao.tileMapColumn < 1){
             vampirao.tileMapColumn = 1;
         } 
 
+        // Neblina: só recalcula (e reenvia) quando o vampirao troca de tile
+        fog.moveUnit(visaoVampirao, vampirao.tileMapColumn - 1, vampirao.tileMapLine - 1);
+        fog.update();
+        fogTexture.upload(fog, 0);
+
         x = tile_inicial_x + 57 + (vampirao.tileMapColumn - vampirao.tileMapLine) * 57;
         y = tile_inicial_y + (vampirao.tileMapColumn + vampirao.tileMapLine) * 28.5;
 
@@ -271,7 +404,7 @@ int main()
 		model = translate(model, vampirao.position);
 		model = rotate(model, radians(0.0f), vec3(0.0, 0.0, 1.0));
 		model = scale(model,vampirao.dimensions);
-		glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+		shader.setMat4(modelLoc, model);
 
 		vec2 offsetTex;
 		
@@ -285,18 +418,41 @@ int main()
 		
 		offsetTex.s = vampirao.iFrame * vampirao.ds;
 		offsetTex.t = (vampirao.iAnimation) * vampirao.dt;
-		glUniform2f(glGetUniformLocation(shaderID, "offsetTex"),offsetTex.s, offsetTex.t);
+		shader.setVec2(offsetTexLoc, offsetTex);
 
 		glBindVertexArray(vampirao.VAO);
 		glBindTexture(GL_TEXTURE_2D, vampirao.texID);
 
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
+		runner.endFrame();
 		glfwSwapBuffers(window);
 	}
-		
+
+	textureManager.printReport();
+	runner.setMetric("time_to_first_frame_ms", textureManager.getLoader().getFirstFrameMs());
+	runner.setMetric("time_to_all_assets_ms", textureManager.getLoader().getAllLoadedMs());
+	runner.setMetric("texture_cache_hits", textureManager.getStats().hits);
+	runner.setMetric("texture_cache_misses", textureManager.getStats().misses);
+	runner.setMetric("texture_resident_bytes", textureManager.getStats().residentBytes);
+	programCache.printReport();
+	runner.setMetric("shader_setup_ms", programCache.getTotalMs());
+	runner.setMetric("program_cache_hits", programCache.getStats().hits);
+	runner.setMetric("visible_tiles", visibleFrames > 0 ? visibleTiles / visibleFrames : 0.0);
+	runner.setMetric("path_queries", mapPathfinder.getStats().queries);
+	runner.setMetric("path_steps", (double)caminho.size());
+	runner.setMetric("fog_units_updated", fog.getStats().unitsUpdated);
+	runner.setMetric("fog_uploaded_texels", fogTexture.getUploadedTexels());
+	runner.setMetric("blocked_moves", movimentosBloqueados);
+	pathfinder = nullptr;
+	tilePlanes = nullptr;
+	runner.finish();
+	mapMesh.release();
+	fogTexture.release();
+	geometry.releaseAll();
+	textureManager.releaseAll();
 	glfwTerminate();
-	return 0;
+	return runner.exitStatus();
 }
 
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode)
@@ -310,6 +466,15 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 	if (action != GLFW_PRESS && action != GLFW_REPEAT){
 		vampirao.isWalking = false;
 	} 
+
+	// andar pelo teclado cancela o caminho do clique
+	if (action == GLFW_PRESS && key != GLFW_KEY_ESCAPE){
+		caminho.clear();
+		passoCaminho = 0;
+	}
+
+	int colunaAntes = vampirao.tileMapColumn;
+	int linhaAntes = vampirao.tileMapLine;
 	
     if (key == GLFW_KEY_LEFT && action == GLFW_PRESS){
         vampirao.iAnimation = 3;
@@ -352,53 +517,23 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
         vampirao.tileMapLine -= 1;
         vampirao.tileMapColumn -= 1;
     }
+
+    // Tile não andável (lava, água funda) ou fora do mapa: fica onde estava
+    if (tilePlanes != nullptr && (vampirao.tileMapColumn != colunaAntes || vampirao.tileMapLine != linhaAntes) &&
+        !tilePlanes->isWalkable(vampirao.tileMapColumn - 1, vampirao.tileMapLine - 1))
+    {
+        vampirao.tileMapColumn = colunaAntes;
+        vampirao.tileMapLine = linhaAntes;
+        movimentosBloqueados++;
+    }
     
 }
 
 int setupShader()
 {
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-
-    GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
+	// Binário do programa em cache (ver ProgramCache.h): só compila quando o
+	// fonte ou o driver mudam
+	return programCache.build(vertexShaderSource, fragmentShaderSource);
 }
 
 int setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
@@ -415,161 +550,52 @@ int setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
 		 0.5, -0.5, 0.0, ds, 0.0  //V3
 		};
 
-	GLuint VBO, VAO;
-
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	glGenVertexArrays(1, &VAO);
-
-	glBindVertexArray(VAO);
-
-	// Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
-
-	// Ponteiro pro atributo 1 - Coordenada de textura s, t
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-
-	return VAO;
+	// x, y, z + s, t (locations 0 e 1)
+	return geometry.acquire(VertexLayout().add(0, 3).add(1, 2), vertices, sizeof(vertices)).VAO;
 }
 
-int setupTile(int nTiles, float &ds, float &dt)
+void desenharMapa(ShaderProgram &shader, TileMapMesh &mapMesh, GLuint tilesetTexID, GLuint fogTexID, const vector<TileSpan> &spans)
 {
+    // Os vértices da malha já estão nas posições do losango de cada célula
+    // (DiamondView); a matriz de modelo só leva o mapa para o centro da janela
+    mat4 model = mat4(1);
+    model = translate(model, vec3(tile_inicial_x, tile_inicial_y, 0.0));
+    shader.setMat4(modelLoc, model);
 
-    ds = 1.0 / (float)nTiles;
-    dt = 1.0;
-
-    // Como eu prefiro escalar depois, th e tw serão 1.0
-    float th = 1.0, tw = 1.0;
-
-    GLfloat vertices[] = {
-        // x   y    z    s     t
-        0.0, th / 2.0f, 0.0, 0.0, dt / 2.0f, // A
-        tw / 2.0f, th, 0.0, ds / 2.0f, dt,   // B
-        tw / 2.0f, 0.0, 0.0, ds / 2.0f, 0.0, // D
-        tw, th / 2.0f, 0.0, ds, dt / 2.0f    // C
-    };
-
-    GLuint VBO, VAO;
-    // Geração do identificador do VBO
-    glGenBuffers(1, &VBO);
-    // Faz a conexão (vincula) do buffer como um buffer de array
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // Envia os dados do array de floats para o buffer da OpenGl
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    // Geração do identificador do VAO (Vertex Array Object)
-    glGenVertexArrays(1, &VAO);
-    // Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-    // e os ponteiros para os atributos
-    glBindVertexArray(VAO);
-    // Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-    //  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-    //  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-    //  Tipo do dado
-    //  Se está normalizado (entre zero e um)
-    //  Tamanho em bytes
-    //  Deslocamento a partir do byte zero
-
-    // Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-    glEnableVertexAttribArray(0);
-
-    // Ponteiro pro atributo 1 - Coordenada de textura s, t
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(1);
-
-    // Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-    // atualmente vinculado - para que depois possamos desvincular com segurança
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    // Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-    glBindVertexArray(0);
-
-    return VAO;
-}
-
-void desenharMapa(GLuint shaderID)
-{
-    // dá pra fazer um cálculo usando tilemap_width e tilemap_height
-    // float x0 = 400;
-    // float y0 = 100;
+    // As coordenadas de textura de cada tile também já estão nos vértices
+    shader.setVec2(offsetTexLoc, 0.0, 0.0);
 
-    for (int i = 0; i < TILEMAP_HEIGHT; i++)
-    {
-        for (int j = 0; j < TILEMAP_WIDTH; j++)
-        {
-            // Matriz de transformaçao do objeto - Matriz de modelo
-            mat4 model = mat4(1); // matriz identidade
+    glBindTexture(GL_TEXTURE_2D, tilesetTexID); // Conectando ao buffer de textura
 
-            Tile curr_tile = tileset[map[i][j]];
+    // Neblina do time no buffer 1, lida pela célula de cada tile
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, fogTexID);
+    glActiveTexture(GL_TEXTURE0);
+    shader.setFloat(fogAmountLoc, 1.0f);
 
-            float x = tile_inicial_x + (j - i) * curr_tile.dimensions.x/2.0;
-            float y = tile_inicial_y + (i + j) * curr_tile.dimensions.y/2.0;
-        
-            model = translate(model, vec3(x, y, 0.0));
-            model = scale(model, curr_tile.dimensions);
-            glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+    // Só as células visíveis (TileCamera), numa única chamada de desenho
+    mapMesh.draw(spans);
 
-            vec2 offsetTex;
-
-            offsetTex.s = curr_tile.iTile * curr_tile.ds;
-            offsetTex.t = 0.0;
-            glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetTex.s, offsetTex.t);
-
-            glBindVertexArray(curr_tile.VAO);              // Conectando ao buffer de geometria
-            glBindTexture(GL_TEXTURE_2D, curr_tile.texID); // Conectando ao buffer de textura
-
-            // Chamada de desenho - drawcall
-            // Poligono Preenchido - GL_TRIANGLES
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        }
-    }
+    // os sprites desenhados depois não passam pela neblina
+    shader.setFloat(fogAmountLoc, 0.0f);
 }
 
-int loadTexture(string filePath, int &width, int &height)
+// Clique com o botão esquerdo: caminho do tile do vampirao até o tile clicado
+void mouse_button_callback(GLFWwindow *window, int button, int action, int mods)
 {
-	GLuint texID;
-
-	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-	int nrChannels;
-
-	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-
-	if (data)
-	{
-		if (nrChannels == 3) // jpg, bmp
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
-		else // png
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
-	}
-
-	stbi_image_free(data);
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	return texID;
+    if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS || pathfinder == nullptr)
+        return;
+
+    double xpos, ypos;
+    glfwGetCursorPos(window, &xpos, &ypos);
+    // y do cursor cresce para baixo; o mapa é desenhado a partir de tile_inicial
+    float mx = xpos - tile_inicial_x;
+    float my = (HEIGHT - ypos) - tile_inicial_y;
+    int col, row;
+    diamondView.computeMouseMap(col, row, TILE_WIDTH, TILE_HEIGHT, mx, my);
+
+    passoCaminho = 0;
+    if (!pathfinder->findPath(vampirao.tileMapColumn - 1, vampirao.tileMapLine - 1, col, row, caminho))
+        caminho.clear();
+    vampirao.isWalking = !caminho.empty();
 }
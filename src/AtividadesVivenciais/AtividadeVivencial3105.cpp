@@ -23,17 +23,33 @@ using namespace std;
 
 using namespace glm;
 
+#include "ShaderProgram.h"
+#include "HeadlessRunner.h"
+#include "ProgramCache.h"
+#include "GeometryRegistry.h"
+#include "TextureManager.h"
+
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 
 // Protótipos das funções
-int setupShader();
+int setupShader(const GLchar *vertexSource, const GLchar *fragmentSource);
 int createVAO();
-int loadTexture(string filePath);
+GLuint loadTextureArray(const string filePaths[], int count);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
 
+// Máximo de camadas do compositor (tamanho do array offsetX no shader)
+const int MAX_LAYERS = 8;
+
+// Benchmark de fill-rate (--bench): resolução do framebuffer e frames por modo
+const int BENCH_WIDTH = 3840, BENCH_HEIGHT = 2160;
+const int BENCH_FRAMES = 100;
+
+// Programas de shader compilados uma vez e reaproveitados do disco
+ProgramCache programCache;
+
 // Código fonte do Vertex Shader (em GLSL): ainda hardcoded
 const GLchar *vertexShaderSource = R"(
  #version 400
@@ -66,6 +82,48 @@ const GLchar *fragmentShaderSource = R"(
  }
  )";
 
+// Compositor de passada única: o mesmo quad de tela cheia, mas o fragment
+// shader lê todas as camadas da textura array e faz a mistura ele mesmo
+const GLchar *parallaxVertexShaderSource = R"(
+ #version 400
+ layout (location = 0) in vec3 position;
+ layout (location = 1) in vec2 texc;
+ out vec2 tex_coord;
+ uniform mat4 projection;
+
+ void main()
+ {
+    tex_coord = texc;
+    gl_Position = projection * vec4(position, 1.0);
+ }
+ )";
+
+// As camadas são compostas da frente (última) para o fundo (primeira) com o
+// operador "over"; quando o pixel já está opaco, as camadas de trás nem são
+// lidas. O resultado é o mesmo das 7 passadas com GL_SRC_ALPHA sobre o fundo preto.
+const GLchar *parallaxFragmentShaderSource = R"(
+ #version 400
+ #define MAX_LAYERS 8
+ in vec2 tex_coord;
+ out vec4 color;
+ uniform sampler2DArray layers_buff;
+ uniform int layerCount;
+ uniform float offsetX[MAX_LAYERS];
+ uniform float textureWidth;
+ void main()
+ {
+    vec3 rgb = vec3(0.0);
+    float alpha = 0.0;
+    for (int i = layerCount - 1; i >= 0 && alpha < 0.999; i--)
+    {
+        vec4 c = texture(layers_buff, vec3(tex_coord.x + offsetX[i] / textureWidth, tex_coord.y, float(i)));
+        rgb += (1.0 - alpha) * c.a * c.rgb;
+        alpha += (1.0 - alpha) * c.a;
+    }
+    color = vec4(rgb, 1.0);
+ }
+ )";
+
 struct Layer {
     GLuint textureID;
     float speedFactor;
@@ -76,8 +134,29 @@ struct Layer {
 
 vector<Layer> layers;
 
-int main()
+// Quad de tela cheia (camadas e compositor usam o mesmo)
+GeometryRegistry geometry;
+
+// Texturas compartilhadas por caminho (carregadas em segundo plano, ver TextureManager.h)
+TextureManager textureManager;
+
+// true: compositor de passada única (textura array); false: uma passada por camada.
+// A tecla P alterna entre os dois
+bool singlePass = true;
+
+// Handles dos uniforms, resolvidos no main
+int modelLoc, offsetXLoc, textureWidthLoc;
+int parallaxOffsetXLoc;
+
+void drawLayersMultiPass(ShaderProgram &shader);
+void drawLayersSinglePass(ShaderProgram &parallax, GLuint layersArray);
+void runBenchmark(GLFWwindow *window, GLuint VAO, ShaderProgram &shader, ShaderProgram &parallax, GLuint layersArray);
+
+int main(int argc, char **argv)
 {
+	// --headless --frames N: benchmark sem janela visível (ver HeadlessRunner.h)
+	HeadlessRunner runner(argc, argv);
+
 	// Inicialização da GLFW
 	glfwInit();
 
@@ -89,7 +168,7 @@ int main()
 	glfwWindowHint(GLFW_SAMPLES, 8);
 
 	// Criação da janela GLFW
-	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "M4", nullptr, nullptr);
+	GLFWwindow *window = runner.createWindow(WIDTH, HEIGHT, "M4");
 	if (!window)
 	{
 		std::cerr << "Falha ao criar a janela GLFW" << std::endl;
@@ -108,6 +187,13 @@ int main()
 		return -1;
 	}
 
+	runner.attach(window);
+	// Entrada programada do modo headless
+	runner.addKey(10, GLFW_KEY_D, 60);
+	runner.addKey(80, GLFW_KEY_P);
+	runner.addKey(90, GLFW_KEY_A, 60);
+	runner.addKey(160, GLFW_KEY_P);
+
 	const GLubyte *renderer = glGetString(GL_RENDERER);
 	const GLubyte *version = glGetString(GL_VERSION);
 	cout << "Renderer: " << renderer << endl;
@@ -117,9 +203,14 @@ int main()
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
 
-	GLuint shaderID = setupShader();
+	GLuint shaderID = setupShader(vertexShaderSource, fragmentShaderSource);
+	GLuint parallaxID = setupShader(parallaxVertexShaderSource, parallaxFragmentShaderSource);
     GLuint VAO = createVAO();
 
+	// Texturas já decodificadas no build (alvo "textures" do CMake); sem o pacote
+	// os PNGs são decodificados na hora
+	textureManager.useBakedPack("baked/textures.pak");
+
 	const string textures[] = {
         "../assets/sprites/sky.png",
         "../assets/sprites/clouds_1.png",
@@ -134,25 +225,36 @@ int main()
 
     for (int i = 0; i < 7; i++) {
         Layer layer;
-        layer.textureID = loadTexture(textures[i]);
+        layer.textureID = textureManager.acquire(textures[i]);
         layer.speedFactor = speeds[i];
         layer.width = 800;
         layer.height = 600  ;
         layers.push_back(layer);
     }
 
+	// As mesmas camadas numa única textura array (camada i = layers[i])
+	GLuint layersArray = loadTextureArray(textures, 7);
+	if (!layersArray)
+	{
+		singlePass = false;
+	}
+
 	
-	GLuint vampireTexture = loadTexture("../assets/sprites/Vampirinho.png");
+	GLuint vampireTexture = textureManager.acquire("../assets/sprites/Vampirinho.png");
 
 	glUseProgram(shaderID);
 
+	ShaderProgram shader(shaderID);
+	modelLoc = shader.uniform("model");
+	offsetXLoc = shader.uniform("offsetX");
+
 	float colorValue = 0.0;
 
 	// Ativando o primeiro buffer de textura do OpenGL
 	glActiveTexture(GL_TEXTURE0);
 
 	// Criando a variável uniform pra mandar a textura pro shader
-	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+	shader.setInt(shader.uniform("tex_buff"), 0);
 
 	glEnable(GL_DEPTH_TEST); 
 	glDepthFunc(GL_ALWAYS);	 
@@ -161,13 +263,32 @@ int main()
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
-    GLint textureWidthLoc = glGetUniformLocation(shaderID, "textureWidth");
+	shader.setMat4(shader.uniform("projection"), projection);
+    textureWidthLoc = shader.uniform("textureWidth");
+
+	glUseProgram(parallaxID);
+	ShaderProgram parallax(parallaxID);
+	parallax.setMat4(parallax.uniform("projection"), projection);
+	parallax.setInt(parallax.uniform("layers_buff"), 0);
+	parallax.setInt(parallax.uniform("layerCount"), (int)layers.size());
+	parallax.setFloat(parallax.uniform("textureWidth"), 800.0f);
+	parallaxOffsetXLoc = parallax.uniform("offsetX");
+
+	if (argc > 1 && string(argv[1]) == "--bench")
+	{
+		runBenchmark(window, VAO, shader, parallax, layersArray);
+		glfwTerminate();
+		return 0;
+	}
 
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
 		glfwPollEvents();
+		runner.beginFrame();
+		textureManager.update();
+		shader.beginFrame();
+		parallax.beginFrame();
 
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
@@ -177,35 +298,51 @@ int main()
 		glLineWidth(10);
 		glPointSize(20);
 
-         mat4 model = mat4(1.0);
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-
-		for (Layer &layer : layers)
+		if (singlePass)
+		{
+			drawLayersSinglePass(parallax, layersArray);
+		}
+		else
 		{
-            glBindTexture(GL_TEXTURE_2D, layer.textureID); // Conectando ao buffer de textura
-            glUniform1f(glGetUniformLocation(shaderID, "offsetX"), layer.offsetX);
-            glUniform1f(textureWidthLoc, (float)layer.width);
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			drawLayersMultiPass(shader);
 		}
 
+		glUseProgram(shaderID);
         mat4 model2 = mat4(1.0);
         model2 = glm::translate(model2, vec3(400.0, 50.0, 0.0));
         model2 = glm::scale(model2, glm::vec3(100.0 / 800.0, 100.0 / 600.0, 1.0));
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model2));
+        shader.setMat4(modelLoc, model2);
         
         glBindTexture(GL_TEXTURE_2D, vampireTexture);
-        glUniform1f(glGetUniformLocation(shaderID, "offsetX"), 0.0);
+        shader.setFloat(offsetXLoc, 0.0);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
+		runner.endFrame();
 		glfwSwapBuffers(window);
 	}
 
+	textureManager.printReport();
+	runner.setMetric("time_to_first_frame_ms", textureManager.getLoader().getFirstFrameMs());
+	runner.setMetric("time_to_all_assets_ms", textureManager.getLoader().getAllLoadedMs());
+	runner.setMetric("texture_cache_hits", textureManager.getStats().hits);
+	runner.setMetric("texture_cache_misses", textureManager.getStats().misses);
+	runner.setMetric("texture_resident_bytes", textureManager.getStats().residentBytes);
+	programCache.printReport();
+	runner.setMetric("shader_setup_ms", programCache.getTotalMs());
+	runner.setMetric("program_cache_hits", programCache.getStats().hits);
+	runner.finish();
+	geometry.releaseAll();
+	textureManager.releaseAll();
 	glfwTerminate();
-	return 0;
+	return runner.exitStatus();
 }
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
+    if (key == GLFW_KEY_P && action == GLFW_PRESS) {
+        singlePass = !singlePass;
+        cout << (singlePass ? "Compositor de passada unica" : "Uma passada por camada") << endl;
+    }
     if (action == GLFW_PRESS || action == GLFW_REPEAT) {
         double movementAmount = 10.0;
         if (key == GLFW_KEY_LEFT || key == GLFW_KEY_A) {
@@ -222,52 +359,11 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 }
 
 //  A função retorna o identificador do programa de shader
-int setupShader()
+int setupShader(const GLchar *vertexSource, const GLchar *fragmentSource)
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
+	// Binário do programa em cache (ver ProgramCache.h): só compila quando o
+	// fonte ou o driver mudam
+	return programCache.build(vertexSource, fragmentSource);
 }
 
 int createVAO()
@@ -279,64 +375,158 @@ int createVAO()
         800, 600, 0.0, 1.0, 1.0
     };
 
-	GLuint VBO, VAO;
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
+	return geometry.acquire(VertexLayout().add(0, 3).add(1, 2), vertices, sizeof(vertices)).VAO;
+}
+// Carrega as imagens numa GL_TEXTURE_2D_ARRAY, uma camada por imagem. Todas
+// precisam ter o mesmo tamanho; se não tiverem (ou alguma falhar), retorna 0
+// e o demo fica só com o desenho por camada
+GLuint loadTextureArray(const string filePaths[], int count)
+{
+	if (count > MAX_LAYERS)
+	{
+		std::cout << "Too many layers for the texture array" << std::endl;
+		return 0;
+	}
 
+	GLuint texID;
+	glGenTextures(1, &texID);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texID);
 
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
+	// Como no TextureParams padrão; o wrap nunca mistura camadas diferentes da array
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	int arrayWidth = 0, arrayHeight = 0;
+	for (int i = 0; i < count; i++)
+	{
+		int width, height, nrChannels;
+		// sempre RGBA: todas as camadas precisam do mesmo formato
+		unsigned char *data = stbi_load(filePaths[i].c_str(), &width, &height, &nrChannels, 4);
+		if (!data || (i > 0 && (width != arrayWidth || height != arrayHeight)))
+		{
+			std::cout << "Failed to load texture array layer " << filePaths[i] << std::endl;
+			stbi_image_free(data);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+			glDeleteTextures(1, &texID);
+			return 0;
+		}
+		if (i == 0)
+		{
+			arrayWidth = width;
+			arrayHeight = height;
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, count, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		}
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		stbi_image_free(data);
+	}
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
 
-	glBindVertexArray(0);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
-	return VAO;
+	return texID;
 }
 
-int loadTexture(string filePath)
+// Caminho antigo: uma passada de tela cheia por camada, misturadas pelo blending
+void drawLayersMultiPass(ShaderProgram &shader)
 {
-	GLuint texID;
+	shader.use();
+	shader.setMat4(modelLoc, mat4(1.0));
+	for (Layer &layer : layers)
+	{
+		glBindTexture(GL_TEXTURE_2D, layer.textureID); // Conectando ao buffer de textura
+		shader.setFloat(offsetXLoc, layer.offsetX);
+		shader.setFloat(textureWidthLoc, (float)layer.width);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
+}
 
-	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
+// Uma única passada: os offsets de todas as camadas vão num array de uniforms
+// (o speedFactor já está aplicado no offsetX pelo key_callback)
+void drawLayersSinglePass(ShaderProgram &parallax, GLuint layersArray)
+{
+	float offsets[MAX_LAYERS] = {};
+	for (size_t i = 0; i < layers.size(); i++)
+	{
+		offsets[i] = layers[i].offsetX;
+	}
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	parallax.use();
+	parallax.setFloatArray(parallaxOffsetXLoc, offsets, (int)layers.size());
+	glBindTexture(GL_TEXTURE_2D_ARRAY, layersArray);
+	// o compositor já escreve o pixel final: sem blending nem leitura do framebuffer
+	glDisable(GL_BLEND);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	glEnable(GL_BLEND);
+}
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+// Mede o fundo inteiro desenhado num framebuffer 4K fora da tela, pelos dois
+// caminhos, e mostra o custo por frame e a taxa de pixels escritos
+void runBenchmark(GLFWwindow *window, GLuint VAO, ShaderProgram &shader, ShaderProgram &parallax, GLuint layersArray)
+{
+	GLuint fbo, colorTex;
+	glGenTextures(1, &colorTex);
+	glBindTexture(GL_TEXTURE_2D, colorTex);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, BENCH_WIDTH, BENCH_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glBindTexture(GL_TEXTURE_2D, 0);
 
-	int width, height, nrChannels;
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Benchmark framebuffer incomplete" << std::endl;
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &fbo);
+		glDeleteTextures(1, &colorTex);
+		return;
+	}
 
-	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+	glfwSwapInterval(0);
+	glViewport(0, 0, BENCH_WIDTH, BENCH_HEIGHT);
+	glBindVertexArray(VAO);
 
-	if (data)
+	const double pixels = (double)BENCH_WIDTH * BENCH_HEIGHT;
+	for (int mode = 0; mode < 2; mode++)
 	{
-		if (nrChannels == 3) // jpg, bmp
+		bool single = (mode == 1);
+		if (single && !layersArray)
+			break;
+
+		// alguns frames de aquecimento (compilação de shader, residência das texturas)
+		for (int i = 0; i < 5; i++)
 		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+			single ? drawLayersSinglePass(parallax, layersArray) : drawLayersMultiPass(shader);
 		}
-		else // png
+		glFinish();
+
+		double start = glfwGetTime();
+		int frames = 0;
+		for (; frames < BENCH_FRAMES && !glfwWindowShouldClose(window); frames++)
 		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+			glfwPollEvents();
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			single ? drawLayersSinglePass(parallax, layersArray) : drawLayersMultiPass(shader);
 		}
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
+		glFinish();
+		double totalTime = glfwGetTime() - start;
+		if (frames == 0)
+			break;
+
+		// pixels escritos: cada passada cobre a tela inteira
+		double passes = single ? 1.0 : (double)layers.size();
+		double msPerFrame = totalTime * 1000.0 / frames;
+		cout << (single ? "passada unica   " : "uma por camada  ")
+			 << " | " << BENCH_WIDTH << "x" << BENCH_HEIGHT
+			 << " | draws/frame: " << passes
+			 << " | ms/frame: " << msPerFrame
+			 << " | Mpixels escritos/s: " << passes * pixels * frames / totalTime / 1e6
+			 << " | Mpixels de tela/s: " << pixels * frames / totalTime / 1e6 << endl;
 	}
 
-	stbi_image_free(data);
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	return texID;
-}
\ No newline at end of file
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glDeleteFramebuffers(1, &fbo);
+	glDeleteTextures(1, &colorTex);
+}
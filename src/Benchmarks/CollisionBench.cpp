@@ -0,0 +1,231 @@
+// Conferência e throughput do teste ponto-em-triângulo em lote (ltMathBatch.h)
+//
+// 1. Conferência: triângulos e pontos em coordenadas inteiras e meio-inteiras,
+//    onde as áreas do triangleCollidePoint2D são exatas em float e o "==" dele
+//    é confiável. O lote tem que dar exatamente o mesmo resultado para todos os
+//    pares (triângulos degenerados ficam de fora: no lote eles nunca colidem).
+//    Pontos estritamente dentro também têm que passar no collideByDotProduct,
+//    que só testa o ângulo no primeiro vértice e por isso aceita pontos fora.
+// 2. Throughput: pares ponto x triângulo por segundo das duas funções do
+//    ltMath.h e do lote (todas as colisões e só o triângulo de cima).
+//
+// Uso: CollisionBench [--points N] [--triangles N] [--out arquivo.json]
+// Retorna 1 se a conferência falhar.
+
+#include "ltMath.h"
+#include "ltMathBatch.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+struct Result {
+	string name;
+	double pairsPerSec;
+};
+
+static volatile int sink;
+
+static bool maskBit(const vector<uint32_t> &mask, int words, int point, int tri) {
+	return (mask[(size_t)point * words + tri / 32] >> (tri % 32)) & 1u;
+}
+
+static bool verify() {
+	mt19937 rng(42);
+	uniform_int_distribution<int> coord(0, 64);
+	uniform_int_distribution<int> half(0, 129);
+
+	vector<vector<float>> tris;
+	TriangleBatch batch;
+	for (int i = 0; i < 300; i++) {
+		vector<float> t(6);
+		for (float &c : t) {
+			c = (float)coord(rng);
+		}
+		if (triangleArea2D(t.data()) == 0.0f) {
+			continue;
+		}
+		tris.push_back(t);
+		batch.add(t.data());
+	}
+
+	vector<float> xs, ys;
+	for (int i = 0; i < 3000; i++) {
+		xs.push_back(half(rng) * 0.5f);
+		ys.push_back(half(rng) * 0.5f);
+	}
+	// Os próprios vértices, que ficam sempre na borda
+	for (const vector<float> &t : tris) {
+		xs.push_back(t[0]);
+		ys.push_back(t[1]);
+	}
+	int n = (int)xs.size();
+
+	vector<uint32_t> mask;
+	collidePoints2D(batch, xs.data(), ys.data(), n, mask);
+	int words = wordsPerPoint(batch);
+
+	long areaMismatch = 0, dotMismatch = 0, pickMismatch = 0, inside = 0;
+	for (int p = 0; p < n; p++) {
+		float point[] = { xs[p], ys[p] };
+		int top = -1;
+		for (int t = 0; t < (int)tris.size(); t++) {
+			float *tri = tris[t].data();
+			bool hit = maskBit(mask, words, p, t);
+			if (hit != triangleCollidePoint2D(tri, point)) {
+				areaMismatch++;
+			}
+			if (hit) {
+				top = t;
+				inside++;
+				float s1[] = { tri[0], tri[1], tri[2], tri[3], point[0], point[1] };
+				float s2[] = { tri[0], tri[1], point[0], point[1], tri[4], tri[5] };
+				float s3[] = { point[0], point[1], tri[2], tri[3], tri[4], tri[5] };
+				bool strict = triangleArea2D(s1) > 0.0f && triangleArea2D(s2) > 0.0f && triangleArea2D(s3) > 0.0f;
+				if (strict && !collideByDotProduct(tri, point)) {
+					dotMismatch++;
+				}
+			}
+		}
+		if (pickTriangle2D(batch, xs[p], ys[p]) != top) {
+			pickMismatch++;
+		}
+	}
+
+	// removeSwap tem que dar o mesmo que reconstruir o lote na nova ordem
+	TriangleBatch removed = batch;
+	vector<vector<float>> order = tris;
+	for (int k = 0; k < 50; k++) {
+		int index = (k * 7) % removed.size();
+		removed.removeSwap(index);
+		order[index] = order.back();
+		order.pop_back();
+	}
+	TriangleBatch rebuilt;
+	for (const vector<float> &t : order) {
+		rebuilt.add(t.data());
+	}
+	long removeMismatch = 0;
+	for (int p = 0; p < n; p++) {
+		if (pickTriangle2D(removed, xs[p], ys[p]) != pickTriangle2D(rebuilt, xs[p], ys[p])) {
+			removeMismatch++;
+		}
+	}
+
+	cout << "conferencia: " << tris.size() << " triangulos x " << n << " pontos, " << inside << " colisoes" << endl;
+	cout << "  triangleCollidePoint2D: " << areaMismatch << " divergencias" << endl;
+	cout << "  collideByDotProduct (pontos internos): " << dotMismatch << " divergencias" << endl;
+	cout << "  pickTriangle2D: " << pickMismatch << " divergencias" << endl;
+	cout << "  removeSwap: " << removeMismatch << " divergencias" << endl;
+	return areaMismatch == 0 && dotMismatch == 0 && pickMismatch == 0 && removeMismatch == 0;
+}
+
+template <typename Body>
+static double seconds(Body body) {
+	auto start = chrono::steady_clock::now();
+	body();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+	int nPoints = 2000;
+	int nTris = 2000;
+	string outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--points" && i + 1 < argc) {
+			nPoints = max(1, atoi(argv[++i]));
+		} else if (arg == "--triangles" && i + 1 < argc) {
+			nTris = max(1, atoi(argv[++i]));
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	bool ok = verify();
+
+	// Cena parecida com a do Parte2: triângulos de até 100 px numa tela 800x600
+	mt19937 rng(7);
+	uniform_real_distribution<float> px(0.0f, 800.0f), py(0.0f, 600.0f), d(-50.0f, 50.0f);
+	vector<float> tris;
+	TriangleBatch batch;
+	for (int i = 0; i < nTris; i++) {
+		float cx = px(rng), cy = py(rng);
+		float t[] = { cx + d(rng), cy + d(rng), cx + d(rng), cy + d(rng), cx + d(rng), cy + d(rng) };
+		tris.insert(tris.end(), t, t + 6);
+		batch.add(t);
+	}
+	vector<float> xs(nPoints), ys(nPoints);
+	for (int i = 0; i < nPoints; i++) {
+		xs[i] = px(rng);
+		ys[i] = py(rng);
+	}
+	double pairs = (double)nPoints * nTris;
+	vector<Result> results;
+
+	int hits = 0;
+	double t = seconds([&]() {
+		for (int p = 0; p < nPoints; p++) {
+			float point[] = { xs[p], ys[p] };
+			for (int i = 0; i < nTris; i++) {
+				hits += triangleCollidePoint2D(&tris[i * 6], point);
+			}
+		}
+	});
+	results.push_back({ "triangleCollidePoint2D", pairs / t });
+
+	t = seconds([&]() {
+		for (int p = 0; p < nPoints; p++) {
+			float point[] = { xs[p], ys[p] };
+			for (int i = 0; i < nTris; i++) {
+				hits += collideByDotProduct(&tris[i * 6], point);
+			}
+		}
+	});
+	results.push_back({ "collideByDotProduct", pairs / t });
+
+	vector<uint32_t> mask;
+	t = seconds([&]() {
+		collidePoints2D(batch, xs.data(), ys.data(), nPoints, mask);
+	});
+	hits += (int)mask[0];
+	results.push_back({ "collidePoints2D", pairs / t });
+
+	vector<int> picked(nPoints);
+	t = seconds([&]() {
+		pickTriangles2D(batch, xs.data(), ys.data(), nPoints, picked.data());
+	});
+	hits += picked[0];
+	// para no primeiro acerto a partir do topo: pares "cobertos" por segundo
+	results.push_back({ "pickTriangles2D", pairs / t });
+	sink = hits;
+
+	cout << "throughput (" << MATHS_SIMD_NAME << "): " << nPoints << " pontos x " << nTris << " triangulos" << endl;
+	for (const Result &r : results) {
+		cout << "  " << left << setw(24) << r.name << right << fixed << setprecision(1)
+		     << setw(10) << r.pairsPerSec / 1e6 << " M pares/s"
+		     << setw(9) << setprecision(1) << r.pairsPerSec / results[0].pairsPerSec << "x" << endl;
+	}
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"CollisionBench\",\n  \"backend\": \"" << MATHS_SIMD_NAME << "\",\n"
+		    << "  \"verified\": " << (ok ? "true" : "false") << ",\n"
+		    << "  \"points\": " << nPoints << ",\n  \"triangles\": " << nTris << ",\n  \"ops\": [\n";
+		for (size_t i = 0; i < results.size(); i++) {
+			out << "    { \"name\": \"" << results[i].name << "\", \"pairs_per_sec\": " << fixed << setprecision(0)
+			    << results[i].pairsPerSec << " }" << (i + 1 < results.size() ? ",\n" : "\n");
+		}
+		out << "  ]\n}\n";
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+// Campos de fluxo (FlowField.h) num TileMap de 2048 x 2048: tempo de construção x threads
+//
+// Gera um mapa de --size x --size com paredes em blocos e terreno de custos
+// diferentes e mede:
+//   construção: os campos de --goals destinos comuns com 1, 2, 4, ... threads
+//               (até --max-threads, padrão: os núcleos da máquina), mediana de
+//               --rounds rodadas, e o ganho sobre 1 thread
+//   agentes   : --agents personagens lendo a direção da sua célula e andando
+//               (passos por segundo)
+// O campo de integração de cada destino é conferido, célula a célula, contra
+// um Dijkstra simples no mapa inteiro, em todas as contagens de threads; o
+// campo de direções tem que levar cada agente ao destino somando exatamente o
+// custo do campo, e os custos batem com o Pathfinder em algumas consultas.
+//
+// Uso: FlowFieldBench [--size N] [--goals N] [--agents N] [--rounds N] [--block N]
+//                     [--max-threads N] [--out arquivo.json]
+// Retorna 1 se algum campo diverge.
+
+#include "TileMap.h"
+#include "FlowField.h"
+#include "Pathfinder.h"
+#include "DiamondView.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+static uint32_t hash2(uint32_t x, uint32_t y) {
+	uint32_t h = x * 374761393u + y * 668265263u;
+	h = (h ^ (h >> 13)) * 1274126177u;
+	return h ^ (h >> 16);
+}
+
+static double median(vector<double> values) {
+	sort(values.begin(), values.end());
+	return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+// Tile 2 (pedra) bloqueia; terreno com 1 (grama), 4 (água rasa) e 0 (areia)
+static void generate(TileMap &tilemap) {
+	int w = tilemap.getWidth(), h = tilemap.getHeight();
+	for (int row = 0; row < h; row++) {
+		for (int col = 0; col < w; col++) {
+			int tile = 1;
+			if (hash2(col >> 3, row >> 3) % 100 < 22 || hash2(col, row) % 1000 < 5) {
+				tile = 2;
+			} else {
+				uint32_t t = hash2((col >> 4) + 7919, (row >> 4) + 104729) % 3;
+				tile = t == 0 ? 1 : (t == 1 ? 4 : 0);
+			}
+			tilemap.at(col, row) = (unsigned char)tile;
+		}
+	}
+}
+
+// Dijkstra de referência no mapa inteiro, sem borda: custo até o destino
+static vector<uint32_t> reference(TileMap &tilemap, const TileCostTable &costs, const TilemapView &view, int goalCol,
+                                  int goalRow) {
+	int w = tilemap.getWidth(), h = tilemap.getHeight();
+	int dc[9], dr[9];
+	for (int d = 1; d <= 8; d++) {
+		dc[d] = dr[d] = 0;
+		view.computeTileWalking(dc[d], dr[d], d);
+	}
+	auto walkable = [&](int col, int row) {
+		return col >= 0 && row >= 0 && col < w && row < h && costs.isWalkable(tilemap.getTile(col, row));
+	};
+	vector<uint32_t> dist((size_t)w * h, FlowField::UNREACHABLE);
+	priority_queue<pair<uint32_t, int>, vector<pair<uint32_t, int>>, greater<pair<uint32_t, int>>> open;
+	dist[(size_t)goalRow * w + goalCol] = 0;
+	open.push({ 0, goalRow * w + goalCol });
+	while (!open.empty()) {
+		uint32_t d = open.top().first;
+		int cell = open.top().second;
+		open.pop();
+		if (d != dist[cell]) {
+			continue;
+		}
+		int col = cell % w, row = cell / w;
+		unsigned enter = costs.getCost(tilemap.getTile(col, row));
+		for (int k = 1; k <= 8; k++) {
+			int fc = col - dc[k], fr = row - dr[k];
+			if (!walkable(fc, fr) ||
+			    (abs(dc[k]) == 1 && abs(dr[k]) == 1 && (!walkable(fc + dc[k], fr) || !walkable(fc, fr + dr[k])))) {
+				continue;
+			}
+			uint32_t nd = d + (abs(dc[k]) + abs(dr[k]) == 1 ? 10 : 14) * enter;
+			if (nd < dist[(size_t)fr * w + fc]) {
+				dist[(size_t)fr * w + fc] = nd;
+				open.push({ nd, fr * w + fc });
+			}
+		}
+	}
+	return dist;
+}
+
+int main(int argc, char **argv) {
+	int size = 2048, goalCount = 4, agentCount = 100000, rounds = 3, block = 64;
+	unsigned maxThreads = max(1u, thread::hardware_concurrency());
+	string outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--size" && i + 1 < argc) {
+			size = max(64, atoi(argv[++i]));
+		} else if (arg == "--goals" && i + 1 < argc) {
+			goalCount = max(1, atoi(argv[++i]));
+		} else if (arg == "--agents" && i + 1 < argc) {
+			agentCount = max(1, atoi(argv[++i]));
+		} else if (arg == "--rounds" && i + 1 < argc) {
+			rounds = max(1, atoi(argv[++i]));
+		} else if (arg == "--block" && i + 1 < argc) {
+			block = max(8, atoi(argv[++i]));
+		} else if (arg == "--max-threads" && i + 1 < argc) {
+			maxThreads = (unsigned)max(1, atoi(argv[++i]));
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	DiamondView diamond;
+	TileCostTable costs;
+	costs.setBlocked(2);
+	costs.setCost(4, 3);
+	costs.setCost(0, 2);
+	TileMap tilemap(size, size, 1);
+	generate(tilemap);
+
+	vector<pair<int, int>> goals;
+	for (uint32_t i = 0; (int)goals.size() < goalCount; i++) {
+		int col = hash2(i, 21) % size, row = hash2(i, 22) % size;
+		if (tilemap.getTile(col, row) != 2) {
+			goals.push_back({ col, row });
+		}
+	}
+
+	bool ok = true;
+	vector<vector<uint32_t>> expected;
+	for (const pair<int, int> &goal : goals) {
+		expected.push_back(reference(tilemap, costs, diamond, goal.first, goal.second));
+	}
+
+	FlowFieldGenerator generator(&tilemap, costs, &diamond, block);
+	vector<FlowField> fields(goals.size());
+	vector<unsigned> threadCounts;
+	for (unsigned t = 1; t < maxThreads; t *= 2) {
+		threadCounts.push_back(t);
+	}
+	threadCounts.push_back(maxThreads);
+
+	vector<double> buildMs;
+	double passesPerField = 0.0;
+	for (unsigned threads : threadCounts) {
+		generator.setThreads(threads);
+		vector<double> times;
+		for (int r = 0; r < rounds; r++) {
+			generator.resetStats();
+			auto start = chrono::steady_clock::now();
+			for (size_t g = 0; g < goals.size(); g++) {
+				generator.build(goals[g].first, goals[g].second, fields[g]);
+			}
+			times.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+			passesPerField = (double)generator.getStats().blockPasses / goals.size();
+		}
+		buildMs.push_back(median(times));
+		for (size_t g = 0; g < goals.size(); g++) {
+			for (int row = 0; row < size && ok; row++) {
+				for (int col = 0; col < size; col++) {
+					if (fields[g].getDistance(col, row) != expected[g][(size_t)row * size + col]) {
+						ok = false;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	// agentes: célula livre alcançável, destino g = i % goals
+	vector<int> agentCol, agentRow, agentGoal;
+	for (uint32_t i = 0; (int)agentCol.size() < agentCount; i++) {
+		int col = hash2(i, 31) % size, row = hash2(i, 32) % size, g = (int)(agentCol.size() % goals.size());
+		if (fields[g].getDistance(col, row) != FlowField::UNREACHABLE) {
+			agentCol.push_back(col);
+			agentRow.push_back(row);
+			agentGoal.push_back(g);
+		}
+	}
+
+	// os primeiros andam até o fim somando o custo de cada passo
+	for (int i = 0; i < 500 && i < agentCount; i++) {
+		const FlowField &field = fields[agentGoal[i]];
+		int col = agentCol[i], row = agentRow[i];
+		uint32_t total = 0;
+		while (field.getDirection(col, row) != 0) {
+			int c = col, r = row;
+			field.step(c, r);
+			total += (abs(c - col) + abs(r - row) == 1 ? 10 : 14) * costs.getCost(tilemap.getTile(c, r));
+			col = c;
+			row = r;
+		}
+		ok = ok && col == goals[agentGoal[i]].first && row == goals[agentGoal[i]].second &&
+		     total == field.getDistance(agentCol[i], agentRow[i]);
+	}
+	{
+		Pathfinder pathfinder(&tilemap, costs, &diamond);
+		vector<PathStep> path;
+		for (int i = 0; i < 50 && i < agentCount; i++) {
+			const pair<int, int> &goal = goals[agentGoal[i]];
+			bool found = pathfinder.findPath(agentCol[i], agentRow[i], goal.first, goal.second, path);
+			ok = ok && found && pathfinder.getLastCost() == fields[agentGoal[i]].getDistance(agentCol[i], agentRow[i]);
+		}
+	}
+
+	// 64 passos de todos os agentes, uma leitura de direção por passo
+	const int steps = 64;
+	long moved = 0;
+	auto start = chrono::steady_clock::now();
+	for (int s = 0; s < steps; s++) {
+		for (int i = 0; i < agentCount; i++) {
+			moved += fields[agentGoal[i]].step(agentCol[i], agentRow[i]);
+		}
+	}
+	double agentSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	double stepsPerSecond = (double)agentCount * steps / agentSeconds;
+
+	cout << size << "x" << size << ", " << goals.size() << " destinos, blocos de " << generator.getBlockSize() << " ("
+	     << fixed << setprecision(1) << passesPerField << " passadas de bloco por campo, "
+	     << thread::hardware_concurrency() << " nucleos)" << endl;
+	for (size_t i = 0; i < threadCounts.size(); i++) {
+		cout << "  " << setw(2) << threadCounts[i] << " threads: " << setw(9) << setprecision(1) << buildMs[i]
+		     << " ms (" << setprecision(1) << buildMs[i] / goals.size() << " ms por campo, " << setprecision(2)
+		     << buildMs[0] / buildMs[i] << "x)" << endl;
+	}
+	cout << "  agentes: " << setprecision(1) << stepsPerSecond / 1e6 << " M passos/s (" << moved << " passos)"
+	     << endl;
+	cout << "  conferencia " << (ok ? "ok" : "FALHOU") << endl;
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"FlowFieldBench\",\n  \"size\": " << size << ",\n  \"goals\": " << goals.size()
+		    << ",\n  \"block\": " << generator.getBlockSize() << ",\n  \"hardware_threads\": "
+		    << thread::hardware_concurrency() << ",\n  \"correct\": " << (ok ? "true" : "false") << fixed
+		    << setprecision(2) << ",\n  \"block_passes_per_field\": " << passesPerField
+		    << ",\n  \"agent_steps_per_s\": " << stepsPerSecond << ",\n  \"build\": [\n";
+		for (size_t i = 0; i < threadCounts.size(); i++) {
+			out << "    { \"threads\": " << threadCounts[i] << ", \"ms\": " << buildMs[i] << ", \"speedup\": "
+			    << buildMs[0] / buildMs[i] << " }" << (i + 1 < threadCounts.size() ? "," : "") << "\n";
+		}
+		out << "  ]\n}\n";
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+// Neblina de guerra incremental (FogOfWar.h) num TileMap de 1024 x 1024
+//
+// Gera um mapa de --size x --size com pedras (opacas) em blocos, espalha
+// --units unidades em dois times (raio --radius) e mede, por frame:
+//   incremental: update() com 1%, 5% e 20% das unidades andando um tile
+//                (mediana de --frames frames), e blocos da textura a reenviar
+//   completo   : um FogOfWar novo com todas as unidades (o custo de recalcular
+//                tudo a cada frame)
+// Depois, 200 pedras trocadas perto de unidades (setTile). Confere os bitsets
+// de visíveis de cada time contra um FogOfWar refeito do zero no fim (as
+// células exploradas têm que conter as visíveis), e o campo de uma unidade
+// sem paredes contra o disco do raio.
+//
+// Uso: FogOfWarBench [--size N] [--units N] [--radius N] [--frames N] [--out arquivo.json]
+// Retorna 1 se a visibilidade incremental diverge.
+
+#include "TileMap.h"
+#include "FogOfWar.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+static uint32_t hash2(uint32_t x, uint32_t y) {
+	uint32_t h = x * 374761393u + y * 668265263u;
+	h = (h ^ (h >> 13)) * 1274126177u;
+	return h ^ (h >> 16);
+}
+
+static double median(vector<double> values) {
+	sort(values.begin(), values.end());
+	return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+static double usSince(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+// Tile 2 (pedra) é opaco, 1 (grama) livre
+static void generate(TileMap &tilemap) {
+	for (int row = 0; row < tilemap.getHeight(); row++) {
+		for (int col = 0; col < tilemap.getWidth(); col++) {
+			bool stone = hash2(col >> 2, row >> 2) % 100 < 12 || hash2(col, row) % 100 < 2;
+			tilemap.at(col, row) = stone ? 2 : 1;
+		}
+	}
+}
+
+struct Mover {
+	int col, row, id;
+};
+
+int main(int argc, char **argv) {
+	int size = 1024, unitCount = 2000, radius = 10, frames = 100;
+	string outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--size" && i + 1 < argc) {
+			size = max(64, atoi(argv[++i]));
+		} else if (arg == "--units" && i + 1 < argc) {
+			unitCount = max(1, atoi(argv[++i]));
+		} else if (arg == "--radius" && i + 1 < argc) {
+			radius = max(1, atoi(argv[++i]));
+		} else if (arg == "--frames" && i + 1 < argc) {
+			frames = max(1, atoi(argv[++i]));
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	bool ok = true;
+
+	// sem paredes o campo é o disco inteiro
+	{
+		TileMap open(64, 64, 1);
+		FogOfWar fog(&open);
+		fog.addUnit(0, 32, 32, radius);
+		fog.update();
+		for (int row = 0; row < 64; row++) {
+			for (int col = 0; col < 64; col++) {
+				int dc = col - 32, dr = row - 32;
+				ok = ok && fog.isVisible(0, col, row) == (dc * dc + dr * dr <= radius * radius);
+			}
+		}
+	}
+
+	TileMap tilemap(size, size, 1);
+	generate(tilemap);
+	FogOfWar fog(&tilemap, 2);
+	fog.setOpaque(2, true);
+
+	vector<Mover> movers;
+	for (uint32_t i = 0; (int)movers.size() < unitCount; i++) {
+		int col = hash2(i, 1) % size, row = hash2(i, 2) % size;
+		if (tilemap.getTile(col, row) != 2) {
+			int team = (int)(movers.size() % 2);
+			movers.push_back({ col, row, fog.addUnit(team, col, row, radius) });
+		}
+	}
+	auto start = chrono::steady_clock::now();
+	fog.update();
+	double firstMs = usSince(start) / 1000.0;
+	fog.clearDirtyBlocks(0);
+	fog.clearDirtyBlocks(1);
+
+	static const int dc[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	static const int dr[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+	const int percents[3] = { 1, 5, 20 };
+	double frameUs[3], blocksPerFrame[3], unitsPerFrame[3];
+	uint32_t seed = 0;
+	for (int p = 0; p < 3; p++) {
+		vector<double> times;
+		long blocks = 0, updated = 0;
+		for (int f = 0; f < frames; f++) {
+			// percents[p]% das unidades andam um tile livre
+			for (size_t i = 0; i < movers.size(); i++) {
+				if ((int)(hash2((uint32_t)i, seed) % 100) >= percents[p]) {
+					continue;
+				}
+				Mover &m = movers[i];
+				int d = hash2((uint32_t)i, seed + 7) % 8;
+				int col = m.col + dc[d], row = m.row + dr[d];
+				if (col >= 0 && row >= 0 && col < size && row < size && tilemap.getTile(col, row) != 2) {
+					m.col = col;
+					m.row = row;
+					fog.moveUnit(m.id, col, row);
+				}
+			}
+			seed++;
+			start = chrono::steady_clock::now();
+			updated += fog.update();
+			times.push_back(usSince(start));
+			blocks += (long)fog.getDirtyBlocks(0).size();
+			fog.clearDirtyBlocks(0);
+			fog.clearDirtyBlocks(1);
+		}
+		frameUs[p] = median(times);
+		blocksPerFrame[p] = (double)blocks / frames;
+		unitsPerFrame[p] = (double)updated / frames;
+	}
+
+	// pedras que aparecem e somem: só as unidades com a célula no raio refazem
+	for (uint32_t i = 0; i < 200; i++) {
+		const Mover &m = movers[hash2(i, 41) % movers.size()];
+		int col = min(size - 1, max(0, m.col + (int)(hash2(i, 42) % 7) - 3));
+		int row = min(size - 1, max(0, m.row + (int)(hash2(i, 43) % 7) - 3));
+		if (col != m.col || row != m.row) {
+			tilemap.setTile(col, row, tilemap.getTile(col, row) == 2 ? 1 : 2);
+		}
+	}
+	fog.update();
+
+	// do zero nas posições finais: custo completo e conferência
+	start = chrono::steady_clock::now();
+	FogOfWar fresh(&tilemap, 2);
+	fresh.setOpaque(2, true);
+	for (size_t i = 0; i < movers.size(); i++) {
+		fresh.addUnit((int)(i % 2), movers[i].col, movers[i].row, radius);
+	}
+	fresh.update();
+	double fullUs = usSince(start);
+	for (int team = 0; team < 2; team++) {
+		ok = ok && fog.getVisibleBits(team) == fresh.getVisibleBits(team);
+		const vector<uint64_t> &visible = fog.getVisibleBits(team), &explored = fog.getExploredBits(team);
+		for (size_t w = 0; w < visible.size(); w++) {
+			ok = ok && (visible[w] & ~explored[w]) == 0;
+		}
+	}
+
+	long visibleCells = 0;
+	for (uint64_t word : fog.getVisibleBits(0)) {
+		visibleCells += __builtin_popcountll(word);
+	}
+	int totalBlocks = fog.getBlocksX() * ((size + FogOfWar::BLOCK - 1) / FogOfWar::BLOCK);
+
+	cout << size << "x" << size << ", " << movers.size() << " unidades em 2 times, raio " << radius << ": "
+	     << visibleCells << " celulas visiveis no time 0, primeiro calculo " << fixed << setprecision(1) << firstMs
+	     << " ms" << endl;
+	for (int p = 0; p < 3; p++) {
+		cout << "  " << setw(2) << percents[p] << "% andando: " << setw(8) << setprecision(1) << frameUs[p]
+		     << " us por frame (" << unitsPerFrame[p] << " unidades, " << blocksPerFrame[p] << " de " << totalBlocks
+		     << " blocos da textura)" << endl;
+	}
+	cout << "  completo:   " << setw(8) << fullUs << " us (" << setprecision(1) << fullUs / frameUs[0]
+	     << "x o frame com 1%)" << endl;
+	cout << "  conferencia " << (ok ? "ok" : "FALHOU") << endl;
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"FogOfWarBench\",\n  \"size\": " << size << ",\n  \"units\": " << movers.size()
+		    << ",\n  \"radius\": " << radius << ",\n  \"correct\": " << (ok ? "true" : "false") << fixed
+		    << setprecision(2) << ",\n  \"full_recompute_us\": " << fullUs << ",\n  \"texture_blocks\": " << totalBlocks
+		    << ",\n  \"incremental\": [\n";
+		for (int p = 0; p < 3; p++) {
+			out << "    { \"moving_percent\": " << percents[p] << ", \"frame_us\": " << frameUs[p]
+			    << ", \"units_updated\": " << unitsPerFrame[p] << ", \"dirty_blocks\": " << blocksPerFrame[p] << " }"
+			    << (p < 2 ? "," : "") << "\n";
+		}
+		out << "  ]\n}\n";
+	}
+	return ok ? 0 : 1;
+}
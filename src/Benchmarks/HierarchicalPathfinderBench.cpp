@@ -0,0 +1,238 @@
+// HPA* num TileMap de 4096 x 4096 (HierarchicalPathfinder.h) x A* completo
+//
+// Gera um mapa de --size x --size com paredes em blocos e mede:
+//   construção : grafo abstrato inteiro (clusters em paralelo)
+//   consulta   : latência de --queries pares aleatórios (p50, p90, p99, máx)
+//   completo   : as primeiras --full consultas com o Pathfinder (JPS, sem
+//                cache), para comparar latência e custo do caminho
+//   atualização: --updates setTile aleatórios (parede <-> grama), cada um
+//                seguido de update(); latência e clusters refeitos
+// Todo caminho é conferido (passos, cantos, custo informado); o HPA* tem que
+// achar caminho sempre que o A* acha, e depois das atualizações tem que dar os
+// mesmos custos de um HPA* construído do zero no mapa alterado.
+//
+// Uso: HierarchicalPathfinderBench [--size N] [--cluster N] [--queries N] [--full N]
+//                                  [--updates N] [--out arquivo.json]
+// Retorna 1 se algum caminho é inválido ou diverge.
+
+#include "TileMap.h"
+#include "Pathfinder.h"
+#include "HierarchicalPathfinder.h"
+#include "DiamondView.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+struct Query {
+	int col0, row0, col1, row1;
+};
+
+static uint32_t hash2(uint32_t x, uint32_t y) {
+	uint32_t h = x * 374761393u + y * 668265263u;
+	h = (h ^ (h >> 13)) * 1274126177u;
+	return h ^ (h >> 16);
+}
+
+static double usSince(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+static double percentile(vector<double> values, double p) {
+	sort(values.begin(), values.end());
+	return values.empty() ? 0.0 : values[min(values.size() - 1, (size_t)(p * values.size()))];
+}
+
+// Tile 2 (pedra) bloqueia, 1 (grama) livre
+static void generate(TileMap &tilemap) {
+	for (int row = 0; row < tilemap.getHeight(); row++) {
+		for (int col = 0; col < tilemap.getWidth(); col++) {
+			bool wall = hash2(col >> 3, row >> 3) % 100 < 22 || hash2(col, row) % 1000 < 5;
+			tilemap.at(col, row) = wall ? 2 : 1;
+		}
+	}
+}
+
+static bool validPath(TileMap &tilemap, const TileCostTable &costs, const TilemapView &view, int col, int row,
+                      int goalCol, int goalRow, const vector<PathStep> &path, unsigned expectedCost) {
+	unsigned total = 0;
+	for (const PathStep &step : path) {
+		int c = col, r = row;
+		view.computeTileWalking(c, r, step.direction);
+		if (c != step.col || r != step.row || c < 0 || r < 0 || c >= tilemap.getWidth() || r >= tilemap.getHeight() ||
+		    !costs.isWalkable(tilemap.getTile(c, r))) {
+			return false;
+		}
+		int dc = c - col, dr = r - row;
+		if (abs(dc) == 1 && abs(dr) == 1 &&
+		    (!costs.isWalkable(tilemap.getTile(col + dc, row)) || !costs.isWalkable(tilemap.getTile(col, row + dr)))) {
+			return false;
+		}
+		total += (abs(dc) + abs(dr) == 1 ? 10 : 14) * costs.getCost(tilemap.getTile(c, r));
+		col = c;
+		row = r;
+	}
+	return col == goalCol && row == goalRow && total == expectedCost;
+}
+
+static void printLatency(const char *name, const vector<double> &us) {
+	cout << "  " << left << setw(12) << name << right << fixed << setprecision(1) << "p50 " << setw(9)
+	     << percentile(us, 0.5) << " us  p90 " << setw(9) << percentile(us, 0.9) << " us  p99 " << setw(9)
+	     << percentile(us, 0.99) << " us  max " << setw(9) << percentile(us, 1.0) << " us" << endl;
+}
+
+static void writeLatency(ofstream &out, const char *name, const vector<double> &us) {
+	out << "    \"" << name << "\": { \"count\": " << us.size() << fixed << setprecision(2) << ", \"p50_us\": "
+	    << percentile(us, 0.5) << ", \"p90_us\": " << percentile(us, 0.9) << ", \"p99_us\": " << percentile(us, 0.99)
+	    << ", \"max_us\": " << percentile(us, 1.0) << " }";
+}
+
+int main(int argc, char **argv) {
+	int size = 4096, cluster = 32, queryCount = 1000, fullCount = 30, updateCount = 1000;
+	string outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--size" && i + 1 < argc) {
+			size = max(64, atoi(argv[++i]));
+		} else if (arg == "--cluster" && i + 1 < argc) {
+			cluster = max(4, atoi(argv[++i]));
+		} else if (arg == "--queries" && i + 1 < argc) {
+			queryCount = max(1, atoi(argv[++i]));
+		} else if (arg == "--full" && i + 1 < argc) {
+			fullCount = max(0, atoi(argv[++i]));
+		} else if (arg == "--updates" && i + 1 < argc) {
+			updateCount = max(0, atoi(argv[++i]));
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	DiamondView diamond;
+	TileCostTable costs;
+	costs.setBlocked(2);
+	TileMap tilemap(size, size, 1);
+	generate(tilemap);
+
+	vector<Query> queries;
+	for (uint32_t i = 0; (int)queries.size() < queryCount; i++) {
+		Query q = { (int)(hash2(i, 1) % size), (int)(hash2(i, 2) % size), (int)(hash2(i, 3) % size),
+		            (int)(hash2(i, 4) % size) };
+		if (tilemap.getTile(q.col0, q.row0) != 2 && tilemap.getTile(q.col1, q.row1) != 2) {
+			queries.push_back(q);
+		}
+	}
+
+	auto start = chrono::steady_clock::now();
+	HierarchicalPathfinder hpa(&tilemap, costs, &diamond, cluster);
+	double buildMs = usSince(start) / 1000.0;
+
+	bool ok = true;
+	vector<PathStep> path;
+	vector<double> queryUs;
+	vector<unsigned> hpaCost(queries.size(), 0);
+	vector<bool> hpaFound(queries.size(), false);
+	for (size_t i = 0; i < queries.size(); i++) {
+		const Query &q = queries[i];
+		start = chrono::steady_clock::now();
+		hpaFound[i] = hpa.findPath(q.col0, q.row0, q.col1, q.row1, path);
+		queryUs.push_back(usSince(start));
+		hpaCost[i] = hpa.getLastCost();
+		ok = ok && (!hpaFound[i] || validPath(tilemap, costs, diamond, q.col0, q.row0, q.col1, q.row1, path, hpaCost[i]));
+	}
+
+	// A* completo nas primeiras consultas
+	vector<double> fullUs;
+	double ratioSum = 0.0, ratioMax = 1.0;
+	int compared = 0;
+	if (fullCount > 0) {
+		Pathfinder full(&tilemap, costs, &diamond);
+		full.setCacheSize(0);
+		for (size_t i = 0; i < queries.size() && (int)i < fullCount; i++) {
+			const Query &q = queries[i];
+			start = chrono::steady_clock::now();
+			bool found = full.findPath(q.col0, q.row0, q.col1, q.row1, path);
+			fullUs.push_back(usSince(start));
+			ok = ok && found == hpaFound[i] && (!found || hpaCost[i] >= full.getLastCost());
+			if (found && full.getLastCost() > 0) {
+				double ratio = (double)hpaCost[i] / full.getLastCost();
+				ratioSum += ratio;
+				ratioMax = max(ratioMax, ratio);
+				compared++;
+			}
+		}
+	}
+
+	// setTile + update, só os clusters afetados
+	vector<double> updateUs;
+	long rebuilt = 0;
+	for (int i = 0; i < updateCount; i++) {
+		int col = hash2(i, 11) % size, row = hash2(i, 12) % size;
+		start = chrono::steady_clock::now();
+		tilemap.setTile(col, row, tilemap.getTile(col, row) == 2 ? 1 : 2);
+		rebuilt += hpa.update();
+		updateUs.push_back(usSince(start));
+	}
+
+	// consultas depois das atualizações: válidas e iguais ao HPA* refeito do zero
+	vector<double> afterUs;
+	HierarchicalPathfinder fresh(&tilemap, costs, &diamond, cluster);
+	vector<PathStep> freshPath;
+	for (size_t i = 0; i < queries.size() && i < 200; i++) {
+		const Query &q = queries[i];
+		if (tilemap.getTile(q.col0, q.row0) == 2 || tilemap.getTile(q.col1, q.row1) == 2) {
+			continue;
+		}
+		start = chrono::steady_clock::now();
+		bool found = hpa.findPath(q.col0, q.row0, q.col1, q.row1, path);
+		afterUs.push_back(usSince(start));
+		bool freshFound = fresh.findPath(q.col0, q.row0, q.col1, q.row1, freshPath);
+		ok = ok && found == freshFound && hpa.getLastCost() == fresh.getLastCost() &&
+		     (!found || validPath(tilemap, costs, diamond, q.col0, q.row0, q.col1, q.row1, path, hpa.getLastCost()));
+	}
+	ok = ok && hpa.getNodeCount() == fresh.getNodeCount() && hpa.getEdgeCount() == fresh.getEdgeCount();
+
+	double total = 0.0;
+	for (double us : queryUs) {
+		total += us;
+	}
+	cout << size << "x" << size << ", clusters de " << cluster << "x" << cluster << ": " << hpa.getNodeCount() << " nos, "
+	     << hpa.getEdgeCount() << " arestas, construido em " << fixed << setprecision(1) << buildMs << " ms ("
+	     << thread::hardware_concurrency() << " threads)" << endl;
+	printLatency("hpa", queryUs);
+	printLatency("completo", fullUs);
+	printLatency("atualizacao", updateUs);
+	printLatency("depois", afterUs);
+	cout << "  " << queries.size() / (total / 1e6) << " consultas/s; custo hpa/otimo " << setprecision(3)
+	     << (compared > 0 ? ratioSum / compared : 1.0) << " em media, " << ratioMax << " no pior; "
+	     << setprecision(2) << (updateCount > 0 ? (double)rebuilt / updateCount : 0.0) << " clusters por atualizacao"
+	     << endl;
+	cout << "  conferencia " << (ok ? "ok" : "FALHOU") << endl;
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"HierarchicalPathfinderBench\",\n  \"size\": " << size << ",\n  \"cluster\": " << cluster
+		    << ",\n  \"correct\": " << (ok ? "true" : "false") << ",\n  \"nodes\": " << hpa.getNodeCount()
+		    << ",\n  \"edges\": " << hpa.getEdgeCount() << fixed << setprecision(2) << ",\n  \"build_ms\": " << buildMs
+		    << ",\n  \"queries_per_s\": " << queries.size() / (total / 1e6) << ",\n  \"cost_ratio_mean\": "
+		    << setprecision(4) << (compared > 0 ? ratioSum / compared : 1.0) << ",\n  \"cost_ratio_max\": " << ratioMax
+		    << ",\n  \"clusters_per_update\": " << (updateCount > 0 ? (double)rebuilt / updateCount : 0.0)
+		    << ",\n  \"latency\": {\n";
+		writeLatency(out, "query", queryUs);
+		out << ",\n";
+		writeLatency(out, "full_astar", fullUs);
+		out << ",\n";
+		writeLatency(out, "update", updateUs);
+		out << ",\n";
+		writeLatency(out, "query_after_updates", afterUs);
+		out << "\n  }\n}\n";
+	}
+	return ok ? 0 : 1;
+}
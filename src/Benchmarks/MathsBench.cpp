@@ -0,0 +1,264 @@
+// Microbenchmark das operações de mat4/vec4 do maths_funcs (Common/M5-6)
+//
+// Compara a implementação atual (SIMD escolhido em tempo de compilação, ver
+// maths_simd.h) com a versão escalar anterior (maths_funcs_legacy.cpp) em
+// matrizes por segundo, e confere se as duas dão o mesmo resultado. Não usa
+// OpenGL nem abre janela.
+//
+// Uso: MathsBench [--matrices N] [--rounds N] [--out arquivo.json]
+//   --matrices  quantas matrizes distintas por rodada (padrão 4096, cabe na cache)
+//   --rounds    quantas vezes o conjunto é percorrido em cada medida (padrão 500)
+//   --out       grava também um JSON com os números de cada operação
+//
+// Retorna 1 se alguma operação diverge da referência além da tolerância.
+
+#include "maths_funcs.h"
+#include "maths_simd.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+
+namespace legacy {
+vec4 mul (const mat4& mm, const vec4& rhs);
+mat4 mul (const mat4& lhs, const mat4& rhs);
+float determinant (const mat4& mm);
+mat4 inverse (const mat4& mm);
+mat4 transpose (const mat4& mm);
+mat4 translate (const mat4& m, const vec3& v);
+mat4 rotate_x_deg (const mat4& m, float deg);
+mat4 rotate_y_deg (const mat4& m, float deg);
+mat4 rotate_z_deg (const mat4& m, float deg);
+mat4 scale (const mat4& m, const vec3& v);
+}
+
+struct Inputs {
+	vector<mat4> a, b;
+	vector<vec4> v;
+	vector<vec3> t;
+	vector<float> deg;
+};
+
+struct Result {
+	string name;
+	double legacyRate;   // matrizes/s
+	double simdRate;
+	double maxError;     // maior diferença relativa entre as duas versões
+	double tolerance;
+};
+
+// Evita que o compilador descarte os resultados medidos
+static volatile float sink;
+
+static float checksum(const mat4 &m) {
+	return m.m[0] + m.m[5] + m.m[10] + m.m[15] + m.m[12];
+}
+
+// Diferença relativa (com piso 1 no denominador, para valores perto de zero)
+static double relError(float a, float b) {
+	return fabs((double)a - b) / max(1.0, fabs((double)b));
+}
+
+static double maxError(const mat4 &a, const mat4 &b) {
+	double e = 0.0;
+	for (int i = 0; i < 16; i++) {
+		e = max(e, relError(a.m[i], b.m[i]));
+	}
+	return e;
+}
+
+// Matriz de modelo como as dos demos (escala, rotação, translação) com uma
+// perturbação pequena em todas as entradas, para que inverse e determinant não
+// caiam em casos triviais
+static mat4 randomMatrix(mt19937 &rng) {
+	uniform_real_distribution<float> pos(-100.0f, 100.0f);
+	uniform_real_distribution<float> scl(0.5f, 4.0f);
+	uniform_real_distribution<float> ang(0.0f, 360.0f);
+	uniform_real_distribution<float> eps(-0.05f, 0.05f);
+
+	mat4 m = identity_mat4();
+	m = scale(m, vec3(scl(rng), scl(rng), scl(rng)));
+	m = rotate_x_deg(m, ang(rng));
+	m = rotate_z_deg(m, ang(rng));
+	m = translate(m, vec3(pos(rng), pos(rng), pos(rng)));
+	for (int i = 0; i < 16; i++) {
+		m.m[i] += eps(rng);
+	}
+	return m;
+}
+
+static Inputs makeInputs(int count) {
+	mt19937 rng(1234);
+	uniform_real_distribution<float> pos(-100.0f, 100.0f);
+	uniform_real_distribution<float> ang(0.0f, 360.0f);
+	Inputs in;
+	for (int i = 0; i < count; i++) {
+		in.a.push_back(randomMatrix(rng));
+		in.b.push_back(randomMatrix(rng));
+		in.v.push_back(vec4(pos(rng), pos(rng), pos(rng), 1.0f));
+		in.t.push_back(vec3(pos(rng), pos(rng), pos(rng)));
+		in.deg.push_back(ang(rng));
+	}
+	return in;
+}
+
+// Roda body(i) para todas as matrizes, rounds vezes, e devolve operações/s
+template <typename Body>
+static double measure(int count, int rounds, Body body) {
+	float acc = 0.0f;
+	for (int i = 0; i < count; i++) {
+		acc += body(i); // aquecimento
+	}
+	auto start = chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < count; i++) {
+			acc += body(i);
+		}
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	sink = acc;
+	return (double)count * rounds / seconds;
+}
+
+int main(int argc, char **argv) {
+	int count = 4096;
+	int rounds = 500;
+	string outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--matrices" && i + 1 < argc) {
+			count = max(1, atoi(argv[++i]));
+		} else if (arg == "--rounds" && i + 1 < argc) {
+			rounds = max(1, atoi(argv[++i]));
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	Inputs in = makeInputs(count);
+	vector<Result> results;
+
+	// Cada operação: nome, tolerância, versão antiga, versão nova (ambas
+	// devolvem a matriz resultante da entrada i)
+	auto matOp = [&](const string &name, double tolerance,
+	                 auto oldOp, auto newOp) {
+		Result r;
+		r.name = name;
+		r.tolerance = tolerance;
+		r.maxError = 0.0;
+		for (int i = 0; i < count; i++) {
+			r.maxError = max(r.maxError, maxError(newOp(i), oldOp(i)));
+		}
+		r.legacyRate = measure(count, rounds, [&](int i) { return checksum(oldOp(i)); });
+		r.simdRate = measure(count, rounds, [&](int i) { return checksum(newOp(i)); });
+		results.push_back(r);
+	};
+
+	matOp("mat4 * mat4", 1e-5,
+	      [&](int i) { return legacy::mul(in.a[i], in.b[i]); },
+	      [&](int i) { return in.a[i] * in.b[i]; });
+	matOp("transpose", 0.0,
+	      [&](int i) { return legacy::transpose(in.a[i]); },
+	      [&](int i) { return transpose(in.a[i]); });
+	matOp("inverse", 1e-3,
+	      [&](int i) { return legacy::inverse(in.a[i]); },
+	      [&](int i) { return inverse(in.a[i]); });
+	matOp("translate", 1e-5,
+	      [&](int i) { return legacy::translate(in.a[i], in.t[i]); },
+	      [&](int i) { return translate(in.a[i], in.t[i]); });
+	matOp("rotate_x_deg", 1e-5,
+	      [&](int i) { return legacy::rotate_x_deg(in.a[i], in.deg[i]); },
+	      [&](int i) { return rotate_x_deg(in.a[i], in.deg[i]); });
+	matOp("rotate_y_deg", 1e-5,
+	      [&](int i) { return legacy::rotate_y_deg(in.a[i], in.deg[i]); },
+	      [&](int i) { return rotate_y_deg(in.a[i], in.deg[i]); });
+	matOp("rotate_z_deg", 1e-5,
+	      [&](int i) { return legacy::rotate_z_deg(in.a[i], in.deg[i]); },
+	      [&](int i) { return rotate_z_deg(in.a[i], in.deg[i]); });
+	matOp("scale", 1e-6,
+	      [&](int i) { return legacy::scale(in.a[i], in.t[i]); },
+	      [&](int i) { return scale(in.a[i], in.t[i]); });
+	// Matriz de modelo completa, como num laço de desenho
+	matOp("model (T*R*S)", 1e-4,
+	      [&](int i) {
+	          mat4 m = legacy::scale(identity_mat4(), vec3(2.0f, 2.0f, 1.0f));
+	          m = legacy::rotate_z_deg(m, in.deg[i]);
+	          return legacy::translate(m, in.t[i]);
+	      },
+	      [&](int i) {
+	          mat4 m = scale(identity_mat4(), vec3(2.0f, 2.0f, 1.0f));
+	          m = rotate_z_deg(m, in.deg[i]);
+	          return translate(m, in.t[i]);
+	      });
+
+	// determinant e mat4 * vec4 não devolvem matriz: comparação à parte
+	{
+		Result r;
+		r.name = "determinant";
+		r.tolerance = 1e-4;
+		r.maxError = 0.0;
+		for (int i = 0; i < count; i++) {
+			float ref = legacy::determinant(in.a[i]);
+			r.maxError = max(r.maxError, fabs((double)determinant(in.a[i]) - ref) / max(1.0, fabs((double)ref)));
+		}
+		r.legacyRate = measure(count, rounds, [&](int i) { return legacy::determinant(in.a[i]); });
+		r.simdRate = measure(count, rounds, [&](int i) { return determinant(in.a[i]); });
+		results.push_back(r);
+	}
+	{
+		Result r;
+		r.name = "mat4 * vec4";
+		r.tolerance = 1e-5;
+		r.maxError = 0.0;
+		for (int i = 0; i < count; i++) {
+			vec4 ref = legacy::mul(in.a[i], in.v[i]);
+			vec4 got = in.a[i] * in.v[i];
+			for (int k = 0; k < 4; k++) {
+				r.maxError = max(r.maxError, relError(got.v[k], ref.v[k]));
+			}
+		}
+		r.legacyRate = measure(count, rounds, [&](int i) { return legacy::mul(in.a[i], in.v[i]).v[0]; });
+		r.simdRate = measure(count, rounds, [&](int i) { return (in.a[i] * in.v[i]).v[0]; });
+		results.push_back(r);
+	}
+
+	bool ok = true;
+	cout << "maths_funcs: " << MATHS_SIMD_NAME << ", " << count << " matrizes x " << rounds << " rodadas" << endl;
+	cout << left << setw(16) << "operacao" << right << setw(14) << "escalar M/s" << setw(14) << "atual M/s"
+	     << setw(10) << "ganho" << setw(12) << "erro max" << endl;
+	for (const Result &r : results) {
+		bool pass = r.maxError <= r.tolerance;
+		ok = ok && pass;
+		cout << left << setw(16) << r.name << right << fixed << setprecision(2)
+		     << setw(14) << r.legacyRate / 1e6 << setw(14) << r.simdRate / 1e6
+		     << setw(9) << r.simdRate / r.legacyRate << "x"
+		     << scientific << setprecision(1) << setw(12) << r.maxError
+		     << (pass ? "" : "  DIVERGE") << endl;
+	}
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"MathsBench\",\n  \"backend\": \"" << MATHS_SIMD_NAME << "\",\n"
+		    << "  \"matrices\": " << count << ",\n  \"rounds\": " << rounds << ",\n  \"ops\": [\n";
+		for (size_t i = 0; i < results.size(); i++) {
+			const Result &r = results[i];
+			out << "    { \"name\": \"" << r.name << "\", \"legacy_per_sec\": " << fixed << setprecision(0) << r.legacyRate
+			    << ", \"current_per_sec\": " << r.simdRate
+			    << ", \"speedup\": " << setprecision(3) << r.simdRate / r.legacyRate
+			    << ", \"max_error\": " << scientific << setprecision(3) << r.maxError << " }"
+			    << (i + 1 < results.size() ? ",\n" : "\n");
+		}
+		out << "  ]\n}\n";
+	}
+
+	return ok ? 0 : 1;
+}
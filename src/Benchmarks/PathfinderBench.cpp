@@ -0,0 +1,308 @@
+// Caminhos num TileMap de 1024 x 1024: A* x jump point search x cache (Pathfinder.h)
+//
+// Gera um mapa de --size x --size com paredes em blocos e obstáculos soltos e
+// mede consultas por segundo (mediana das rodadas):
+//   astar     : A* puro, pares aleatórios de células livres
+//   jps       : os mesmos pares com jump point search (custo uniforme)
+//   terreno   : A* com tiles de custos diferentes (sem JPS), 1/4 das consultas
+//   agentes   : --agents personagens indo para 4 destinos comuns, replanejando
+//               a cada 8 passos, sem cache e com cache de caminhos
+// Todo caminho é conferido (passos válidos pelas direções do DiamondView, sem
+// cortar cantos, custo igual ao informado), o JPS tem que dar o mesmo custo do
+// A*, e as respostas do cache o mesmo custo de uma busca nova. Também confere
+// o A* com as direções do SlideView num mapa menor.
+//
+// Uso: PathfinderBench [--size N] [--queries N] [--agents N] [--rounds N] [--out arquivo.json]
+// Retorna 1 se algum caminho é inválido ou não ótimo.
+
+#include "TileMap.h"
+#include "Pathfinder.h"
+#include "DiamondView.h"
+#include "SlideView.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+struct Query {
+	int col0, row0, col1, row1;
+};
+
+static uint32_t hash2(uint32_t x, uint32_t y) {
+	uint32_t h = x * 374761393u + y * 668265263u;
+	h = (h ^ (h >> 13)) * 1274126177u;
+	return h ^ (h >> 16);
+}
+
+static double median(vector<double> values) {
+	sort(values.begin(), values.end());
+	return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+// Tile 2 (pedra) bloqueia; terreno usa 1 (grama), 4 (água rasa) e 0 (areia)
+static void generate(TileMap &tilemap, bool terrain) {
+	int w = tilemap.getWidth(), h = tilemap.getHeight();
+	for (int row = 0; row < h; row++) {
+		for (int col = 0; col < w; col++) {
+			bool wall = hash2(col >> 3, row >> 3) % 100 < 22 || hash2(col, row) % 1000 < 5;
+			int tile = 1;
+			if (wall) {
+				tile = 2;
+			} else if (terrain) {
+				uint32_t t = hash2((col >> 4) + 7919, (row >> 4) + 104729) % 3;
+				tile = t == 0 ? 1 : (t == 1 ? 4 : 0);
+			}
+			tilemap.at(col, row) = (unsigned char)tile;
+		}
+	}
+}
+
+static TileCostTable costTable() {
+	TileCostTable costs;
+	costs.setBlocked(2);
+	costs.setCost(4, 3);
+	costs.setCost(0, 2);
+	return costs;
+}
+
+// Confere passos, cantos e custo de um caminho
+static bool validPath(TileMap &tilemap, const TileCostTable &costs, const TilemapView &view, int col, int row,
+                      int goalCol, int goalRow, const vector<PathStep> &path, unsigned expectedCost) {
+	unsigned total = 0;
+	for (const PathStep &step : path) {
+		int c = col, r = row;
+		view.computeTileWalking(c, r, step.direction);
+		if (c != step.col || r != step.row || c < 0 || r < 0 || c >= tilemap.getWidth() || r >= tilemap.getHeight() ||
+		    !costs.isWalkable(tilemap.getTile(c, r))) {
+			return false;
+		}
+		int dc = c - col, dr = r - row;
+		if (abs(dc) == 1 && abs(dr) == 1 &&
+		    (!costs.isWalkable(tilemap.getTile(col + dc, row)) || !costs.isWalkable(tilemap.getTile(col, row + dr)))) {
+			return false;
+		}
+		total += (abs(dc) + abs(dr) == 1 ? 10 : 14) * costs.getCost(tilemap.getTile(c, r));
+		col = c;
+		row = r;
+	}
+	return col == goalCol && row == goalRow && total == expectedCost;
+}
+
+static vector<Query> makeQueries(TileMap &tilemap, const TileCostTable &costs, int count, uint32_t seed) {
+	vector<Query> queries;
+	int w = tilemap.getWidth(), h = tilemap.getHeight();
+	for (uint32_t i = 0; (int)queries.size() < count; i++) {
+		Query q = { (int)(hash2(i, seed) % w), (int)(hash2(i, seed + 1) % h), (int)(hash2(i, seed + 2) % w),
+		            (int)(hash2(i, seed + 3) % h) };
+		if (costs.isWalkable(tilemap.getTile(q.col0, q.row0)) && costs.isWalkable(tilemap.getTile(q.col1, q.row1))) {
+			queries.push_back(q);
+		}
+	}
+	return queries;
+}
+
+struct RunResult {
+	vector<double> ms;
+	long found;
+	vector<unsigned> costs;
+	bool valid;
+	double expandedPerQuery;
+};
+
+static RunResult runQueries(TileMap &tilemap, Pathfinder &pathfinder, const DiamondView &view,
+                            const vector<Query> &queries, int rounds) {
+	RunResult result = { {}, 0, vector<unsigned>(queries.size(), 0), true, 0.0 };
+	vector<PathStep> path;
+	for (int r = 0; r < rounds; r++) {
+		pathfinder.resetStats();
+		result.found = 0;
+		auto start = chrono::steady_clock::now();
+		for (size_t i = 0; i < queries.size(); i++) {
+			const Query &q = queries[i];
+			if (pathfinder.findPath(q.col0, q.row0, q.col1, q.row1, path)) {
+				result.found++;
+				result.costs[i] = pathfinder.getLastCost();
+			}
+		}
+		result.ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+		result.expandedPerQuery = (double)pathfinder.getStats().expanded / queries.size();
+	}
+	// conferência fora do tempo medido
+	for (size_t i = 0; i < queries.size(); i++) {
+		const Query &q = queries[i];
+		if (pathfinder.findPath(q.col0, q.row0, q.col1, q.row1, path)) {
+			result.valid = result.valid && validPath(tilemap, pathfinder.getCostTable(), view, q.col0, q.row0, q.col1,
+			                                         q.row1, path, pathfinder.getLastCost());
+		}
+	}
+	return result;
+}
+
+struct AgentResult {
+	double ms;
+	long queries, cacheHits;
+	bool valid;
+};
+
+// Agentes andando para destinos comuns e replanejando pelo caminho
+static AgentResult runAgents(TileMap &tilemap, Pathfinder &pathfinder, Pathfinder *reference, const DiamondView &view,
+                             int agents, int steps) {
+	const TileCostTable &costs = pathfinder.getCostTable();
+	vector<Query> goals = makeQueries(tilemap, costs, 4, 91);
+	vector<Query> starts = makeQueries(tilemap, costs, agents, 17);
+	vector<PathStep> path, check;
+	AgentResult result = { 0.0, 0, 0, true };
+	pathfinder.resetStats();
+	auto start = chrono::steady_clock::now();
+	for (int a = 0; a < agents; a++) {
+		int col = starts[a].col0, row = starts[a].row0;
+		const Query &goal = goals[a % goals.size()];
+		for (int s = 0; s < steps; s += 8) {
+			if (!pathfinder.findPath(col, row, goal.col1, goal.row1, path) || path.empty()) {
+				break;
+			}
+			if (reference != nullptr && s % 32 == 0) {
+				unsigned cost = pathfinder.getLastCost();
+				reference->findPath(col, row, goal.col1, goal.row1, check);
+				result.valid = result.valid && cost == reference->getLastCost() &&
+				               validPath(tilemap, costs, view, col, row, goal.col1, goal.row1, path, cost);
+			}
+			const PathStep &next = path[min(path.size(), (size_t)8) - 1];
+			col = next.col;
+			row = next.row;
+		}
+	}
+	result.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	result.queries = pathfinder.getStats().queries;
+	result.cacheHits = pathfinder.getStats().cacheHits;
+	return result;
+}
+
+int main(int argc, char **argv) {
+	int size = 1024, queryCount = 400, agents = 64, rounds = 3;
+	string outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--size" && i + 1 < argc) {
+			size = max(64, atoi(argv[++i]));
+		} else if (arg == "--queries" && i + 1 < argc) {
+			queryCount = max(1, atoi(argv[++i]));
+		} else if (arg == "--agents" && i + 1 < argc) {
+			agents = max(1, atoi(argv[++i]));
+		} else if (arg == "--rounds" && i + 1 < argc) {
+			rounds = max(1, atoi(argv[++i]));
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	DiamondView diamond;
+	TileCostTable costs = costTable();
+	TileMap tilemap(size, size, 1);
+	generate(tilemap, false);
+	vector<Query> queries = makeQueries(tilemap, costs, queryCount, 5);
+
+	Pathfinder pathfinder(&tilemap, costs, &diamond);
+	pathfinder.setCacheSize(0);
+	pathfinder.setJumpPoints(false);
+	RunResult astar = runQueries(tilemap, pathfinder, diamond, queries, rounds);
+	pathfinder.setJumpPoints(true);
+	RunResult jps = runQueries(tilemap, pathfinder, diamond, queries, rounds);
+	bool ok = astar.valid && jps.valid && astar.found == jps.found && astar.costs == jps.costs;
+
+	// agentes: sem cache x com cache (conferido contra buscas novas)
+	AgentResult noCache = runAgents(tilemap, pathfinder, nullptr, diamond, agents, size);
+	Pathfinder cached(&tilemap, costs, &diamond);
+	AgentResult withCache = runAgents(tilemap, cached, nullptr, diamond, agents, size);
+	AgentResult checked = runAgents(tilemap, cached, &pathfinder, diamond, agents, size);
+	ok = ok && checked.valid;
+
+	// tiles com custos diferentes: só A*
+	TileMap terrain(size, size, 1);
+	generate(terrain, true);
+	vector<Query> terrainQueries = makeQueries(terrain, costs, max(1, queryCount / 4), 9);
+	Pathfinder terrainFinder(&terrain, costs, &diamond);
+	terrainFinder.setCacheSize(0);
+	RunResult weighted = runQueries(terrain, terrainFinder, diamond, terrainQueries, rounds);
+	ok = ok && weighted.valid && terrainFinder.getStats().jumpSearches == 0;
+
+	// setTile: a célula bloqueada some dos caminhos seguintes
+	vector<PathStep> path;
+	const Query &q = queries[0];
+	if (cached.findPath(q.col0, q.row0, q.col1, q.row1, path) && path.size() > 1) {
+		PathStep middle = path[path.size() / 2];
+		tilemap.setTile(middle.col, middle.row, 2);
+		bool again = cached.findPath(q.col0, q.row0, q.col1, q.row1, path);
+		for (const PathStep &step : path) {
+			ok = ok && !(step.col == middle.col && step.row == middle.row);
+		}
+		ok = ok && (!again || validPath(tilemap, costs, diamond, q.col0, q.row0, q.col1, q.row1, path, cached.getLastCost()));
+		tilemap.setTile(middle.col, middle.row, 1);
+	}
+
+	// setTile: a célula bloqueada vira canto de uma diagonal do caminho no cache
+	{
+		TileMap corner(4, 4, 1);
+		Pathfinder cornerFinder(&corner, costs, &diamond);
+		Pathfinder fresh(&corner, costs, &diamond);
+		fresh.setCacheSize(0);
+		cornerFinder.findPath(0, 0, 2, 2, path);
+		corner.setTile(1, 0, 2);
+		bool again = cornerFinder.findPath(0, 0, 2, 2, path);
+		bool expected = fresh.findPath(0, 0, 2, 2, path);
+		ok = ok && again == expected && cornerFinder.getLastCost() == fresh.getLastCost();
+		if (again) {
+			cornerFinder.findPath(0, 0, 2, 2, path);
+			ok = ok && validPath(corner, costs, diamond, 0, 0, 2, 2, path, cornerFinder.getLastCost());
+		}
+	}
+
+	// SlideView (norte/sul andam duas linhas): A* com as direções dele
+	SlideView slide;
+	TileMap small(256, 256, 1);
+	generate(small, true);
+	Pathfinder slideFinder(&small, costs, &slide);
+	vector<Query> slideQueries = makeQueries(small, costs, 200, 13);
+	bool slideOk = true;
+	for (const Query &sq : slideQueries) {
+		if (slideFinder.findPath(sq.col0, sq.row0, sq.col1, sq.row1, path)) {
+			slideOk = slideOk && validPath(small, costs, slide, sq.col0, sq.row0, sq.col1, sq.row1, path, slideFinder.getLastCost());
+		}
+	}
+	ok = ok && slideOk && slideFinder.getStats().jumpSearches == 0;
+
+	double astarQps = queries.size() / (median(astar.ms) / 1000.0);
+	double jpsQps = queries.size() / (median(jps.ms) / 1000.0);
+	double weightedQps = terrainQueries.size() / (median(weighted.ms) / 1000.0);
+	double noCacheQps = noCache.queries / (noCache.ms / 1000.0);
+	double cacheQps = withCache.queries / (withCache.ms / 1000.0);
+	cout << size << "x" << size << ", " << queries.size() << " consultas, " << rounds << " rodadas (mediana)" << endl;
+	cout << fixed << setprecision(1)
+	     << "  astar    " << setw(10) << astarQps << " consultas/s, " << astar.expandedPerQuery << " nos/consulta, "
+	     << astar.found << " com caminho" << endl
+	     << "  jps      " << setw(10) << jpsQps << " consultas/s, " << jps.expandedPerQuery << " nos/consulta" << endl
+	     << "  terreno  " << setw(10) << weightedQps << " consultas/s (A*, custos 1-3)" << endl
+	     << "  agentes  " << setw(10) << noCacheQps << " consultas/s sem cache, " << cacheQps << " com cache ("
+	     << withCache.cacheHits << " de " << withCache.queries << " no cache)" << endl
+	     << "  conferencia " << (ok ? "ok" : "FALHOU") << endl;
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"PathfinderBench\",\n  \"size\": " << size << ",\n  \"queries\": " << queries.size()
+		    << ",\n  \"rounds\": " << rounds << ",\n  \"correct\": " << (ok ? "true" : "false") << fixed << setprecision(1)
+		    << ",\n  \"queries_per_s\": {\n    \"astar\": " << astarQps << ",\n    \"jps\": " << jpsQps
+		    << ",\n    \"terrain_astar\": " << weightedQps << ",\n    \"agents_no_cache\": " << noCacheQps
+		    << ",\n    \"agents_cache\": " << cacheQps << "\n  },\n  \"expanded_per_query\": { \"astar\": "
+		    << astar.expandedPerQuery << ", \"jps\": " << jps.expandedPerQuery << " },\n  \"agent_cache_hits\": "
+		    << withCache.cacheHits << ",\n  \"agent_queries\": " << withCache.queries << "\n}\n";
+	}
+	return ok ? 0 : 1;
+}
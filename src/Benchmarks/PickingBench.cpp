@@ -0,0 +1,204 @@
+// Benchmark do índice espacial de clique (Common/TriangleIndex.h)
+//
+// Coloca N triângulos iguais aos do Transformacoes/Parte2 (100x100, girados
+// 180 graus) e mede inserções, cliques (pick), arrastes (update) e remoções
+// por segundo, em dois cenários: todos na tela 800x600 (sobreposição enorme,
+// o caso do Parte2) e espalhados num mundo grande. Uma amostra dos cliques é
+// conferida contra a busca linear em todos os triângulos.
+//
+// Uso: PickingBench [--triangles N] [--out arquivo.json]   (padrão 1000000)
+// Retorna 1 se algum clique divergir da busca linear.
+
+#include "TriangleIndex.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+struct Scenario {
+	string name;
+	double insertRate, pickRate, updateRate, removeRate;
+	double linearPickRate;
+	double compactMs;
+	long mismatches;
+};
+
+static volatile long long sink;
+
+template <typename Body>
+static double seconds(Body body) {
+	auto start = chrono::steady_clock::now();
+	body();
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Triângulo do Parte2 na posição (x, y): o triângulo base (-0.5,-0.5),
+// (0.5,-0.5), (0,0.5) escalado por 100 e girado 180 graus
+static void parte2Triangle(float x, float y, float *t) {
+	t[0] = x + 50.0f; t[1] = y + 50.0f;
+	t[2] = x - 50.0f; t[3] = y + 50.0f;
+	t[4] = x;         t[5] = y - 50.0f;
+}
+
+// Referência: orientação em double, arestas incluídas
+static bool insideReference(const float *t, float x, float y) {
+	double d0 = ((double)t[2] - t[0]) * ((double)y - t[1]) - ((double)t[3] - t[1]) * ((double)x - t[0]);
+	double d1 = ((double)t[4] - t[2]) * ((double)y - t[3]) - ((double)t[5] - t[3]) * ((double)x - t[2]);
+	double d2 = ((double)t[0] - t[4]) * ((double)y - t[5]) - ((double)t[1] - t[5]) * ((double)x - t[4]);
+	return (d0 >= 0 && d1 >= 0 && d2 >= 0) || (d0 <= 0 && d1 <= 0 && d2 <= 0);
+}
+
+static int linearPick(const TriangleIndex &index, float x, float y) {
+	for (int id = index.size() - 1; id >= 0; id--) {
+		if (index.isAlive(id) && insideReference(index.getVertices(id), x, y)) {
+			return id;
+		}
+	}
+	return -1;
+}
+
+static Scenario run(const string &name, int count, float worldW, float worldH) {
+	Scenario s;
+	s.name = name;
+	mt19937 rng(99);
+	uniform_real_distribution<float> px(0.0f, worldW), py(0.0f, worldH), step(-20.0f, 20.0f);
+
+	vector<float> positions((size_t)count * 2);
+	for (float &p : positions) {
+		p = 0.0f;
+	}
+	for (int i = 0; i < count; i++) {
+		positions[i * 2] = px(rng);
+		positions[i * 2 + 1] = py(rng);
+	}
+
+	TriangleIndex index(64.0f);
+	double t = seconds([&]() {
+		float tri[6];
+		for (int i = 0; i < count; i++) {
+			parte2Triangle(positions[i * 2], positions[i * 2 + 1], tri);
+			index.insert(tri);
+		}
+	});
+	s.insertRate = count / t;
+
+	const int queries = 1000000;
+	vector<float> qx(queries), qy(queries);
+	for (int i = 0; i < queries; i++) {
+		qx[i] = px(rng);
+		qy[i] = py(rng);
+	}
+	long long acc = 0;
+	t = seconds([&]() {
+		for (int i = 0; i < queries; i++) {
+			acc += index.pick(qx[i], qy[i]);
+		}
+	});
+	s.pickRate = queries / t;
+
+	// Arrastes: triângulos aleatórios andando um pouco, como um drag do mouse
+	const int updates = 200000;
+	t = seconds([&]() {
+		float tri[6];
+		for (int i = 0; i < updates; i++) {
+			int id = rng() % count;
+			positions[id * 2] += step(rng);
+			positions[id * 2 + 1] += step(rng);
+			parte2Triangle(positions[id * 2], positions[id * 2 + 1], tri);
+			index.update(id, tri);
+		}
+	});
+	s.updateRate = updates / t;
+
+	// Remoções (botão direito) de 10% dos triângulos
+	const int removals = count / 10;
+	t = seconds([&]() {
+		for (int i = 0; i < removals; i++) {
+			index.remove((int)(((long long)i * 7919) % count));
+		}
+	});
+	s.removeRate = removals / t;
+
+	// Conferência (depois dos arrastes e remoções) e custo da busca linear
+	const int samples = 300;
+	s.mismatches = 0;
+	t = seconds([&]() {
+		for (int i = 0; i < samples; i++) {
+			int expected = linearPick(index, qx[i], qy[i]);
+			if (index.pick(qx[i], qy[i]) != expected) {
+				s.mismatches++;
+			}
+			acc += expected;
+		}
+	});
+	s.linearPickRate = samples / t;
+
+	vector<int> items(index.size());
+	for (int i = 0; i < (int)items.size(); i++) {
+		items[i] = i;
+	}
+	s.compactMs = seconds([&]() { index.compact(items); }) * 1000.0;
+	for (int i = 0; i < samples; i++) {
+		if (index.pick(qx[i], qy[i]) != linearPick(index, qx[i], qy[i])) {
+			s.mismatches++;
+		}
+	}
+
+	sink = acc;
+	return s;
+}
+
+int main(int argc, char **argv) {
+	int count = 1000000;
+	string outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--triangles" && i + 1 < argc) {
+			count = max(1, atoi(argv[++i]));
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	vector<Scenario> scenarios;
+	scenarios.push_back(run("tela 800x600", count, 800.0f, 600.0f));
+	scenarios.push_back(run("mundo 32000x32000", count, 32000.0f, 32000.0f));
+
+	bool ok = true;
+	cout << count << " triangulos (operacoes por segundo)" << endl;
+	for (const Scenario &s : scenarios) {
+		ok = ok && s.mismatches == 0;
+		cout << s.name << fixed << setprecision(0) << endl
+		     << "  insert  " << setw(12) << s.insertRate << endl
+		     << "  pick    " << setw(12) << s.pickRate << "   (busca linear: " << s.linearPickRate << ")" << endl
+		     << "  update  " << setw(12) << s.updateRate << endl
+		     << "  remove  " << setw(12) << s.removeRate << endl
+		     << "  compact " << setw(12) << setprecision(1) << s.compactMs << " ms" << endl
+		     << "  divergencias: " << s.mismatches << endl;
+	}
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"PickingBench\",\n  \"triangles\": " << count << ",\n  \"scenarios\": [\n";
+		for (size_t i = 0; i < scenarios.size(); i++) {
+			const Scenario &s = scenarios[i];
+			out << fixed << setprecision(0)
+			    << "    { \"name\": \"" << s.name << "\", \"insert_per_sec\": " << s.insertRate
+			    << ", \"pick_per_sec\": " << s.pickRate << ", \"linear_pick_per_sec\": " << s.linearPickRate
+			    << ", \"update_per_sec\": " << s.updateRate << ", \"remove_per_sec\": " << s.removeRate
+			    << ", \"compact_ms\": " << setprecision(2) << s.compactMs
+			    << ", \"mismatches\": " << s.mismatches << " }" << (i + 1 < scenarios.size() ? ",\n" : "\n");
+		}
+		out << "  ]\n}\n";
+	}
+
+	return ok ? 0 : 1;
+}
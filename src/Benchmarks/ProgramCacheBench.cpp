@@ -0,0 +1,200 @@
+// Início frio x quente do cache de programas de shader (Common/ProgramCache.h)
+//
+// Monta N programas (vertex + fragment) parecidos com os dos demos, com um
+// fragment shader de tamanho crescente para o compilador ter trabalho, e mede:
+//   frio   : pasta do cache vazia: compila, linka e grava cada binário
+//   quente : mesma execução de novo: todos os programas vêm do disco
+//   sem    : cache desligado (o setupShader antigo dos demos)
+// O resultado é a mediana das rodadas. Também confere a invalidação: um fonte
+// alterado e um arquivo com outro driver no cabeçalho têm que ser recompilados.
+//
+// Uso: ProgramCacheBench [--programs N] [--rounds N] [--dir pasta] [--out arquivo.json]
+// Retorna 1 se o driver aceita binários e o início quente não veio todo do
+// cache, ou se a invalidação falhou.
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "ProgramCache.h"
+#include "HeadlessRunner.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+struct Program {
+	string vertex, fragment;
+};
+
+static double median(vector<double> values) {
+	sort(values.begin(), values.end());
+	return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+static const char *VERTEX_SOURCE = R"(
+#version 400
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texc;
+uniform mat4 projection;
+uniform mat4 model;
+out vec2 texCoord;
+void main()
+{
+	gl_Position = projection * model * vec4(position, 1.0);
+	texCoord = texc;
+}
+)";
+
+// Fragment shader com "terms" termos de ruído (cada programa um diferente)
+static string fragmentSource(int id, int terms) {
+	string s = "#version 400\nin vec2 texCoord;\nuniform sampler2D texBuff;\nuniform float time;\nout vec4 color;\n";
+	s += "float hash(vec2 p) { return fract(sin(dot(p, vec2(12.9898, 78.233))) * 43758.5453); }\n";
+	s += "void main()\n{\n\tvec4 c = texture(texBuff, texCoord);\n\tfloat n = 0.0;\n";
+	for (int t = 0; t < terms; t++) {
+		s += "\tn += hash(texCoord * " + to_string(t + 1) + ".0 + vec2(" + to_string(id) + ".0, time)) * " +
+		     to_string(1.0 / (t + 1)) + ";\n";
+	}
+	s += "\tcolor = vec4(c.rgb * (0.5 + 0.5 * n), c.a);\n}\n";
+	return s;
+}
+
+// Constrói todos os programas; devolve o tempo em ms
+static double buildAll(ProgramCache &cache, const vector<Program> &programs) {
+	auto start = chrono::steady_clock::now();
+	vector<GLuint> ids;
+	for (const Program &p : programs) {
+		ids.push_back(cache.build(p.vertex.c_str(), p.fragment.c_str()));
+	}
+	glFinish();
+	double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	for (GLuint id : ids) {
+		glDeleteProgram(id);
+	}
+	return ms;
+}
+
+int main(int argc, char **argv) {
+	int count = 16, rounds = 5;
+	string dir = "shader_cache_bench", outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--programs" && i + 1 < argc) {
+			count = max(1, atoi(argv[++i]));
+		} else if (arg == "--rounds" && i + 1 < argc) {
+			rounds = max(1, atoi(argv[++i]));
+		} else if (arg == "--dir" && i + 1 < argc) {
+			dir = argv[++i];
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	// Contexto escondido (ou OSMesa sem display), como no modo headless dos demos
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	char headless[] = "--headless";
+	char *runnerArgs[] = { argv[0], headless };
+	HeadlessRunner runner(2, runnerArgs);
+	GLFWwindow *window = runner.createWindow(64, 64, "ProgramCacheBench");
+	if (!window) {
+		cerr << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return 1;
+	}
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+		cerr << "Failed to initialize GLAD" << endl;
+		glfwTerminate();
+		return 1;
+	}
+
+	vector<Program> programs;
+	for (int i = 0; i < count; i++) {
+		programs.push_back({ VERTEX_SOURCE, fragmentSource(i, 8 + i * 4) });
+	}
+
+	vector<double> coldMs, warmMs, offMs;
+	bool allHits = true;
+	bool supported = false;
+	for (int r = 0; r < rounds; r++) {
+		ProgramCache cold(dir);
+		cold.clear();
+		coldMs.push_back(buildAll(cold, programs));
+
+		ProgramCache warm(dir);
+		warmMs.push_back(buildAll(warm, programs));
+		allHits = allHits && warm.getStats().hits == count;
+		supported = supported || warm.getStats().hits > 0;
+
+		ProgramCache off(dir);
+		off.setEnabled(false);
+		offMs.push_back(buildAll(off, programs));
+	}
+
+	// Invalidação: cabeçalho de outro driver e fonte alterado
+	bool invalidationOk = true;
+	size_t diskBytes = 0;
+	if (supported) {
+		for (const auto &entry : fs::directory_iterator(dir)) {
+			diskBytes += entry.file_size();
+		}
+
+		// troca um byte do driver gravado num dos arquivos
+		fs::path first = fs::directory_iterator(dir)->path();
+		fstream file(first, ios::in | ios::out | ios::binary);
+		file.seekp(4 + 4 + 8 + 4);
+		file.put('#');
+		file.close();
+		ProgramCache again(dir);
+		buildAll(again, programs);
+		invalidationOk = again.getStats().invalidated == 1 && again.getStats().hits == count - 1;
+
+		ProgramCache changed(dir);
+		vector<Program> edited = { { VERTEX_SOURCE, programs[0].fragment + "// alterado\n" } };
+		buildAll(changed, edited);
+		invalidationOk = invalidationOk && changed.getStats().misses == 1;
+	}
+
+	const GLubyte *renderer = glGetString(GL_RENDERER);
+	string rendererName = renderer ? (const char *)renderer : "";
+	replace(rendererName.begin(), rendererName.end(), '"', '\'');
+
+	cout << count << " programas, " << rounds << " rodadas (mediana, ms) em " << rendererName << endl;
+	cout << fixed << setprecision(2) << "  frio    " << setw(10) << median(coldMs) << endl
+	     << "  quente  " << setw(10) << median(warmMs) << endl
+	     << "  sem     " << setw(10) << median(offMs) << endl;
+	if (supported) {
+		cout << "  inicio quente " << setprecision(1) << median(offMs) / max(median(warmMs), 1e-6) << "x mais rapido; "
+		     << diskBytes / 1024 << " KB em " << dir << "; invalidacao " << (invalidationOk ? "ok" : "FALHOU") << endl;
+	} else {
+		cout << "  driver sem binarios de programa: tudo compilado" << endl;
+	}
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"ProgramCacheBench\",\n  \"renderer\": \"" << rendererName << "\",\n"
+		    << "  \"programs\": " << count << ",\n  \"rounds\": " << rounds << ",\n"
+		    << "  \"binary_supported\": " << (supported ? "true" : "false") << ",\n"
+		    << "  \"cache_bytes\": " << diskBytes << ",\n"
+		    << "  \"invalidation_ok\": " << (invalidationOk ? "true" : "false") << ",\n  \"median_ms\": {\n"
+		    << fixed << setprecision(3) << "    \"cold\": " << median(coldMs) << ",\n    \"warm\": " << median(warmMs)
+		    << ",\n    \"no_cache\": " << median(offMs) << "\n  }\n}\n";
+	}
+
+	ProgramCache(dir).clear();
+	glfwTerminate();
+	bool ok = !supported || (allHits && invalidationOk);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+// Leitura de shaders de arquivo: parse_file_into_str antigo x ShaderSource.h
+//
+// Gera uma "biblioteca" de shaders de tamanho crescente (64 arquivos, todos
+// incluindo um common.glsl, e um shader principal que inclui todos) e mede:
+//   antigo : o parse_file_into_str que ficava no gl_utils.cpp (fgets + strcat,
+//            quadrático), lendo a mesma biblioteca já concatenada num arquivo
+//   frio   : ShaderSourceLoader com o cache vazio (lê e varre cada arquivo)
+//   quente : de novo, com os arquivos no cache (só monta a lista de trechos)
+// O resultado é a mediana das rodadas. O texto montado (sem as linhas #line) é
+// conferido contra a biblioteca concatenada, e os #define contra o esperado;
+// um shader montado tem que continuar igual depois que o cache é relido.
+// Não usa OpenGL nem abre janela.
+//
+// Uso: ShaderLoadBench [--max-kb N] [--legacy-max-kb N] [--rounds N] [--dir pasta] [--out arquivo.json]
+//   --max-kb         maior biblioteca (padrão 16384); começa em 64 KB e cresce 4x
+//   --legacy-max-kb  maior tamanho medido com o leitor antigo (padrão 1024)
+// Retorna 1 se o texto montado difere do esperado.
+
+#include "ShaderSource.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const int LIBRARY_FILES = 64;
+
+struct Row {
+	size_t bytes;
+	double legacyMs;     // < 0: não medido
+	double coldMs, warmMs;
+	int pieces;
+};
+
+static double median(vector<double> values) {
+	sort(values.begin(), values.end());
+	return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+// Versão anterior do gl_utils.cpp, sem mudanças (exceto o log de erro)
+static bool legacy_parse_file_into_str(const char *file_name, char *shader_str, int max_len) {
+	shader_str[0] = '\0'; // reset string
+	FILE *file = fopen(file_name, "r");
+	if (!file) {
+		return false;
+	}
+	int current_len = 0;
+	char line[2048];
+	strcpy(line, "");
+	while (!feof(file)) {
+		if (NULL != fgets(line, 2048, file)) {
+			current_len += strlen(line);
+			if (current_len >= max_len) {
+				cerr << "ERROR: shader length is longer than string buffer length " << max_len << endl;
+			}
+			strcat(shader_str, line);
+		}
+	}
+	fclose(file);
+	return true;
+}
+
+static void writeFile(const fs::path &path, const string &text) {
+	ofstream out(path, ios::binary);
+	out << text;
+}
+
+// Gera a biblioteca em dir; devolve o texto esperado depois dos #include
+static string generateLibrary(const fs::path &dir, size_t bytes) {
+	fs::remove_all(dir);
+	fs::create_directories(dir / "lib");
+	string common = "#version 400\nconst float PI = 3.14159265;\nfloat saturate(float x) { return clamp(x, 0.0, 1.0); }\n";
+	writeFile(dir / "lib" / "common.glsl", common);
+
+	string expected = "#version 400\n" + common.substr(common.find('\n') + 1);
+	string root = "#version 400\n";
+	size_t perFile = bytes / LIBRARY_FILES;
+	for (int f = 0; f < LIBRARY_FILES; f++) {
+		string body;
+		for (int i = 0; body.size() < perFile; i++) {
+			body += "float f" + to_string(f) + "_" + to_string(i) + "(float x) { return saturate(x * " + to_string(i) +
+			        ".0 + " + to_string(f) + ".0); }\n";
+		}
+		string name = "lib" + to_string(f) + ".glsl";
+		writeFile(dir / "lib" / name, "#include \"common.glsl\"\n" + body);
+		root += "#include \"lib/" + name + "\"\n";
+		expected += body;
+	}
+	string tail = "out vec4 color;\nvoid main()\n{\n\tcolor = vec4(f0_0(PI));\n}\n";
+	root += tail;
+	expected += tail;
+	writeFile(dir / "main.frag", root);
+	writeFile(dir / "flat.frag", expected);
+	return expected;
+}
+
+static string withoutLineDirectives(const string &text) {
+	string out;
+	out.reserve(text.size());
+	istringstream in(text);
+	string line;
+	while (getline(in, line)) {
+		if (line.compare(0, 5, "#line") != 0) {
+			out += line + "\n";
+		}
+	}
+	return out;
+}
+
+int main(int argc, char **argv) {
+	size_t maxKb = 16384, legacyMaxKb = 1024;
+	int rounds = 3;
+	string dir = "shader_load_bench", outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--max-kb" && i + 1 < argc) {
+			maxKb = max(64, atoi(argv[++i]));
+		} else if (arg == "--legacy-max-kb" && i + 1 < argc) {
+			legacyMaxKb = max(0, atoi(argv[++i]));
+		} else if (arg == "--rounds" && i + 1 < argc) {
+			rounds = max(1, atoi(argv[++i]));
+		} else if (arg == "--dir" && i + 1 < argc) {
+			dir = argv[++i];
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	bool ok = true;
+	vector<Row> rows;
+	for (size_t kb = 64; kb <= maxKb; kb *= 4) {
+		string expected = generateLibrary(dir, kb * 1024);
+		string mainPath = (fs::path(dir) / "main.frag").string();
+		string flatPath = (fs::path(dir) / "flat.frag").string();
+		Row row = { expected.size(), -1.0, 0.0, 0.0, 0 };
+
+		if (kb <= legacyMaxKb) {
+			vector<char> buffer(expected.size() + 1);
+			vector<double> times;
+			for (int r = 0; r < rounds; r++) {
+				auto start = chrono::steady_clock::now();
+				legacy_parse_file_into_str(flatPath.c_str(), buffer.data(), (int)buffer.size());
+				times.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+			}
+			row.legacyMs = median(times);
+			ok = ok && expected == buffer.data();
+		}
+
+		ShaderSourceLoader loader;
+		ShaderSource source;
+		vector<double> cold, warm;
+		for (int r = 0; r < rounds; r++) {
+			loader.clearCache();
+			auto start = chrono::steady_clock::now();
+			loader.load(mainPath, source);
+			cold.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+			start = chrono::steady_clock::now();
+			loader.load(mainPath, source);
+			warm.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+		}
+		row.coldMs = median(cold);
+		row.warmMs = median(warm);
+		row.pieces = source.count();
+		if (!source.getError().empty() || withoutLineDirectives(source.text()) != expected) {
+			cerr << "texto montado difere do esperado em " << kb << " KB " << source.getError() << endl;
+			ok = false;
+		}
+		rows.push_back(row);
+	}
+
+	// Permutação: os #define vão logo depois do #version, e a contagem de linhas segue
+	ShaderSourceLoader loader;
+	ShaderSource variant;
+	loader.load((fs::path(dir) / "main.frag").string(), { "USE_FOG", "MAX_LIGHTS 4" }, variant);
+	string prefix = "#version 400\n#define USE_FOG\n#define MAX_LIGHTS 4\n#line 2 0\n";
+	bool definesOk = variant.text().compare(0, prefix.size(), prefix) == 0;
+	ok = ok && definesOk;
+
+	// Arquivos relidos (aqui, cache limpo) não invalidam um shader já montado
+	string before = variant.text();
+	loader.clearCache();
+	ShaderSource other;
+	loader.load((fs::path(dir) / "main.frag").string(), other);
+	ok = ok && variant.text() == before;
+
+	cout << "biblioteca de " << LIBRARY_FILES << " arquivos, " << rounds << " rodadas (mediana, ms)" << endl;
+	cout << "      KB      antigo        frio      quente   frio MB/s  trechos" << endl;
+	for (const Row &row : rows) {
+		cout << fixed << setprecision(2) << setw(8) << row.bytes / 1024;
+		if (row.legacyMs >= 0.0) {
+			cout << setw(12) << row.legacyMs;
+		} else {
+			cout << setw(12) << "-";
+		}
+		cout << setw(12) << row.coldMs << setw(12) << row.warmMs << setw(12) << setprecision(0)
+		     << row.bytes / 1048576.0 / max(row.coldMs, 1e-6) * 1000.0 << setw(9) << row.pieces << endl;
+	}
+	double growth = (rows.back().coldMs / max(rows.front().coldMs, 1e-6)) /
+	                ((double)rows.back().bytes / rows.front().bytes);
+	cout << setprecision(2) << "  frio: tempo/tamanho do maior sobre o menor = " << growth << " (1 = linear); defines "
+	     << (definesOk ? "ok" : "FALHOU") << endl;
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"ShaderLoadBench\",\n  \"files\": " << LIBRARY_FILES << ",\n  \"rounds\": " << rounds
+		    << ",\n  \"correct\": " << (ok ? "true" : "false") << ",\n  \"linear_growth\": " << fixed
+		    << setprecision(3) << growth << ",\n  \"sizes\": [\n";
+		for (size_t i = 0; i < rows.size(); i++) {
+			const Row &row = rows[i];
+			out << "    { \"bytes\": " << row.bytes << ", \"legacy_ms\": ";
+			if (row.legacyMs >= 0.0) {
+				out << row.legacyMs;
+			} else {
+				out << "null";
+			}
+			out << ", \"cold_ms\": " << row.coldMs << ", \"warm_ms\": " << row.warmMs << ", \"pieces\": " << row.pieces
+			    << " }" << (i + 1 < rows.size() ? "," : "") << "\n";
+		}
+		out << "  ]\n}\n";
+	}
+
+	fs::remove_all(dir);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,335 @@
+// Tempo de carregamento de todas as texturas de assets/: PNG x pacote
+// pré-decodificado (src/Tools/TextureBaker.cpp, Common/BakedTextures.h)
+//
+//   png    : stbi_load + glTexImage2D + glGenerateMipmap, como o loadTexture
+//            antigo dos demos, uma imagem depois da outra
+//   pacote : mmap do pacote + upload de cada nível direto das páginas
+//            mapeadas, no formato comprimido que o driver aceita
+//            (pack_load) ou em RGBA8 (pack_load_rgba8)
+//
+// Cada rodada termina com glFinish (todas as texturas na GPU) e apaga as
+// texturas; o resultado é a mediana das rodadas, com o cache de disco do
+// sistema já quente. Também são medidos só os passos de CPU (decodificar os
+// PNGs x mapear o pacote e ler as páginas). O nível 0 de cada textura do
+// pacote é conferido contra o PNG decodificado.
+//
+// Por textura, o relatório lista cada formato do pacote que o driver aceita:
+// bytes com mipmaps, PSNR (calculado pelo TextureBaker) e tempo de upload.
+//
+// Uso: TextureLoadBench <pasta-assets> <pacote> [--rounds N] [--out arquivo.json]
+// Retorna 1 se o pacote não abrir ou divergir dos PNGs.
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// STB_IMAGE
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include "BakedTextures.h"
+#include "HeadlessRunner.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+struct FormatResult {
+	int format;
+	size_t bytes;
+	float psnr;
+	vector<double> ms;
+};
+
+struct AssetResult {
+	string name;
+	vector<FormatResult> formats;
+};
+
+struct Phase {
+	string name;
+	vector<double> ms;
+};
+
+static volatile unsigned sink;
+
+template <typename Body>
+static double milliseconds(Body body) {
+	auto start = chrono::steady_clock::now();
+	body();
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static double median(vector<double> values) {
+	sort(values.begin(), values.end());
+	return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+// O loadTexture que os demos tinham antes do TextureManager
+static GLuint loadPng(const string &filePath, size_t &bytes) {
+	GLuint texID;
+	glGenTextures(1, &texID);
+	glBindTexture(GL_TEXTURE_2D, texID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	int width, height, nrChannels;
+	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+	if (data) {
+		GLenum format = nrChannels == 3 ? GL_RGB : GL_RGBA;
+		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+		glGenerateMipmap(GL_TEXTURE_2D);
+		bytes += (size_t)width * height * nrChannels;
+	}
+	stbi_image_free(data);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return texID;
+}
+
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		cerr << "Uso: TextureLoadBench <pasta-assets> <pacote> [--rounds N] [--out arquivo.json]" << endl;
+		return 1;
+	}
+	fs::path assetsDir = argv[1];
+	string packPath = argv[2];
+	int rounds = 5;
+	string outPath;
+	for (int i = 3; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--rounds" && i + 1 < argc) {
+			rounds = max(1, atoi(argv[++i]));
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	vector<string> names;
+	for (const auto &entry : fs::recursive_directory_iterator(assetsDir)) {
+		if (entry.is_regular_file() && entry.path().extension() == ".png") {
+			names.push_back(fs::relative(entry.path(), assetsDir).generic_string());
+		}
+	}
+	sort(names.begin(), names.end());
+
+	// Contexto escondido (ou OSMesa sem display), como no modo headless dos demos
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	char headless[] = "--headless";
+	char *runnerArgs[] = { argv[0], headless };
+	HeadlessRunner runner(2, runnerArgs);
+	GLFWwindow *window = runner.createWindow(64, 64, "TextureLoadBench");
+	if (!window) {
+		cerr << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return 1;
+	}
+	glfwMakeContextCurrent(window);
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+		cerr << "Failed to initialize GLAD" << endl;
+		glfwTerminate();
+		return 1;
+	}
+
+	// Conferência: o nível 0 do pacote tem que ser o PNG em RGBA
+	BakedTexturePack pack;
+	if (!pack.open(packPath)) {
+		cerr << "Pacote nao encontrado: " << packPath << endl;
+		glfwTerminate();
+		return 1;
+	}
+	int mismatches = 0;
+	for (const string &name : names) {
+		const BakedTexture *tex = pack.find(name);
+		const BakedVariant *rgba = tex ? tex->variant(BAKED_RGBA8) : nullptr;
+		int width, height, nrChannels;
+		unsigned char *data = stbi_load((assetsDir / name).string().c_str(), &width, &height, &nrChannels, 4);
+		bool same = rgba && data && !tex->premultiplied && tex->width == width && tex->height == height &&
+		            memcmp(rgba->levels[0].data, data, (size_t)width * height * 4) == 0;
+		if (!same) {
+			cerr << "divergencia: " << name << endl;
+			mismatches++;
+		}
+		stbi_image_free(data);
+	}
+
+	// Formatos de cada textura que o driver aceita
+	vector<AssetResult> assets;
+	for (const string &name : names) {
+		const BakedTexture *tex = pack.find(name);
+		if (!tex) {
+			continue;
+		}
+		AssetResult asset = { name, {} };
+		for (const BakedVariant &variant : tex->variants) {
+			if (BakedTexturePack::isFormatSupported(variant.format)) {
+				size_t bytes = 0;
+				for (const BakedLevel &level : variant.levels) {
+					bytes += level.bytes;
+				}
+				asset.formats.push_back({ variant.format, bytes, variant.psnr, {} });
+			}
+		}
+		assets.push_back(asset);
+	}
+	pack.close();
+
+	Phase pngCpu = { "png_decode", {} }, packCpu = { "pack_map", {} };
+	Phase pngGpu = { "png_load", {} }, packGpu = { "pack_load", {} }, packRgbaGpu = { "pack_load_rgba8", {} };
+	size_t pngBytes = 0, packBytes = 0, packRgbaBytes = 0;
+	vector<GLuint> textures;
+	for (int r = 0; r < rounds; r++) {
+		// Só CPU: pixels prontos na memória
+		pngCpu.ms.push_back(milliseconds([&]() {
+			for (const string &name : names) {
+				int width, height, nrChannels;
+				unsigned char *data = stbi_load((assetsDir / name).string().c_str(), &width, &height, &nrChannels, 0);
+				sink = data ? data[0] : 0;
+				stbi_image_free(data);
+			}
+		}));
+		packCpu.ms.push_back(milliseconds([&]() {
+			pack.open(packPath);
+			unsigned acc = 0;
+			for (const string &name : names) {
+				const BakedTexture *tex = pack.find(name);
+				if (!tex) {
+					continue;
+				}
+				// toca cada página, como o driver faria ao copiar
+				for (const BakedLevel &level : pack.chooseVariant(*tex)->levels) {
+					for (size_t i = 0; i < level.bytes; i += 4096) {
+						acc += level.data[i];
+					}
+				}
+			}
+			sink = acc;
+			pack.close();
+		}));
+
+		// Até as texturas estarem na GPU
+		pngBytes = 0;
+		pngGpu.ms.push_back(milliseconds([&]() {
+			for (const string &name : names) {
+				textures.push_back(loadPng((assetsDir / name).string(), pngBytes));
+			}
+			glFinish();
+		}));
+		glDeleteTextures((GLsizei)textures.size(), textures.data());
+		textures.clear();
+
+		// Pacote no melhor formato comprimido e em RGBA8
+		for (int compressed = 1; compressed >= 0; compressed--) {
+			Phase &phase = compressed ? packGpu : packRgbaGpu;
+			size_t &bytes = compressed ? packBytes : packRgbaBytes;
+			bytes = 0;
+			pack.setCompression(compressed != 0);
+			phase.ms.push_back(milliseconds([&]() {
+				pack.open(packPath);
+				for (const string &name : names) {
+					int width, height;
+					GLuint texID = pack.loadTexture(name, width, height);
+					if (texID) {
+						textures.push_back(texID);
+						bytes += pack.residentBytes(*pack.find(name), true);
+					}
+				}
+				glFinish();
+				pack.close();
+			}));
+			glDeleteTextures((GLsizei)textures.size(), textures.data());
+			textures.clear();
+		}
+		pack.setCompression(true);
+
+		// Upload de cada textura em cada formato
+		pack.open(packPath);
+		for (AssetResult &asset : assets) {
+			for (FormatResult &result : asset.formats) {
+				pack.forceFormat(result.format);
+				GLuint texID = 0;
+				result.ms.push_back(milliseconds([&]() {
+					int width, height;
+					texID = pack.loadTexture(asset.name, width, height);
+					glFinish();
+				}));
+				glDeleteTextures(1, &texID);
+			}
+		}
+		pack.forceFormat(-1);
+		pack.close();
+	}
+
+	const GLubyte *renderer = glGetString(GL_RENDERER);
+	string rendererName = renderer ? (const char *)renderer : "";
+	replace(rendererName.begin(), rendererName.end(), '"', '\'');
+
+	vector<Phase *> phases = { &pngCpu, &packCpu, &pngGpu, &packRgbaGpu, &packGpu };
+	cout << names.size() << " texturas, " << rounds << " rodadas (mediana, ms) em " << rendererName << endl;
+	for (Phase *p : phases) {
+		cout << "  " << left << setw(12) << p->name << right << fixed << setprecision(2) << setw(10) << median(p->ms) << endl;
+	}
+	cout << "  carregamento " << setprecision(1) << median(pngGpu.ms) / max(median(packGpu.ms), 1e-6) << "x mais rapido com o pacote"
+	     << " (png: " << pngBytes / 1024 << " KB nivel 0, pacote: " << packRgbaBytes / 1024 << " KB com mipmaps em RGBA8, "
+	     << packBytes / 1024 << " KB comprimido)" << endl;
+	cout << "  divergencias: " << mismatches << endl;
+	cout << "por textura (formato: KB, PSNR, ms de upload):" << endl;
+	for (const AssetResult &asset : assets) {
+		cout << "  " << asset.name;
+		for (const FormatResult &result : asset.formats) {
+			cout << "  " << BakedTexturePack::formatName(result.format) << ": " << result.bytes / 1024 << " KB, ";
+			if (isinf(result.psnr)) {
+				cout << "sem perdas";
+			} else {
+				cout << setprecision(1) << result.psnr << " dB";
+			}
+			cout << ", " << setprecision(3) << median(result.ms) << " ms";
+		}
+		cout << endl;
+	}
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"TextureLoadBench\",\n  \"renderer\": \"" << rendererName << "\",\n"
+		    << "  \"textures\": " << names.size() << ",\n  \"rounds\": " << rounds << ",\n"
+		    << "  \"mismatches\": " << mismatches << ",\n  \"median_ms\": {\n";
+		for (size_t i = 0; i < phases.size(); i++) {
+			out << "    \"" << phases[i]->name << "\": " << fixed << setprecision(3) << median(phases[i]->ms)
+			    << (i + 1 < phases.size() ? ",\n" : "\n");
+		}
+		out << "  },\n  \"resident_bytes\": { \"png\": " << pngBytes << ", \"pack_rgba8\": " << packRgbaBytes
+		    << ", \"pack\": " << packBytes << " },\n  \"assets\": [\n";
+		for (size_t a = 0; a < assets.size(); a++) {
+			out << "    { \"name\": \"" << assets[a].name << "\", \"formats\": [";
+			for (size_t f = 0; f < assets[a].formats.size(); f++) {
+				const FormatResult &result = assets[a].formats[f];
+				out << (f ? ", " : "") << "{ \"format\": \"" << BakedTexturePack::formatName(result.format)
+				    << "\", \"bytes\": " << result.bytes << ", \"psnr_db\": ";
+				if (isinf(result.psnr)) {
+					out << "null";
+				} else {
+					out << setprecision(2) << result.psnr;
+				}
+				out << ", \"upload_ms\": " << setprecision(3) << median(result.ms) << " }";
+			}
+			out << "] }" << (a + 1 < assets.size() ? ",\n" : "\n");
+		}
+		out << "  ]\n}\n";
+	}
+
+	glfwTerminate();
+	return mismatches == 0 ? 0 : 1;
+}
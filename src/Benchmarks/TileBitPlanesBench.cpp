@@ -0,0 +1,188 @@
+// Consultas de região nos bit-planes (TileBitPlanes.h) x varredura byte a byte
+//
+// Gera um mapa de --size x --size (lava e água funda não andáveis, em
+// manchas) e, para retângulos de 3x3 até 512x512 em posições aleatórias,
+// mede consultas por segundo de:
+//   anyBlocked   : alguma célula não andável no retângulo
+//   countWalkable: quantas células andáveis
+// com os bit-planes (SIMD, backend do maths_simd.h) e lendo o tile de cada
+// célula do TileMap e consultando o TileProperties (como antes). As duas
+// respostas têm que ser iguais, também depois de --edits setTile aleatórios.
+//
+// Uso: TileBitPlanesBench [--size N] [--edits N] [--out arquivo.json]
+// Retorna 1 se alguma resposta diverge.
+
+#include "TileMap.h"
+#include "TileBitPlanes.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+struct Rect {
+	int col0, row0, col1, row1;
+};
+
+static uint32_t hash2(uint32_t x, uint32_t y) {
+	uint32_t h = x * 374761393u + y * 668265263u;
+	h = (h ^ (h >> 13)) * 1274126177u;
+	return h ^ (h >> 16);
+}
+
+// 1 grama, 0 areia, 4 água rasa; 3 lava e 5 água funda bloqueiam
+static void generate(TileMap &tilemap) {
+	static const unsigned char tiles[8] = { 1, 1, 1, 0, 0, 4, 3, 5 };
+	for (int row = 0; row < tilemap.getHeight(); row++) {
+		for (int col = 0; col < tilemap.getWidth(); col++) {
+			unsigned char tile = tiles[hash2(col >> 5, row >> 5) % 8];
+			if (tile != 3 && tile != 5 && hash2(col, row) % 1000 < 3) {
+				tile = 3;
+			}
+			tilemap.at(col, row) = tile;
+		}
+	}
+}
+
+static bool scanBlocked(TileMap &tilemap, const TileProperties &props, const Rect &r) {
+	for (int row = r.row0; row < r.row1; row++) {
+		for (int col = r.col0; col < r.col1; col++) {
+			if (!props.isWalkable(tilemap.getTile(col, row))) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+static long scanWalkable(TileMap &tilemap, const TileProperties &props, const Rect &r) {
+	long total = 0;
+	for (int row = r.row0; row < r.row1; row++) {
+		for (int col = r.col0; col < r.col1; col++) {
+			total += props.isWalkable(tilemap.getTile(col, row));
+		}
+	}
+	return total;
+}
+
+int main(int argc, char **argv) {
+	int size = 4096, edits = 10000;
+	string outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--size" && i + 1 < argc) {
+			size = max(1024, atoi(argv[++i]));
+		} else if (arg == "--edits" && i + 1 < argc) {
+			edits = max(0, atoi(argv[++i]));
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	TileProperties props;
+	props.setWalkable(3, false);
+	props.setWalkable(5, false);
+	props.setCost(4, 3);
+	props.setOpaque(2, true);
+	props.setAnimated(3, true);
+
+	TileMap tilemap(size, size, 1);
+	generate(tilemap);
+	TileBitPlanes planes(&tilemap, props);
+
+	const int sides[5] = { 3, 16, 64, 200, 512 };
+	double anyPlanes[5], anyScan[5], countPlanes[5], countScan[5];
+	bool ok = true;
+	long sink = 0;
+	for (int s = 0; s < 5; s++) {
+		int side = sides[s];
+		// mais ou menos as mesmas células varridas em cada tamanho
+		int queryCount = max(200, (int)(40000000L / ((long)side * side)));
+		queryCount = min(queryCount, 1000000);
+		vector<Rect> rects(queryCount);
+		for (int i = 0; i < queryCount; i++) {
+			int col = hash2(i, s * 2 + 1) % (size - side), row = hash2(i, s * 2 + 2) % (size - side);
+			rects[i] = { col, row, col + side, row + side };
+		}
+
+		vector<char> blocked(queryCount);
+		vector<long> walkable(queryCount);
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < queryCount; i++) {
+			blocked[i] = planes.anyBlocked(rects[i].col0, rects[i].row0, rects[i].col1, rects[i].row1);
+		}
+		anyPlanes[s] = queryCount / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		start = chrono::steady_clock::now();
+		for (int i = 0; i < queryCount; i++) {
+			walkable[i] = planes.countWalkable(rects[i].col0, rects[i].row0, rects[i].col1, rects[i].row1);
+		}
+		countPlanes[s] = queryCount / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+		start = chrono::steady_clock::now();
+		for (int i = 0; i < queryCount; i++) {
+			bool b = scanBlocked(tilemap, props, rects[i]);
+			ok = ok && b == (blocked[i] != 0);
+			sink += b;
+		}
+		anyScan[s] = queryCount / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		start = chrono::steady_clock::now();
+		for (int i = 0; i < queryCount; i++) {
+			long w = scanWalkable(tilemap, props, rects[i]);
+			ok = ok && w == walkable[i];
+			sink += w;
+		}
+		countScan[s] = queryCount / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	}
+
+	// setTile mantém os planes: confere de novo em retângulos com bordas quebradas
+	for (int i = 0; i < edits; i++) {
+		static const unsigned char tiles[6] = { 0, 1, 2, 3, 4, 5 };
+		tilemap.setTile(hash2(i, 51) % size, hash2(i, 52) % size, tiles[hash2(i, 53) % 6]);
+	}
+	for (int i = 0; i < 2000; i++) {
+		int col = hash2(i, 61) % size, row = hash2(i, 62) % size;
+		Rect r = { col, row, min(size, col + 1 + (int)(hash2(i, 63) % 300)), min(size, row + 1 + (int)(hash2(i, 64) % 40)) };
+		ok = ok && planes.anyBlocked(r.col0, r.row0, r.col1, r.row1) == scanBlocked(tilemap, props, r) &&
+		     planes.countWalkable(r.col0, r.row0, r.col1, r.row1) == scanWalkable(tilemap, props, r);
+		long opaque = 0, animated = 0;
+		for (int row = r.row0; row < r.row1; row++) {
+			for (int c = r.col0; c < r.col1; c++) {
+				opaque += props.isOpaque(tilemap.getTile(c, row));
+				animated += props.isAnimated(tilemap.getTile(c, row));
+			}
+		}
+		ok = ok && planes.count(TILE_OPAQUE, r.col0, r.row0, r.col1, r.row1) == opaque &&
+		     planes.count(TILE_ANIMATED, r.col0, r.row0, r.col1, r.row1) == animated &&
+		     planes.any(TILE_OPAQUE, r.col0, r.row0, r.col1, r.row1) == (opaque > 0);
+	}
+
+	cout << size << "x" << size << ", SIMD " << MATHS_SIMD_NAME << " (consultas/s, planes x byte a byte)" << endl;
+	for (int s = 0; s < 5; s++) {
+		cout << "  " << setw(3) << sides[s] << "x" << left << setw(3) << sides[s] << right << "  anyBlocked " << scientific
+		     << setprecision(2) << anyPlanes[s] << " x " << anyScan[s] << " (" << fixed << setprecision(1)
+		     << anyPlanes[s] / anyScan[s] << "x)   countWalkable " << scientific << setprecision(2) << countPlanes[s]
+		     << " x " << countScan[s] << " (" << fixed << setprecision(1) << countPlanes[s] / countScan[s] << "x)"
+		     << endl;
+	}
+	cout << "  conferencia " << (ok ? "ok" : "FALHOU") << (sink == 0 ? " " : "") << endl;
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"TileBitPlanesBench\",\n  \"size\": " << size << ",\n  \"simd\": \"" << MATHS_SIMD_NAME
+		    << "\",\n  \"correct\": " << (ok ? "true" : "false") << ",\n  \"rects\": [\n" << fixed << setprecision(1);
+		for (int s = 0; s < 5; s++) {
+			out << "    { \"side\": " << sides[s] << ", \"any_blocked_per_s\": " << anyPlanes[s]
+			    << ", \"any_blocked_scan_per_s\": " << anyScan[s] << ", \"count_walkable_per_s\": " << countPlanes[s]
+			    << ", \"count_walkable_scan_per_s\": " << countScan[s] << " }" << (s < 4 ? "," : "") << "\n";
+		}
+		out << "  ]\n}\n";
+	}
+	return ok ? 0 : 1;
+}
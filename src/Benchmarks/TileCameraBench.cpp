@@ -0,0 +1,180 @@
+// Recorte por câmera: TileCamera (Common/M5-6) num mapa de 100000 x 100000
+//
+// Passeia uma tela de --width x --height pixels (1920x1080 por padrão) por um
+// mapa enorme, sem guardar o mapa (o tile de cada célula vem de um hash), no
+// DiamondView e no SlideView com tiles de 64x32. Por frame mede:
+//   spans     : computeVisibleSpans (linhas e colunas visíveis)
+//   visitar   : leitura de todas as células dos spans
+//   envolvente: células do retângulo envolvente (computeVisibleRange), o que
+//               um recorte só por linha/coluna desenharia
+// O tempo por frame não pode depender do tamanho do mapa. Em alguns frames os
+// spans são conferidos contra a força bruta no retângulo envolvente, e
+// computeTilePosition contra computeDrawPosition.
+//
+// Uso: TileCameraBench [--map N] [--width N] [--height N] [--frames N] [--out arquivo.json]
+// Retorna 1 se algum span ou inverso diverge.
+
+#include "TileCamera.h"
+#include "DiamondView.h"
+#include "SlideView.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+struct ViewResult {
+	string name;
+	vector<double> spanUs, visitUs;
+	double visibleCells, rangeCells;
+	long long checksum;
+	bool ok;
+};
+
+static uint32_t hash2(uint32_t x, uint32_t y) {
+	uint32_t h = x * 374761393u + y * 668265263u;
+	h = (h ^ (h >> 13)) * 1274126177u;
+	return h ^ (h >> 16);
+}
+
+static double percentile(vector<double> values, double p) {
+	sort(values.begin(), values.end());
+	return values.empty() ? 0.0 : values[min(values.size() - 1, (size_t)(p * values.size()))];
+}
+
+static double usSince(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+static ViewResult run(const string &name, const TilemapView &view, int mapSize, float width, float height, int frames) {
+	const float tw = 64.0f, th = 32.0f;
+	TileCamera camera(&view, tw, th, mapSize, mapSize);
+	camera.setViewport(width, height);
+
+	ViewResult result;
+	result.name = name;
+	result.visibleCells = result.rangeCells = 0.0;
+	result.checksum = 0;
+	result.ok = true;
+
+	// caminho: do canto (0, 0) do mapa até o oposto, com ida e volta, passando
+	// também pelas bordas (parte da tela fora do mapa)
+	float fx0, fy0, fx1, fy1;
+	view.computeDrawPosition(0, 0, tw, th, fx0, fy0);
+	view.computeDrawPosition(mapSize - 1, mapSize - 1, tw, th, fx1, fy1);
+
+	vector<TileSpan> spans;
+	for (int f = 0; f < frames; f++) {
+		double t = (double)f / max(1, frames - 1);
+		double x = fx0 + (fx1 - fx0) * t - width / 2.0 + sin(t * 40.0) * width;
+		double y = fy0 + (fy1 - fy0) * t - height / 2.0 + cos(t * 40.0) * height;
+		camera.setPosition(x, y);
+
+		auto start = chrono::steady_clock::now();
+		long cells = camera.computeVisibleSpans(spans);
+		result.spanUs.push_back(usSince(start));
+
+		start = chrono::steady_clock::now();
+		long long sum = 0;
+		for (const TileSpan &span : spans) {
+			for (int col = span.col0; col < span.col1; col++) {
+				sum += hash2(col, span.row) & 7;
+			}
+		}
+		result.visitUs.push_back(usSince(start));
+		result.checksum += sum;
+
+		int col0, row0, col1, row1;
+		long range = camera.computeVisibleRange(col0, row0, col1, row1) ? (long)(col1 - col0) * (row1 - row0) : 0;
+		result.visibleCells += cells;
+		result.rangeCells += range;
+
+		// força bruta no retângulo envolvente (com folga) a cada 64 frames
+		if (f % 64 == 0) {
+			size_t s = 0;
+			long counted = 0;
+			for (int row = max(0, row0 - 2); row < min(mapSize, row1 + 2); row++) {
+				while (s < spans.size() && spans[s].row < row) {
+					s++;
+				}
+				for (int col = max(0, col0 - 2); col < min(mapSize, col1 + 2); col++) {
+					bool inSpan = s < spans.size() && spans[s].row == row && col >= spans[s].col0 && col < spans[s].col1;
+					result.ok = result.ok && inSpan == camera.isVisible(col, row);
+					counted += camera.isVisible(col, row);
+				}
+			}
+			result.ok = result.ok && counted == cells;
+		}
+	}
+
+	// computeTilePosition(computeDrawPosition(c, r)) == (c, r)
+	for (int i = 0; i < 10000; i++) {
+		int col = hash2(i, 1) % 4096, row = hash2(i, 2) % 4096;
+		float x, y, c, r;
+		view.computeDrawPosition(col, row, tw, th, x, y);
+		view.computeTilePosition(x, y, tw, th, c, r);
+		result.ok = result.ok && fabsf(c - col) < 1e-2f && fabsf(r - row) < 1e-2f;
+	}
+	result.visibleCells /= frames;
+	result.rangeCells /= frames;
+	return result;
+}
+
+int main(int argc, char **argv) {
+	int mapSize = 100000, frames = 20000;
+	float width = 1920.0f, height = 1080.0f;
+	string outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--map" && i + 1 < argc) {
+			mapSize = max(16, atoi(argv[++i]));
+		} else if (arg == "--width" && i + 1 < argc) {
+			width = (float)max(16, atoi(argv[++i]));
+		} else if (arg == "--height" && i + 1 < argc) {
+			height = (float)max(16, atoi(argv[++i]));
+		} else if (arg == "--frames" && i + 1 < argc) {
+			frames = max(1, atoi(argv[++i]));
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	DiamondView diamond;
+	SlideView slide;
+	vector<ViewResult> results = { run("diamond", diamond, mapSize, width, height, frames),
+	                               run("slide", slide, mapSize, width, height, frames) };
+
+	bool ok = true;
+	cout << mapSize << "x" << mapSize << " tiles de 64x32, tela " << width << "x" << height << ", " << frames << " frames" << endl;
+	for (const ViewResult &r : results) {
+		ok = ok && r.ok;
+		cout << "  " << left << setw(8) << r.name << right << fixed << setprecision(2)
+		     << " spans " << percentile(r.spanUs, 0.5) << " us (p99 " << percentile(r.spanUs, 0.99) << ")"
+		     << ", visitar " << percentile(r.visitUs, 0.5) << " us"
+		     << ", " << setprecision(0) << r.visibleCells << " celulas visiveis (envolvente " << r.rangeCells << ")"
+		     << ", conferencia " << (r.ok ? "ok" : "FALHOU") << endl;
+	}
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"TileCameraBench\",\n  \"map\": " << mapSize << ",\n  \"viewport\": [" << width << ", " << height
+		    << "],\n  \"frames\": " << frames << ",\n  \"correct\": " << (ok ? "true" : "false") << ",\n  \"views\": {\n";
+		for (size_t i = 0; i < results.size(); i++) {
+			const ViewResult &r = results[i];
+			out << "    \"" << r.name << "\": { " << fixed << setprecision(3) << "\"spans_median_us\": " << percentile(r.spanUs, 0.5)
+			    << ", \"spans_p99_us\": " << percentile(r.spanUs, 0.99) << ", \"visit_median_us\": " << percentile(r.visitUs, 0.5)
+			    << ", \"visible_cells\": " << setprecision(1) << r.visibleCells << ", \"bounding_cells\": " << r.rangeCells
+			    << ", \"checksum\": " << r.checksum << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+		}
+		out << "  }\n}\n";
+	}
+	return ok ? 0 : 1;
+}
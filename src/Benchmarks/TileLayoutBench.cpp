@@ -0,0 +1,232 @@
+// Layouts de memória do TileMap: row-major x tiled 16x16 x Morton (TileLayout.h)
+//
+// Preenche um mapa de --size x --size (4096 por padrão, maior que a cache) em
+// cada layout com os mesmos tiles e mede, em milhões de células por segundo:
+//   vizinhos  : andarilhos que leem a vizinhança 3x3 e dão um passo numa das
+//               oito direções do SlideView::computeTileWalking (pathfinding,
+//               autotiling)
+//   diagonal  : caminhadas isométricas longas (DiamondView, DIRECTION_NORTH
+//               anda col+1 e row+1 a cada passo)
+//   região    : soma de retângulos 64x64 aleatórios com o iterador region()
+//               e com getTile em dois laços (linha a linha)
+//   mapa      : soma do mapa inteiro com o iterador all()
+// O resultado é a mediana das rodadas. As somas têm que ser iguais em todos
+// os layouts (e o iterador tem que visitar cada célula uma vez).
+//
+// Uso: TileLayoutBench [--size N] [--steps N] [--rounds N] [--out arquivo.json]
+// Retorna 1 se algum layout diverge.
+
+#include "TileMap.h"
+#include "SlideView.h"
+#include "DiamondView.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+struct Workload {
+	string name;
+	long long cells;          // células lidas por rodada
+	vector<double> ms;
+	long long checksum;
+};
+
+struct LayoutResult {
+	string name;
+	size_t bytes;
+	vector<Workload> workloads;
+	bool iteratorOk;
+};
+
+static uint32_t hash2(uint32_t x, uint32_t y) {
+	uint32_t h = x * 374761393u + y * 668265263u;
+	h = (h ^ (h >> 13)) * 1274126177u;
+	return h ^ (h >> 16);
+}
+
+static double median(vector<double> values) {
+	sort(values.begin(), values.end());
+	return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+template <typename Layout>
+static LayoutResult run(int size, int steps, int rounds) {
+	BasicTileMap<Layout> tilemap(size, size, 0);
+	for (int row = 0; row < size; row++) {
+		for (int col = 0; col < size; col++) {
+			tilemap.at(col, row) = (unsigned char)(hash2(col, row) % 7);
+		}
+	}
+
+	LayoutResult result;
+	result.name = Layout::name();
+	result.bytes = 0;
+	Layout probe;
+	result.bytes = probe.init(size, size);
+	result.workloads = { { "vizinhos", 0, {}, 0 }, { "diagonal", 0, {}, 0 }, { "regiao", 0, {}, 0 },
+	                     { "regiao_getTile", 0, {}, 0 }, { "mapa", 0, {}, 0 } };
+
+	SlideView slide;
+	DiamondView diamond;
+	const int walkers = 64;
+	const int lines = max(1, steps / size);
+	const int rects = max(1, steps / (64 * 64));
+	for (int r = 0; r < rounds; r++) {
+		// vizinhança 3x3 + passo numa direção aleatória (a mesma sequência em todos os layouts)
+		auto start = chrono::steady_clock::now();
+		long long sum = 0;
+		for (int w = 0; w < walkers; w++) {
+			int col = hash2(w, 1) % size, row = hash2(w, 2) % size;
+			for (int s = 0; s < steps / walkers; s++) {
+				if (col < 1 || row < 2 || col >= size - 2 || row >= size - 2) {
+					col = hash2(w, s) % (size - 4) + 2;
+					row = hash2(s, w) % (size - 4) + 2;
+				}
+				for (int dr = -1; dr <= 1; dr++) {
+					for (int dc = -1; dc <= 1; dc++) {
+						sum += tilemap.getTile(col + dc, row + dr);
+					}
+				}
+				slide.computeTileWalking(col, row, 1 + (hash2(s, w + 7) % 8));
+			}
+		}
+		result.workloads[0].ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+		result.workloads[0].cells = (long long)walkers * (steps / walkers) * 9;
+		result.workloads[0].checksum = sum;
+
+		// diagonais isométricas
+		start = chrono::steady_clock::now();
+		sum = 0;
+		for (int l = 0; l < lines; l++) {
+			int col = hash2(l, 3) % (size / 2), row = hash2(l, 4) % (size / 2);
+			for (int s = 0; s < size / 2; s++) {
+				sum += tilemap.getTile(col, row);
+				diamond.computeTileWalking(col, row, DIRECTION_NORTH);
+			}
+		}
+		result.workloads[1].ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+		result.workloads[1].cells = (long long)lines * (size / 2);
+		result.workloads[1].checksum = sum;
+
+		// retângulos 64x64: iterador por região x getTile linha a linha
+		start = chrono::steady_clock::now();
+		sum = 0;
+		for (int i = 0; i < rects; i++) {
+			int col0 = hash2(i, 5) % (size - 64), row0 = hash2(i, 6) % (size - 64);
+			for (TileCell cell : tilemap.region(col0, row0, col0 + 64, row0 + 64)) {
+				sum += cell.tile;
+			}
+		}
+		result.workloads[2].ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+		result.workloads[2].cells = (long long)rects * 64 * 64;
+		result.workloads[2].checksum = sum;
+
+		start = chrono::steady_clock::now();
+		sum = 0;
+		for (int i = 0; i < rects; i++) {
+			int col0 = hash2(i, 5) % (size - 64), row0 = hash2(i, 6) % (size - 64);
+			for (int row = row0; row < row0 + 64; row++) {
+				for (int col = col0; col < col0 + 64; col++) {
+					sum += tilemap.getTile(col, row);
+				}
+			}
+		}
+		result.workloads[3].ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+		result.workloads[3].cells = (long long)rects * 64 * 64;
+		result.workloads[3].checksum = sum;
+
+		// mapa inteiro na ordem da memória
+		start = chrono::steady_clock::now();
+		sum = 0;
+		for (TileCell cell : tilemap.all()) {
+			sum += cell.tile;
+		}
+		result.workloads[4].ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+		result.workloads[4].cells = (long long)size * size;
+		result.workloads[4].checksum = sum;
+	}
+
+	// O iterador visita cada célula uma vez, com o valor certo (região que
+	// corta blocos nas quatro bordas)
+	int c0 = 7, r0 = 5, c1 = min(size, 7 + 100), r1 = min(size, 5 + 77);
+	vector<int> seen((size_t)(c1 - c0) * (r1 - r0), 0);
+	result.iteratorOk = true;
+	for (TileCell cell : tilemap.region(c0, r0, c1, r1)) {
+		bool inside = cell.col >= c0 && cell.col < c1 && cell.row >= r0 && cell.row < r1;
+		result.iteratorOk = result.iteratorOk && inside && cell.tile == tilemap.getTile(cell.col, cell.row);
+		if (inside) {
+			seen[(size_t)(cell.row - r0) * (c1 - c0) + (cell.col - c0)]++;
+		}
+	}
+	for (int count : seen) {
+		result.iteratorOk = result.iteratorOk && count == 1;
+	}
+	return result;
+}
+
+int main(int argc, char **argv) {
+	int size = 4096, steps = 4 << 20, rounds = 5;
+	string outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--size" && i + 1 < argc) {
+			size = max(128, atoi(argv[++i]));
+		} else if (arg == "--steps" && i + 1 < argc) {
+			steps = max(1024, atoi(argv[++i]));
+		} else if (arg == "--rounds" && i + 1 < argc) {
+			rounds = max(1, atoi(argv[++i]));
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+
+	vector<LayoutResult> results = { run<RowMajorLayout>(size, steps, rounds), run<TiledLayout>(size, steps, rounds),
+	                                 run<MortonLayout>(size, steps, rounds) };
+
+	bool ok = true;
+	for (const LayoutResult &layout : results) {
+		ok = ok && layout.iteratorOk;
+		for (size_t w = 0; w < layout.workloads.size(); w++) {
+			ok = ok && layout.workloads[w].checksum == results[0].workloads[w].checksum;
+		}
+	}
+	ok = ok && results[0].workloads[2].checksum == results[0].workloads[3].checksum;
+
+	cout << size << "x" << size << ", " << rounds << " rodadas (mediana, milhoes de celulas/s)" << endl;
+	cout << "  layout       " ;
+	for (const Workload &w : results[0].workloads) {
+		cout << setw(16) << w.name;
+	}
+	cout << setw(10) << "MB" << endl;
+	for (const LayoutResult &layout : results) {
+		cout << "  " << left << setw(13) << layout.name << right;
+		for (const Workload &w : layout.workloads) {
+			cout << fixed << setprecision(1) << setw(16) << w.cells / 1000.0 / max(median(w.ms), 1e-6);
+		}
+		cout << setw(10) << layout.bytes / 1048576.0 << endl;
+	}
+	cout << "  conferencia " << (ok ? "ok" : "FALHOU") << endl;
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"TileLayoutBench\",\n  \"size\": " << size << ",\n  \"rounds\": " << rounds
+		    << ",\n  \"correct\": " << (ok ? "true" : "false") << ",\n  \"mcells_per_s\": {\n";
+		for (size_t l = 0; l < results.size(); l++) {
+			out << "    \"" << results[l].name << "\": { \"bytes\": " << results[l].bytes;
+			for (const Workload &w : results[l].workloads) {
+				out << ", \"" << w.name << "\": " << fixed << setprecision(2) << w.cells / 1000.0 / max(median(w.ms), 1e-6);
+			}
+			out << " }" << (l + 1 < results.size() ? "," : "") << "\n";
+		}
+		out << "  }\n}\n";
+	}
+	return ok ? 0 : 1;
+}
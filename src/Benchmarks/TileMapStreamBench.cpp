@@ -0,0 +1,204 @@
+// Mundo grande em chunks: StreamingTileMap x TileMap carregado inteiro
+//
+// Gera um mundo de --size x --size (16384 por padrão) num .tmap, abre com o
+// StreamingTileMap (Common/M5-6) e passeia com uma câmera de --view x --view
+// tiles pela diagonal do mapa: a cada frame faz o prefetch da área da câmera,
+// lê todas as células visíveis e altera uma. Mede:
+//   abrir     : open do arquivo (só cabeçalho e índice)
+//   frame     : prefetch + leitura da área visível, mediana e p99
+//   memória   : pico de bytes residentes x o mapa inteiro
+//   inteiro   : TileMapFile::load do mesmo arquivo num TileMap (tempo e bytes)
+// Tudo o que é lido é conferido contra o gerador, e as alterações são gravadas
+// com save e conferidas reabrindo o arquivo. Não usa OpenGL nem abre janela.
+//
+// Uso: TileMapStreamBench [--size N] [--chunk N] [--cache N] [--view N] [--frames N]
+//                         [--no-full] [--dir pasta] [--out arquivo.json]
+// Retorna 1 se alguma célula lida difere do esperado.
+
+#include "TileMap.h"
+#include "TileMapFile.h"
+#include "StreamingTileMap.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static uint32_t hash2(int x, int y, uint32_t seed) {
+	uint32_t h = (uint32_t)x * 374761393u + (uint32_t)y * 668265263u + seed * 2246822519u;
+	h = (h ^ (h >> 13)) * 1274126177u;
+	return h ^ (h >> 16);
+}
+
+// Regiões de 32x32 com alguns tiles soltos (como o --generate do TileMapTool)
+static unsigned char worldTile(int col, int row) {
+	int base = hash2(col >> 5, row >> 5, 1) % 7;
+	return (unsigned char)(hash2(col, row, 2) % 64 == 0 ? (base + 1) % 7 : base);
+}
+
+static double msSince(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static double percentile(vector<double> values, double p) {
+	sort(values.begin(), values.end());
+	return values.empty() ? 0.0 : values[min(values.size() - 1, (size_t)(p * values.size()))];
+}
+
+int main(int argc, char **argv) {
+	int size = 16384, chunk = 64, cache = 256, view = 128, frames = 2000;
+	bool full = true;
+	string dir = "tilemap_stream_bench", outPath;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--size" && i + 1 < argc) {
+			size = max(64, atoi(argv[++i]));
+		} else if (arg == "--chunk" && i + 1 < argc) {
+			chunk = max(4, atoi(argv[++i]));
+		} else if (arg == "--cache" && i + 1 < argc) {
+			cache = max(1, atoi(argv[++i]));
+		} else if (arg == "--view" && i + 1 < argc) {
+			view = max(1, atoi(argv[++i]));
+		} else if (arg == "--frames" && i + 1 < argc) {
+			frames = max(1, atoi(argv[++i]));
+		} else if (arg == "--no-full") {
+			full = false;
+		} else if (arg == "--dir" && i + 1 < argc) {
+			dir = argv[++i];
+		} else if (arg == "--out" && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+	}
+	view = min(view, size);
+	fs::create_directories(dir);
+	string worldPath = (fs::path(dir) / "world.tmap").string();
+	string editedPath = (fs::path(dir) / "world_edited.tmap").string();
+
+	auto start = chrono::steady_clock::now();
+	TileMapHeader header = { size, size, chunk, 0, 0.0f };
+	if (!TileMapFile::save(worldPath, header, worldTile)) {
+		cerr << "Falha ao gravar " << worldPath << endl;
+		return 1;
+	}
+	double writeMs = msSince(start);
+	size_t fileBytes = (size_t)fs::file_size(worldPath);
+
+	StreamingTileMap world(cache);
+	start = chrono::steady_clock::now();
+	if (!world.open(worldPath)) {
+		cerr << "Falha ao abrir " << worldPath << endl;
+		return 1;
+	}
+	double openMs = msSince(start);
+
+	// Câmera na diagonal, ida e volta; uma alteração por frame
+	bool ok = true;
+	map<pair<int, int>, unsigned char> edits;
+	vector<double> frameMs;
+	long checksum = 0;
+	int span = size - view;
+	for (int f = 0; f < frames; f++) {
+		int t = span > 0 ? (f * 3) % (2 * span) : 0;
+		int x0 = t < span ? t : 2 * span - t;
+		int y0 = x0 / 2;
+
+		start = chrono::steady_clock::now();
+		world.prefetch(x0 - chunk, y0 - chunk, x0 + view + chunk, y0 + view + chunk);
+		for (int row = y0; row < y0 + view; row++) {
+			for (int col = x0; col < x0 + view; col++) {
+				checksum += world.getTile(col, row);
+			}
+		}
+		frameMs.push_back(msSince(start));
+
+		// conferência (fora do tempo medido): uma linha da câmera por frame
+		int row = y0 + f % view;
+		for (int col = x0; col < x0 + view; col++) {
+			auto edited = edits.find({ col, row });
+			unsigned char expected = edited != edits.end() ? edited->second : worldTile(col, row);
+			ok = ok && world.getTile(col, row) == expected;
+		}
+
+		int ec = x0 + (int)(hash2(f, 0, 3) % view), er = y0 + (int)(hash2(f, 1, 3) % view);
+		unsigned char tile = (unsigned char)((world.getTile(ec, er) + 1) % 7);
+		world.setTile(ec, er, tile);
+		edits[{ ec, er }] = tile;
+	}
+	StreamingTileMapStats stats = world.getStats();
+
+	// Alterações gravadas e relidas de outro arquivo
+	start = chrono::steady_clock::now();
+	bool saved = world.save(editedPath);
+	double saveMs = msSince(start);
+	StreamingTileMap reopened(16);
+	saved = saved && reopened.open(editedPath);
+	for (const auto &edit : edits) {
+		ok = ok && saved && reopened.getTile(edit.first.first, edit.first.second) == edit.second;
+	}
+	for (int i = 0; i < 100000 && saved; i++) {
+		int col = hash2(i, 7, 5) % size, row = hash2(i, 8, 5) % size;
+		if (edits.find({ col, row }) == edits.end()) {
+			ok = ok && reopened.getTile(col, row) == worldTile(col, row);
+		}
+	}
+	ok = ok && saved;
+
+	double fullMs = 0.0;
+	if (full) {
+		TileMap whole(1, 1, 0);
+		start = chrono::steady_clock::now();
+		bool loaded = TileMapFile::load(worldPath, whole);
+		fullMs = msSince(start);
+		for (int i = 0; i < 100000 && loaded; i++) {
+			int col = hash2(i, 9, 5) % size, row = hash2(i, 10, 5) % size;
+			ok = ok && whole.getTile(col, row) == worldTile(col, row);
+		}
+		ok = ok && loaded;
+	}
+
+	size_t mapBytes = (size_t)size * size;
+	double medianMs = percentile(frameMs, 0.5), p99Ms = percentile(frameMs, 0.99);
+	cout << size << "x" << size << " em chunks de " << chunk << "x" << chunk << ", cache de " << cache << " chunks, camera de "
+	     << view << "x" << view << ", " << frames << " frames" << endl;
+	cout << fixed << setprecision(2) << "  arquivo  " << fileBytes / 1024 << " KB gerado em " << writeMs << " ms" << endl
+	     << "  abrir    " << openMs << " ms" << endl
+	     << "  frame    " << medianMs << " ms (p99 " << p99Ms << " ms), " << stats.loads << " chunks lidos, "
+	     << stats.evictions << " despejados, " << stats.writeBacks << " regravados" << endl
+	     << "  memoria  pico de " << stats.peakResidentBytes / 1024 << " KB (mapa inteiro: " << mapBytes / 1024 << " KB)" << endl
+	     << "  save     " << saveMs << " ms" << endl;
+	if (full) {
+		cout << "  inteiro  " << fullMs << " ms para carregar " << mapBytes / 1024 << " KB" << endl;
+	}
+	cout << "  conferencia " << (ok ? "ok" : "FALHOU") << " (checksum " << checksum << ")" << endl;
+
+	if (!outPath.empty()) {
+		ofstream out(outPath);
+		out << "{\n  \"target\": \"TileMapStreamBench\",\n  \"size\": " << size << ",\n  \"chunk\": " << chunk
+		    << ",\n  \"cache_chunks\": " << cache << ",\n  \"view\": " << view << ",\n  \"frames\": " << frames
+		    << ",\n  \"correct\": " << (ok ? "true" : "false") << ",\n  \"file_bytes\": " << fileBytes
+		    << ",\n  \"map_bytes\": " << mapBytes << ",\n  \"peak_resident_bytes\": " << stats.peakResidentBytes
+		    << ",\n  \"chunk_loads\": " << stats.loads << ",\n  \"evictions\": " << stats.evictions
+		    << ",\n  \"write_backs\": " << stats.writeBacks << fixed << setprecision(3) << ",\n  \"write_ms\": " << writeMs
+		    << ",\n  \"open_ms\": " << openMs << ",\n  \"frame_median_ms\": " << medianMs << ",\n  \"frame_p99_ms\": " << p99Ms
+		    << ",\n  \"save_ms\": " << saveMs;
+		if (full) {
+			out << ",\n  \"full_load_ms\": " << fullMs;
+		}
+		out << "\n}\n";
+	}
+
+	world.close();
+	reopened.close();
+	fs::remove_all(dir);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,247 @@
+// Cópia congelada das funções de mat4 do maths_funcs.cpp antes da versão SIMD
+// (Common/M5-6/maths_simd.h). Serve só de referência para o MathsBench: mesmo
+// código, mesma forma (fora de linha, em outra unidade de tradução), para que a
+// comparação de matrizes/s e a conferência dos resultados sejam justas.
+
+#include "maths_funcs.h"
+#include <stdio.h>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+namespace legacy {
+
+vec4 mul (const mat4& mm, const vec4& rhs) {
+	const float* m = mm.m;
+	// 0x + 4y + 8z + 12w
+	float x =
+		m[0] * rhs.v[0] +
+		m[4] * rhs.v[1] +
+		m[8] * rhs.v[2] +
+		m[12] * rhs.v[3];
+	// 1x + 5y + 9z + 13w
+	float y = m[1] * rhs.v[0] +
+		m[5] * rhs.v[1] +
+		m[9] * rhs.v[2] +
+		m[13] * rhs.v[3];
+	// 2x + 6y + 10z + 14w
+	float z = m[2] * rhs.v[0] +
+		m[6] * rhs.v[1] +
+		m[10] * rhs.v[2] +
+		m[14] * rhs.v[3];
+	// 3x + 7y + 11z + 15w
+	float w = m[3] * rhs.v[0] +
+		m[7] * rhs.v[1] +
+		m[11] * rhs.v[2] +
+		m[15] * rhs.v[3];
+	return vec4 (x, y, z, w);
+}
+
+mat4 mul (const mat4& lhs, const mat4& rhs) {
+	const float* m = lhs.m;
+	mat4 r = ::zero_mat4 ();
+	int r_index = 0;
+	for (int col = 0; col < 4; col++) {
+		for (int row = 0; row < 4; row++) {
+			float sum = 0.0f;
+			for (int i = 0; i < 4; i++) {
+				sum += rhs.m[i + col * 4] * m[row + i * 4];
+			}
+			r.m[r_index] = sum;
+			r_index++;
+		}
+	}
+	return r;
+}
+
+// returns a scalar value with the determinant for a 4x4 matrix
+// see http://www.euclideanspace.com/maths/algebra/matrix/functions/determinant/fourD/index.htm
+float determinant (const mat4& mm) {
+	return
+		mm.m[12] * mm.m[9] * mm.m[6] * mm.m[3] -
+		mm.m[8] * mm.m[13] * mm.m[6] * mm.m[3] -
+		mm.m[12] * mm.m[5] * mm.m[10] * mm.m[3] +
+		mm.m[4] * mm.m[13] * mm.m[10] * mm.m[3] +
+		mm.m[8] * mm.m[5] * mm.m[14] * mm.m[3] -
+		mm.m[4] * mm.m[9] * mm.m[14] * mm.m[3] -
+		mm.m[12] * mm.m[9] * mm.m[2] * mm.m[7] +
+		mm.m[8] * mm.m[13] * mm.m[2] * mm.m[7] +
+		mm.m[12] * mm.m[1] * mm.m[10] * mm.m[7] -
+		mm.m[0] * mm.m[13] * mm.m[10] * mm.m[7] -
+		mm.m[8] * mm.m[1] * mm.m[14] * mm.m[7] +
+		mm.m[0] * mm.m[9] * mm.m[14] * mm.m[7] +
+		mm.m[12] * mm.m[5] * mm.m[2] * mm.m[11] -
+		mm.m[4] * mm.m[13] * mm.m[2] * mm.m[11] -
+		mm.m[12] * mm.m[1] * mm.m[6] * mm.m[11] +
+		mm.m[0] * mm.m[13] * mm.m[6] * mm.m[11] +
+		mm.m[4] * mm.m[1] * mm.m[14] * mm.m[11] -
+		mm.m[0] * mm.m[5] * mm.m[14] * mm.m[11] -
+		mm.m[8] * mm.m[5] * mm.m[2] * mm.m[15] +
+		mm.m[4] * mm.m[9] * mm.m[2] * mm.m[15] +
+		mm.m[8] * mm.m[1] * mm.m[6] * mm.m[15] -
+		mm.m[0] * mm.m[9] * mm.m[6] * mm.m[15] -
+		mm.m[4] * mm.m[1] * mm.m[10] * mm.m[15] +
+		mm.m[0] * mm.m[5] * mm.m[10] * mm.m[15];
+}
+
+/* returns a 16-element array that is the inverse of a 16-element array (4x4
+matrix). see http://www.euclideanspace.com/maths/algebra/matrix/functions/inverse/fourD/index.htm */
+mat4 inverse (const mat4& mm) {
+	float det = legacy::determinant (mm);
+	/* there is no inverse if determinant is zero (not likely unless scale is
+	broken) */
+	if (0.0f == det) {
+		fprintf (stderr, "WARNING. matrix has no determinant. can not invert\n");
+		return mm;
+	}
+	float inv_det = 1.0f / det;
+	
+	return mat4 (
+		inv_det * (
+			mm.m[9] * mm.m[14] * mm.m[7] - mm.m[13] * mm.m[10] * mm.m[7] +
+			mm.m[13] * mm.m[6] * mm.m[11] - mm.m[5] * mm.m[14] * mm.m[11] -
+			mm.m[9] * mm.m[6] * mm.m[15] + mm.m[5] * mm.m[10] * mm.m[15]
+		),
+		inv_det * (
+			mm.m[13] * mm.m[10] * mm.m[3] - mm.m[9] * mm.m[14] * mm.m[3] -
+			mm.m[13] * mm.m[2] * mm.m[11] + mm.m[1] * mm.m[14] * mm.m[11] +
+			mm.m[9] * mm.m[2] * mm.m[15] - mm.m[1] * mm.m[10] * mm.m[15]
+		),
+		inv_det * (
+			mm.m[5] * mm.m[14] * mm.m[3] - mm.m[13] * mm.m[6] * mm.m[3] +
+			mm.m[13] * mm.m[2] * mm.m[7] - mm.m[1] * mm.m[14] * mm.m[7] -
+			mm.m[5] * mm.m[2] * mm.m[15] + mm.m[1] * mm.m[6] * mm.m[15]
+		),
+		inv_det * (
+			mm.m[9] * mm.m[6] * mm.m[3] - mm.m[5] * mm.m[10] * mm.m[3] -
+			mm.m[9] * mm.m[2] * mm.m[7] + mm.m[1] * mm.m[10] * mm.m[7] +
+			mm.m[5] * mm.m[2] * mm.m[11] - mm.m[1] * mm.m[6] * mm.m[11]
+		),
+		inv_det * (
+			mm.m[12] * mm.m[10] * mm.m[7] - mm.m[8] * mm.m[14] * mm.m[7] -
+			mm.m[12] * mm.m[6] * mm.m[11] + mm.m[4] * mm.m[14] * mm.m[11] +
+			mm.m[8] * mm.m[6] * mm.m[15] - mm.m[4] * mm.m[10] * mm.m[15]
+		),
+		inv_det * (
+			mm.m[8] * mm.m[14] * mm.m[3] - mm.m[12] * mm.m[10] * mm.m[3] +
+			mm.m[12] * mm.m[2] * mm.m[11] - mm.m[0] * mm.m[14] * mm.m[11] -
+			mm.m[8] * mm.m[2] * mm.m[15] + mm.m[0] * mm.m[10] * mm.m[15]
+		),
+		inv_det * (
+			mm.m[12] * mm.m[6] * mm.m[3] - mm.m[4] * mm.m[14] * mm.m[3] -
+			mm.m[12] * mm.m[2] * mm.m[7] + mm.m[0] * mm.m[14] * mm.m[7] +
+			mm.m[4] * mm.m[2] * mm.m[15] - mm.m[0] * mm.m[6] * mm.m[15]
+		),
+		inv_det * (
+			mm.m[4] * mm.m[10] * mm.m[3] - mm.m[8] * mm.m[6] * mm.m[3] +
+			mm.m[8] * mm.m[2] * mm.m[7] - mm.m[0] * mm.m[10] * mm.m[7] -
+			mm.m[4] * mm.m[2] * mm.m[11] + mm.m[0] * mm.m[6] * mm.m[11]
+		),
+		inv_det * (
+			mm.m[8] * mm.m[13] * mm.m[7] - mm.m[12] * mm.m[9] * mm.m[7] +
+			mm.m[12] * mm.m[5] * mm.m[11] - mm.m[4] * mm.m[13] * mm.m[11] -
+			mm.m[8] * mm.m[5] * mm.m[15] + mm.m[4] * mm.m[9] * mm.m[15]
+		),
+		inv_det * (
+			mm.m[12] * mm.m[9] * mm.m[3] - mm.m[8] * mm.m[13] * mm.m[3] -
+			mm.m[12] * mm.m[1] * mm.m[11] + mm.m[0] * mm.m[13] * mm.m[11] +
+			mm.m[8] * mm.m[1] * mm.m[15] - mm.m[0] * mm.m[9] * mm.m[15]
+		),
+		inv_det * (
+			mm.m[4] * mm.m[13] * mm.m[3] - mm.m[12] * mm.m[5] * mm.m[3] +
+			mm.m[12] * mm.m[1] * mm.m[7] - mm.m[0] * mm.m[13] * mm.m[7] -
+			mm.m[4] * mm.m[1] * mm.m[15] + mm.m[0] * mm.m[5] * mm.m[15]
+		),
+		inv_det * (
+			mm.m[8] * mm.m[5] * mm.m[3] - mm.m[4] * mm.m[9] * mm.m[3] -
+			mm.m[8] * mm.m[1] * mm.m[7] + mm.m[0] * mm.m[9] * mm.m[7] +
+			mm.m[4] * mm.m[1] * mm.m[11] - mm.m[0] * mm.m[5] * mm.m[11]
+		),
+		inv_det * (
+			mm.m[12] * mm.m[9] * mm.m[6] - mm.m[8] * mm.m[13] * mm.m[6] -
+			mm.m[12] * mm.m[5] * mm.m[10] + mm.m[4] * mm.m[13] * mm.m[10] +
+			mm.m[8] * mm.m[5] * mm.m[14] - mm.m[4] * mm.m[9] * mm.m[14]
+		),
+		inv_det * (
+			mm.m[8] * mm.m[13] * mm.m[2] - mm.m[12] * mm.m[9] * mm.m[2] +
+			mm.m[12] * mm.m[1] * mm.m[10] - mm.m[0] * mm.m[13] * mm.m[10] -
+			mm.m[8] * mm.m[1] * mm.m[14] + mm.m[0] * mm.m[9] * mm.m[14]
+		),
+		inv_det * (
+			mm.m[12] * mm.m[5] * mm.m[2] - mm.m[4] * mm.m[13] * mm.m[2] -
+			mm.m[12] * mm.m[1] * mm.m[6] + mm.m[0] * mm.m[13] * mm.m[6] +
+			mm.m[4] * mm.m[1] * mm.m[14] - mm.m[0] * mm.m[5] * mm.m[14]
+		),
+		inv_det * (
+			mm.m[4] * mm.m[9] * mm.m[2] - mm.m[8] * mm.m[5] * mm.m[2] +
+			mm.m[8] * mm.m[1] * mm.m[6] - mm.m[0] * mm.m[9] * mm.m[6] -
+			mm.m[4] * mm.m[1] * mm.m[10] + mm.m[0] * mm.m[5] * mm.m[10]
+		)
+	);
+}
+
+// returns a 16-element array flipped on the main diagonal
+mat4 transpose (const mat4& mm) {
+	return mat4 (
+		mm.m[0], mm.m[4], mm.m[8], mm.m[12],
+		mm.m[1], mm.m[5], mm.m[9], mm.m[13],
+		mm.m[2], mm.m[6], mm.m[10], mm.m[14],
+		mm.m[3], mm.m[7], mm.m[11], mm.m[15]
+	);
+}
+
+/*--------------------------AFFINE MATRIX FUNCTIONS---------------------------*/
+// translate a 4d matrix with xyz array
+mat4 translate (const mat4& m, const vec3& v) {
+	mat4 m_t = ::identity_mat4 ();
+	m_t.m[12] = v.v[0];
+	m_t.m[13] = v.v[1];
+	m_t.m[14] = v.v[2];
+	return mul (m_t, m);
+}
+
+// rotate around x axis by an angle in degrees
+mat4 rotate_x_deg (const mat4& m, float deg) {
+	// convert to radians
+	float rad = deg * ONE_DEG_IN_RAD;
+	mat4 m_r = ::identity_mat4 ();
+	m_r.m[5] = cos (rad);
+	m_r.m[9] = -sin (rad);
+	m_r.m[6] = sin (rad);
+	m_r.m[10] = cos (rad);
+	return mul (m_r, m);
+}
+
+// rotate around y axis by an angle in degrees
+mat4 rotate_y_deg (const mat4& m, float deg) {
+	// convert to radians
+	float rad = deg * ONE_DEG_IN_RAD;
+	mat4 m_r = ::identity_mat4 ();
+	m_r.m[0] = cos (rad);
+	m_r.m[8] = sin (rad);
+	m_r.m[2] = -sin (rad);
+	m_r.m[10] = cos (rad);
+	return mul (m_r, m);
+}
+
+// rotate around z axis by an angle in degrees
+mat4 rotate_z_deg (const mat4& m, float deg) {
+	// convert to radians
+	float rad = deg * ONE_DEG_IN_RAD;
+	mat4 m_r = ::identity_mat4 ();
+	m_r.m[0] = cos (rad);
+	m_r.m[4] = -sin (rad);
+	m_r.m[1] = sin (rad);
+	m_r.m[5] = cos (rad);
+	return mul (m_r, m);
+}
+
+// scale a matrix by [x, y, z]
+mat4 scale (const mat4& m, const vec3& v) {
+	mat4 a = ::identity_mat4 ();
+	a.m[0] = v.v[0];
+	a.m[5] = v.v[1];
+	a.m[10] = v.v[2];
+	return mul (a, m);
+}
+
+} // namespace legacy
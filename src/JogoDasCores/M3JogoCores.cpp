@@ -4,6 +4,10 @@
 #include <vector>
 #include <cmath>
 #include <ctime>
+#include <cstring>
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -14,41 +18,63 @@
 using namespace std;
 using namespace glm;
 
+#include "ShaderProgram.h"
+#include "HeadlessRunner.h"
+#include "ProgramCache.h"
+#include "GeometryRegistry.h"
+
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
-const GLuint ROWS = 6, COLS = 8;
-const GLuint QUAD_WIDTH = 100, QUAD_HEIGHT = 100;
 const float dMax = sqrt(3.0);
 
+// Tamanho da grade: 6x8 por padrão, ou --grid N para N x N (ex.: 1000 para o
+// painel de vídeo). As células sempre cobrem a janela inteira
+int ROWS = 6, COLS = 8;
+float QUAD_WIDTH = 100.0f, QUAD_HEIGHT = 100.0f;
+
 // Protótipos das funções
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
-GLuint createQuad();
+Geometry createQuad();
+GLuint createGridVAO(const Geometry &quad);
+void marcarAlterada(int index);
+void enviarAlteracoes();
 int setupShader();
 void eliminarSimilares(float tolerancia);
+void inicializarGrid();
 void reiniciarJogo();
 void validaFimJogo();
 
+// Programas de shader compilados uma vez e reaproveitados do disco
+ProgramCache programCache;
+
 // Código fonte do Vertex Shader (em GLSL): ainda hardcoded
+// Uma instância por célula: posição e cor vêm do buffer de instâncias; células
+// eliminadas (alfa 0) viram um quad degenerado, sem nenhum fragmento
 const GLchar* vertexShaderSource = R"(
 #version 400
 layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 cellPosition;
+layout (location = 2) in vec4 cellColor;
 uniform mat4 projection;
-uniform mat4 model;
+uniform vec2 cellSize;
+out vec3 vColor;
 void main()
 {
-	gl_Position = projection * model * vec4(position, 1.0);
+	vColor = cellColor.rgb;
+	vec2 corner = position.xy * cellSize * cellColor.a;
+	gl_Position = projection * vec4(cellPosition + corner, 0.0, 1.0);
 }
 )";
 
 // Código fonte do Fragment Shader (em GLSL): ainda hardcoded
 const GLchar* fragmentShaderSource = R"(
 #version 400
-uniform vec4 inputColor;
+in vec3 vColor;
 out vec4 color;
 void main()
 {
-	color = inputColor;
+	color = vec4(vColor, 1.0);
 }
 )";
 
@@ -59,21 +85,54 @@ struct Quad {
 	bool eliminated;
 };
 
-Quad grid[ROWS][COLS];
+// Célula no buffer de instâncias da GPU (12 bytes): centro da célula e cor
+// RGBA8, com alfa 255 = visível e 0 = eliminada
+struct CellInstance {
+	float x, y;
+	unsigned char rgba[4];
+};
+
+// grid[i * COLS + j]: linha i, coluna j
+vector<Quad> grid;
+int restantes = 0; // células ainda não eliminadas
+
+// Cópia da grade no formato do buffer de instâncias. O buffer é alocado uma
+// vez e fica na GPU; só as células marcadas em celulasAlteradas são reenviadas
+vector<CellInstance> instancias;
+vector<int> celulasAlteradas;
+vector<bool> alterada;
+GLuint instanceVBO = 0;
+
+// Quad unitário compartilhado por todas as células
+GeometryRegistry geometry;
+
 int iSelected = -1;
 int scoreFinal = 0;
 int tentativas = 0;
 
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
+	// --headless --frames N: benchmark sem janela visível (ver HeadlessRunner.h)
+	HeadlessRunner runner(argc, argv);
+
 	srand(time(0));
 
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc)
+		{
+			ROWS = COLS = std::max(1, atoi(argv[++i]));
+		}
+	}
+	QUAD_WIDTH = (float)WIDTH / COLS;
+	QUAD_HEIGHT = (float)HEIGHT / ROWS;
+
 	// Inicialização da GLFW
 	glfwInit();
 
 	// Criação da janela GLFW
-	GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Jogo das cores! Isadora Albano ❤️🩷🧡💛💚", nullptr, nullptr);
+	GLFWwindow* window = runner.createWindow(WIDTH, HEIGHT, "Jogo das cores! Isadora Albano ❤️🩷🧡💛💚");
 	glfwMakeContextCurrent(window);
 
 	// Registro das funções de callback
@@ -86,6 +145,12 @@ int main()
 		std::cout << "Failed to initialize GLAD" << std::endl;
 	}
 
+	runner.attach(window);
+	// Entrada programada do modo headless
+	for (int i = 0; i < 40; i++)
+		runner.addClick(10 + i * 6, (i * 3 % COLS) * QUAD_WIDTH + QUAD_WIDTH / 2, (i * 5 % ROWS) * QUAD_HEIGHT + QUAD_HEIGHT / 2);
+	runner.addKey(250, GLFW_KEY_SPACE);
+
 	// Informações da versão do driver
 	const GLubyte* renderer = glGetString(GL_RENDERER);
 	const GLubyte* version = glGetString(GL_VERSION);
@@ -97,17 +162,21 @@ int main()
 	glViewport(0, 0, width, height);
 
 	GLuint shaderID = setupShader();
-	GLuint VAO = createQuad();
+	inicializarGrid();
+	GLuint VAO = createGridVAO(createQuad());
 
 	glUseProgram(shaderID);
-	GLint colorLoc = glGetUniformLocation(shaderID, "inputColor");
+	ShaderProgram shader(shaderID);
 	mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	shader.setMat4(shader.uniform("projection"), projection);
+	shader.setVec2(shader.uniform("cellSize"), QUAD_WIDTH, QUAD_HEIGHT);
 
 	// Loop principal
 	while (!glfwWindowShouldClose(window))
 	{
 		glfwPollEvents();
+		runner.beginFrame();
+		shader.beginFrame();
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
 
@@ -119,47 +188,33 @@ int main()
 		{
 			eliminarSimilares(0.2f);
 		}
+		validaFimJogo();
 
-		// Inicializar a grid
-		for (int i = 0; i < ROWS; i++)
-		{
-			for (int j = 0; j < COLS; j++)
-			{
-				if (!grid[i][j].eliminated)
-				{
-					mat4 model = mat4(1);
-					model = translate(model, grid[i][j].position);
-					model = scale(model, grid[i][j].dimensions);
-					glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-					glUniform4f(colorLoc, grid[i][j].color.r, grid[i][j].color.g, grid[i][j].color.b, 1.0f);
-					glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-				}
-			}
-		}
+		// A grade inteira numa única chamada; antes, só as células que mudaram
+		// neste frame sobem para a GPU
+		enviarAlteracoes();
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, ROWS * COLS);
 
 		glBindVertexArray(0);
-		validaFimJogo();
+		runner.endFrame();
 		glfwSwapBuffers(window);
 	}
 
+	programCache.printReport();
+	runner.setMetric("shader_setup_ms", programCache.getTotalMs());
+	runner.setMetric("program_cache_hits", programCache.getStats().hits);
+	runner.finish();
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &instanceVBO);
+	geometry.releaseAll();
 	glfwTerminate();
-	return 0;
+	return runner.exitStatus();
 }
 
 // Verifica se todos os retangulos foram eliminados
 void validaFimJogo()
 {
-	bool allEliminated = true;
-	for (int i = 0; i < ROWS; i++) {
-		for (int j = 0; j < COLS; j++) {
-			if (!grid[i][j].eliminated) {
-				allEliminated = false;
-				break;
-			}
-		}
-		if (!allEliminated) break;
-	}
-	if (allEliminated) {
+	if (restantes == 0) {
 		reiniciarJogo();
 	}
 };
@@ -183,7 +238,9 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 		glfwGetCursorPos(window, &xpos, &ypos);
 		int x = xpos / QUAD_WIDTH;
 		int y = ypos / QUAD_HEIGHT;
-		if (!grid[y][x].eliminated)
+		if (x < 0 || x >= COLS || y < 0 || y >= ROWS)
+			return;
+		if (!grid[y * COLS + x].eliminated)
 		{
 			iSelected = x + y * COLS;
 			tentativas++;
@@ -192,68 +249,129 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 	}
 }
 
-GLuint createQuad()
+Geometry createQuad()
 {
-	GLuint VAO, VBO;
 	GLfloat vertices[] = {
 		-0.5f,  0.5f, 0.0f,
 		-0.5f, -0.5f, 0.0f,
 		 0.5f,  0.5f, 0.0f,
 		 0.5f, -0.5f, 0.0f
 	};
+	return geometry.acquire(VertexLayout().add(0, 3), vertices, sizeof(vertices));
+}
+
+// VAO da grade: o quad compartilhado (location 0, por vértice) + o buffer de
+// instâncias (locations 1 e 2, uma vez por célula)
+GLuint createGridVAO(const Geometry &quad)
+{
+	GLuint VAO;
 	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
 	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ARRAY_BUFFER, quad.VBO);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
 	glEnableVertexAttribArray(0);
+
+	glGenBuffers(1, &instanceVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, instancias.size() * sizeof(CellInstance), instancias.data(), GL_DYNAMIC_DRAW);
+
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(CellInstance), (GLvoid*)offsetof(CellInstance, x));
+	glEnableVertexAttribArray(1);
+	glVertexAttribDivisor(1, 1);
+	glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CellInstance), (GLvoid*)offsetof(CellInstance, rgba));
+	glEnableVertexAttribArray(2);
+	glVertexAttribDivisor(2, 1);
+
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
+
+	celulasAlteradas.clear();
+	alterada.assign(grid.size(), false);
 	return VAO;
 }
 
+// Copia a célula para o formato da GPU e a marca para o próximo envio
+void marcarAlterada(int index)
+{
+	const Quad &q = grid[index];
+	CellInstance &c = instancias[index];
+	c.x = q.position.x;
+	c.y = q.position.y;
+	c.rgba[0] = (unsigned char)(q.color.r * 255.0f + 0.5f);
+	c.rgba[1] = (unsigned char)(q.color.g * 255.0f + 0.5f);
+	c.rgba[2] = (unsigned char)(q.color.b * 255.0f + 0.5f);
+	c.rgba[3] = q.eliminated ? 0 : 255;
+
+	if (!alterada.empty() && !alterada[index])
+	{
+		alterada[index] = true;
+		celulasAlteradas.push_back(index);
+	}
+}
+
+// Reenvia só as células alteradas, juntando células vizinhas num único
+// glBufferSubData; se mudou boa parte da grade (reinício), envia tudo de uma vez
+void enviarAlteracoes()
+{
+	if (celulasAlteradas.empty())
+		return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	if (celulasAlteradas.size() * 4 >= grid.size())
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, 0, instancias.size() * sizeof(CellInstance), instancias.data());
+	}
+	else
+	{
+		sort(celulasAlteradas.begin(), celulasAlteradas.end());
+		size_t first = 0;
+		while (first < celulasAlteradas.size())
+		{
+			size_t last = first + 1;
+			while (last < celulasAlteradas.size() && celulasAlteradas[last] == celulasAlteradas[last - 1] + 1)
+				last++;
+			int start = celulasAlteradas[first];
+			int count = celulasAlteradas[last - 1] - start + 1;
+			glBufferSubData(GL_ARRAY_BUFFER, (size_t)start * sizeof(CellInstance), (size_t)count * sizeof(CellInstance), &instancias[start]);
+			first = last;
+		}
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	for (int index : celulasAlteradas)
+		alterada[index] = false;
+	celulasAlteradas.clear();
+}
+
 int setupShader()
 {
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-	return shaderProgram;
+	// Binário do programa em cache (ver ProgramCache.h): só compila quando o
+	// fonte ou o driver mudam
+	return programCache.build(vertexShaderSource, fragmentShaderSource);
 }
 
 void eliminarSimilares(float tolerancia)
 {
-	int x = iSelected % COLS;
-	int y = iSelected / COLS;
-	vec3 C = grid[y][x].color;
-	grid[y][x].eliminated = true;
+	vec3 C = grid[iSelected].color;
+	grid[iSelected].eliminated = true;
+	restantes--;
+	marcarAlterada(iSelected);
 	int pontos = 0;
 
-	for (int i = 0; i < ROWS; i++)
+	for (int index = 0; index < (int)grid.size(); index++)
 	{
-		for (int j = 0; j < COLS; j++)
+		if (!grid[index].eliminated)
 		{
-			if (!grid[i][j].eliminated)
+			vec3 O = grid[index].color;
+			float d = sqrt(pow(C.r - O.r, 2) + pow(C.g - O.g, 2) + pow(C.b - O.b, 2));
+			float dd = d / dMax;
+			if (dd <= tolerancia)
 			{
-				vec3 O = grid[i][j].color;
-				float d = sqrt(pow(C.r - O.r, 2) + pow(C.g - O.g, 2) + pow(C.b - O.b, 2));
-				float dd = d / dMax;
-				if (dd <= tolerancia)
-				{
-					grid[i][j].eliminated = true;
-					pontos += 5;
-				}
+				grid[index].eliminated = true;
+				restantes--;
+				marcarAlterada(index);
+				pontos += 5;
 			}
 		}
 	}
@@ -262,23 +380,34 @@ void eliminarSimilares(float tolerancia)
 	iSelected = -1;
 }
 
-void reiniciarJogo()
+// Sorteia as cores de todas as células (e marca todas para reenvio)
+void inicializarGrid()
 {
-	cout << "FIM DE JOGO - Pontuacao final: " << scoreFinal << ", Tentativas: " << tentativas << endl;
-	scoreFinal = 0;
-	tentativas = 0;
+	grid.resize((size_t)ROWS * COLS);
+	instancias.resize(grid.size());
 	for (int i = 0; i < ROWS; i++)
 	{
 		for (int j = 0; j < COLS; j++)
 		{
-			grid[i][j].position = vec3(QUAD_WIDTH/2 + j*QUAD_WIDTH, QUAD_HEIGHT/2 + i*QUAD_HEIGHT, 0);
-            grid[i][j].dimensions = vec3(QUAD_WIDTH, QUAD_HEIGHT, 1);
-            grid[i][j].color = vec3(
+			Quad &q = grid[i * COLS + j];
+			q.position = vec3(QUAD_WIDTH/2 + j*QUAD_WIDTH, QUAD_HEIGHT/2 + i*QUAD_HEIGHT, 0);
+            q.dimensions = vec3(QUAD_WIDTH, QUAD_HEIGHT, 1);
+            q.color = vec3(
                 rand() % 256 / 255.0f,
                 rand() % 256 / 255.0f,
                 rand() % 256 / 255.0f
             );
-            grid[i][j].eliminated = false;
+            q.eliminated = false;
+			marcarAlterada(i * COLS + j);
 		}
 	}
+	restantes = (int)grid.size();
+}
+
+void reiniciarJogo()
+{
+	cout << "FIM DE JOGO - Pontuacao final: " << scoreFinal << ", Tentativas: " << tentativas << endl;
+	scoreFinal = 0;
+	tentativas = 0;
+	inicializarGrid();
 }
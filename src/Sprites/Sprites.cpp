@@ -21,6 +21,13 @@ using namespace std;
 #include <glm/gtc/type_ptr.hpp>
 
 using namespace glm;
+
+#include "ShaderProgram.h"
+#include "HeadlessRunner.h"
+#include "ProgramCache.h"
+#include "GeometryRegistry.h"
+#include "TextureManager.h"
+
 struct Sprite
 {
 	GLuint VAO;
@@ -35,14 +42,22 @@ struct Sprite
 
 Sprite vampirao;
 
+// VAOs/VBOs compartilhados: sprites com o mesmo recorte usam o mesmo quad
+GeometryRegistry geometry;
+
+// Texturas compartilhadas por caminho (carregadas em segundo plano, ver TextureManager.h)
+TextureManager textureManager;
+
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 
 int setupShader();
 int setupSprite(int nAnimations, int nFrames, float &ds, float &dt);
-int loadTexture(string filePath, int &width, int &height);
 
 const GLuint WIDTH = 800, HEIGHT = 600;
 
+// Programas de shader compilados uma vez e reaproveitados do disco
+ProgramCache programCache;
+
 // Código fonte do Vertex Shader (em GLSL): ainda hardcoded
 const GLchar *vertexShaderSource = R"(
  #version 400
@@ -72,8 +87,11 @@ const GLchar *fragmentShaderSource = R"(
  }
  )";
 
-int main()
+int main(int argc, char **argv)
 {
+	// --headless --frames N: benchmark sem janela visível (ver HeadlessRunner.h)
+	HeadlessRunner runner(argc, argv);
+
 	// Inicialização da GLFW
 	glfwInit();
 
@@ -81,7 +99,7 @@ int main()
 	glfwWindowHint(GLFW_SAMPLES, 8);
 
 	// Criação da janela GLFW
-	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana", nullptr, nullptr);
+	GLFWwindow *window = runner.createWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana");
 	if (!window)
 	{
 		std::cerr << "Falha ao criar a janela GLFW" << std::endl;
@@ -100,6 +118,13 @@ int main()
 		return -1;
 	}
 
+	runner.attach(window);
+	// Entrada programada do modo headless
+	runner.addKey(10, GLFW_KEY_RIGHT, 30);
+	runner.addKey(60, GLFW_KEY_UP, 20);
+	runner.addKey(100, GLFW_KEY_LEFT, 30);
+	runner.addKey(150, GLFW_KEY_DOWN, 20);
+
 	// Obtendo as informações de versão
 	const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
 	const GLubyte *version = glGetString(GL_VERSION);	/* version as a string */
@@ -114,9 +139,13 @@ int main()
 	// Compilando e buildando o programa de shader
 	GLuint shaderID = setupShader();
 
+	// Texturas já decodificadas no build (alvo "textures" do CMake); sem o pacote
+	// os PNGs são decodificados na hora
+	textureManager.useBakedPack("baked/textures.pak");
+
 	//Carregando uma textura 
 	int imgWidth, imgHeight;
-	GLuint texID = loadTexture("../assets/sprites/Vampires1_Walk_full.png",imgWidth,imgHeight);
+	GLuint texID = textureManager.acquire("../assets/sprites/Vampires1_Walk_full.png", imgWidth, imgHeight);
 
 	// Gerando um buffer simples, com a geometria de um triângulo
 	vampirao.nAnimations = 4;
@@ -133,7 +162,7 @@ int main()
 	background.nFrames = 1;
 	background.VAO = setupSprite(background.nAnimations,background.nFrames,background.ds,background.dt);
 	background.position = vec3(400.0, 300.0, 0.0);
-	background.texID = loadTexture("../assets/backgrounds/vampiro-fundo.png",imgWidth,imgHeight);
+	background.texID = textureManager.acquire("../assets/backgrounds/vampiro-fundo.png", imgWidth, imgHeight);
 	background.dimensions = vec3(800, 600, 1.0);
 	background.iAnimation = 0;
 	background.iFrame = 0;
@@ -141,6 +170,11 @@ int main()
 
 	glUseProgram(shaderID);
 
+	// Uniforms resolvidos uma única vez; o laço de desenho só usa os handles
+	ShaderProgram shader(shaderID);
+	int modelLoc = shader.uniform("model");
+	int offsetTexLoc = shader.uniform("offsetTex");
+
 	double prev_s = glfwGetTime();
 	double title_countdown_s = 0.1;
 
@@ -150,11 +184,11 @@ int main()
 	glActiveTexture(GL_TEXTURE0);
 
 	// Criando a variável uniform pra mandar a textura pro shader
-	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+	shader.setInt(shader.uniform("tex_buff"), 0);
 
 	// Matriz de projeção paralela ortográfica
 	mat4 projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	shader.setMat4(shader.uniform("projection"), projection);
 
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_ALWAYS);
@@ -187,7 +221,8 @@ int main()
 
 				// Cria uma string e define o FPS como título da janela.
 				char tmp[256];
-				sprintf(tmp, "Vampirinho por ai\tFPS %.2lf", fps);
+				sprintf(tmp, "Vampirinho por ai\tFPS %.2lf | uniforms: %d enviados, %d ignorados", fps,
+						shader.getUploads(), shader.getSkippedUploads());
 				glfwSetWindowTitle(window, tmp);
 
 				title_countdown_s = 0.1;
@@ -195,6 +230,9 @@ int main()
 		}
 
 		glfwPollEvents();
+		runner.beginFrame();
+		textureManager.update();
+		shader.beginFrame();
 
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
@@ -207,7 +245,7 @@ int main()
 		model = translate(model,background.position);
 		model = rotate(model, radians(0.0f), vec3(0.0, 0.0, 1.0));
 		model = scale(model,background.dimensions);
-		glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+		shader.setMat4(modelLoc, model);
 
 		
 
@@ -216,7 +254,7 @@ int main()
 		
 		offsetTexBg.s = background.iFrame * 0.01;
 		offsetTexBg.t = 0.0;
-		glUniform2f(glGetUniformLocation(shaderID, "offsetTex"),offsetTexBg.s, offsetTexBg.t);
+		shader.setVec2(offsetTexLoc, offsetTexBg);
 
 		glBindVertexArray(background.VAO);
 		glBindTexture(GL_TEXTURE_2D, background.texID);
@@ -228,7 +266,7 @@ int main()
 		model = translate(model,vampirao.position);
 		model = rotate(model, radians(0.0f), vec3(0.0, 0.0, 1.0));
 		model = scale(model,vampirao.dimensions);
-		glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+		shader.setMat4(modelLoc, model);
 
 		vec2 offsetTex;
 		
@@ -242,18 +280,31 @@ int main()
 		
 		offsetTex.s = vampirao.iFrame * vampirao.ds;
 		offsetTex.t = (vampirao.iAnimation) * vampirao.dt;
-		glUniform2f(glGetUniformLocation(shaderID, "offsetTex"),offsetTex.s, offsetTex.t);
+		shader.setVec2(offsetTexLoc, offsetTex);
 
 		glBindVertexArray(vampirao.VAO);
 		glBindTexture(GL_TEXTURE_2D, vampirao.texID);
 
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
+		runner.endFrame();
 		glfwSwapBuffers(window);
 	}
 		
+	textureManager.printReport();
+	runner.setMetric("time_to_first_frame_ms", textureManager.getLoader().getFirstFrameMs());
+	runner.setMetric("time_to_all_assets_ms", textureManager.getLoader().getAllLoadedMs());
+	runner.setMetric("texture_cache_hits", textureManager.getStats().hits);
+	runner.setMetric("texture_cache_misses", textureManager.getStats().misses);
+	runner.setMetric("texture_resident_bytes", textureManager.getStats().residentBytes);
+	programCache.printReport();
+	runner.setMetric("shader_setup_ms", programCache.getTotalMs());
+	runner.setMetric("program_cache_hits", programCache.getStats().hits);
+	runner.finish();
+	geometry.releaseAll();
+	textureManager.releaseAll();
 	glfwTerminate();
-	return 0;
+	return runner.exitStatus();
 }
 
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode)
@@ -299,48 +350,9 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 
 int setupShader()
 {
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-
-    GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
+	// Binário do programa em cache (ver ProgramCache.h): só compila quando o
+	// fonte ou o driver mudam
+	return programCache.build(vertexShaderSource, fragmentShaderSource);
 }
 
 int setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
@@ -357,67 +369,6 @@ int setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
 		 0.5, -0.5, 0.0, ds, 0.0  //V3
 		};
 
-	GLuint VBO, VAO;
-
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	glGenVertexArrays(1, &VAO);
-
-	glBindVertexArray(VAO);
-
-	// Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
-
-	// Ponteiro pro atributo 1 - Coordenada de textura s, t
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-
-	return VAO;
-}
-
-int loadTexture(string filePath, int &width, int &height)
-{
-	GLuint texID;
-
-	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-	int nrChannels;
-
-	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-
-	if (data)
-	{
-		if (nrChannels == 3) // jpg, bmp
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
-		else // png
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
-	}
-
-	stbi_image_free(data);
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	return texID;
+	// x, y, z + s, t (locations 0 e 1)
+	return geometry.acquire(VertexLayout().add(0, 3).add(1, 2), vertices, sizeof(vertices)).VAO;
 }
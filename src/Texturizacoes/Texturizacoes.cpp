@@ -3,6 +3,8 @@
 #include <assert.h>
 #include <cmath>
 #include <vector>
+#include <cstdlib>
+#include <cstring>
 
 using namespace std;
 
@@ -23,6 +25,12 @@ using namespace std;
 
 using namespace glm;
 
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "HeadlessRunner.h"
+#include "ProgramCache.h"
+#include "TextureManager.h"
+
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 
@@ -30,30 +38,45 @@ struct Sprite
 {
 	vec3 position;
 	vec3 dimensions;
-	GLuint VAO;
 	GLuint texID;
+	vec4 uvRect; // região da textura usada pelo sprite (atlas), offset.xy e escala.zw
 };
 
 // Protótipos das funções
 int setupShader();
-int setupSprite();
-int loadTexture(string filePath);
-Sprite createSprite(vec3 position, vec3 dimensions, GLuint texID);
+Sprite createSprite(vec3 position, vec3 dimensions, GLuint texID, vec4 uvRect = vec4(0.0, 0.0, 1.0, 1.0));
+Sprite loadSprite(vec3 position, vec3 dimensions, string asset);
+void runBenchmark(GLFWwindow *window, SpriteBatch &batch, const vector<Sprite> &templates);
+
+// Atlas gerado no build pelo AtlasPacker (alvo "atlas" do CMake); se não
+// existir, cada sprite carrega a sua própria textura
+TextureAtlas atlas;
+
+// Texturas compartilhadas por caminho (carregadas em segundo plano, ver TextureManager.h)
+TextureManager textureManager;
+
+// Quantidade de frames medidos em cada etapa do benchmark (--bench)
+const int BENCH_FRAMES = 200;
 
 // Dimensões da janela
 const GLuint WIDTH = 800, HEIGHT = 600;
 
+// Programas de shader compilados uma vez e reaproveitados do disco
+ProgramCache programCache;
+
 // Código fonte do Vertex Shader (em GLSL): ainda hardcoded
+// model e uvRect chegam por instância, vindos do SpriteBatch
 const GLchar *vertexShaderSource = R"(
  #version 400
  layout (location = 0) in vec3 position;
  layout (location = 1) in vec2 texc;
+ layout (location = 2) in mat4 model;
+ layout (location = 6) in vec4 uvRect;
  out vec2 tex_coord;
  uniform mat4 projection;
- uniform mat4 model;
  void main()
  {
-	tex_coord = texc;
+	tex_coord = uvRect.xy + texc * uvRect.zw;
 	gl_Position = projection * model * vec4(position.x, position.y, position.z, 1.0);
  }
  )";
@@ -70,8 +93,18 @@ const GLchar *fragmentShaderSource = R"(
  }
  )";
 
-int main()
+int main(int argc, char **argv)
 {
+	// --headless --frames N: benchmark sem janela visível (ver HeadlessRunner.h)
+	HeadlessRunner runner(argc, argv);
+
+	bool benchmark = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--bench") == 0)
+			benchmark = true;
+	}
+
 	glfwInit();
 
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
@@ -82,7 +115,7 @@ int main()
 	glfwWindowHint(GLFW_SAMPLES, 8);
 
 	// Criação da janela GLFW
-	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Texturizacoes", nullptr, nullptr);
+	GLFWwindow *window = runner.createWindow(WIDTH, HEIGHT, "Texturizacoes");
 	if (!window)
 	{
 		std::cerr << "Falha ao criar a janela GLFW" << std::endl;
@@ -101,6 +134,8 @@ int main()
 		return -1;
 	}
 
+	runner.attach(window);
+
 	int width, height;
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
@@ -108,16 +143,25 @@ int main()
 	// Compilando e buildando o programa de shader
 	GLuint shaderID = setupShader();
 
+	// Texturas já decodificadas no build (alvo "textures" do CMake); sem o pacote
+	// os PNGs são decodificados na hora
+	textureManager.useBakedPack("baked/textures.pak");
+
+	if (atlas.load("atlas/atlas.bin"))
+		cout << "Atlas carregado: " << atlas.getPageCount() << " pagina(s)" << endl;
+
 	vector<Sprite> sprites;
 
-    sprites.push_back(createSprite(vec3(400, 300, 0), vec3(800, 600, 1),loadTexture("../assets/sprites/sky.png")));
-    sprites.push_back(createSprite(vec3(400, 300, 0), vec3(800, 600, 1),loadTexture("../assets/sprites/aurora.png")));
-    sprites.push_back(createSprite(vec3(150, 150, 0), vec3(200, 150, 1),loadTexture("../assets/sprites/clouds_1.png")));
-    sprites.push_back(createSprite(vec3(650, 150, 0), vec3(200, 150, 1),loadTexture("../assets/sprites/clouds_2.png")));
-    sprites.push_back(createSprite(vec3(400, 500, 0), vec3(800, 200, 1),loadTexture("../assets/sprites/rocks_tex.png")));
-    sprites.push_back(createSprite(vec3(200, 400, 0), vec3(100, 100, 1),loadTexture("../assets/sprites/coruja.png")));
-    sprites.push_back(createSprite(vec3(600, 585, 0), vec3(80, 80, 1),loadTexture("../assets/sprites/vampirinho.png")));
+    sprites.push_back(loadSprite(vec3(400, 300, 0), vec3(800, 600, 1), "sprites/sky.png"));
+    sprites.push_back(loadSprite(vec3(400, 300, 0), vec3(800, 600, 1), "sprites/aurora.png"));
+    sprites.push_back(loadSprite(vec3(150, 150, 0), vec3(200, 150, 1), "sprites/clouds_1.png"));
+    sprites.push_back(loadSprite(vec3(650, 150, 0), vec3(200, 150, 1), "sprites/clouds_2.png"));
+    sprites.push_back(loadSprite(vec3(400, 500, 0), vec3(800, 200, 1), "sprites/rocks_tex.png"));
+    sprites.push_back(loadSprite(vec3(200, 400, 0), vec3(100, 100, 1), "sprites/coruja.png"));
+    sprites.push_back(loadSprite(vec3(600, 585, 0), vec3(80, 80, 1), "sprites/Vampirinho.png"));
                 
+	SpriteBatch batch;
+
 	glUseProgram(shaderID);
 
 	float colorValue = 0.0;
@@ -135,10 +179,23 @@ int main()
 	mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
 	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
 
+	if (benchmark)
+	{
+		textureManager.getLoader().waitAll();
+		runBenchmark(window, batch, sprites);
+		batch.release();
+		atlas.release();
+		textureManager.releaseAll();
+		glfwTerminate();
+		return 0;
+	}
+
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
 		glfwPollEvents();
+		runner.beginFrame();
+		textureManager.update();
 
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
@@ -147,30 +204,38 @@ int main()
 		glLineWidth(10);
 		glPointSize(20);
 
+		// Todos os sprites vão para o mesmo buffer de instâncias; a ordem de
+		// submissão é a ordem de pintura (fundo primeiro)
+		batch.begin();
 		for (Sprite &sprite : sprites)
 		{
-			mat4 model = mat4(1);
-			model = translate(model, sprite.position);
-			model = scale(model, sprite.dimensions);
-			glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-
-			glBindVertexArray(sprite.VAO);
-			glBindTexture(GL_TEXTURE_2D, sprite.texID);
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			batch.draw(sprite.texID, sprite.position, sprite.dimensions, sprite.uvRect);
 		}
+		batch.end();
+
+		runner.endFrame();
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
 	}
+	textureManager.printReport();
+	runner.setMetric("time_to_first_frame_ms", textureManager.getLoader().getFirstFrameMs());
+	runner.setMetric("time_to_all_assets_ms", textureManager.getLoader().getAllLoadedMs());
+	runner.setMetric("texture_cache_hits", textureManager.getStats().hits);
+	runner.setMetric("texture_cache_misses", textureManager.getStats().misses);
+	runner.setMetric("texture_resident_bytes", textureManager.getStats().residentBytes);
+	programCache.printReport();
+	runner.setMetric("shader_setup_ms", programCache.getTotalMs());
+	runner.setMetric("program_cache_hits", programCache.getStats().hits);
+	runner.finish();
 	// Pede pra OpenGL desalocar os buffers
-	for (Sprite &sprite : sprites)
-	{
-		glDeleteVertexArrays(1, &sprite.VAO);
-	}
+	batch.release();
+	atlas.release();
+	textureManager.releaseAll();
 
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
-	return 0;
+	return runner.exitStatus();
 }
 
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode)
@@ -181,132 +246,84 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 
 int setupShader()
 {
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-    
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
+	// Binário do programa em cache (ver ProgramCache.h): só compila quando o
+	// fonte ou o driver mudam
+	return programCache.build(vertexShaderSource, fragmentShaderSource);
 }
 
-int loadTexture(string filePath)
+Sprite createSprite(vec3 position, vec3 dimensions, GLuint texID, vec4 uvRect)
 {
-	GLuint texID;
-
-	// Gera o identificador da textura na memória
-	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-	int width, height, nrChannels;
-
-	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-
-	if (data)
-	{
-		if (nrChannels == 3) // jpg, bmp
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
-		else // png
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
-	}
+    Sprite sprite;
 
-	stbi_image_free(data);
+	sprite.position = position;
+	sprite.dimensions = dimensions;
+	sprite.texID = texID;
+	sprite.uvRect = uvRect;
 
-	glBindTexture(GL_TEXTURE_2D, 0);
+    return sprite;
 
-	return texID;
 }
 
-int setupSprite()
+// asset: caminho relativo a assets/. Usa a região do atlas quando ele foi
+// carregado, senão carrega a textura avulsa como antes
+Sprite loadSprite(vec3 position, vec3 dimensions, string asset)
 {
-	GLfloat vertices[] = {
-		// x   y    z    s     t
-		-0.5,  0.5, 0.0, 0.0, 1.0, //V0
-		-0.5, -0.5, 0.0, 0.0, 0.0, //V1
-		 0.5,  0.5, 0.0, 1.0, 1.0, //V2
-		 0.5, -0.5, 0.0, 1.0, 0.0  //V3
-		};
+	AtlasRegion region;
+	if (atlas.find(asset, region))
+		return createSprite(position, dimensions, region.texID, region.uvRect);
 
-	GLuint VBO, VAO;
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	return createSprite(position, dimensions, textureManager.acquire("../assets/" + asset));
+}
 
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
+// Modo benchmark: desenha 1k, 10k e 100k sprites aleatórios (usando as texturas
+// dos sprites da cena) e mede draw calls e tempo por frame. O glFinish garante
+// que o tempo medido inclui o trabalho da GPU, e o vsync fica desligado.
+void runBenchmark(GLFWwindow *window, SpriteBatch &batch, const vector<Sprite> &templates)
+{
+	const int counts[] = { 1000, 10000, 100000 };
 
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
+	glfwSwapInterval(0);
+	batch.setSortMode(SPRITE_SORT_TEXTURE);
 
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
+	for (int n : counts)
+	{
+		vector<Sprite> sprites;
+		for (int i = 0; i < n; i++)
+		{
+			vec3 position(rand() % WIDTH, rand() % HEIGHT, 0);
+			vec3 dimensions(8 + rand() % 32, 8 + rand() % 32, 1);
+			const Sprite &base = templates[i % templates.size()];
+			sprites.push_back(createSprite(position, dimensions, base.texID, base.uvRect));
+		}
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+		double totalTime = 0.0;
+		int totalDraws = 0;
+		int frames = 0;
+		for (; frames < BENCH_FRAMES && !glfwWindowShouldClose(window); frames++)
+		{
+			glfwPollEvents();
+			double start = glfwGetTime();
+
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			batch.begin();
+			for (Sprite &sprite : sprites)
+			{
+				batch.draw(sprite.texID, sprite.position, sprite.dimensions, sprite.uvRect);
+			}
+			batch.end();
+			glFinish();
+
+			totalTime += glfwGetTime() - start;
+			totalDraws += batch.getDrawCalls();
+			glfwSwapBuffers(window);
+		}
+		if (frames == 0)
+			break;
 
-	return VAO;
+		cout << "sprites: " << n
+			 << " | draws/frame: " << (double)totalDraws / frames
+			 << " | ms/frame: " << totalTime * 1000.0 / frames << endl;
+	}
 
+	batch.setSortMode(SPRITE_SORT_NONE);
 }
-
-Sprite createSprite(vec3 position, vec3 dimensions, GLuint texID)
-{
-    Sprite sprite;
-
-	sprite.position = position;
-	sprite.dimensions = dimensions;
-	sprite.VAO = setupSprite();
-	sprite.texID = texID;
-
-    return sprite;
-
-}
\ No newline at end of file
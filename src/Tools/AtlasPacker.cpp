@@ -0,0 +1,329 @@
+// Empacotador de atlas de texturas (executado durante o build)
+//
+// Lê todos os PNGs das pastas indicadas dentro de assets/, distribui as imagens
+// em uma ou mais páginas (skyline bottom-left, maiores primeiro) com uma borda
+// de "padding" que repete os pixels da borda da imagem, e grava:
+//   - atlas_<n>.png : uma imagem RGBA por página
+//   - atlas.bin     : manifesto binário com o retângulo de cada imagem
+//
+// Uso: AtlasPacker <pasta-assets> <pasta-saida> [--size N] [--padding N] <subpastas...>
+//
+// Formato do atlas.bin (little-endian):
+//   char[4]  "ATLS"
+//   uint32   versão (1)
+//   uint32   quantidade de páginas
+//   uint32   quantidade de imagens
+//   páginas: uint16 largura, uint16 altura, uint8 tamanho do nome, nome
+//   imagens: uint8 tamanho do nome, nome (caminho relativo a assets/, com '/'),
+//            uint16 página, uint16 x, uint16 y, uint16 largura, uint16 altura
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// STB_IMAGE
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+// STB_IMAGE_WRITE
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+struct Image
+{
+	string name;
+	int width, height;
+	unsigned char *pixels; // RGBA
+	int page, x, y;        // posição do retângulo útil (sem o padding)
+};
+
+// Skyline: guarda o "contorno" superior das imagens já colocadas como uma
+// sequência de segmentos horizontais; cada imagem nova vai para o ponto mais
+// baixo (e depois mais à esquerda) onde cabe
+struct SkylineNode
+{
+	int x, y, width;
+};
+
+struct Page
+{
+	int maxSize;
+	int usedWidth = 0, usedHeight = 0;
+	vector<SkylineNode> skyline;
+
+	Page(int size) : maxSize(size)
+	{
+		skyline.push_back({ 0, 0, size });
+	}
+
+	// Altura em que um retângulo de largura w apoiado no nó i ficaria, ou -1
+	int fitAt(size_t i, int w, int h)
+	{
+		int x = skyline[i].x;
+		if (x + w > maxSize)
+			return -1;
+		int y = 0;
+		int remaining = w;
+		while (remaining > 0)
+		{
+			if (i >= skyline.size())
+				return -1;
+			y = max(y, skyline[i].y);
+			if (y + h > maxSize)
+				return -1;
+			remaining -= skyline[i].width;
+			i++;
+		}
+		return y;
+	}
+
+	bool insert(int w, int h, int &outX, int &outY)
+	{
+		int bestY = maxSize, bestX = maxSize;
+		size_t bestIndex = skyline.size();
+		for (size_t i = 0; i < skyline.size(); i++)
+		{
+			int y = fitAt(i, w, h);
+			if (y >= 0 && (y < bestY || (y == bestY && skyline[i].x < bestX)))
+			{
+				bestY = y;
+				bestX = skyline[i].x;
+				bestIndex = i;
+			}
+		}
+		if (bestIndex == skyline.size())
+			return false;
+
+		// Novo segmento no topo do retângulo; os segmentos cobertos encolhem ou somem
+		skyline.insert(skyline.begin() + bestIndex, { bestX, bestY + h, w });
+		for (size_t i = bestIndex + 1; i < skyline.size();)
+		{
+			SkylineNode &prev = skyline[i - 1];
+			int prevEnd = prev.x + prev.width;
+			if (skyline[i].x >= prevEnd)
+				break;
+			int shrink = prevEnd - skyline[i].x;
+			skyline[i].x += shrink;
+			skyline[i].width -= shrink;
+			if (skyline[i].width <= 0)
+				skyline.erase(skyline.begin() + i);
+			else
+				break;
+		}
+		// junta segmentos vizinhos de mesma altura
+		for (size_t i = 0; i + 1 < skyline.size();)
+		{
+			if (skyline[i].y == skyline[i + 1].y)
+			{
+				skyline[i].width += skyline[i + 1].width;
+				skyline.erase(skyline.begin() + i + 1);
+			}
+			else
+				i++;
+		}
+
+		outX = bestX;
+		outY = bestY;
+		usedWidth = max(usedWidth, bestX + w);
+		usedHeight = max(usedHeight, bestY + h);
+		return true;
+	}
+};
+
+// Copia a imagem para a página e repete as bordas dentro do padding, para que a
+// filtragem não "puxe" pixels das imagens vizinhas
+void blit(vector<unsigned char> &page, int pageWidth, int pageHeight, const Image &img, int padding)
+{
+	for (int py = -padding; py < img.height + padding; py++)
+	{
+		int sy = min(max(py, 0), img.height - 1);
+		int dy = img.y + py;
+		if (dy < 0 || dy >= pageHeight)
+			continue;
+		for (int px = -padding; px < img.width + padding; px++)
+		{
+			int sx = min(max(px, 0), img.width - 1);
+			int dx = img.x + px;
+			if (dx < 0 || dx >= pageWidth)
+				continue;
+			memcpy(&page[(dy * pageWidth + dx) * 4], &img.pixels[(sy * img.width + sx) * 4], 4);
+		}
+	}
+}
+
+void writeU16(ofstream &out, int value)
+{
+	unsigned char b[2] = { (unsigned char)(value & 0xFF), (unsigned char)((value >> 8) & 0xFF) };
+	out.write((const char *)b, 2);
+}
+
+void writeU32(ofstream &out, uint32_t value)
+{
+	unsigned char b[4] = { (unsigned char)(value & 0xFF), (unsigned char)((value >> 8) & 0xFF),
+						   (unsigned char)((value >> 16) & 0xFF), (unsigned char)((value >> 24) & 0xFF) };
+	out.write((const char *)b, 4);
+}
+
+void writeName(ofstream &out, const string &name)
+{
+	unsigned char len = (unsigned char)min<size_t>(name.size(), 255);
+	out.write((const char *)&len, 1);
+	out.write(name.data(), len);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 4)
+	{
+		cerr << "Uso: AtlasPacker <pasta-assets> <pasta-saida> [--size N] [--padding N] <subpastas...>" << endl;
+		return 1;
+	}
+
+	fs::path assetsDir = argv[1];
+	fs::path outDir = argv[2];
+	int pageSize = 4096;
+	int padding = 2;
+	vector<string> subdirs;
+	for (int i = 3; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+			pageSize = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--padding") == 0 && i + 1 < argc)
+			padding = atoi(argv[++i]);
+		else
+			subdirs.push_back(argv[i]);
+	}
+
+	// Carrega as imagens (sempre como RGBA)
+	vector<Image> images;
+	for (const string &sub : subdirs)
+	{
+		fs::path dir = assetsDir / sub;
+		if (!fs::exists(dir))
+		{
+			cerr << "Pasta nao encontrada: " << dir << endl;
+			continue;
+		}
+		for (const auto &entry : fs::recursive_directory_iterator(dir))
+		{
+			if (!entry.is_regular_file() || entry.path().extension() != ".png")
+				continue;
+			Image img;
+			int channels;
+			img.pixels = stbi_load(entry.path().string().c_str(), &img.width, &img.height, &channels, 4);
+			if (!img.pixels)
+			{
+				cerr << "Falha ao carregar " << entry.path() << endl;
+				continue;
+			}
+			if (img.width + 2 * padding > pageSize || img.height + 2 * padding > pageSize)
+			{
+				cerr << "Imagem maior que a pagina, ignorada: " << entry.path() << endl;
+				stbi_image_free(img.pixels);
+				continue;
+			}
+			img.name = fs::relative(entry.path(), assetsDir).generic_string();
+			img.page = -1;
+			images.push_back(img);
+		}
+	}
+
+	// Maiores primeiro (altura, depois largura): o skyline desperdiça menos espaço
+	sort(images.begin(), images.end(), [](const Image &a, const Image &b) {
+		if (a.height != b.height)
+			return a.height > b.height;
+		if (a.width != b.width)
+			return a.width > b.width;
+		return a.name < b.name;
+	});
+
+	vector<Page> pages;
+	for (Image &img : images)
+	{
+		int w = img.width + 2 * padding;
+		int h = img.height + 2 * padding;
+		int x, y;
+		for (size_t p = 0; p < pages.size() && img.page < 0; p++)
+		{
+			if (pages[p].insert(w, h, x, y))
+				img.page = (int)p;
+		}
+		if (img.page < 0)
+		{
+			pages.push_back(Page(pageSize));
+			pages.back().insert(w, h, x, y);
+			img.page = (int)pages.size() - 1;
+		}
+		img.x = x + padding;
+		img.y = y + padding;
+	}
+
+	fs::create_directories(outDir);
+
+	// Cada página é recortada para a área realmente usada
+	vector<string> pageNames;
+	for (size_t p = 0; p < pages.size(); p++)
+	{
+		int pw = pages[p].usedWidth, ph = pages[p].usedHeight;
+		vector<unsigned char> pixels((size_t)pw * ph * 4, 0);
+		for (const Image &img : images)
+		{
+			if (img.page == (int)p)
+				blit(pixels, pw, ph, img, padding);
+		}
+		string name = "atlas_" + to_string(p) + ".png";
+		if (!stbi_write_png((outDir / name).string().c_str(), pw, ph, 4, pixels.data(), pw * 4))
+		{
+			cerr << "Falha ao gravar " << name << endl;
+			return 1;
+		}
+		pageNames.push_back(name);
+	}
+
+	ofstream out(outDir / "atlas.bin", ios::binary);
+	if (!out)
+	{
+		cerr << "Falha ao gravar atlas.bin" << endl;
+		return 1;
+	}
+	out.write("ATLS", 4);
+	writeU32(out, 1);
+	writeU32(out, (uint32_t)pages.size());
+	writeU32(out, (uint32_t)images.size());
+	for (size_t p = 0; p < pages.size(); p++)
+	{
+		writeU16(out, pages[p].usedWidth);
+		writeU16(out, pages[p].usedHeight);
+		writeName(out, pageNames[p]);
+	}
+	for (const Image &img : images)
+	{
+		writeName(out, img.name);
+		writeU16(out, img.page);
+		writeU16(out, img.x);
+		writeU16(out, img.y);
+		writeU16(out, img.width);
+		writeU16(out, img.height);
+	}
+
+	long long usedArea = 0, pageArea = 0;
+	for (const Image &img : images)
+		usedArea += (long long)img.width * img.height;
+	for (const Page &page : pages)
+		pageArea += (long long)page.usedWidth * page.usedHeight;
+	cout << images.size() << " imagens em " << pages.size() << " pagina(s), ocupacao "
+		 << (pageArea ? 100.0 * usedArea / pageArea : 0.0) << "%" << endl;
+
+	for (Image &img : images)
+		stbi_image_free(img.pixels);
+	return 0;
+}
@@ -0,0 +1,1095 @@
+// Compressão de texturas em blocos 4x4 (usada pelo TextureBaker)
+//
+// Codificadores para os formatos que as placas de vídeo leem direto:
+//   BC1  (DXT1)  8 bytes/bloco: duas cores 565 + 2 bits por pixel; no modo de
+//                3 cores o índice 3 é transparente (alfa de 1 bit)
+//   BC3  (DXT5) 16 bytes/bloco: alfa em 8 bytes (dois extremos + 3 bits por
+//                pixel) + cor BC1
+//   BC7         16 bytes/bloco: modo 6 (um subconjunto, RGBA 7777 + bit p,
+//                4 bits por pixel) ou, nos blocos em que o alfa varia, modo 5
+//                (cor e alfa com índices separados)
+//   ETC2        cor nos modos "individual" e "diferencial" do ETC1 (8 bytes) e,
+//                no RGBA8, alfa EAC (mais 8 bytes)
+//
+// Os extremos de cada bloco saem do eixo principal das cores (PCA) e são
+// refinados por mínimos quadrados com os índices escolhidos. Nos formatos com
+// alfa, a cor de um pixel pesa proporcionalmente ao seu alfa: a cor de um pixel
+// transparente não aparece na tela.
+//
+// Os decodificadores existem para medir a qualidade (PSNR) do resultado.
+
+#ifndef BlockCompress_h
+#define BlockCompress_h
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+// 16 pixels RGBA, linha a linha (pixel y * 4 + x)
+struct Block
+{
+	unsigned char px[16][4];
+};
+
+// Bloco (bx, by) da imagem; fora da imagem repete a última linha/coluna
+inline void loadBlock(const unsigned char *rgba, int width, int height, int bx, int by, Block &block)
+{
+	for (int y = 0; y < 4; y++)
+	{
+		int sy = std::min(by * 4 + y, height - 1);
+		for (int x = 0; x < 4; x++)
+		{
+			int sx = std::min(bx * 4 + x, width - 1);
+			memcpy(block.px[y * 4 + x], &rgba[((size_t)sy * width + sx) * 4], 4);
+		}
+	}
+}
+
+inline void storeBlock(const Block &block, unsigned char *rgba, int width, int height, int bx, int by)
+{
+	for (int y = 0; y < 4 && by * 4 + y < height; y++)
+	{
+		for (int x = 0; x < 4 && bx * 4 + x < width; x++)
+			memcpy(&rgba[((size_t)(by * 4 + y) * width + bx * 4 + x) * 4], block.px[y * 4 + x], 4);
+	}
+}
+
+inline int clampByte(int v)
+{
+	return v < 0 ? 0 : v > 255 ? 255 : v;
+}
+
+// ---------------------------------------------------------------------------
+// Ajuste dos extremos
+
+// Extremos (e0, e1) da reta que melhor aproxima os pixels com peso w[i] > 0,
+// em "channels" canais (3 = RGB, 4 = RGBA)
+inline void principalEndpoints(const Block &block, const float *w, int channels, float *e0, float *e1)
+{
+	float mean[4] = { 0, 0, 0, 0 }, total = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < channels; c++)
+			mean[c] += w[i] * block.px[i][c];
+		total += w[i];
+	}
+	if (total <= 0)
+	{
+		for (int c = 0; c < channels; c++)
+			e0[c] = e1[c] = 0;
+		return;
+	}
+	for (int c = 0; c < channels; c++)
+		mean[c] /= total;
+
+	float cov[4][4] = {};
+	for (int i = 0; i < 16; i++)
+	{
+		float d[4];
+		for (int c = 0; c < channels; c++)
+			d[c] = block.px[i][c] - mean[c];
+		for (int a = 0; a < channels; a++)
+			for (int b = 0; b < channels; b++)
+				cov[a][b] += w[i] * d[a] * d[b];
+	}
+
+	// Iteração de potência a partir da diagonal da caixa envolvente
+	float axis[4] = { 1, 1, 1, 1 };
+	for (int it = 0; it < 8; it++)
+	{
+		float next[4] = { 0, 0, 0, 0 }, len = 0;
+		for (int a = 0; a < channels; a++)
+		{
+			for (int b = 0; b < channels; b++)
+				next[a] += cov[a][b] * axis[b];
+			len += next[a] * next[a];
+		}
+		if (len <= 1e-12f)
+			break;
+		len = std::sqrt(len);
+		for (int c = 0; c < channels; c++)
+			axis[c] = next[c] / len;
+	}
+
+	float tMin = 1e30f, tMax = -1e30f;
+	for (int i = 0; i < 16; i++)
+	{
+		if (w[i] <= 0)
+			continue;
+		float t = 0;
+		for (int c = 0; c < channels; c++)
+			t += (block.px[i][c] - mean[c]) * axis[c];
+		tMin = std::min(tMin, t);
+		tMax = std::max(tMax, t);
+	}
+	for (int c = 0; c < channels; c++)
+	{
+		e0[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * tMax));
+		e1[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * tMin));
+	}
+}
+
+// Mínimos quadrados: dados os índices (peso t[i] de e1 na interpolação),
+// os extremos que minimizam o erro. Retorna false se o sistema é singular
+inline bool refineEndpoints(const Block &block, const float *w, const float *t, int channels, float *e0, float *e1)
+{
+	float A = 0, B = 0, C = 0, X[4] = { 0, 0, 0, 0 }, Y[4] = { 0, 0, 0, 0 };
+	for (int i = 0; i < 16; i++)
+	{
+		float s = 1 - t[i];
+		A += w[i] * s * s;
+		B += w[i] * s * t[i];
+		C += w[i] * t[i] * t[i];
+		for (int c = 0; c < channels; c++)
+		{
+			X[c] += w[i] * s * block.px[i][c];
+			Y[c] += w[i] * t[i] * block.px[i][c];
+		}
+	}
+	float det = A * C - B * B;
+	if (std::fabs(det) < 1e-6f)
+		return false;
+	for (int c = 0; c < channels; c++)
+	{
+		e0[c] = std::min(255.0f, std::max(0.0f, (C * X[c] - B * Y[c]) / det));
+		e1[c] = std::min(255.0f, std::max(0.0f, (A * Y[c] - B * X[c]) / det));
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// BC1 (cor) e BC3 (alfa)
+
+inline uint16_t pack565(const float *c)
+{
+	int r = (int)(c[0] * 31 / 255 + 0.5f), g = (int)(c[1] * 63 / 255 + 0.5f), b = (int)(c[2] * 31 / 255 + 0.5f);
+	return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+inline void unpack565(uint16_t v, int *c)
+{
+	int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+	c[0] = (r << 3) | (r >> 2);
+	c[1] = (g << 2) | (g >> 4);
+	c[2] = (b << 3) | (b >> 2);
+}
+
+// Paleta de 4 cores (c0 > c1) ou 3 cores + transparente (c0 <= c1)
+inline void bc1Palette(uint16_t c0, uint16_t c1, bool fourColor, int palette[4][4])
+{
+	unpack565(c0, palette[0]);
+	unpack565(c1, palette[1]);
+	palette[0][3] = palette[1][3] = 255;
+	for (int c = 0; c < 3; c++)
+	{
+		if (fourColor)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+		else
+		{
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = fourColor ? 255 : 0;
+}
+
+// Índices mais próximos (só RGB) para os pixels com peso; retorna o erro
+inline float bc1Indices(const Block &block, const float *w, const int palette[4][4], int colors, int *index)
+{
+	float error = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int best = 0, bestDist = 1 << 30;
+		for (int k = 0; k < colors; k++)
+		{
+			int dr = block.px[i][0] - palette[k][0], dg = block.px[i][1] - palette[k][1], db = block.px[i][2] - palette[k][2];
+			int dist = dr * dr + dg * dg + db * db;
+			if (dist < bestDist)
+			{
+				bestDist = dist;
+				best = k;
+			}
+		}
+		index[i] = best;
+		error += w[i] * bestDist;
+	}
+	return error;
+}
+
+// Bloco de cor BC1. transparent[i] marca os pixels que devem usar o índice 3
+// transparente (só com punchThrough); w[i] é o peso da cor de cada pixel.
+// Com forceFourColor (cor do BC3) a paleta é sempre a de 4 cores
+inline void encodeBC1Color(const Block &block, const float *weights, bool punchThrough, bool forceFourColor, uint8_t *out)
+{
+	bool transparent[16];
+	bool anyTransparent = false;
+	float w[16];
+	for (int i = 0; i < 16; i++)
+	{
+		transparent[i] = punchThrough && block.px[i][3] < 128;
+		anyTransparent = anyTransparent || transparent[i];
+		w[i] = transparent[i] ? 0.0f : weights[i];
+	}
+	bool fourColor = forceFourColor || !anyTransparent;
+	int colors = fourColor ? 4 : 3;
+	// peso de e1 para cada índice da paleta
+	const float tFour[4] = { 0.0f, 1.0f, 1.0f / 3, 2.0f / 3 };
+	const float tThree[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+	const float *tOf = fourColor ? tFour : tThree;
+
+	float e0[4], e1[4];
+	principalEndpoints(block, w, 3, e0, e1);
+
+	int index[16];
+	uint16_t c0 = 0, c1 = 0;
+	for (int pass = 0; pass < 3; pass++)
+	{
+		c0 = pack565(e0);
+		c1 = pack565(e1);
+		int palette[4][4];
+		bc1Palette(c0, c1, fourColor, palette);
+		bc1Indices(block, w, palette, colors, index);
+		float t[16];
+		for (int i = 0; i < 16; i++)
+			t[i] = tOf[index[i]];
+		if (pass < 2 && !refineEndpoints(block, w, t, 3, e0, e1))
+			break;
+	}
+
+	// Ordem dos extremos decide o modo: c0 > c1 são 4 cores, c0 <= c1 são 3
+	if (fourColor && c0 < c1)
+		std::swap(c0, c1);
+	if (!fourColor && c0 > c1)
+		std::swap(c0, c1);
+	int palette[4][4];
+	bc1Palette(c0, c1, fourColor || c0 > c1, palette);
+	bc1Indices(block, w, palette, colors, index);
+	uint32_t bits = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int k = transparent[i] ? 3 : index[i];
+		if (fourColor && c0 == c1 && !forceFourColor)
+			k = 0; // c0 == c1 cai no modo de 3 cores: só o índice 0 é seguro
+		bits |= (uint32_t)k << (2 * i);
+	}
+	out[0] = c0 & 0xFF;
+	out[1] = c0 >> 8;
+	out[2] = c1 & 0xFF;
+	out[3] = c1 >> 8;
+	for (int b = 0; b < 4; b++)
+		out[4 + b] = (bits >> (8 * b)) & 0xFF;
+}
+
+inline void decodeBC1Color(const uint8_t *in, bool forceFourColor, Block &block)
+{
+	uint16_t c0 = in[0] | (in[1] << 8), c1 = in[2] | (in[3] << 8);
+	uint32_t bits = in[4] | (in[5] << 8) | (in[6] << 16) | ((uint32_t)in[7] << 24);
+	int palette[4][4];
+	bc1Palette(c0, c1, forceFourColor || c0 > c1, palette);
+	for (int i = 0; i < 16; i++)
+	{
+		int k = (bits >> (2 * i)) & 3;
+		for (int c = 0; c < 4; c++)
+			block.px[i][c] = (unsigned char)palette[k][c];
+	}
+}
+
+inline void bc3AlphaPalette(int a0, int a1, int palette[8])
+{
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1)
+	{
+		for (int j = 1; j <= 6; j++)
+			palette[j + 1] = ((7 - j) * a0 + j * a1) / 7;
+	}
+	else
+	{
+		for (int j = 1; j <= 4; j++)
+			palette[j + 1] = ((5 - j) * a0 + j * a1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+inline int bc3AlphaIndices(const Block &block, const int palette[8], int *index)
+{
+	int error = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int best = 0, bestDist = 1 << 30;
+		for (int k = 0; k < 8; k++)
+		{
+			int d = block.px[i][3] - palette[k];
+			if (d * d < bestDist)
+			{
+				bestDist = d * d;
+				best = k;
+			}
+		}
+		index[i] = best;
+		error += bestDist;
+	}
+	return error;
+}
+
+// Bloco de alfa do BC3: testa o modo de 8 valores (a0 > a1) e o de 6 valores
+// com 0 e 255 explícitos, e fica com o de menor erro
+inline void encodeBC3Alpha(const Block &block, uint8_t *out)
+{
+	int lo = 255, hi = 0, innerLo = 255, innerHi = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int a = block.px[i][3];
+		lo = std::min(lo, a);
+		hi = std::max(hi, a);
+		if (a != 0 && a != 255)
+		{
+			innerLo = std::min(innerLo, a);
+			innerHi = std::max(innerHi, a);
+		}
+	}
+	int palette[8], index[16], best[16];
+	int a0 = hi, a1 = lo;
+	bc3AlphaPalette(a0, a1, palette);
+	int bestError = bc3AlphaIndices(block, palette, best);
+	if (innerLo <= innerHi)
+	{
+		bc3AlphaPalette(innerLo, innerHi, palette);
+		int error = bc3AlphaIndices(block, palette, index);
+		if (error < bestError)
+		{
+			bestError = error;
+			a0 = innerLo;
+			a1 = innerHi;
+			memcpy(best, index, sizeof(best));
+		}
+	}
+	out[0] = (uint8_t)a0;
+	out[1] = (uint8_t)a1;
+	uint64_t bits = 0;
+	for (int i = 0; i < 16; i++)
+		bits |= (uint64_t)best[i] << (3 * i);
+	for (int b = 0; b < 6; b++)
+		out[2 + b] = (bits >> (8 * b)) & 0xFF;
+}
+
+inline void decodeBC3Alpha(const uint8_t *in, Block &block)
+{
+	int palette[8];
+	bc3AlphaPalette(in[0], in[1], palette);
+	uint64_t bits = 0;
+	for (int b = 0; b < 6; b++)
+		bits |= (uint64_t)in[2 + b] << (8 * b);
+	for (int i = 0; i < 16; i++)
+		block.px[i][3] = (unsigned char)palette[(bits >> (3 * i)) & 7];
+}
+
+// Peso da cor de cada pixel nos formatos com alfa
+inline void alphaWeights(const Block &block, float *w)
+{
+	for (int i = 0; i < 16; i++)
+		w[i] = (block.px[i][3] + 1) / 256.0f;
+}
+
+inline void encodeBC1(const Block &block, bool punchThrough, uint8_t *out)
+{
+	float w[16];
+	std::fill(w, w + 16, 1.0f);
+	encodeBC1Color(block, w, punchThrough, false, out);
+}
+
+inline void decodeBC1(const uint8_t *in, Block &block)
+{
+	decodeBC1Color(in, false, block);
+}
+
+inline void encodeBC3(const Block &block, uint8_t *out)
+{
+	float w[16];
+	alphaWeights(block, w);
+	encodeBC3Alpha(block, out);
+	encodeBC1Color(block, w, false, true, out + 8);
+}
+
+inline void decodeBC3(const uint8_t *in, Block &block)
+{
+	decodeBC1Color(in + 8, true, block);
+	decodeBC3Alpha(in, block);
+}
+
+// ---------------------------------------------------------------------------
+// BC7 modo 6
+
+static const int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Extremo de 7 bits por canal + bit p comum: o p que erra menos
+inline void bc7Quantize(const float *e, int *q, int &p)
+{
+	float bestError = 1e30f;
+	for (int bit = 0; bit < 2; bit++)
+	{
+		int cand[4];
+		float error = 0;
+		for (int c = 0; c < 4; c++)
+		{
+			cand[c] = std::min(127, std::max(0, (int)std::floor((e[c] - bit) / 2 + 0.5f)));
+			float d = e[c] - ((cand[c] << 1) | bit);
+			error += d * d;
+		}
+		if (error < bestError)
+		{
+			bestError = error;
+			p = bit;
+			memcpy(q, cand, sizeof(cand));
+		}
+	}
+}
+
+inline void bc7Palette(const int *q0, int p0, const int *q1, int p1, int palette[16][4])
+{
+	for (int k = 0; k < 16; k++)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			int a = (q0[c] << 1) | p0, b = (q1[c] << 1) | p1;
+			palette[k][c] = ((64 - BC7_WEIGHTS4[k]) * a + BC7_WEIGHTS4[k] * b + 32) >> 6;
+		}
+	}
+}
+
+inline float bc7Indices(const Block &block, const int palette[16][4], int *index)
+{
+	float error = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int best = 0, bestDist = 1 << 30;
+		for (int k = 0; k < 16; k++)
+		{
+			int dist = 0;
+			for (int c = 0; c < 4; c++)
+			{
+				int d = block.px[i][c] - palette[k][c];
+				dist += d * d;
+			}
+			if (dist < bestDist)
+			{
+				bestDist = dist;
+				best = k;
+			}
+		}
+		index[i] = best;
+		error += bestDist;
+	}
+	return error;
+}
+
+struct BitWriter
+{
+	uint8_t *out;
+	int pos;
+
+	void put(uint32_t value, int bits)
+	{
+		for (int b = 0; b < bits; b++, pos++)
+		{
+			if ((value >> b) & 1)
+				out[pos >> 3] |= (uint8_t)(1 << (pos & 7));
+		}
+	}
+};
+
+struct BitReader
+{
+	const uint8_t *in;
+	int pos;
+
+	uint32_t get(int bits)
+	{
+		uint32_t value = 0;
+		for (int b = 0; b < bits; b++, pos++)
+			value |= (uint32_t)((in[pos >> 3] >> (pos & 7)) & 1) << b;
+		return value;
+	}
+};
+
+// Modo 6: RGBA numa reta só, 4 bits por pixel. Retorna o erro
+inline float encodeBC7Mode6(const Block &block, uint8_t *out)
+{
+	float w[16];
+	std::fill(w, w + 16, 1.0f);
+	float e0[4], e1[4];
+	principalEndpoints(block, w, 4, e0, e1);
+
+	int q0[4], q1[4], p0 = 0, p1 = 0, index[16];
+	int palette[16][4];
+	float error = 0;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		bc7Quantize(e0, q0, p0);
+		bc7Quantize(e1, q1, p1);
+		bc7Palette(q0, p0, q1, p1, palette);
+		error = bc7Indices(block, palette, index);
+		float t[16];
+		for (int i = 0; i < 16; i++)
+			t[i] = BC7_WEIGHTS4[index[i]] / 64.0f;
+		if (pass == 0 && !refineEndpoints(block, w, t, 4, e0, e1))
+			break;
+	}
+
+	// O índice do pixel 0 é gravado com 3 bits: o bit alto tem que ser 0
+	if (index[0] & 8)
+	{
+		std::swap(q0, q1);
+		std::swap(p0, p1);
+		for (int i = 0; i < 16; i++)
+			index[i] = 15 - index[i];
+	}
+
+	memset(out, 0, 16);
+	BitWriter bits = { out, 0 };
+	bits.put(1 << 6, 7); // modo 6
+	for (int c = 0; c < 4; c++)
+	{
+		bits.put(q0[c], 7);
+		bits.put(q1[c], 7);
+	}
+	bits.put(p0, 1);
+	bits.put(p1, 1);
+	bits.put(index[0], 3);
+	for (int i = 1; i < 16; i++)
+		bits.put(index[i], 4);
+	return error;
+}
+
+static const int BC7_WEIGHTS2[4] = { 0, 21, 43, 64 };
+
+inline int bc7Interpolate2(int a, int b, int k)
+{
+	return ((64 - BC7_WEIGHTS2[k]) * a + BC7_WEIGHTS2[k] * b + 32) >> 6;
+}
+
+// Modo 5: cor (RGB 777) e alfa (8 bits) com índices separados de 2 bits.
+// Cobre os blocos em que o alfa não acompanha a cor (bordas de sprites),
+// onde a reta única do modo 6 erra muito. Retorna o erro
+inline float encodeBC7Mode5(const Block &block, uint8_t *out)
+{
+	float w[16];
+	std::fill(w, w + 16, 1.0f);
+	float e0[4], e1[4];
+	principalEndpoints(block, w, 3, e0, e1);
+
+	int q0[3], q1[3], colorIndex[16];
+	float colorError = 0;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		int palette[4][3];
+		for (int c = 0; c < 3; c++)
+		{
+			q0[c] = std::min(127, (int)(e0[c] * 127 / 255 + 0.5f));
+			q1[c] = std::min(127, (int)(e1[c] * 127 / 255 + 0.5f));
+			for (int k = 0; k < 4; k++)
+				palette[k][c] = bc7Interpolate2(q0[c] << 1 | q0[c] >> 6, q1[c] << 1 | q1[c] >> 6, k);
+		}
+		colorError = 0;
+		float t[16];
+		for (int i = 0; i < 16; i++)
+		{
+			int bestDist = 1 << 30;
+			for (int k = 0; k < 4; k++)
+			{
+				int dist = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					int d = block.px[i][c] - palette[k][c];
+					dist += d * d;
+				}
+				if (dist < bestDist)
+				{
+					bestDist = dist;
+					colorIndex[i] = k;
+				}
+			}
+			colorError += bestDist;
+			t[i] = BC7_WEIGHTS2[colorIndex[i]] / 64.0f;
+		}
+		if (pass == 0 && !refineEndpoints(block, w, t, 3, e0, e1))
+			break;
+	}
+
+	int a0 = 255, a1 = 0, alphaIndex[16];
+	for (int i = 0; i < 16; i++)
+	{
+		a0 = std::min(a0, (int)block.px[i][3]);
+		a1 = std::max(a1, (int)block.px[i][3]);
+	}
+	float alphaError = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int bestDist = 1 << 30;
+		for (int k = 0; k < 4; k++)
+		{
+			int d = block.px[i][3] - bc7Interpolate2(a0, a1, k);
+			if (d * d < bestDist)
+			{
+				bestDist = d * d;
+				alphaIndex[i] = k;
+			}
+		}
+		alphaError += bestDist;
+	}
+
+	// Índices do pixel 0 gravados com 1 bit
+	if (colorIndex[0] & 2)
+	{
+		std::swap(q0, q1);
+		for (int i = 0; i < 16; i++)
+			colorIndex[i] = 3 - colorIndex[i];
+	}
+	if (alphaIndex[0] & 2)
+	{
+		std::swap(a0, a1);
+		for (int i = 0; i < 16; i++)
+			alphaIndex[i] = 3 - alphaIndex[i];
+	}
+
+	memset(out, 0, 16);
+	BitWriter bits = { out, 0 };
+	bits.put(1 << 5, 6); // modo 5
+	bits.put(0, 2);      // sem rotação de canais
+	for (int c = 0; c < 3; c++)
+	{
+		bits.put(q0[c], 7);
+		bits.put(q1[c], 7);
+	}
+	bits.put(a0, 8);
+	bits.put(a1, 8);
+	for (int i = 0; i < 16; i++)
+		bits.put(colorIndex[i], i == 0 ? 1 : 2);
+	for (int i = 0; i < 16; i++)
+		bits.put(alphaIndex[i], i == 0 ? 1 : 2);
+	return colorError + alphaError;
+}
+
+// Modo 6, ou modo 5 quando o alfa varia e o modo 5 erra menos
+inline void encodeBC7(const Block &block, uint8_t *out)
+{
+	float error = encodeBC7Mode6(block, out);
+	bool alphaVaries = false;
+	for (int i = 1; i < 16; i++)
+		alphaVaries = alphaVaries || block.px[i][3] != block.px[0][3];
+	if (alphaVaries)
+	{
+		uint8_t other[16];
+		if (encodeBC7Mode5(block, other) < error)
+			memcpy(out, other, 16);
+	}
+}
+
+// Só os modos 5 e 6 (os que o encodeBC7 gera); outros modos saem pretos
+inline void decodeBC7(const uint8_t *in, Block &block)
+{
+	memset(block.px, 0, sizeof(block.px));
+	if ((in[0] & 0x7F) == 0x40)
+	{
+		BitReader bits = { in, 7 };
+		int q0[4], q1[4];
+		for (int c = 0; c < 4; c++)
+		{
+			q0[c] = bits.get(7);
+			q1[c] = bits.get(7);
+		}
+		int p0 = bits.get(1), p1 = bits.get(1);
+		int palette[16][4];
+		bc7Palette(q0, p0, q1, p1, palette);
+		for (int i = 0; i < 16; i++)
+		{
+			int k = bits.get(i == 0 ? 3 : 4);
+			for (int c = 0; c < 4; c++)
+				block.px[i][c] = (unsigned char)palette[k][c];
+		}
+	}
+	else if ((in[0] & 0x3F) == 0x20)
+	{
+		BitReader bits = { in, 6 };
+		int rotation = bits.get(2), e0[4], e1[4];
+		for (int c = 0; c < 3; c++)
+		{
+			int a = bits.get(7), b = bits.get(7);
+			e0[c] = a << 1 | a >> 6;
+			e1[c] = b << 1 | b >> 6;
+		}
+		e0[3] = bits.get(8);
+		e1[3] = bits.get(8);
+		for (int i = 0; i < 16; i++)
+		{
+			int k = bits.get(i == 0 ? 1 : 2);
+			for (int c = 0; c < 3; c++)
+				block.px[i][c] = (unsigned char)bc7Interpolate2(e0[c], e1[c], k);
+		}
+		for (int i = 0; i < 16; i++)
+		{
+			int k = bits.get(i == 0 ? 1 : 2);
+			block.px[i][3] = (unsigned char)bc7Interpolate2(e0[3], e1[3], k);
+			if (rotation)
+				std::swap(block.px[i][3], block.px[i][rotation - 1]);
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+// ETC2: cor (modos individual e diferencial do ETC1) e alfa EAC
+
+// Modificadores de cada tabela; índice do pixel 0..3 = +a, +b, -a, -b
+static const int ETC_MODIFIERS[8][4] = {
+	{ 2, 8, -2, -8 }, { 5, 17, -5, -17 }, { 9, 29, -9, -29 }, { 13, 42, -13, -42 },
+	{ 18, 60, -18, -60 }, { 24, 80, -24, -80 }, { 33, 106, -33, -106 }, { 47, 183, -47, -183 }
+};
+
+static const int EAC_MODIFIERS[16][8] = {
+	{ -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 }, { -2, -5, -8, -13, 1, 4, 7, 12 },
+	{ -2, -4, -6, -13, 1, 3, 5, 12 }, { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+	{ -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 }, { -2, -6, -8, -10, 1, 5, 7, 9 },
+	{ -2, -5, -8, -10, 1, 4, 7, 9 }, { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+	{ -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 }, { -4, -6, -8, -9, 3, 5, 7, 8 },
+	{ -3, -5, -7, -9, 2, 4, 6, 8 }
+};
+
+// Pixels de cada metade do bloco (índice y * 4 + x): flip 0 divide em
+// colunas 0-1 / 2-3, flip 1 em linhas 0-1 / 2-3
+inline void etcSubblock(int flip, int half, int *pixels)
+{
+	int n = 0;
+	for (int y = 0; y < 4; y++)
+	{
+		for (int x = 0; x < 4; x++)
+		{
+			int side = flip ? y / 2 : x / 2;
+			if (side == half)
+				pixels[n++] = y * 4 + x;
+		}
+	}
+}
+
+struct EtcChoice
+{
+	float error;
+	int table;
+	int index[8];
+};
+
+// Melhor tabela para uma metade com a cor base dada (já expandida para 8 bits)
+inline EtcChoice etcBestTable(const Block &block, const float *w, const int *pixels, const int *base)
+{
+	EtcChoice best;
+	best.error = 1e30f;
+	for (int table = 0; table < 8; table++)
+	{
+		EtcChoice cur;
+		cur.error = 0;
+		cur.table = table;
+		for (int n = 0; n < 8; n++)
+		{
+			const unsigned char *p = block.px[pixels[n]];
+			int bestDist = 1 << 30;
+			for (int k = 0; k < 4; k++)
+			{
+				int m = ETC_MODIFIERS[table][k], dist = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					int d = p[c] - clampByte(base[c] + m);
+					dist += d * d;
+				}
+				if (dist < bestDist)
+				{
+					bestDist = dist;
+					cur.index[n] = k;
+				}
+			}
+			cur.error += w[pixels[n]] * bestDist;
+		}
+		if (cur.error < best.error)
+			best = cur;
+	}
+	return best;
+}
+
+inline void etcAverage(const Block &block, const float *w, const int *pixels, float *avg)
+{
+	float total = 0;
+	avg[0] = avg[1] = avg[2] = 0;
+	for (int n = 0; n < 8; n++)
+	{
+		for (int c = 0; c < 3; c++)
+			avg[c] += w[pixels[n]] * block.px[pixels[n]][c];
+		total += w[pixels[n]];
+	}
+	for (int c = 0; c < 3; c++)
+		avg[c] = total > 0 ? avg[c] / total : 0;
+}
+
+inline void encodeETC2Color(const Block &block, const float *w, uint8_t *out)
+{
+	float bestError = 1e30f;
+	uint64_t bestBits = 0;
+
+	for (int flip = 0; flip < 2; flip++)
+	{
+		int pixels[2][8];
+		float avg[2][3];
+		for (int half = 0; half < 2; half++)
+		{
+			etcSubblock(flip, half, pixels[half]);
+			etcAverage(block, w, pixels[half], avg[half]);
+		}
+
+		// Individual: cada metade com a sua cor RGB444
+		{
+			int q[2][3];
+			EtcChoice choice[2];
+			for (int half = 0; half < 2; half++)
+			{
+				choice[half].error = 1e30f;
+				for (int d = -1; d <= 1; d++)
+				{
+					int cand[3], base[3];
+					for (int c = 0; c < 3; c++)
+					{
+						cand[c] = std::min(15, std::max(0, (int)(avg[half][c] * 15 / 255 + 0.5f) + d));
+						base[c] = cand[c] << 4 | cand[c];
+					}
+					EtcChoice cur = etcBestTable(block, w, pixels[half], base);
+					if (cur.error < choice[half].error)
+					{
+						choice[half] = cur;
+						memcpy(q[half], cand, sizeof(cand));
+					}
+				}
+			}
+			float error = choice[0].error + choice[1].error;
+			if (error < bestError)
+			{
+				bestError = error;
+				uint64_t bits = 0;
+				bits |= (uint64_t)q[0][0] << 60 | (uint64_t)q[1][0] << 56;
+				bits |= (uint64_t)q[0][1] << 52 | (uint64_t)q[1][1] << 48;
+				bits |= (uint64_t)q[0][2] << 44 | (uint64_t)q[1][2] << 40;
+				bits |= (uint64_t)choice[0].table << 37 | (uint64_t)choice[1].table << 34;
+				bits |= (uint64_t)flip << 32;
+				for (int half = 0; half < 2; half++)
+				{
+					for (int n = 0; n < 8; n++)
+					{
+						int p = pixels[half][n], i = (p % 4) * 4 + p / 4; // coluna a coluna
+						int k = choice[half].index[n];
+						bits |= (uint64_t)(k >> 1) << (16 + i) | (uint64_t)(k & 1) << i;
+					}
+				}
+				bestBits = bits;
+			}
+		}
+
+		// Diferencial: RGB555 + diferença de -4 a 3 para a segunda metade
+		{
+			int cand[2][3][3];
+			EtcChoice choice[2][3];
+			for (int half = 0; half < 2; half++)
+			{
+				for (int d = 0; d < 3; d++)
+				{
+					int base[3];
+					for (int c = 0; c < 3; c++)
+					{
+						cand[half][d][c] = std::min(31, std::max(0, (int)(avg[half][c] * 31 / 255 + 0.5f) + d - 1));
+						base[c] = cand[half][d][c] << 3 | cand[half][d][c] >> 2;
+					}
+					choice[half][d] = etcBestTable(block, w, pixels[half], base);
+				}
+			}
+			for (int d0 = 0; d0 < 3; d0++)
+			{
+				for (int d1 = 0; d1 < 3; d1++)
+				{
+					int delta[3];
+					bool valid = true;
+					for (int c = 0; c < 3; c++)
+					{
+						delta[c] = cand[1][d1][c] - cand[0][d0][c];
+						valid = valid && delta[c] >= -4 && delta[c] <= 3;
+					}
+					float error = choice[0][d0].error + choice[1][d1].error;
+					if (!valid || error >= bestError)
+						continue;
+					bestError = error;
+					uint64_t bits = 0;
+					bits |= (uint64_t)cand[0][d0][0] << 59 | (uint64_t)(delta[0] & 7) << 56;
+					bits |= (uint64_t)cand[0][d0][1] << 51 | (uint64_t)(delta[1] & 7) << 48;
+					bits |= (uint64_t)cand[0][d0][2] << 43 | (uint64_t)(delta[2] & 7) << 40;
+					bits |= (uint64_t)choice[0][d0].table << 37 | (uint64_t)choice[1][d1].table << 34;
+					bits |= (uint64_t)1 << 33 | (uint64_t)flip << 32;
+					const EtcChoice *chosen[2] = { &choice[0][d0], &choice[1][d1] };
+					for (int half = 0; half < 2; half++)
+					{
+						for (int n = 0; n < 8; n++)
+						{
+							int p = pixels[half][n], i = (p % 4) * 4 + p / 4;
+							int k = chosen[half]->index[n];
+							bits |= (uint64_t)(k >> 1) << (16 + i) | (uint64_t)(k & 1) << i;
+						}
+					}
+					bestBits = bits;
+				}
+			}
+		}
+	}
+
+	for (int b = 0; b < 8; b++)
+		out[b] = (bestBits >> (56 - 8 * b)) & 0xFF;
+}
+
+// Só os modos individual e diferencial (os que o encodeETC2Color gera)
+inline void decodeETC2Color(const uint8_t *in, Block &block)
+{
+	uint64_t bits = 0;
+	for (int b = 0; b < 8; b++)
+		bits = bits << 8 | in[b];
+	bool diff = (bits >> 33) & 1, flip = (bits >> 32) & 1;
+	int base[2][3];
+	for (int c = 0; c < 3; c++)
+	{
+		int shift = 56 - 8 * c;
+		if (diff)
+		{
+			int b0 = (bits >> (shift + 3)) & 31;
+			int d = (bits >> shift) & 7;
+			int b1 = b0 + (d >= 4 ? d - 8 : d);
+			base[0][c] = b0 << 3 | b0 >> 2;
+			base[1][c] = b1 << 3 | b1 >> 2;
+		}
+		else
+		{
+			int b0 = (bits >> (shift + 4)) & 15, b1 = (bits >> shift) & 15;
+			base[0][c] = b0 << 4 | b0;
+			base[1][c] = b1 << 4 | b1;
+		}
+	}
+	int table[2] = { (int)(bits >> 37) & 7, (int)(bits >> 34) & 7 };
+	for (int p = 0; p < 16; p++)
+	{
+		int x = p % 4, y = p / 4, i = x * 4 + y;
+		int half = flip ? y / 2 : x / 2;
+		int k = (int)((bits >> (16 + i)) & 1) << 1 | (int)((bits >> i) & 1);
+		for (int c = 0; c < 3; c++)
+			block.px[p][c] = (unsigned char)clampByte(base[half][c] + ETC_MODIFIERS[table[half]][k]);
+		block.px[p][3] = 255;
+	}
+}
+
+inline void encodeEAC(const Block &block, uint8_t *out)
+{
+	int lo = 255, hi = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		lo = std::min(lo, (int)block.px[i][3]);
+		hi = std::max(hi, (int)block.px[i][3]);
+	}
+	int bestBase = lo, bestMul = 1, bestTable = 13, bestIndex[16];
+	std::fill(bestIndex, bestIndex + 16, 4); // tabela 13, índice 4: modificador 0
+	if (lo != hi)
+	{
+		int bestError = 1 << 30;
+		for (int table = 0; table < 16; table++)
+		{
+			int mMin = EAC_MODIFIERS[table][3], mMax = EAC_MODIFIERS[table][7];
+			int ideal = (int)((hi - lo) / (float)(mMax - mMin) + 0.5f);
+			for (int mul = std::max(1, ideal - 1); mul <= std::min(15, ideal + 1); mul++)
+			{
+				int bases[3] = { lo - mMin * mul, hi - mMax * mul, (lo + hi + 1) / 2 - (mMin + mMax) * mul / 2 };
+				for (int b = 0; b < 3; b++)
+				{
+					int base = clampByte(bases[b]), error = 0, index[16];
+					for (int i = 0; i < 16 && error < bestError; i++)
+					{
+						int bestDist = 1 << 30;
+						for (int k = 0; k < 8; k++)
+						{
+							int d = block.px[i][3] - clampByte(base + EAC_MODIFIERS[table][k] * mul);
+							if (d * d < bestDist)
+							{
+								bestDist = d * d;
+								index[i] = k;
+							}
+						}
+						error += bestDist;
+					}
+					if (error < bestError)
+					{
+						bestError = error;
+						bestBase = base;
+						bestMul = mul;
+						bestTable = table;
+						memcpy(bestIndex, index, sizeof(index));
+					}
+				}
+			}
+		}
+	}
+	uint64_t bits = (uint64_t)bestBase << 56 | (uint64_t)bestMul << 52 | (uint64_t)bestTable << 48;
+	for (int p = 0; p < 16; p++)
+	{
+		int i = (p % 4) * 4 + p / 4; // coluna a coluna, o primeiro nos bits mais altos
+		bits |= (uint64_t)bestIndex[p] << (45 - 3 * i);
+	}
+	for (int b = 0; b < 8; b++)
+		out[b] = (bits >> (56 - 8 * b)) & 0xFF;
+}
+
+inline void decodeEAC(const uint8_t *in, Block &block)
+{
+	uint64_t bits = 0;
+	for (int b = 0; b < 8; b++)
+		bits = bits << 8 | in[b];
+	int base = (int)(bits >> 56), mul = (int)(bits >> 52) & 15, table = (int)(bits >> 48) & 15;
+	for (int p = 0; p < 16; p++)
+	{
+		int i = (p % 4) * 4 + p / 4;
+		int k = (int)(bits >> (45 - 3 * i)) & 7;
+		block.px[p][3] = (unsigned char)clampByte(base + EAC_MODIFIERS[table][k] * mul);
+	}
+}
+
+inline void encodeETC2(const Block &block, bool alpha, uint8_t *out)
+{
+	float w[16];
+	if (alpha)
+	{
+		alphaWeights(block, w);
+		encodeEAC(block, out);
+		encodeETC2Color(block, w, out + 8);
+	}
+	else
+	{
+		std::fill(w, w + 16, 1.0f);
+		encodeETC2Color(block, w, out);
+	}
+}
+
+inline void decodeETC2(const uint8_t *in, bool alpha, Block &block)
+{
+	if (alpha)
+	{
+		decodeETC2Color(in + 8, block);
+		decodeEAC(in, block);
+	}
+	else
+	{
+		decodeETC2Color(in, block);
+	}
+}
+
+#endif /* BlockCompress_h */
@@ -0,0 +1,602 @@
+// Pacote de texturas pré-decodificadas (executado durante o build)
+//
+// Decodifica uma vez todos os PNGs de assets/ e grava os pixels RGBA8 já com a
+// cadeia de mipmaps, num único arquivo que o Common/BakedTextures.h mapeia na
+// memória (mmap) e envia para a GPU sem decodificar nada nem copiar para o heap.
+//
+// Cada textura também é gravada em formatos comprimidos em blocos 4x4
+// (BlockCompress.h), que a GPU lê direto com 1/4 a 1/8 da memória:
+//   bc1   BC1 (DXT1) para texturas opacas ou com alfa de 1 bit
+//   bc3   BC3 (DXT5) para texturas com alfa intermediário
+//   bc7   BC7, modo 5 ou modo 6 escolhido bloco a bloco
+//   etc2  ETC2 RGB8 (opacas) ou ETC2 RGBA8 + EAC
+// O Common/BakedTextures.h escolhe em tempo de execução o melhor formato que o
+// driver aceita e volta para o RGBA8 quando nenhum é suportado. Uma variante
+// cujo PSNR (nível 0, contra o PNG) fica abaixo de --min-psnr é descartada:
+// pixel art com NEAREST mostra cada erro de bloco.
+//
+// A compressão roda em paralelo (uma tarefa por textura e formato).
+//
+// Uso: TextureBaker <pasta-assets> <arquivo-saida> [--premultiply]
+//                   [--formats bc1,bc3,bc7,etc2] [--min-psnr dB] [--report arquivo.json]
+//
+// Com --premultiply a cor é gravada multiplicada pelo alfa (para quem desenha
+// com glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)); os demos usam alfa comum.
+// --formats vazio ("--formats rgba8") grava só o RGBA8. O relatório lista, por
+// textura, o tamanho, o PSNR e o tempo de compressão de cada formato.
+//
+// Formato do pacote (little-endian):
+//   char[4]  "TXPK"
+//   uint32   versão (2)
+//   uint32   quantidade de texturas
+//   uint32   início dos dados (múltiplo de 4096)
+//   texturas: uint8 tamanho do nome, nome (caminho relativo a assets/, com '/'),
+//             uint16 largura, uint16 altura, uint8 flags (bit 0: pré-multiplicado),
+//             uint8 variantes (a primeira é sempre RGBA8),
+//             por variante: uint8 formato (BakedFormat), uint16 PSNR em
+//             centésimos de dB (0xFFFF = sem perdas), uint8 níveis,
+//             por nível: uint64 offset, uint32 bytes
+//   dados:    os níveis de cada variante em sequência; cada variante começa num
+//             offset múltiplo de 4096 (página) e cada nível num múltiplo de 16
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "BlockCompress.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// STB_IMAGE
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+const uint64_t PAGE_ALIGN = 4096;
+const uint64_t LEVEL_ALIGN = 16;
+
+// Mesmos valores do BakedFormat (Common/BakedTextures.h)
+enum Format
+{
+	FORMAT_RGBA8 = 0,
+	FORMAT_BC1 = 1,       // RGB, opaco
+	FORMAT_BC1_ALPHA = 2, // RGBA com alfa de 1 bit
+	FORMAT_BC3 = 3,
+	FORMAT_BC7 = 4,
+	FORMAT_ETC2_RGB = 5,
+	FORMAT_ETC2_RGBA = 6
+};
+
+const char *formatName(int format)
+{
+	static const char *names[] = { "rgba8", "bc1", "bc1a", "bc3", "bc7", "etc2_rgb", "etc2_rgba" };
+	return names[format];
+}
+
+struct Level
+{
+	int width, height;
+	vector<unsigned char> pixels; // RGBA8 ou blocos comprimidos
+	uint64_t offset;
+};
+
+struct Variant
+{
+	int format;
+	vector<Level> levels;
+	double psnr;     // nível 0 contra o PNG; infinito = sem perdas
+	double encodeMs;
+	bool kept;       // false: abaixo do --min-psnr
+};
+
+struct Texture
+{
+	string name;
+	fs::path file;
+	bool loaded;
+	vector<Variant> variants; // [0] = RGBA8
+};
+
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+// Roda body(0..count-1) em todas as threads da máquina
+template <typename Body>
+void parallelFor(size_t count, Body body)
+{
+	atomic<size_t> next(0);
+	unsigned workers = max(1u, thread::hardware_concurrency());
+	vector<thread> threads;
+	for (unsigned t = 0; t < workers; t++)
+	{
+		threads.emplace_back([&]() {
+			for (size_t i = next++; i < count; i = next++)
+				body(i);
+		});
+	}
+	for (thread &t : threads)
+		t.join();
+}
+// Próximo nível da cadeia: média de cada bloco 2x2 (nas bordas de tamanho
+// ímpar o último pixel se repete). Com alfa comum a cor é ponderada pelo alfa,
+// para que os pixels transparentes (de cor indefinida) não escureçam as bordas
+Level downsample(const Level &src, bool premultiplied)
+{
+	Level dst;
+	dst.width = max(1, src.width / 2);
+	dst.height = max(1, src.height / 2);
+	dst.pixels.resize((size_t)dst.width * dst.height * 4);
+	dst.offset = 0;
+	for (int y = 0; y < dst.height; y++)
+	{
+		for (int x = 0; x < dst.width; x++)
+		{
+			unsigned sum[4] = { 0, 0, 0, 0 };
+			unsigned alphaSum = 0;
+			for (int dy = 0; dy < 2; dy++)
+			{
+				for (int dx = 0; dx < 2; dx++)
+				{
+					int sx = min(x * 2 + dx, src.width - 1);
+					int sy = min(y * 2 + dy, src.height - 1);
+					const unsigned char *p = &src.pixels[((size_t)sy * src.width + sx) * 4];
+					unsigned weight = premultiplied ? 1 : p[3];
+					for (int c = 0; c < 3; c++)
+						sum[c] += p[c] * weight;
+					sum[3] += p[3];
+					alphaSum += weight;
+				}
+			}
+			unsigned char *q = &dst.pixels[((size_t)y * dst.width + x) * 4];
+			for (int c = 0; c < 3; c++)
+				q[c] = alphaSum ? (unsigned char)((sum[c] + alphaSum / 2) / alphaSum) : 0;
+			q[3] = (unsigned char)((sum[3] + 2) / 4);
+		}
+	}
+	return dst;
+}
+
+void premultiply(vector<unsigned char> &pixels)
+{
+	for (size_t i = 0; i < pixels.size(); i += 4)
+	{
+		for (int c = 0; c < 3; c++)
+			pixels[i + c] = (unsigned char)((pixels[i + c] * pixels[i + 3] + 127) / 255);
+	}
+}
+
+void writeU8(ofstream &out, int value)
+{
+	unsigned char b = (unsigned char)value;
+	out.write((const char *)&b, 1);
+}
+
+void writeU16(ofstream &out, int value)
+{
+	unsigned char b[2] = { (unsigned char)(value & 0xFF), (unsigned char)((value >> 8) & 0xFF) };
+	out.write((const char *)b, 2);
+}
+
+void writeU32(ofstream &out, uint32_t value)
+{
+	unsigned char b[4] = { (unsigned char)(value & 0xFF), (unsigned char)((value >> 8) & 0xFF),
+						   (unsigned char)((value >> 16) & 0xFF), (unsigned char)((value >> 24) & 0xFF) };
+	out.write((const char *)b, 4);
+}
+
+void writeU64(ofstream &out, uint64_t value)
+{
+	writeU32(out, (uint32_t)(value & 0xFFFFFFFFu));
+	writeU32(out, (uint32_t)(value >> 32));
+}
+
+void writeName(ofstream &out, const string &name)
+{
+	unsigned char len = (unsigned char)min<size_t>(name.size(), 255);
+	out.write((const char *)&len, 1);
+	out.write(name.data(), len);
+}
+
+int blockBytes(int format)
+{
+	return format == FORMAT_BC1 || format == FORMAT_BC1_ALPHA || format == FORMAT_ETC2_RGB ? 8 : 16;
+}
+
+void encodeBlock(int format, const Block &block, uint8_t *out)
+{
+	switch (format)
+	{
+	case FORMAT_BC1: encodeBC1(block, false, out); break;
+	case FORMAT_BC1_ALPHA: encodeBC1(block, true, out); break;
+	case FORMAT_BC3: encodeBC3(block, out); break;
+	case FORMAT_BC7: encodeBC7(block, out); break;
+	case FORMAT_ETC2_RGB: encodeETC2(block, false, out); break;
+	case FORMAT_ETC2_RGBA: encodeETC2(block, true, out); break;
+	}
+}
+
+void decodeBlock(int format, const uint8_t *in, Block &block)
+{
+	switch (format)
+	{
+	case FORMAT_BC1:
+	case FORMAT_BC1_ALPHA: decodeBC1(in, block); break;
+	case FORMAT_BC3: decodeBC3(in, block); break;
+	case FORMAT_BC7: decodeBC7(in, block); break;
+	case FORMAT_ETC2_RGB: decodeETC2(in, false, block); break;
+	case FORMAT_ETC2_RGBA: decodeETC2(in, true, block); break;
+	}
+}
+
+// Com alfa comum a cor de um pixel transparente não aparece: os pixels com
+// alfa 0 recebem a cor média dos visíveis do bloco, para não puxarem os
+// extremos para cores que ninguém vê
+void fillTransparent(Block &block)
+{
+	int sum[3] = { 0, 0, 0 }, visible = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		if (block.px[i][3] == 0)
+			continue;
+		for (int c = 0; c < 3; c++)
+			sum[c] += block.px[i][c];
+		visible++;
+	}
+	for (int i = 0; i < 16; i++)
+	{
+		if (block.px[i][3] != 0)
+			continue;
+		for (int c = 0; c < 3; c++)
+			block.px[i][c] = visible ? (unsigned char)(sum[c] / visible) : 0;
+	}
+}
+
+Level encodeLevel(const Level &src, int format, bool premultiplied)
+{
+	Level dst;
+	dst.width = src.width;
+	dst.height = src.height;
+	dst.offset = 0;
+	int blocksX = (src.width + 3) / 4, blocksY = (src.height + 3) / 4, size = blockBytes(format);
+	dst.pixels.resize((size_t)blocksX * blocksY * size);
+	for (int by = 0; by < blocksY; by++)
+	{
+		for (int bx = 0; bx < blocksX; bx++)
+		{
+			Block block;
+			loadBlock(src.pixels.data(), src.width, src.height, bx, by, block);
+			if (!premultiplied)
+				fillTransparent(block);
+			encodeBlock(format, block, &dst.pixels[((size_t)by * blocksX + bx) * size]);
+		}
+	}
+	return dst;
+}
+
+// PSNR do nível comprimido contra o original. Com alfa comum a cor entra
+// multiplicada pelo alfa: o erro de cor de um pixel transparente não aparece
+double levelPsnr(const Level &original, const Level &compressed, int format, bool premultiplied)
+{
+	vector<unsigned char> decoded(original.pixels.size());
+	int blocksX = (original.width + 3) / 4, blocksY = (original.height + 3) / 4, size = blockBytes(format);
+	for (int by = 0; by < blocksY; by++)
+	{
+		for (int bx = 0; bx < blocksX; bx++)
+		{
+			Block block;
+			decodeBlock(format, &compressed.pixels[((size_t)by * blocksX + bx) * size], block);
+			storeBlock(block, decoded.data(), original.width, original.height, bx, by);
+		}
+	}
+	double sum = 0;
+	for (size_t i = 0; i < decoded.size(); i += 4)
+	{
+		const unsigned char *a = &original.pixels[i], *b = &decoded[i];
+		for (int c = 0; c < 3; c++)
+		{
+			double d = premultiplied ? a[c] - b[c] : (a[c] * a[3] - b[c] * b[3]) / 255.0;
+			sum += d * d;
+		}
+		sum += (a[3] - b[3]) * (a[3] - b[3]);
+	}
+	double mse = sum / (decoded.size() / 4 * 4.0);
+	return mse == 0 ? INFINITY : 10 * log10(255.0 * 255.0 / mse);
+}
+
+// Formatos comprimidos de uma textura conforme o alfa: opaca, alfa de 1 bit
+// (só 0 e 255) ou alfa intermediário
+vector<int> formatsFor(const Level &base, const vector<string> &families)
+{
+	bool opaque = true, binary = true;
+	for (size_t i = 3; i < base.pixels.size(); i += 4)
+	{
+		opaque = opaque && base.pixels[i] == 255;
+		binary = binary && (base.pixels[i] == 0 || base.pixels[i] == 255);
+	}
+	auto wants = [&](const char *family) { return find(families.begin(), families.end(), family) != families.end(); };
+	vector<int> formats;
+	if (wants("bc1") && binary)
+		formats.push_back(opaque ? FORMAT_BC1 : FORMAT_BC1_ALPHA);
+	else if (wants("bc3") && !opaque)
+		formats.push_back(FORMAT_BC3);
+	if (wants("bc7"))
+		formats.push_back(FORMAT_BC7);
+	if (wants("etc2"))
+		formats.push_back(opaque ? FORMAT_ETC2_RGB : FORMAT_ETC2_RGBA);
+	return formats;
+}
+
+string psnrText(double psnr)
+{
+	ostringstream text;
+	if (isinf(psnr))
+		text << "inf";
+	else
+		text << fixed << setprecision(2) << psnr;
+	return text.str();
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		cerr << "Uso: TextureBaker <pasta-assets> <arquivo-saida> [--premultiply] [--formats bc1,bc3,bc7,etc2]"
+				" [--min-psnr dB] [--report arquivo.json]"
+			 << endl;
+		return 1;
+	}
+
+	fs::path assetsDir = argv[1];
+	fs::path outPath = argv[2];
+	bool premultiplied = false;
+	vector<string> families = { "bc1", "bc3", "bc7", "etc2" };
+	double minPsnr = 35.0;
+	string reportPath;
+	for (int i = 3; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--premultiply") == 0)
+			premultiplied = true;
+		else if (strcmp(argv[i], "--formats") == 0 && i + 1 < argc)
+		{
+			families.clear();
+			stringstream list(argv[++i]);
+			string family;
+			while (getline(list, family, ','))
+				families.push_back(family);
+		}
+		else if (strcmp(argv[i], "--min-psnr") == 0 && i + 1 < argc)
+			minPsnr = atof(argv[++i]);
+		else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc)
+			reportPath = argv[++i];
+	}
+
+	// Ordem fixa (por nome): o pacote sai igual a cada build
+	vector<fs::path> files;
+	for (const auto &entry : fs::recursive_directory_iterator(assetsDir))
+	{
+		if (entry.is_regular_file() && entry.path().extension() == ".png")
+			files.push_back(entry.path());
+	}
+	sort(files.begin(), files.end());
+
+	auto start = chrono::steady_clock::now();
+
+	// Decodificação e mipmaps, uma textura por thread
+	vector<Texture> textures(files.size());
+	parallelFor(files.size(), [&](size_t t) {
+		Texture &tex = textures[t];
+		tex.file = files[t];
+		tex.name = fs::relative(files[t], assetsDir).generic_string();
+		tex.loaded = false;
+		Level base;
+		int channels;
+		unsigned char *data = stbi_load(files[t].string().c_str(), &base.width, &base.height, &channels, 4);
+		if (!data)
+			return;
+		if (base.width > 65535 || base.height > 65535)
+		{
+			stbi_image_free(data);
+			return;
+		}
+		base.pixels.assign(data, data + (size_t)base.width * base.height * 4);
+		base.offset = 0;
+		stbi_image_free(data);
+		if (premultiplied)
+			premultiply(base.pixels);
+
+		Variant rgba = { FORMAT_RGBA8, {}, INFINITY, 0.0, true };
+		rgba.levels.push_back(move(base));
+		while (rgba.levels.back().width > 1 || rgba.levels.back().height > 1)
+			rgba.levels.push_back(downsample(rgba.levels.back(), premultiplied));
+		tex.variants.push_back(move(rgba));
+		for (int format : formatsFor(tex.variants[0].levels[0], families))
+			tex.variants.push_back({ format, {}, 0.0, 0.0, true });
+		tex.loaded = true;
+	});
+
+	// Compressão: uma tarefa por textura e formato
+	vector<pair<size_t, size_t>> jobs;
+	for (size_t t = 0; t < textures.size(); t++)
+	{
+		if (!textures[t].loaded)
+		{
+			cerr << "Falha ao carregar " << textures[t].file << endl;
+			continue;
+		}
+		for (size_t v = 1; v < textures[t].variants.size(); v++)
+			jobs.push_back({ t, v });
+	}
+	parallelFor(jobs.size(), [&](size_t j) {
+		const Texture &tex = textures[jobs[j].first];
+		Variant &variant = textures[jobs[j].first].variants[jobs[j].second];
+		auto begin = chrono::steady_clock::now();
+		for (const Level &level : tex.variants[0].levels)
+			variant.levels.push_back(encodeLevel(level, variant.format, premultiplied));
+		variant.encodeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+		variant.psnr = levelPsnr(tex.variants[0].levels[0], variant.levels[0], variant.format, premultiplied);
+		variant.kept = variant.psnr >= minPsnr;
+	});
+	textures.erase(remove_if(textures.begin(), textures.end(), [](const Texture &tex) { return !tex.loaded; }),
+				   textures.end());
+	double bakeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+	// Tamanho do diretório para saber onde começam os dados
+	uint64_t headerSize = 16;
+	for (const Texture &tex : textures)
+	{
+		headerSize += 1 + min<size_t>(tex.name.size(), 255) + 2 + 2 + 1 + 1;
+		for (const Variant &variant : tex.variants)
+		{
+			if (variant.kept)
+				headerSize += 1 + 2 + 1 + variant.levels.size() * 12;
+		}
+	}
+	uint64_t dataStart = alignUp(headerSize, PAGE_ALIGN);
+
+	uint64_t offset = dataStart;
+	for (Texture &tex : textures)
+	{
+		for (Variant &variant : tex.variants)
+		{
+			if (!variant.kept)
+				continue;
+			offset = alignUp(offset, PAGE_ALIGN);
+			for (Level &level : variant.levels)
+			{
+				offset = alignUp(offset, LEVEL_ALIGN);
+				level.offset = offset;
+				offset += level.pixels.size();
+			}
+		}
+	}
+
+	if (outPath.has_parent_path())
+		fs::create_directories(outPath.parent_path());
+	ofstream out(outPath, ios::binary);
+	if (!out)
+	{
+		cerr << "Falha ao gravar " << outPath << endl;
+		return 1;
+	}
+	out.write("TXPK", 4);
+	writeU32(out, 2);
+	writeU32(out, (uint32_t)textures.size());
+	writeU32(out, (uint32_t)dataStart);
+	for (const Texture &tex : textures)
+	{
+		writeName(out, tex.name);
+		writeU16(out, tex.variants[0].levels[0].width);
+		writeU16(out, tex.variants[0].levels[0].height);
+		writeU8(out, premultiplied ? 1 : 0);
+		writeU8(out, (int)count_if(tex.variants.begin(), tex.variants.end(), [](const Variant &v) { return v.kept; }));
+		for (const Variant &variant : tex.variants)
+		{
+			if (!variant.kept)
+				continue;
+			writeU8(out, variant.format);
+			writeU16(out, isinf(variant.psnr) ? 0xFFFF : (int)min(65534.0, variant.psnr * 100 + 0.5));
+			writeU8(out, (int)variant.levels.size());
+			for (const Level &level : variant.levels)
+			{
+				writeU64(out, level.offset);
+				writeU32(out, (uint32_t)level.pixels.size());
+			}
+		}
+	}
+
+	// Os buracos de alinhamento ficam zerados
+	const vector<char> zeros(PAGE_ALIGN, 0);
+	uint64_t position = headerSize;
+	for (const Texture &tex : textures)
+	{
+		for (const Variant &variant : tex.variants)
+		{
+			if (!variant.kept)
+				continue;
+			for (const Level &level : variant.levels)
+			{
+				out.write(zeros.data(), (streamsize)(level.offset - position));
+				out.write((const char *)level.pixels.data(), (streamsize)level.pixels.size());
+				position = level.offset + level.pixels.size();
+			}
+		}
+	}
+	if (!out)
+	{
+		cerr << "Falha ao gravar " << outPath << endl;
+		return 1;
+	}
+
+	// Relatório: tamanho com mipmaps, PSNR do nível 0 e tempo de cada formato
+	size_t totalBytes[7] = {}, dropped = 0;
+	for (const Texture &tex : textures)
+	{
+		cout << "  " << tex.name << " (" << tex.variants[0].levels[0].width << "x" << tex.variants[0].levels[0].height << ")";
+		for (const Variant &variant : tex.variants)
+		{
+			size_t bytes = 0;
+			for (const Level &level : variant.levels)
+				bytes += level.pixels.size();
+			cout << "  " << formatName(variant.format) << " " << bytes / 1024 << " KB";
+			if (variant.format != FORMAT_RGBA8)
+				cout << " " << psnrText(variant.psnr) << " dB" << (variant.kept ? "" : " (descartado)");
+			if (variant.kept)
+				totalBytes[variant.format] += bytes;
+			else
+				dropped++;
+		}
+		cout << endl;
+	}
+	if (!reportPath.empty())
+	{
+		if (fs::path(reportPath).has_parent_path())
+			fs::create_directories(fs::path(reportPath).parent_path());
+		ofstream report(reportPath);
+		report << "{\n  \"target\": \"TextureBaker\",\n  \"min_psnr\": " << minPsnr << ",\n  \"bake_ms\": " << fixed
+			   << setprecision(1) << bakeMs << ",\n  \"textures\": [\n";
+		for (size_t t = 0; t < textures.size(); t++)
+		{
+			const Texture &tex = textures[t];
+			report << "    { \"name\": \"" << tex.name << "\", \"width\": " << tex.variants[0].levels[0].width
+				   << ", \"height\": " << tex.variants[0].levels[0].height << ", \"formats\": [\n";
+			for (size_t v = 0; v < tex.variants.size(); v++)
+			{
+				const Variant &variant = tex.variants[v];
+				size_t bytes = 0;
+				for (const Level &level : variant.levels)
+					bytes += level.pixels.size();
+				string psnr = psnrText(variant.psnr);
+				report << "      { \"format\": \"" << formatName(variant.format) << "\", \"bytes\": " << bytes
+					   << ", \"psnr_db\": " << (psnr == "inf" ? "null" : psnr) << ", \"encode_ms\": " << variant.encodeMs
+					   << ", \"kept\": " << (variant.kept ? "true" : "false") << " }"
+					   << (v + 1 < tex.variants.size() ? ",\n" : "\n");
+			}
+			report << "    ] }" << (t + 1 < textures.size() ? ",\n" : "\n");
+		}
+		report << "  ]\n}\n";
+	}
+
+	cout << textures.size() << " texturas em " << fixed << setprecision(0) << bakeMs << " ms, pacote de "
+		 << position / 1024 << " KB:";
+	for (int format = 0; format < 7; format++)
+	{
+		if (totalBytes[format])
+			cout << " " << formatName(format) << " " << totalBytes[format] / 1024 << " KB";
+	}
+	cout << "; " << dropped << " variantes abaixo de " << minPsnr << " dB descartadas" << endl;
+	return 0;
+}
@@ -0,0 +1,155 @@
+// Conversor de tilemaps para o formato em chunks .tmap (executado durante o build)
+//
+// Lê um mapa em texto e grava o .tmap lido pelo TileMapFile.h (mapa inteiro
+// na memória) e pelo StreamingTileMap.h (chunks sob demanda). Também gera
+// mundos procedurais grandes para testar o streaming, chunk por chunk, sem
+// montar o mapa inteiro na memória.
+//
+// Uso: TileMapTool <mapa.txt> <saida.tmap> [--chunk N] [--tileset N]
+//      TileMapTool --generate <largura> <altura> <saida.tmap> [--chunk N] [--tiles N] [--seed N]
+//
+// Formato do texto: linhas começando com '#' são comentários; depois vêm a
+// largura e a altura e os ids dos tiles, linha 0 primeiro, separados por
+// espaços ou vírgulas.
+
+#include "TileMapFile.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+static uint32_t hash2(int x, int y, uint32_t seed)
+{
+	uint32_t h = (uint32_t)x * 374761393u + (uint32_t)y * 668265263u + seed * 2246822519u;
+	h = (h ^ (h >> 13)) * 1274126177u;
+	return h ^ (h >> 16);
+}
+
+// Regiões de 32x32 de um mesmo tile com alguns tiles soltos, parecido com
+// um mapa desenhado (e por isso bem comprimível)
+static unsigned char generatedTile(int col, int row, int tiles, uint32_t seed)
+{
+	int base = hash2(col >> 5, row >> 5, seed) % tiles;
+	if (hash2(col, row, seed + 1) % 64 == 0)
+	{
+		return (unsigned char)((base + 1) % tiles);
+	}
+	return (unsigned char)base;
+}
+
+static bool readText(const string &path, int &width, int &height, vector<unsigned char> &cells)
+{
+	ifstream in(path);
+	if (!in)
+	{
+		cerr << "Arquivo nao encontrado: " << path << endl;
+		return false;
+	}
+	string text, line;
+	while (getline(in, line))
+	{
+		if (!line.empty() && line[0] == '#')
+			continue;
+		replace(line.begin(), line.end(), ',', ' ');
+		text += line + " ";
+	}
+	istringstream values(text);
+	if (!(values >> width >> height) || width <= 0 || height <= 0)
+	{
+		cerr << "Dimensoes invalidas em " << path << endl;
+		return false;
+	}
+	cells.resize((size_t)width * height);
+	for (size_t i = 0; i < cells.size(); i++)
+	{
+		int tile;
+		if (!(values >> tile) || tile < 0 || tile > 255)
+		{
+			cerr << "Esperados " << cells.size() << " tiles entre 0 e 255 em " << path << endl;
+			return false;
+		}
+		cells[i] = (unsigned char)tile;
+	}
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		cerr << "Uso: TileMapTool <mapa.txt> <saida.tmap> [--chunk N] [--tileset N]" << endl
+			 << "     TileMapTool --generate <largura> <altura> <saida.tmap> [--chunk N] [--tiles N] [--seed N]" << endl;
+		return 1;
+	}
+
+	bool generate = strcmp(argv[1], "--generate") == 0;
+	int first = generate ? 5 : 3;
+	if (generate && argc < 5)
+	{
+		cerr << "Uso: TileMapTool --generate <largura> <altura> <saida.tmap>" << endl;
+		return 1;
+	}
+	int chunk = 64, tileset = 0, tiles = 7;
+	uint32_t seed = 1;
+	for (int i = first; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+			chunk = max(1, min(4096, atoi(argv[++i])));
+		else if (strcmp(argv[i], "--tileset") == 0 && i + 1 < argc)
+			tileset = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--tiles") == 0 && i + 1 < argc)
+			tiles = max(1, min(256, atoi(argv[++i])));
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			seed = (uint32_t)atoi(argv[++i]);
+	}
+
+	auto start = chrono::steady_clock::now();
+	TileMapHeader header;
+	string outPath;
+	bool ok;
+	if (generate)
+	{
+		header = { atoi(argv[2]), atoi(argv[3]), chunk, tileset, 0.0f };
+		outPath = argv[4];
+		if (header.width <= 0 || header.height <= 0)
+		{
+			cerr << "Dimensoes invalidas" << endl;
+			return 1;
+		}
+		ok = TileMapFile::save(outPath, header, [tiles, seed](int col, int row) {
+			return generatedTile(col, row, tiles, seed);
+		});
+	}
+	else
+	{
+		vector<unsigned char> cells;
+		int width, height;
+		if (!readText(argv[1], width, height, cells))
+			return 1;
+		header = { width, height, chunk, tileset, 0.0f };
+		outPath = argv[2];
+		ok = TileMapFile::save(outPath, header, [&cells, width](int col, int row) {
+			return cells[(size_t)row * width + col];
+		});
+	}
+	if (!ok)
+	{
+		cerr << "Falha ao gravar " << outPath << endl;
+		return 1;
+	}
+
+	ifstream written(outPath, ios::binary | ios::ate);
+	double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	cout << outPath << ": " << header.width << "x" << header.height << ", " << header.chunkCount() << " chunks de "
+		 << chunk << "x" << chunk << ", " << (long long)written.tellg() / 1024 << " KB (" << (long long)ms << " ms)" << endl;
+	return 0;
+}
@@ -15,18 +15,33 @@ using namespace glm;
 
 #include <cmath>
 
+#include "ShaderProgram.h"
+#include "HeadlessRunner.h"
+#include "ProgramCache.h"
+#include "GeometryRegistry.h"
+#include "TriangleIndex.h"
+
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
+void cursor_pos_callback(GLFWwindow* window, double xpos, double ypos);
 
 // Protótipos das funções
 GLuint createTriangle(float x0, float y0, float x1, float y1, float x2, float y2);
 int setupShader();
 int setupGeometry();
+void addTriangle(float x, float y);
+void deleteTriangle(int id);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
 
+// Triângulos com os mesmos vértices compartilham VAO/VBO
+GeometryRegistry geometry;
+
+// Programas de shader compilados uma vez e reaproveitados do disco
+ProgramCache programCache;
+
 const GLchar *vertexShaderSource = R"(
 #version 400
 layout (location = 0) in vec3 position;
@@ -58,20 +73,34 @@ struct Triangle
 
 vector<Triangle> triangles;
 
+// Índice espacial para o clique: o id de um triângulo é a sua posição em
+// triangles (ordem de desenho), então o id maior é o que está por cima
+TriangleIndex pickIndex(64.0f);
+int selected = -1;    // triângulo selecionado pelo clique (-1: nenhum)
+bool dragging = false;
+vec2 dragOffset;      // posição do triângulo - cursor, no início do arraste
+
+mat4 modelMatrix(const Triangle &tri);
+void triangleVertices(const Triangle &tri, float *out);
+
 vector <vec3> colors;
 int iColor = 0;
 
-int main()
+int main(int argc, char **argv)
 {
+	// --headless --frames N: benchmark sem janela visível (ver HeadlessRunner.h)
+	HeadlessRunner runner(argc, argv);
+
 	glfwInit();
 
 	// Criação da janela GLFW
-	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana", nullptr, nullptr);
+	GLFWwindow *window = runner.createWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana");
 	glfwMakeContextCurrent(window);
 
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
 	glfwSetMouseButtonCallback(window, mouse_button_callback);
+	glfwSetCursorPosCallback(window, cursor_pos_callback);
 
 	// GLAD: carrega todos os ponteiros d funções da OpenGL
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
@@ -79,6 +108,15 @@ int main()
 		std::cout << "Failed to initialize GLAD" << std::endl;
 	}
 
+	runner.attach(window);
+	// Entrada programada do modo headless
+	for (int i = 0; i < 50; i++)
+		runner.addClick(10 + i * 4, 50 + (i * 70) % 700, 50 + (i * 130) % 500);
+	// arrasta o primeiro triângulo e apaga alguns com o botão direito
+	runner.addDrag(220, 400, 300, 600, 450, 30);
+	for (int i = 0; i < 10; i++)
+		runner.addClick(260 + i * 3, 50 + (i * 70) % 700, 50 + (i * 130) % 500, GLFW_MOUSE_BUTTON_RIGHT);
+
 	// Obtendo as informações de versão
 	const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
 	const GLubyte *version = glGetString(GL_VERSION);	/* version as a string */
@@ -120,24 +158,23 @@ int main()
 	
 	GLuint VAO = createTriangle(-0.5,-0.5,0.5,-0.5,0.0,0.5);
 	
-	Triangle tri;
-	tri.position = vec3(400.0,300.0,0.0);
-	tri.dimensions = vec3(100.0,100.0,1.0);
-	tri.color = vec3(colors[iColor].r, colors[iColor].g, colors[iColor].b);
-	iColor = (iColor + 1) % colors.size();
-	triangles.push_back(tri);
+	addTriangle(400.0, 300.0);
 
 
 	glUseProgram(shaderID);
 
-	GLint colorLoc = glGetUniformLocation(shaderID, "inputColor");
+	ShaderProgram shader(shaderID);
+	int colorLoc = shader.uniform("inputColor");
+	int modelLoc = shader.uniform("model");
 
 	mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	shader.setMat4(shader.uniform("projection"), projection);
 
 	while (!glfwWindowShouldClose(window))
 	{
 		glfwPollEvents();
+		runner.beginFrame();
+		shader.beginFrame();
 
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
@@ -149,75 +186,51 @@ int main()
 
 		for (int i = 0; i < triangles.size(); i++)
 		{
-			// Matriz de modelo: transformações na geometria (objeto)
-			mat4 model = mat4(1); // matriz identidade
-			// Translação
-			model = translate(model,vec3(triangles[i].position.x,triangles[i].position.y,0.0));
+			if (!pickIndex.isAlive(i))
+				continue; // apagado, aguardando a compactação
 
-			model = rotate(model,radians(180.0f),vec3(0.0,0.0,1.0));
-			// Escala
-			model = scale(model,vec3(triangles[i].dimensions.x,triangles[i].dimensions.y,1.0));
-			glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+			shader.setMat4(modelLoc, modelMatrix(triangles[i]));
 
-			glUniform4f(colorLoc, triangles[i].color.r, triangles[i].color.g, triangles[i].color.b, 1.0f); // enviando cor para variável uniform inputColor
+			// O selecionado aparece clareado
+			vec3 color = triangles[i].color;
+			if (i == selected)
+				color = color + (vec3(1.0) - color) * 0.6f;
+			shader.setVec4(colorLoc, color.r, color.g, color.b, 1.0f); // enviando cor para variável uniform inputColor
 			glDrawArrays(GL_TRIANGLES, 0, 3);
 		}
 
 		glBindVertexArray(0); // Desconectando o buffer de geometria
 
+		runner.endFrame();
+
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
 	}
 
+	programCache.printReport();
+	runner.setMetric("shader_setup_ms", programCache.getTotalMs());
+	runner.setMetric("program_cache_hits", programCache.getStats().hits);
+	runner.finish();
+	geometry.releaseAll();
 	glfwTerminate();
-	return 0;
+	return runner.exitStatus();
 }
 
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode)
 {
 	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
 		glfwSetWindowShouldClose(window, GL_TRUE);
+
+	// Delete/Backspace apagam o triângulo selecionado
+	if ((key == GLFW_KEY_DELETE || key == GLFW_KEY_BACKSPACE) && action == GLFW_PRESS && selected >= 0)
+		deleteTriangle(selected);
 }
 
 int setupShader()
 {
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
+	// Binário do programa em cache (ver ProgramCache.h): só compila quando o
+	// fonte ou o driver mudam
+	return programCache.build(vertexShaderSource, fragmentShaderSource);
 }
 
 int setupGeometry()
@@ -229,27 +242,11 @@ int setupGeometry()
 		0.0, 0.5, 0.0,	 // v2
 	};
 
-	GLuint VBO, VAO;
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-	
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-
-	return VAO;
+	return geometry.acquire(VertexLayout().add(0, 3), vertices, sizeof(vertices)).VAO;
 }
 
 GLuint createTriangle(float x0, float y0, float x1, float y1, float x2, float y2)
 {
-	GLuint VAO;
-
 	GLfloat vertices[] = {
 		// x    y    z
 		// T0
@@ -258,37 +255,120 @@ GLuint createTriangle(float x0, float y0, float x1, float y1, float x2, float y2
 		x2, y2, 0.0, // v2
 	};
 
-	GLuint VBO;
-	glGenBuffers(1, &VBO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	return geometry.acquire(VertexLayout().add(0, 3), vertices, sizeof(vertices)).VAO;
+}
+
+// Matriz de modelo: transformações na geometria (objeto)
+mat4 modelMatrix(const Triangle &tri)
+{
+	mat4 model = mat4(1); // matriz identidade
+	// Translação
+	model = translate(model,vec3(tri.position.x,tri.position.y,0.0));
+
+	model = rotate(model,radians(180.0f),vec3(0.0,0.0,1.0));
+	// Escala
+	model = scale(model,vec3(tri.dimensions.x,tri.dimensions.y,1.0));
+	return model;
+}
+
+// Vértices do triângulo na tela (o mesmo triângulo do createTriangle passado
+// pela matriz de modelo), no formato { x0, y0, x1, y1, x2, y2 }
+void triangleVertices(const Triangle &tri, float *out)
+{
+	const vec2 base[3] = { vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.0, 0.5) };
+	mat4 model = modelMatrix(tri);
+	for (int i = 0; i < 3; i++)
+	{
+		vec4 v = model * vec4(base[i], 0.0, 1.0);
+		out[i * 2] = v.x;
+		out[i * 2 + 1] = v.y;
+	}
+}
 
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
+void addTriangle(float x, float y)
+{
+	Triangle tri;
+	tri.position = vec3(x,y,0.0);
+	tri.dimensions = vec3(100.0,100.0,1.0);
+	tri.color = vec3(colors[iColor].r, colors[iColor].g, colors[iColor].b);
+	iColor = (iColor + 1) % colors.size();
+	triangles.push_back(tri);
 
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
+	float vertices[6];
+	triangleVertices(tri, vertices);
+	pickIndex.insert(vertices);
+}
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+void deleteTriangle(int id)
+{
+	pickIndex.remove(id);
+	if (id == selected)
+	{
+		selected = -1;
+		dragging = false;
+	}
 
-	return VAO;
+	// Com mais buracos do que triângulos, fecha os buracos (os ids mudam)
+	if (pickIndex.getLiveCount() < pickIndex.size() / 2)
+	{
+		int newSelected = -1;
+		if (selected >= 0)
+		{
+			newSelected = 0;
+			for (int i = 0; i < selected; i++)
+				newSelected += pickIndex.isAlive(i);
+		}
+		pickIndex.compact(triangles);
+		selected = newSelected;
+	}
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
-    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
-    {
-		double xpos, ypos;
-		glfwGetCursorPos(window, &xpos, &ypos);
+	double xpos, ypos;
+	glfwGetCursorPos(window, &xpos, &ypos);
+
+	if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+	{
 		cout << xpos << "  " << ypos << endl;
 
-		Triangle tri;
-		tri.position = vec3(xpos,ypos,0.0);
-		tri.dimensions = vec3(100.0,100.0,1.0);
-		tri.color = vec3(colors[iColor].r, colors[iColor].g, colors[iColor].b);
-		iColor = (iColor + 1) % colors.size();
-		triangles.push_back(tri);
-		
+		// Clique num triângulo seleciona e começa a arrastar o de cima;
+		// clique no vazio cria um triângulo novo
+		int hit = pickIndex.pick(xpos, ypos);
+		if (hit >= 0)
+		{
+			selected = hit;
+			dragging = true;
+			dragOffset = vec2(triangles[hit].position.x - xpos, triangles[hit].position.y - ypos);
+		}
+		else
+		{
+			selected = -1;
+			addTriangle(xpos, ypos);
+		}
+	}
+	else if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
+	{
+		dragging = false;
+	}
+	else if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS)
+	{
+		// Botão direito apaga o triângulo de cima
+		int hit = pickIndex.pick(xpos, ypos);
+		if (hit >= 0)
+			deleteTriangle(hit);
 	}
 }
+
+void cursor_pos_callback(GLFWwindow* window, double xpos, double ypos)
+{
+	if (!dragging || selected < 0)
+		return;
+
+	Triangle &tri = triangles[selected];
+	tri.position = vec3(vec2(xpos, ypos) + dragOffset, 0.0);
+
+	float vertices[6];
+	triangleVertices(tri, vertices);
+	pickIndex.update(selected, vertices);
+}